@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+Compares two runs of the benchmarks (the JSON files written by the bench-json target, or by any benchmark run with
+--benchmark_out_format=json) and flags the benchmarks that got slower than a threshold.
+
+Usage: compare.py [--threshold PERCENT] [--metric real_time|cpu_time] BASELINE CURRENT
+
+BASELINE and CURRENT are either two JSON files or two directories of JSON files (matched by file name). When the
+runs have repetitions, the medians are compared. Exits with status 1 if any benchmark regressed.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+NANOSECONDS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_file(path):
+    """Reads a JSON file, returning the time of every benchmark (in nanoseconds) by name."""
+    with open(path) as file:
+        report = json.load(file)
+
+    times = {}
+    medians = {}
+
+    for benchmark in report.get("benchmarks", []):
+        if benchmark.get("error_occurred"):
+            continue
+
+        scale = NANOSECONDS[benchmark.get("time_unit", "ns")]
+
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[benchmark["run_name"]] = benchmark, scale
+        else:
+            times.setdefault(benchmark.get("run_name", benchmark["name"]), (benchmark, scale))
+
+    # with repetitions, every repetition is an iteration run: keep the median instead
+    times.update(medians)
+    return times
+
+
+def load(path):
+    """Reads a JSON file, or all the JSON files of a directory, prefixing the names with the file name."""
+    if not os.path.isdir(path):
+        return load_file(path)
+
+    times = {}
+
+    for entry in sorted(os.listdir(path)):
+        if entry.endswith(".json"):
+            prefix = entry[:-len(".json")] + ":"
+
+            for name, value in load_file(os.path.join(path, entry)).items():
+                times[prefix + name] = value
+
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flags the benchmarks that regressed between two runs.")
+    parser.add_argument("baseline", help="the JSON file (or directory) of the reference run")
+    parser.add_argument("current", help="the JSON file (or directory) of the run to check")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="the slowdown (in percent) above which a benchmark regressed (default: 10)")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time",
+                        help="the time to compare (default: real_time)")
+    arguments = parser.parse_args()
+
+    baseline = load(arguments.baseline)
+    current = load(arguments.current)
+    regressions = 0
+
+    print("%-70s %14s %14s %9s" % ("Benchmark", "Baseline (ns)", "Current (ns)", "Change"))
+
+    for name in sorted(set(baseline) & set(current)):
+        before = baseline[name][0][arguments.metric] * baseline[name][1]
+        after = current[name][0][arguments.metric] * current[name][1]
+        change = (after - before) / before * 100 if before > 0 else 0.0
+        flag = ""
+
+        if change > arguments.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+
+        print("%-70s %14.1f %14.1f %+8.1f%%%s" % (name, before, after, change, flag))
+
+    for name in sorted(set(baseline) - set(current)):
+        print("%-70s only in the baseline" % name)
+
+    for name in sorted(set(current) - set(baseline)):
+        print("%-70s only in the current run" % name)
+
+    if regressions:
+        print("\n%d benchmark(s) slower by more than %.1f%%" % (regressions, arguments.threshold))
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/element-pool.hxx>
+
+using namespace ese::flow;
+
+static std::atomic<std::uint64_t> allocations(0);
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* address = std::malloc(size == 0 ? 1 : size))
+        return address;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* address) noexcept
+{
+    std::free(address);
+}
+
+void operator delete(void* address, std::size_t) noexcept
+{
+    std::free(address);
+}
+
+/*
+ * The message of the benchmarks: a heap-allocated payload.
+ */
+typedef std::vector<char> Message;
+
+/*
+ * Every message is built by the producer and destroyed by the consumer, through a std::queue.
+ */
+static void fresh_messages(benchmark::State& state)
+{
+    const int batch_size = static_cast<int>(state.range(0));
+    Channel<Message> channel;
+    const std::uint64_t first = allocations.load();
+
+    for (auto _: state)
+    {
+        for (int i = 0; i < batch_size; ++i)
+            channel.get_sender().send(Message(256, static_cast<char>(i)));
+
+        for (int i = 0; i < batch_size; ++i)
+            benchmark::DoNotOptimize(channel.get_receiver().receive());
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch_size);
+    state.counters["allocations_per_item"] = static_cast<double>(allocations.load() - first)
+        / static_cast<double>(state.iterations() * batch_size);
+}
+BENCHMARK(fresh_messages)->Arg(64)->Arg(1024);
+
+/*
+ * Messages circulate between the producer and the consumer, through a RingQueue.
+ */
+static void pooled_messages(benchmark::State& state)
+{
+    const int batch_size = static_cast<int>(state.range(0));
+    RingQueueChannel<Message> channel;
+    ElementPool<Message> pool(static_cast<std::size_t>(batch_size));
+
+    auto round = [&channel, &pool, batch_size] ()
+        {
+            for (int i = 0; i < batch_size; ++i)
+            {
+                Message message = pool.acquire();
+                message.assign(256, static_cast<char>(i));
+                channel.get_sender().send(std::move(message));
+            }
+
+            for (int i = 0; i < batch_size; ++i)
+                pool.release(channel.get_receiver().receive());
+        };
+
+    // the warm-up fills the pool and grows the queue
+    round();
+    const std::uint64_t first = allocations.load();
+
+    for (auto _: state)
+        round();
+
+    state.SetItemsProcessed(state.iterations() * batch_size);
+    state.counters["allocations_per_item"] = static_cast<double>(allocations.load() - first)
+        / static_cast<double>(state.iterations() * batch_size);
+}
+BENCHMARK(pooled_messages)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();
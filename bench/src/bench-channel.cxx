@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/lock-free-channel.hxx>
+
+using namespace ese::flow;
+
+/*
+ * An element of a specified size (in bytes), copied by value through the channels.
+ */
+template<std::size_t Size>
+struct Payload
+{
+    char data[Size];
+};
+
+/*
+ * Producers (the benchmark threads) send into a channel, while state.range(0) consumers drain it in batches.
+ */
+template<typename TChannel>
+static void hand_off(benchmark::State& state)
+{
+    typedef typename TChannel::ElementType ElementType;
+
+    static TChannel channel(1024);
+    static std::atomic_bool running(false);
+    static std::vector<std::thread> consumers;
+
+    if (state.thread_index() == 0)
+    {
+        running = true;
+
+        for (long i = 0; i < state.range(0); ++i)
+            consumers.emplace_back([] ()
+                {
+                    ElementType batch[64];
+
+                    while (running.load(std::memory_order_relaxed))
+                        channel.get_receiver().receive_batch(batch, 64, std::chrono::steady_clock::now()
+                            + std::chrono::milliseconds(1));
+                });
+    }
+
+    Sender<ElementType>& sender = channel.get_sender();
+    const ElementType element{};
+
+    for (auto _: state)
+        sender.send(element);
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<long>(sizeof(ElementType)));
+
+    if (state.thread_index() == 0)
+    {
+        running = false;
+        channel.wake_up();
+
+        for (std::thread& consumer: consumers)
+            consumer.join();
+
+        consumers.clear();
+
+        ElementType element;
+
+        while (channel.get_receiver().try_receive(&element));
+    }
+}
+
+/*
+ * Sends an element to an echo thread and waits for it to come back: the time of an iteration is a round trip.
+ */
+template<typename TChannel>
+static void round_trip(benchmark::State& state)
+{
+    typedef typename TChannel::ElementType ElementType;
+
+    TChannel ping(1024);
+    TChannel pong(1024);
+    std::atomic_bool running(true);
+
+    std::thread echo([&ping, &pong, &running] ()
+        {
+            ElementType element;
+
+            while (running.load(std::memory_order_relaxed))
+                if (ping.get_receiver().try_receive_for(&element, std::chrono::milliseconds(1)))
+                    pong.get_sender().send(std::move(element));
+        });
+
+    Sender<ElementType>& sender = ping.get_sender();
+    Receiver<ElementType>& receiver = pong.get_receiver();
+    ElementType element{};
+
+    for (auto _: state)
+    {
+        sender.send(element);
+        receiver.try_receive(&element, true);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    running = false;
+    ping.wake_up();
+    echo.join();
+}
+
+// single producer, single consumer
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<8>>)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<64>>)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<512>>)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, SpscChannel<Payload<8>>)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, SpscChannel<Payload<64>>)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, SpscChannel<Payload<512>>)->Arg(1)->UseRealTime();
+
+// many producers, single consumer
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<8>>)->Arg(1)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<64>>)->Arg(1)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, MpmcChannel<Payload<8>>)->Arg(1)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, MpmcChannel<Payload<64>>)->Arg(1)->ThreadRange(2, 16)->UseRealTime();
+
+// many producers, many consumers
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<8>>)->Arg(4)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, Channel<Payload<64>>)->Arg(4)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, MpmcChannel<Payload<8>>)->Arg(4)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(hand_off, MpmcChannel<Payload<64>>)->Arg(4)->ThreadRange(2, 16)->UseRealTime();
+
+// latency
+BENCHMARK_TEMPLATE(round_trip, Channel<Payload<8>>)->UseRealTime();
+BENCHMARK_TEMPLATE(round_trip, SpscChannel<Payload<8>>)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/consumer.hxx>
+
+using namespace ese::flow;
+
+class SummingConsumerFactory: public ConsumerFactory<long>
+{
+public:
+    SummingConsumerFactory(Receiver<long>* receiver):
+        ConsumerFactory(receiver),
+        sum(0)
+    {
+
+    }
+
+    void consume_0(long&& number) override
+    {
+        sum += number;
+    }
+
+    long sum;
+};
+
+static const std::size_t elements = 256;
+
+/*
+ * Sends a burst of elements, then drains it with a consumer, reporting the number of elements per second.
+ */
+template<typename TCreate>
+static void run(benchmark::State& state, TCreate create)
+{
+    Channel<long> channel;
+    SummingConsumerFactory factory(&channel.get_receiver());
+    Consumer<long> consumer = create(factory);
+    std::vector<long> burst(elements, 1);
+
+    for (auto _: state)
+    {
+        channel.get_sender().send_batch(burst.begin(), burst.end());
+
+        while (consumer() > 0);
+    }
+
+    benchmark::DoNotOptimize(factory.sum);
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+
+/*
+ * One element per call.
+ */
+static void consume_one(benchmark::State& state)
+{
+    run(state, [] (SummingConsumerFactory& factory) { return factory.create_one(); });
+}
+BENCHMARK(consume_one);
+
+/*
+ * Batches of state.range(0) elements per call.
+ */
+static void consume_batch(benchmark::State& state)
+{
+    const std::size_t max = static_cast<std::size_t>(state.range(0));
+    run(state, [max] (SummingConsumerFactory& factory) { return factory.create_batch(max); });
+}
+BENCHMARK(consume_batch)->Arg(8)->Arg(64)->Arg(256);
+
+/*
+ * Batches sized by the adaptive consumer, up to state.range(0) elements per call.
+ */
+static void consume_adaptive(benchmark::State& state)
+{
+    const std::size_t max = static_cast<std::size_t>(state.range(0));
+    run(state, [max] (SummingConsumerFactory& factory) { return factory.create_adaptive(max); });
+}
+BENCHMARK(consume_adaptive)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
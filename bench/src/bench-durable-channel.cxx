@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <dirent.h>
+#include <unistd.h>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/durable-channel.hxx>
+
+using namespace ese::flow;
+
+/*
+ * Sends batches of elements, receiving them after every batch.
+ */
+template<typename TChannel>
+static void send_and_drain(benchmark::State& state, TChannel& channel)
+{
+    const std::size_t batch_size = static_cast<std::size_t>(state.range(0));
+    std::vector<long> batch(batch_size);
+    long i = 0;
+
+    for (auto _: state)
+    {
+        for (long& element: batch)
+            element = i++;
+
+        channel.get_sender().send_batch(batch.begin(), batch.end());
+
+        while (channel.get_receiver().receive_batch(batch.data(), batch_size) != 0);
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+/*
+ * A temporary directory, removed with its files.
+ */
+class TemporaryDirectory
+{
+public:
+    std::string path;
+
+    TemporaryDirectory()
+    {
+        char name[] = "/tmp/ese-flow-bench-XXXXXX";
+        path = mkdtemp(name);
+    }
+
+    ~TemporaryDirectory()
+    {
+        if (DIR* handle = opendir(path.c_str()))
+        {
+            while (dirent* entry = readdir(handle))
+                std::remove((path + "/" + entry->d_name).c_str());
+
+            closedir(handle);
+        }
+
+        rmdir(path.c_str());
+    }
+};
+
+static void in_memory(benchmark::State& state)
+{
+    Channel<long> channel;
+    send_and_drain(state, channel);
+}
+BENCHMARK(in_memory)->Arg(1)->Arg(64);
+
+static void durable_no_sync(benchmark::State& state)
+{
+    TemporaryDirectory directory;
+    DurableLogOptions options;
+    options.sync_every = 0;
+    options.sync_interval = std::chrono::milliseconds(0);
+
+    DurableChannel<long> channel(directory.path, options);
+    send_and_drain(state, channel);
+}
+BENCHMARK(durable_no_sync)->Arg(1)->Arg(64);
+
+static void durable_group_commit(benchmark::State& state)
+{
+    TemporaryDirectory directory;
+    DurableChannel<long> channel(directory.path);
+    send_and_drain(state, channel);
+}
+BENCHMARK(durable_group_commit)->Arg(1)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/consumer.hxx>
+#include <ese/flow/executor.hxx>
+#include <ese/flow/lambda-executable.hxx>
+#include <ese/flow/thread-pool-executor.hxx>
+
+using namespace ese::flow;
+
+/*
+ * Every heap allocation of the process is counted.
+ */
+static std::atomic<std::size_t> allocations(0);
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+/*
+ * The captures of a typical task: a few pointers and integers (too big for the std::function's inline buffer).
+ */
+typedef struct _Payload_
+{
+    std::atomic_long* counter;
+    long a;
+    long b;
+    long c;
+} Payload;
+
+/*
+ * Submits tasks to an executor, reporting the number of allocations per task.
+ */
+template<typename TExecutor>
+static void submit(benchmark::State& state, TExecutor& executor)
+{
+    static const std::size_t tasks = 1024;
+
+    std::atomic_long counter(0);
+    Payload payload = {&counter, 1, 2, 3};
+    std::size_t total_tasks = 0;
+    const std::size_t before = allocations.load();
+
+    for (auto _: state)
+    {
+        for (std::size_t i = 0; i < tasks; ++i)
+            executor.execute([payload] ()
+                {
+                    payload.counter->fetch_add(payload.a + payload.b + payload.c, std::memory_order_relaxed);
+                });
+
+        total_tasks += tasks;
+    }
+
+    state.counters["allocs_per_task"] = static_cast<double>(allocations.load() - before) / total_tasks;
+    state.SetItemsProcessed(total_tasks);
+}
+
+static void inline_std_function(benchmark::State& state)
+{
+    Executor<std::function<void()>> executor;
+    submit(state, executor);
+}
+BENCHMARK(inline_std_function);
+
+static void inline_lambda_executable(benchmark::State& state)
+{
+    Executor<LambdaExecutable> executor;
+    submit(state, executor);
+}
+BENCHMARK(inline_lambda_executable);
+
+/*
+ * Submits tasks to a pool with two workers (the time measures the submitting thread only).
+ */
+template<typename TExecutable>
+static void pool(benchmark::State& state)
+{
+    ThreadPoolExecutor<TExecutable> executor(2);
+
+    // warm-up: the pool recycles its storage
+    for (int i = 0; i < 4096; ++i)
+        executor.execute([] () {});
+
+    executor.drain();
+    submit(state, executor);
+    executor.drain();
+}
+BENCHMARK_TEMPLATE(pool, std::function<void()>);
+BENCHMARK_TEMPLATE(pool, LambdaExecutable);
+
+class NullConsumerFactory: public ConsumerFactory<int>
+{
+public:
+    explicit NullConsumerFactory(Receiver<int>* receiver):
+        ConsumerFactory(receiver)
+    {
+
+    }
+
+    void consume_0(int&&) override
+    {
+
+    }
+};
+
+/*
+ * Creates consumers, reporting the number of allocations per consumer.
+ */
+static void consumer_creation(benchmark::State& state)
+{
+    Channel<int> channel;
+    NullConsumerFactory factory(&channel.get_receiver());
+    std::size_t consumers = 0;
+    const std::size_t before = allocations.load();
+
+    for (auto _: state)
+    {
+        Consumer<int> consumer = factory.create_one();
+        benchmark::DoNotOptimize(consumer());
+        ++consumers;
+    }
+
+    state.counters["allocs_per_consumer"] = static_cast<double>(allocations.load() - before) / consumers;
+}
+BENCHMARK(consumer_creation);
+
+BENCHMARK_MAIN();
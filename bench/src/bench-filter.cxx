@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <ese/flow/filter.hxx>
+#include <ese/flow/static-filter.hxx>
+
+using namespace ese::flow;
+
+class AddFilter: public Filter<int, int>
+{
+public:
+    int filter(int&& i) override
+    {
+        return i + 3;
+    }
+
+    int filter(const int& i) override
+    {
+        return i + 3;
+    }
+};
+
+class MultiplyFilter: public Filter<int, int>
+{
+public:
+    int filter(int&& i) override
+    {
+        return i * 5;
+    }
+
+    int filter(const int& i) override
+    {
+        return i * 5;
+    }
+};
+
+class XorFilter: public Filter<int, int>
+{
+public:
+    int filter(int&& i) override
+    {
+        return i ^ 0x55;
+    }
+
+    int filter(const int& i) override
+    {
+        return i ^ 0x55;
+    }
+};
+
+static const std::size_t elements = 4096;
+
+/*
+ * Passes every element through the chain, reporting the number of elements per second.
+ */
+template<typename TChain>
+static void run(benchmark::State& state, TChain chain)
+{
+    std::vector<int> in(elements);
+    std::vector<int> out(elements);
+
+    for (std::size_t i = 0; i < elements; ++i)
+        in[i] = static_cast<int>(i);
+
+    for (auto _: state)
+    {
+        for (std::size_t i = 0; i < elements; ++i)
+            out[i] = chain(in[i]);
+
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+
+/*
+ * Three cheap filters, called through the vtable (one indirect call each).
+ */
+static void virtual_chain(benchmark::State& state)
+{
+    AddFilter add;
+    MultiplyFilter multiply;
+    XorFilter xor_;
+    Filter<int, int>* a = &add;
+    Filter<int, int>* b = &multiply;
+    Filter<int, int>* c = &xor_;
+
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(b);
+    benchmark::DoNotOptimize(c);
+    run(state, [a, b, c] (const int& i) { return i | *a | *b | *c; });
+}
+BENCHMARK(virtual_chain);
+
+/*
+ * The same filters, fused at compile-time (inlined end-to-end).
+ */
+static void static_chain(benchmark::State& state)
+{
+    auto chain = static_filter([] (int i) { return i + 3; })
+        | static_filter([] (int i) { return i * 5; })
+        | static_filter([] (int i) { return i ^ 0x55; });
+
+    run(state, chain);
+}
+BENCHMARK(static_chain);
+
+/*
+ * The fused filters, type-erased by the adapter (one indirect call for the whole chain).
+ */
+static void adapted_static_chain(benchmark::State& state)
+{
+    auto adapter = to_filter<int, int>(static_filter([] (int i) { return i + 3; })
+        | static_filter([] (int i) { return i * 5; })
+        | static_filter([] (int i) { return i ^ 0x55; }));
+    Filter<int, int>* filter = &adapter;
+
+    benchmark::DoNotOptimize(filter);
+    run(state, [filter] (const int& i) { return i | *filter; });
+}
+BENCHMARK(adapted_static_chain);
+
+BENCHMARK_MAIN();
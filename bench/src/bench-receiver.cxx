@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <ese/flow/channel.hxx>
+
+#ifdef ESE_FLOW_BENCH_WITH_BOOST
+#include <boost/any.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <typeinfo>
+#endif
+
+using namespace ese::flow;
+
+/*
+ * Non-blocking receive on an empty channel, through the Receiver interface.
+ */
+static void try_receive_empty(benchmark::State& state)
+{
+    Channel<int> channel;
+    Receiver<int>& receiver = channel.get_receiver();
+    int element;
+
+    for (auto _: state)
+        benchmark::DoNotOptimize(receiver.try_receive(&element));
+}
+BENCHMARK(try_receive_empty);
+
+/*
+ * Non-blocking receive on an empty channel, through the concrete (final) receiver type.
+ */
+static void try_receive_empty_static(benchmark::State& state)
+{
+    Channel<int> channel;
+    Channel<int>::ReceiverType& receiver = channel.get_receiver();
+    int element;
+
+    for (auto _: state)
+        benchmark::DoNotOptimize(receiver.try_receive(&element));
+}
+BENCHMARK(try_receive_empty_static);
+
+/*
+ * Sends an element and receives it back (with a deadline), on the same thread.
+ */
+static void send_and_receive(benchmark::State& state)
+{
+    Channel<int> channel;
+    Receiver<int>& receiver = channel.get_receiver();
+    Sender<int>& sender = channel.get_sender();
+    int element;
+
+    for (auto _: state)
+    {
+        sender.send(1);
+        benchmark::DoNotOptimize(receiver.try_receive_for(&element, std::chrono::milliseconds(1)));
+    }
+}
+BENCHMARK(send_and_receive);
+
+/*
+ * Receive on an empty channel with a deadline already passed (the timeout path, without sleeping).
+ */
+static void receive_expired_deadline(benchmark::State& state)
+{
+    Channel<int> channel;
+    Receiver<int>& receiver = channel.get_receiver();
+    const std::chrono::steady_clock::time_point past = std::chrono::steady_clock::now();
+    int element;
+
+    for (auto _: state)
+        benchmark::DoNotOptimize(receiver.try_receive_until(&element, past));
+}
+BENCHMARK(receive_expired_deadline);
+
+/*
+ * Receive on an empty channel, until a timeout of state.range(0) microseconds: the time of an iteration minus the
+ * timeout is the overshoot of the wait.
+ */
+static void receive_timeout(benchmark::State& state)
+{
+    Channel<int> channel;
+    Receiver<int>& receiver = channel.get_receiver();
+    const std::chrono::microseconds timeout(state.range(0));
+    int element;
+
+    for (auto _: state)
+        benchmark::DoNotOptimize(receiver.try_receive_for(&element, timeout));
+}
+BENCHMARK(receive_timeout)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->UseRealTime();
+
+#ifdef ESE_FLOW_BENCH_WITH_BOOST
+/*
+ * The receive path as it was before the Deadline type: the time point is boxed into a boost::any, passed to the
+ * virtual method and matched against the known clocks via typeid.
+ */
+class LegacyReceiver
+{
+public:
+    virtual ~LegacyReceiver()
+    {
+
+    }
+
+    bool try_receive(int* address, bool blocking = false)
+    {
+        using time_point = std::chrono::time_point<std::chrono::high_resolution_clock>;
+        return try_receive_until(address, blocking ? time_point::max() : time_point::min());
+    }
+
+    template<class Clock, class Duration>
+    bool try_receive_until(int* address, const std::chrono::time_point<Clock, Duration>& time)
+    {
+        return try_receive_until_0(address, std::chrono::time_point_cast<typename Clock::duration>(time));
+    }
+
+    template<class Rep, class Period>
+    bool try_receive_for(int* address, const std::chrono::duration<Rep, Period>& duration)
+    {
+        return try_receive_until(address, std::chrono::high_resolution_clock::now() + duration);
+    }
+
+    void send(int element)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        queue.push(element);
+        lock.unlock();
+        condition_variable.notify_one();
+    }
+
+protected:
+    virtual bool try_receive_until_0(int* address, const boost::any& time) = 0;
+
+    std::queue<int> queue;
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+};
+
+class LegacyChannelReceiver: public LegacyReceiver
+{
+protected:
+    bool try_receive_until_0(int* address, const boost::any& time) override
+    {
+        using time_point_high = std::chrono::time_point<std::chrono::high_resolution_clock>;
+        using time_point_steady = std::chrono::time_point<std::chrono::steady_clock>;
+        using time_point_system = std::chrono::time_point<std::chrono::system_clock>;
+
+        if (time.type() == typeid(time_point_high))
+            return try_receive_until_1(address, boost::any_cast<time_point_high>(time));
+        else if (time.type() == typeid(time_point_steady))
+            return try_receive_until_1(address, boost::any_cast<time_point_steady>(time));
+        else if (time.type() == typeid(time_point_system))
+            return try_receive_until_1(address, boost::any_cast<time_point_system>(time));
+        else
+            throw std::exception();
+    }
+
+private:
+    template<class Clock, class Duration>
+    bool try_receive_until_1(int* address, const std::chrono::time_point<Clock, Duration>& time)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (queue.empty())
+        {
+            if (time == std::chrono::time_point<Clock, Duration>::min())
+                return false;
+
+            condition_variable.wait_until(lock, time);
+
+            if (queue.empty())
+                return false;
+        }
+
+        *address = queue.front();
+        queue.pop();
+        return true;
+    }
+};
+
+/*
+ * Non-blocking receive on an empty channel, through the legacy boost::any path.
+ */
+static void legacy_try_receive_empty(benchmark::State& state)
+{
+    LegacyChannelReceiver channel;
+    LegacyReceiver& receiver = channel;
+    int element;
+
+    for (auto _: state)
+        benchmark::DoNotOptimize(receiver.try_receive(&element));
+}
+BENCHMARK(legacy_try_receive_empty);
+
+/*
+ * Sends an element and receives it back (with a deadline), through the legacy boost::any path.
+ */
+static void legacy_send_and_receive(benchmark::State& state)
+{
+    LegacyChannelReceiver channel;
+    LegacyReceiver& receiver = channel;
+    int element;
+
+    for (auto _: state)
+    {
+        receiver.send(1);
+        benchmark::DoNotOptimize(receiver.try_receive_for(&element, std::chrono::milliseconds(1)));
+    }
+}
+BENCHMARK(legacy_send_and_receive);
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/sharded-channel.hxx>
+
+using namespace ese::flow;
+
+/*
+ * Many producers (the benchmark threads) send into the same channel, while one consumer drains it in batches.
+ */
+template<typename TChannel>
+static void many_producers(benchmark::State& state, TChannel& channel)
+{
+    static std::atomic_bool running(false);
+    static std::unique_ptr<std::thread> consumer;
+
+    if (state.thread_index() == 0)
+    {
+        running = true;
+        consumer.reset(new std::thread([&channel] ()
+            {
+                long batch[64];
+
+                while (running.load(std::memory_order_relaxed))
+                    channel.get_receiver().receive_batch(batch, 64, std::chrono::steady_clock::now()
+                        + std::chrono::milliseconds(1));
+            }));
+    }
+
+    Sender<long>& sender = channel.get_sender();
+    long i = 0;
+
+    for (auto _: state)
+        sender.send(i++);
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        running = false;
+        consumer->join();
+        consumer.reset();
+
+        long element;
+
+        while (channel.get_receiver().try_receive(&element));
+    }
+}
+
+static void channel(benchmark::State& state)
+{
+    static Channel<long> channel;
+    many_producers(state, channel);
+}
+BENCHMARK(channel)->ThreadRange(1, 32)->UseRealTime();
+
+static void sharded_fifo(benchmark::State& state)
+{
+    static ShardedChannel<long> channel(0, ShardOrdering::PER_PRODUCER_FIFO);
+    many_producers(state, channel);
+}
+BENCHMARK(sharded_fifo)->ThreadRange(1, 32)->UseRealTime();
+
+static void sharded_relaxed(benchmark::State& state)
+{
+    static ShardedChannel<long> channel(0, ShardOrdering::RELAXED);
+    many_producers(state, channel);
+}
+BENCHMARK(sharded_relaxed)->ThreadRange(1, 32)->UseRealTime();
+
+BENCHMARK_MAIN();
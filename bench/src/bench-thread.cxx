@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <ese/flow/thread.hxx>
+#include <ese/flow/thread-pool.hxx>
+
+using namespace ese::flow;
+
+/*
+ * Every flow gets a new system thread.
+ */
+static void system_threads(benchmark::State& state)
+{
+    for (auto _: state)
+    {
+        Thread thread([] () {});
+        thread.join();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(system_threads);
+
+/*
+ * Every flow runs on a worker of a warmed-up pool.
+ */
+static void pooled_threads(benchmark::State& state)
+{
+    ThreadPoolOptions options;
+    options.min_size = 4;
+    ThreadPool pool(options);
+
+    for (auto _: state)
+    {
+        Thread thread([] () {}, pool);
+        thread.join();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(pooled_threads);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,47 @@
+#ifndef ESE_FLOW_ALIGNEDPTR_HXX
+#define ESE_FLOW_ALIGNEDPTR_HXX
+
+#include <memory>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Deleter of the objects created by make_aligned().
+         * \tparam T The type of the objects.
+         * */
+        template<typename T>
+        class AlignedDelete
+        {
+        public:
+            /**
+             * \brief Destroys an object and frees its storage.
+             * \param object The object (created by make_aligned()).
+             * */
+            void operator()(T* object) const noexcept;
+        };
+
+        /**
+         * \brief Owns an object created by make_aligned().
+         * */
+        template<typename T>
+        using AlignedPtr = std::unique_ptr<T, AlignedDelete<T>>;
+
+        /**
+         * \brief Creates an object on the heap, honoring its alignment even if it is bigger than the fundamental one.
+         * \tparam T The type of the object.
+         * \param args The arguments passed to the object's constructor.
+         * \return The object.
+         *
+         * Before C++17, new only aligns to alignof(std::max_align_t), so a type padded to a cache line (e.g. with
+         * alignas(ESE_FLOW_CACHE_LINE_SIZE)) may still share lines with its neighbours once allocated. \n
+         * */
+        template<typename T, typename... TArgs>
+        AlignedPtr<T> make_aligned(TArgs&&... args);
+    }
+}
+
+#include "template/aligned-ptr.txx"
+
+#endif
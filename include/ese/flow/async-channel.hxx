@@ -0,0 +1,429 @@
+
+#ifndef ESE_FLOW_ASYNCCHANNEL_HXX
+#define ESE_FLOW_ASYNCCHANNEL_HXX
+
+#if !defined(__cpp_impl_coroutine)
+#error "ese/flow/async-channel.hxx needs C++20 coroutines: link the ese-flow-async target"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/executor.hxx>
+#include <ese/flow/lambda-executable.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TAsyncChannel>
+        class AsyncChannelReceiver;
+
+        template<typename TAsyncChannel>
+        class AsyncChannelSender;
+
+        /**
+         * \brief The return type of a fire-and-forget coroutine (a "flow").
+         *
+         * The coroutine starts immediately, on the calling thread, and its frame is destroyed when it ends. An
+         * exception escaping the coroutine terminates the program. \n
+         * */
+        class AsyncTask
+        {
+        public:
+            /**
+             * \brief The promise of an AsyncTask coroutine.
+             * */
+            struct promise_type
+            {
+                AsyncTask get_return_object() noexcept
+                {
+                    return AsyncTask();
+                }
+
+                std::suspend_never initial_suspend() noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() noexcept
+                {
+                    return {};
+                }
+
+                void return_void() noexcept
+                {
+
+                }
+
+                void unhandled_exception() noexcept
+                {
+                    std::terminate();
+                }
+            };
+        };
+
+        /**
+         * \brief Awaited to move the coroutine onto an executor.
+         * \sa resume_on()
+         * */
+        class ResumeOnAwaitable
+        {
+        public:
+            /**
+             * \brief Construct the awaitable.
+             * \param executor The executor on which the coroutine is resumed.
+             * */
+            explicit ResumeOnAwaitable(Executor<LambdaExecutable>& executor) noexcept;
+
+            bool await_ready() const noexcept;
+
+            void await_suspend(std::coroutine_handle<> handle);
+
+            void await_resume() const noexcept;
+
+        private:
+            /**
+             * \brief The executor on which the coroutine is resumed.
+             * */
+            Executor<LambdaExecutable>& executor;
+        };
+
+        /**
+         * \brief Moves the awaiting coroutine onto an executor (e.g. to start a flow on a thread pool).
+         * \param executor The executor.
+         * \return The awaitable.
+         * */
+        ResumeOnAwaitable resume_on(Executor<LambdaExecutable>& executor) noexcept;
+
+        /**
+         * \brief Lets coroutines send into (and receive from) a channel without blocking any thread.
+         * \param TChannel The type of the channel (any channel with get_receiver(), get_sender() and
+         *     set_listener() methods).
+         *
+         * A coroutine that awaits async_receive() on an empty channel (or async_send() on a full one) is suspended
+         * and queued: no thread waits for it. When the channel notifies its listener (this object) the first queued
+         * coroutine is retried on the executor, and resumed there if it succeeds (then the next one is retried, and
+         * so on). In this way tens of thousands of flows can wait on a handful of threads. \n
+         * The AsyncChannel becomes the listener of the channel. async_send() needs receive notifications, which
+         * are sent by Channel and LockFreeChannel only (the other channels are unbounded, so it never suspends on
+         * them). Threads can keep using the channel's synchronous receiver and sender at the same time. \n
+         * The AsyncChannel must outlive the coroutines suspended on it. \n
+         * */
+        template<typename TChannel>
+        class AsyncChannel: private ChannelListener
+        {
+        public:
+            /**
+             * \brief The type of the wrapped channel.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             * \brief The type of elements to share.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief The type of the asynchronous receiver.
+             * */
+            typedef AsyncChannelReceiver<AsyncChannel<TChannel>> ReceiverType;
+
+            /**
+             * \brief The type of the asynchronous sender.
+             * */
+            typedef AsyncChannelSender<AsyncChannel<TChannel>> SenderType;
+
+            /**
+             * \brief Construct an AsyncChannel object, that becomes the listener of the channel.
+             * \param channel The channel.
+             * \param executor The executor on which suspended coroutines are resumed.
+             * \throw std::logic_error If the channel already has another listener (e.g. a Poller).
+             * */
+            AsyncChannel(TChannel& channel, Executor<LambdaExecutable>& executor);
+
+            AsyncChannel(const AsyncChannel&) = delete;
+
+            AsyncChannel& operator=(const AsyncChannel&) = delete;
+
+            /**
+             * \brief Removes the listener from the channel.
+             * */
+            ~AsyncChannel();
+
+            /**
+             * \brief Get the asynchronous receiver.
+             * \return The receiver.
+             * */
+            ReceiverType& get_receiver() noexcept;
+
+            /**
+             * \brief Get the asynchronous sender.
+             * \return The sender.
+             * */
+            SenderType& get_sender() noexcept;
+
+        private:
+            /**
+             * \brief A suspended coroutine, waiting to retry its operation.
+             * */
+            class Waiter
+            {
+            public:
+                /**
+                 * \brief The suspended coroutine.
+                 * */
+                std::coroutine_handle<> handle;
+
+                /**
+                 * \brief The next waiter in the queue.
+                 * */
+                Waiter* next = nullptr;
+
+                /**
+                 * \brief The epoch of the queue, read before the last attempt.
+                 * */
+                std::uint64_t epoch = 0;
+
+                /**
+                 * \brief Tries the operation, without waiting.
+                 * \return True if it succeeded, false otherwise.
+                 * */
+                virtual bool attempt() = 0;
+
+            protected:
+                ~Waiter() = default;
+            };
+
+            /**
+             * \brief The coroutines waiting for the same kind of notification (protected by the mutex).
+             * */
+            typedef struct _WaitQueue_
+            {
+                /**
+                 * \brief The first waiter.
+                 * */
+                Waiter* head = nullptr;
+
+                /**
+                 * \brief The last waiter.
+                 * */
+                Waiter* tail = nullptr;
+
+                /**
+                 * \brief Incremented on every notification: a waiter that missed one retries instead of queueing.
+                 * */
+                std::atomic<std::uint64_t> epoch{0};
+            } WaitQueue;
+
+            /**
+             * \brief The wrapped channel.
+             * */
+            TChannel& channel;
+
+            /**
+             * \brief The executor on which suspended coroutines are resumed.
+             * */
+            Executor<LambdaExecutable>& executor;
+
+            /**
+             * \brief Protects the queues.
+             * */
+            std::mutex mutex;
+
+            /**
+             * \brief The coroutines waiting for an element.
+             * */
+            WaitQueue receive_waiters;
+
+            /**
+             * \brief The coroutines waiting for space.
+             * */
+            WaitQueue send_waiters;
+
+            /**
+             * \brief The asynchronous receiver.
+             * */
+            ReceiverType receiver;
+
+            /**
+             * \brief The asynchronous sender.
+             * */
+            SenderType sender;
+
+            void on_send() noexcept override;
+
+            void on_receive() noexcept override;
+
+            /**
+             * \brief Retries the first waiter of a queue (if any) on the executor.
+             * \param queue The queue.
+             * */
+            void wake(WaitQueue& queue) noexcept;
+
+            /**
+             * \brief Tries the operation of a waiter until it succeeds, or the waiter is queued.
+             * \param waiter The waiter.
+             * \param queue The queue of the waiter.
+             * \return True if the waiter was queued (the coroutine stays suspended), false if it succeeded.
+             * */
+            bool suspend(Waiter& waiter, WaitQueue& queue);
+
+            /**
+             * \brief Retries a woken waiter, resuming it if it succeeds (on the calling thread).
+             * \param waiter The waiter.
+             * \param queue The queue of the waiter.
+             * */
+            void retry(Waiter& waiter, WaitQueue& queue);
+
+            friend ReceiverType;
+            friend SenderType;
+        };
+
+        /**
+         * \brief Receives elements from an AsyncChannel, suspending the coroutine while the channel is empty.
+         * \param TAsyncChannel The type of AsyncChannel from which it receives elements.
+         * */
+        template<typename TAsyncChannel>
+        class AsyncChannelReceiver final
+        {
+        public:
+            /**
+             * \brief The type of receiving elements.
+             * */
+            typedef typename TAsyncChannel::ElementType ElementType;
+
+            /**
+             * \brief The awaitable returned by async_receive(): it yields the received element.
+             * */
+            class Awaitable final: private TAsyncChannel::Waiter
+            {
+            public:
+                bool await_ready();
+
+                bool await_suspend(std::coroutine_handle<> handle);
+
+                ElementType await_resume();
+
+            private:
+                /**
+                 * \brief The channel from which it receives the element.
+                 * */
+                TAsyncChannel& channel;
+
+                /**
+                 * \brief The received element.
+                 * */
+                ElementType element;
+
+                /**
+                 * \brief Construct the awaitable.
+                 * \param channel The channel from which it receives the element.
+                 * */
+                explicit Awaitable(TAsyncChannel& channel);
+
+                bool attempt() override;
+
+                friend AsyncChannelReceiver;
+                friend TAsyncChannel;
+            };
+
+            /**
+             * \brief Receives an element (use it as co_await receiver.async_receive()).
+             * \return The awaitable, that yields the element.
+             * */
+            Awaitable async_receive();
+
+        private:
+            /**
+             * \brief The channel from which it receives elements.
+             * */
+            TAsyncChannel& channel;
+
+            /**
+             * \brief Construct the receiver.
+             * \param channel The channel from which it receives elements.
+             * */
+            explicit AsyncChannelReceiver(TAsyncChannel& channel) noexcept;
+
+            friend TAsyncChannel;
+        };
+
+        /**
+         * \brief Sends elements into an AsyncChannel, suspending the coroutine while the channel is full.
+         * \param TAsyncChannel The type of AsyncChannel in which it sends elements.
+         * */
+        template<typename TAsyncChannel>
+        class AsyncChannelSender final
+        {
+        public:
+            /**
+             * \brief The type of sending elements.
+             * */
+            typedef typename TAsyncChannel::ElementType ElementType;
+
+            /**
+             * \brief The awaitable returned by async_send().
+             * */
+            class Awaitable final: private TAsyncChannel::Waiter
+            {
+            public:
+                bool await_ready();
+
+                bool await_suspend(std::coroutine_handle<> handle);
+
+                void await_resume() const noexcept;
+
+            private:
+                /**
+                 * \brief The channel in which it sends the element.
+                 * */
+                TAsyncChannel& channel;
+
+                /**
+                 * \brief The element to send.
+                 * */
+                ElementType element;
+
+                /**
+                 * \brief Construct the awaitable.
+                 * \param channel The channel in which it sends the element.
+                 * \param element The element to send.
+                 * */
+                Awaitable(TAsyncChannel& channel, ElementType&& element);
+
+                bool attempt() override;
+
+                friend AsyncChannelSender;
+                friend TAsyncChannel;
+            };
+
+            /**
+             * \brief Sends an element (use it as co_await sender.async_send(element)).
+             * \param element The element to send.
+             * \return The awaitable, that completes once the element was sent.
+             * */
+            Awaitable async_send(ElementType element);
+
+        private:
+            /**
+             * \brief The channel in which it sends elements.
+             * */
+            TAsyncChannel& channel;
+
+            /**
+             * \brief Construct the sender.
+             * \param channel The channel in which it sends elements.
+             * */
+            explicit AsyncChannelSender(TAsyncChannel& channel) noexcept;
+
+            friend TAsyncChannel;
+        };
+    }
+}
+
+#include "ese/flow/template/async-channel.txx"
+
+#endif
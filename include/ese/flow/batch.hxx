@@ -0,0 +1,14 @@
+
+#ifndef ESE_FLOW_BATCH_HXX
+#define ESE_FLOW_BATCH_HXX
+
+/**
+ * \brief The maximal number of elements that batch operations move at a time through their stack buffer.
+ *
+ * It can be overridden by defining it before including any ese-flow header.
+ * */
+#ifndef ESE_FLOW_BATCH_CHUNK_SIZE
+#define ESE_FLOW_BATCH_CHUNK_SIZE (64)
+#endif
+
+#endif
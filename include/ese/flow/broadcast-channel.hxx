@@ -0,0 +1,465 @@
+
+#ifndef ESE_FLOW_BROADCASTCHANNEL_HXX
+#define ESE_FLOW_BROADCASTCHANNEL_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <ese/flow/aligned-ptr.hxx>
+#include <ese/flow/cache-line.hxx>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/receiver.hxx>
+#include <ese/flow/sender.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        class BroadcastReceiver;
+
+        template<typename TChannel>
+        class BroadcastSender;
+
+        /**
+         * \brief Tells to a BroadcastChannel what to do when a subscriber did not read the element that the next
+         *     send would overwrite.
+         *
+         * BLOCK makes the sender wait for the slowest subscriber (try_send() waits only until its deadline). \n
+         * SKIP overwrites the element: the slow subscriber silently jumps to the oldest element still in the ring
+         * (the skipped elements are counted). \n
+         * LAG_DETECT overwrites the element like SKIP, but the slow subscriber is marked as lagged: its reads fail
+         * until it calls resync() (e.g. after requesting a snapshot). \n
+         * The senders never wait with a policy other than BLOCK.
+         * */
+        enum class SlowSubscriberPolicy
+        {
+            BLOCK,
+            SKIP,
+            LAG_DETECT
+        };
+
+        /**
+         * \brief Delivers every sent element to all its subscribers.
+         * \param TElement The type of elements to share. Have to be default constructible and assignable.
+         * \param TWaitPolicy Tells to the subscribers how to wait for elements (BlockingWaitPolicy,
+         *     SpinThenParkWaitPolicy or BusyPollWaitPolicy).
+         *
+         * The elements are written once in a fixed-capacity ring buffer (Disruptor-style) and every subscriber
+         * (a BroadcastReceiver, created by subscribe()) reads them through its own cursor: the visiting methods
+         * (try_read() and friends) give a constant reference to the element in the ring, so there are no copies
+         * (the Receiver interface copies every element, instead). A subscriber receives the elements sent after
+         * its subscription. \n
+         * When the ring is full, the SlowSubscriberPolicy decides between waiting for the slowest subscriber and
+         * overwriting the elements it did not read. \n
+         * Senders are serialized by a mutex (a send costs O(1), except when the ring is full: then the cursors of
+         * the subscribers are checked). Subscribers never lock: every subscriber have to be used by one thread at a
+         * time. \n
+         * */
+        template<typename TElement, typename TWaitPolicy = BlockingWaitPolicy>
+        class BroadcastChannel
+        {
+        public:
+            /**
+             *  brief The type of elements to share.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             *  brief The policy used by subscribers to wait for elements.
+             * */
+            typedef TWaitPolicy WaitPolicyType;
+
+            /**
+             * \brief The type of the Receiver of every subscriber.
+             * */
+            typedef BroadcastReceiver<BroadcastChannel<TElement, TWaitPolicy>> ReceiverType;
+
+            /**
+             * \brief The type of the Sender that interacts with this BroadcastChannel.
+             * */
+            typedef BroadcastSender<BroadcastChannel<TElement, TWaitPolicy>> SenderType;
+
+            /**
+             * \brief Construct a BroadcastChannel object, with no subscribers.
+             * \param capacity The (minimal) number of elements in the ring.
+             * \param policy What to do when a subscriber did not read the element that a send would overwrite.
+             * \sa subscribe()
+             * \sa get_sender()
+             * */
+            explicit BroadcastChannel(std::size_t capacity = 1024,
+                SlowSubscriberPolicy policy = SlowSubscriberPolicy::BLOCK);
+
+            BroadcastChannel(const BroadcastChannel&) = delete;
+
+            BroadcastChannel& operator=(const BroadcastChannel&) = delete;
+
+            /**
+             * \brief Creates a new subscriber, that receives the elements sent from now on.
+             * \return The subscriber's receiver (owned by the channel).
+             * */
+            ReceiverType& subscribe();
+
+            /**
+             * \brief Removes a subscriber (its receiver is destroyed).
+             * \param receiver The subscriber's receiver. It must not be in use.
+             * */
+            void unsubscribe(ReceiverType& receiver);
+
+            /**
+             * \brief Get the channel's sender.
+             * \return The sender.
+             * */
+            SenderType& get_sender() noexcept;
+
+            /**
+             * \brief Wakes up all the subscribers that are waiting for an element.
+             * */
+            void wake_up() noexcept;
+
+            /**
+             * \brief Sets the listener notified after every send.
+             * \param listener The listener (nullptr removes the current one).
+             * \return True if the listener was set, false if the channel already has another listener (that has to be
+             *     removed first).
+             *
+             * The listener can be changed only while nobody is sending into the channel.
+             * */
+            bool set_listener(ChannelListener* listener) noexcept;
+
+            /**
+             * \brief Get the capacity of the ring.
+             * \return The capacity.
+             * */
+            std::size_t get_capacity() const noexcept;
+
+            /**
+             * \brief Get the policy applied to slow subscribers.
+             * \return The policy.
+             * */
+            SlowSubscriberPolicy get_policy() const noexcept;
+
+            /**
+             * \brief Get the number of subscribers.
+             * \return The number of subscribers.
+             * */
+            std::size_t get_subscribers_count() const;
+
+        private:
+            /**
+             * \brief A slot of the ring.
+             * */
+            typedef struct _Slot_
+            {
+                /**
+                 * \brief The sequence of the stored element, plus one (0 for a slot never written).
+                 * */
+                std::atomic<std::uint64_t> sequence;
+
+                /**
+                 * \brief The stored element.
+                 * */
+                TElement element;
+            } Slot;
+
+            /**
+             * \brief capacity - 1, used to map sequences to slots.
+             * */
+            const std::uint64_t mask;
+
+            /**
+             * \brief The slots.
+             * */
+            std::unique_ptr<Slot[]> slots;
+
+            /**
+             * \brief What to do when a subscriber did not read the element that a send would overwrite.
+             * */
+            const SlowSubscriberPolicy policy;
+
+            /**
+             * \brief Serializes the senders (and protects the subscribers' list).
+             * */
+            mutable std::mutex mutex;
+
+            /**
+             * \brief The sequence of the next sent element (protected by the mutex).
+             * */
+            std::uint64_t next;
+
+            /**
+             * \brief The minimal cursor of the subscribers, as last computed (protected by the mutex).
+             * */
+            std::uint64_t cached_gating;
+
+            /**
+             * \brief The subscribers (protected by the mutex).
+             * */
+            std::vector<AlignedPtr<ReceiverType>> subscribers;
+
+            /**
+             * \brief Used to signal when an element was published.
+             * */
+            EventCount published_event;
+
+            /**
+             * \brief Used to signal when a subscriber moved its cursor (senders wait on it, with BLOCK).
+             * */
+            EventCount consumed_event;
+
+            /**
+             * \brief Incremented on every wake_up() call, so that spinning subscribers can notice it.
+             * */
+            std::atomic_uint wake_ups;
+
+            /**
+             * \brief The listener notified after every send (if any).
+             * */
+            std::atomic<ChannelListener*> listener;
+
+            /**
+             * \brief The channel's Sender object.
+             * */
+            SenderType sender;
+
+            /**
+             * \brief Computes the minimal cursor of the subscribers.
+             * \return The minimal cursor (the next sequence, if there are no subscribers).
+             * */
+            std::uint64_t compute_gating() const noexcept;
+
+            /**
+             * \brief Makes room for the next element, applying the policy to slow subscribers.
+             * \param lock The lock on the channel's mutex.
+             * \param time The deadline until which a sender can wait (with BLOCK).
+             * \return True if there is room, false if the deadline was reached.
+             * */
+            bool claim(std::unique_lock<std::mutex>& lock, const Deadline& time);
+
+            /**
+             * \brief Writes the next element and publishes it (the room have to be already claimed).
+             * \param element The element (forwarded into the ring).
+             * */
+            template<typename TForward>
+            void publish(TForward&& element);
+
+            /**
+             * \brief Wakes up the subscribers and the listener, after elements were published.
+             * */
+            void notify_send() noexcept;
+
+            friend ReceiverType;
+            friend SenderType;
+        };
+
+        /**
+         * \brief A subscriber of a BroadcastChannel.
+         * \param TChannel The type of BroadcastChannel from which it receives elements.
+         *
+         * The visiting methods read the elements in place (no copies), the Receiver methods copy them.
+         */
+        template<typename TChannel>
+        class BroadcastReceiver final: public Receiver<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             *  brief The type of BroadcastChannel from which it receives elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             *  brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Visits the next element, optionally waiting for it.
+             * \param visitor Called with a constant reference to the element in the ring (it must not throw, nor
+             *     keep the reference).
+             * \param blocking Tells if the method should wait until there is an element.
+             * \return True if an element was visited, false otherwise.
+             * */
+            template<class TVisitor>
+            bool try_read(TVisitor&& visitor, bool blocking = false);
+
+            /**
+             * \brief Visits the next element, waiting for it until a time point.
+             * \param visitor Called with a constant reference to the element in the ring.
+             * \param time The time point to wait until.
+             * \return True if an element was visited, false otherwise.
+             * */
+            template<class TVisitor, class Clock, class Duration>
+            bool try_read_until(TVisitor&& visitor, const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Visits the next element, waiting for it for an amount of time.
+             * \param visitor Called with a constant reference to the element in the ring.
+             * \param duration The amount of time to wait.
+             * \return True if an element was visited, false otherwise.
+             * */
+            template<class TVisitor, class Rep, class Period>
+            bool try_read_for(TVisitor&& visitor, const std::chrono::duration<Rep, Period>& duration);
+
+            /**
+             * \brief Tries to receive (a copy of) the next element until a deadline.
+             * \param address The pointer to the address where the element have to be copied.
+             * \param time The deadline.
+             * \return True if the element was received, false otherwise.
+             * */
+            bool try_receive_until_0(ElementType* address, const Deadline& time) override;
+
+            /**
+             * \brief Tells if there is an element to read.
+             * \return True if there is no element to read (or the subscriber lagged), false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Tells if the subscriber lagged (only with SlowSubscriberPolicy::LAG_DETECT).
+             * \return True if some element was overwritten before being read (and resync() was not called yet).
+             * */
+            bool is_lagged() const noexcept;
+
+            /**
+             * \brief Clears the lagged state: the reads continue from the oldest element still in the ring.
+             * */
+            void resync() noexcept;
+
+            /**
+             * \brief Get the number of elements overwritten before this subscriber could read them.
+             * \return The number of skipped elements.
+             * */
+            std::uint64_t get_skipped_count() const noexcept;
+
+        private:
+            /**
+             * \brief Set in the cursor while the subscriber reads the slot, so that no sender overwrites it.
+             * */
+            static constexpr std::uint64_t BUSY = std::uint64_t(1) << 63;
+
+            /**
+             * \brief The channel from which it receives elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief The sequence of the next element to read (with the BUSY bit, while reading).
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::uint64_t> cursor;
+
+            /**
+             * \brief Set by the senders when they overwrite an element not read yet (with LAG_DETECT).
+             * */
+            std::atomic_bool lagged;
+
+            /**
+             * \brief The number of elements overwritten before being read.
+             * */
+            std::atomic<std::uint64_t> skipped_count;
+
+            /**
+             * \brief Construct the subscriber.
+             * \param channel The channel from which it receives elements.
+             * \param cursor The sequence of the first element to read.
+             * */
+            BroadcastReceiver(ChannelType& channel, std::uint64_t cursor) noexcept;
+
+            /**
+             * \brief Visits the next element, without waiting.
+             * \param visitor Called with a constant reference to the element.
+             * \return True if an element was visited, false otherwise.
+             * */
+            template<class TVisitor>
+            bool try_visit(TVisitor& visitor);
+
+            /**
+             * \brief Visits the next element, waiting for it until a deadline.
+             * \param visitor Called with a constant reference to the element.
+             * \param time The deadline.
+             * \return True if an element was visited, false otherwise.
+             * */
+            template<class TVisitor>
+            bool read_until(TVisitor& visitor, const Deadline& time);
+
+            friend ChannelType;
+
+            template<typename T, typename... TArgs>
+            friend AlignedPtr<T> make_aligned(TArgs&&... args);
+        };
+
+        /**
+         * \brief Send elements into a BroadcastChannel object.
+         * \param TChannel The type of BroadcastChannel in which sends elements.
+         * */
+        template<typename TChannel>
+        class BroadcastSender final: public Sender<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             * \brief The type of BroadcastChannel in which sends elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             * \brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Send the element to all the subscribers.
+             * \param element The element to send.
+             *
+             * If the ring is full, the SlowSubscriberPolicy is applied (BLOCK waits for the slowest subscriber).
+             * */
+            void send(ElementType&& element) override;
+
+            /**
+             * \brief Send the element to all the subscribers.
+             * \param element The element to send.
+             *
+             * If the ring is full, the SlowSubscriberPolicy is applied (BLOCK waits for the slowest subscriber).
+             * */
+            void send(const ElementType& element) override;
+
+            /**
+             * \brief Send many elements to all the subscribers.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * All the elements are published under a single lock acquisition and the subscribers are notified once.
+             * */
+            void send_batch_0(ElementType* elements, std::size_t count) override;
+
+            /**
+             * \brief Tries to send the element, waiting for the slowest subscriber until a deadline.
+             * \param element The address of the element to send (moved from there only if it was sent).
+             * \param time The deadline (used only with SlowSubscriberPolicy::BLOCK).
+             * \return True if the element was sent, false otherwise.
+             * */
+            bool try_send_until_0(ElementType* element, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel in which it sends elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the sender, that sends elements in a specified channel.
+             * \param channel The channel from in which sends elements.
+             * */
+            BroadcastSender(ChannelType& channel) noexcept;
+
+            friend ChannelType;
+        };
+    }
+}
+
+#include "ese/flow/template/broadcast-channel.txx"
+
+#endif
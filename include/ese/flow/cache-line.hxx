@@ -0,0 +1,13 @@
+
+#ifndef ESE_FLOW_CACHELINE_HXX
+#define ESE_FLOW_CACHELINE_HXX
+
+/**
+ * \brief The assumed size (in bytes) of a CPU cache line.
+ *
+ * Used to align (and pad) data that is frequently written by different threads, so that it does not end up in the
+ * same cache line (avoiding false sharing).
+ * */
+#define ESE_FLOW_CACHE_LINE_SIZE (64)
+
+#endif
@@ -0,0 +1,53 @@
+
+#ifndef ESE_FLOW_CHANNELLISTENER_HXX
+#define ESE_FLOW_CHANNELLISTENER_HXX
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Interface notified by a channel every time some element is sent into it (and, optionally, received
+         *     from it).
+         * \sa Poller
+         * \sa AsyncChannel
+         *
+         * A channel has at most one listener, set via its set_listener() method (that refuses to replace a different
+         * listener, so a Poller and an AsyncChannel cannot share a channel). The notification happens after
+         * the elements entered the channel, on the sender's thread: implementations have to be fast and must not
+         * send into the notifying channel. \n
+         * Channel and LockFreeChannel also notify when elements left the channel, on the receiver's thread (other
+         * channels never call on_receive()). \n
+         * */
+        class ChannelListener
+        {
+        public:
+            /**
+             * \brief Empty implementation.
+             * */
+            virtual ~ChannelListener() noexcept;
+
+            /**
+             * \brief Called after some element was sent into the channel.
+             * */
+            virtual void on_send() noexcept = 0;
+
+            /**
+             * \brief Called after some element was received from the channel (the default does nothing).
+             * */
+            virtual void on_receive() noexcept;
+        };
+
+        inline ChannelListener::~ChannelListener() noexcept
+        {
+
+        }
+
+        inline void ChannelListener::on_receive() noexcept
+        {
+
+        }
+    }
+}
+
+#endif
@@ -2,12 +2,33 @@
 #ifndef ESE_FLOW_CHANNEL_HXX
 #define ESE_FLOW_CHANNEL_HXX
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <type_traits>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/lock-role.hxx>
+#include <ese/flow/overflow-policy.hxx>
 #include <ese/flow/receiver.hxx>
+#include <ese/flow/ring-queue.hxx>
 #include <ese/flow/sender.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+#ifdef ESE_FLOW_METRICS
+#include <ese/flow/metrics.hxx>
+#endif
+
+#ifdef ESE_FLOW_TRACING
+#include <ese/flow/trace.hxx>
+#endif
+
+#ifdef ESE_FLOW_LOCK_PROFILING
+#include <ese/flow/profiled-mutex.hxx>
+#endif
 
 namespace ese
 {
@@ -19,19 +40,44 @@ namespace ese
         template<typename TChannel>
         class ChannelSender;
 
+        template<typename TQueue>
+        auto queue_has_front(TQueue* queue) -> decltype(queue->front(), std::true_type());
+
+        std::false_type queue_has_front(...);
+
+        /**
+         * \brief Tells if a queue pops its elements in the order in which they were pushed.
+         * \tparam TQueue The type of the queue.
+         *
+         * By default the queues with a front() method (e.g. std::queue and RingQueue) are FIFO, those with a top()
+         * method (e.g. std::priority_queue) are not. A queue that has front() but reorders its elements (e.g.
+         * DeadlineQueue) specializes it. \n
+         * */
+        template<typename TQueue>
+        struct IsFifoQueue: decltype(queue_has_front(static_cast<TQueue*>(nullptr)))
+        {
+
+        };
+
         /**
          * \brief Used to safely share elements among threads.
          * \param TElement The type of elements to share.
          * \param TQueue The queue type used to store sent elements that waits to be received. The specified type have
          *     to implement at least pop(), front() (or top()), and push() methods (std::queue and std::priority_queue
          *     are both suitable as this template parameter).
+         * \param TWaitPolicy Tells to the receivers how to wait for elements (BlockingWaitPolicy,
+         *     SpinThenParkWaitPolicy or BusyPollWaitPolicy).
          *
          * To send elements in channel use the channel's Sender object and to receive data from the channel use the
          * channel's Receiver object. \n
          * The elements that are sent, but not received yet are stored in a queue of template type TQueue. \n
+         * The channel is unbounded by default. A bounded channel applies its OverflowPolicy when an element is sent
+         * while the channel is full, and counts the dropped elements and the blocked sends. \n
          * All operation (even those of receiver and sender) are thread-safe. \n
+         * Senders notify the receivers only when some of them is actually sleeping. \n
+         * A ChannelListener (e.g. a Poller) can be notified of every send, to wait on many channels at once. \n
          * */
-        template <typename TElement, typename TQueue = std::queue<TElement>>
+        template <typename TElement, typename TQueue = std::queue<TElement>, typename TWaitPolicy = BlockingWaitPolicy>
         class Channel
         {
         public:
@@ -45,23 +91,43 @@ namespace ese
              * */
             typedef TQueue QueueType;
 
+            /**
+             *  brief The policy used by receivers to wait for elements.
+             * */
+            typedef TWaitPolicy WaitPolicyType;
+
             /**
              * \brief The type of the Receiver that interacts with this Channel.
              * */
-            typedef ChannelReceiver<Channel<TElement, TQueue>> ReceiverType;
+            typedef ChannelReceiver<Channel<TElement, TQueue, TWaitPolicy>> ReceiverType;
 
             /**
              * \brief The type of the Sender that interacts with this Channel.
              * */
-            typedef ChannelSender<Channel<TElement, TQueue>> SenderType;
+            typedef ChannelSender<Channel<TElement, TQueue, TWaitPolicy>> SenderType;
 
             /**
-             * \brief Construct a Channel object.
+             * \brief Construct an unbounded Channel object.
              * \sa get_receiver()
              * \sa get_sender()
              * */
             Channel();
 
+            /**
+             * \brief Construct a bounded Channel object.
+             * \param capacity The maximal number of elements that can wait in the channel to be received (0 means
+             *     unbounded).
+             * \param overflow_policy What to do with elements sent while the channel is full.
+             * \param sample_period With OverflowPolicy::SAMPLE, one of every sample_period overflowing elements is
+             *     kept.
+             * \throw std::invalid_argument If the policy is DROP_OLDEST or SAMPLE, and the queue is not FIFO (see
+             *     IsFifoQueue).
+             * \sa get_receiver()
+             * \sa get_sender()
+             * */
+            explicit Channel(std::size_t capacity, OverflowPolicy overflow_policy = OverflowPolicy::BLOCK,
+                std::size_t sample_period = 16);
+
             /**
              * \brief Get the channel's receiver.
              * \return The receiver.
@@ -80,7 +146,93 @@ namespace ese
              * */
             void wake_up() noexcept;
 
+            /**
+             * \brief Get the channel's capacity.
+             * \return The capacity (0 means unbounded).
+             * */
+            std::size_t get_capacity() const noexcept;
+
+            /**
+             * \brief Get the channel's overflow policy.
+             * \return The overflow policy.
+             * */
+            OverflowPolicy get_overflow_policy() const noexcept;
+
+            /**
+             * \brief Get the number of elements discarded by the overflow policy.
+             * \return The number of dropped elements (sent ones and those evicted from the queue).
+             * */
+            std::uint64_t get_dropped_count() const noexcept;
+
+            /**
+             * \brief Get the number of sends that found the channel full, with OverflowPolicy::BLOCK.
+             * \return The number of blocked sends (those that waited and those that gave up).
+             * */
+            std::uint64_t get_blocked_count() const noexcept;
+
+            /**
+             * \brief Tells if the channel is (was, at the moment of the call) empty.
+             * \return True if there is no element to receive, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Sets the listener notified after every send (and receive).
+             * \param listener The listener (nullptr removes the current one).
+             * \return True if the listener was set, false if the channel already has another listener (that has to be
+             *     removed first).
+             *
+             * The listener can be changed only while nobody is sending into (or receiving from) the channel.
+             * */
+            bool set_listener(ChannelListener* listener) noexcept;
+
+#ifdef ESE_FLOW_METRICS
+            /**
+             * \brief Reads the metrics of the channel (available only when ESE_FLOW_METRICS is defined).
+             * \return The metrics.
+             * \sa MetricsRegistry
+             * */
+            ChannelMetrics get_metrics() const noexcept;
+#endif
+
+#ifdef ESE_FLOW_LOCK_PROFILING
+            /**
+             * \brief Reads the profile of the channel's mutex (available only when ESE_FLOW_LOCK_PROFILING is
+             *     defined).
+             * \return The profile.
+             * \sa LockProfiler
+             * */
+            LockProfile get_lock_profile() const noexcept;
+#endif
+
         private:
+#ifdef ESE_FLOW_LOCK_PROFILING
+            /**
+             * \brief The type of the channel's mutex.
+             * */
+            typedef ProfiledMutex MutexType;
+
+            /**
+             * \brief The type of the channel's condition variables (they have to release a ProfiledMutex).
+             * */
+            typedef std::condition_variable_any ConditionVariableType;
+#else
+            /**
+             * \brief The type of the channel's mutex.
+             * */
+            typedef std::mutex MutexType;
+
+            /**
+             * \brief The type of the channel's condition variables.
+             * */
+            typedef std::condition_variable ConditionVariableType;
+#endif
+
+            /**
+             * \brief The type of a lock on the channel's mutex.
+             * */
+            typedef std::unique_lock<MutexType> LockType;
+
             /**
              * \brief The channel's queue.
              * */
@@ -89,12 +241,92 @@ namespace ese
             /**
              * \bried Mutex used to synchronize access to channel's queue.
              * */
-            std::mutex mutex;
+            MutexType mutex;
 
             /**
              * \brief Condition variable used to signal when the channel's queue is no more empty.
              * */
-            std::condition_variable condition_variable;
+            ConditionVariableType condition_variable;
+
+            /**
+             * \brief Condition variable used to signal when the channel's queue is no more full.
+             * */
+            ConditionVariableType not_full_condition_variable;
+
+            /**
+             * \brief The maximal number of elements in the channel's queue (0 means unbounded).
+             * */
+            const std::size_t capacity;
+
+            /**
+             * \brief What to do with elements sent while the channel is full.
+             * */
+            const OverflowPolicy overflow_policy;
+
+            /**
+             * \brief With OverflowPolicy::SAMPLE, one of every sample_period overflowing elements is kept.
+             * */
+            const std::size_t sample_period;
+
+            /**
+             * \brief The number of overflowing elements, used by OverflowPolicy::SAMPLE (protected by the mutex).
+             * */
+            std::size_t overflows;
+
+            /**
+             * \brief The number of elements in the channel's queue, readable without locking the mutex (used by
+             *     spinning receivers).
+             * */
+            std::atomic_size_t size;
+
+            /**
+             * \brief The number of receivers sleeping on the condition variable (protected by the mutex).
+             * */
+            int sleeping_receivers;
+
+            /**
+             * \brief The number of senders sleeping on the "not full" condition variable (protected by the mutex).
+             * */
+            int sleeping_senders;
+
+            /**
+             * \brief The number of elements discarded by the overflow policy.
+             * */
+            std::atomic<std::uint64_t> dropped_count;
+
+            /**
+             * \brief The number of sends that found the channel full, with OverflowPolicy::BLOCK.
+             * */
+            std::atomic<std::uint64_t> blocked_count;
+
+            /**
+             * \brief Incremented on every wake_up() call, so that spinning receivers can notice it.
+             * */
+            std::atomic_uint wake_ups;
+
+            /**
+             * \brief The listener notified after every send and receive (if any).
+             * */
+            std::atomic<ChannelListener*> listener;
+
+#ifdef ESE_FLOW_METRICS
+            /**
+             * \brief The counters behind get_metrics().
+             * */
+            ChannelCounters counters;
+#endif
+
+#ifdef ESE_FLOW_TRACING
+            /**
+             * \brief The number of elements pushed to the queue (the sequence of the ENQUEUE trace events).
+             * */
+            std::uint64_t pushed_sequence = 0;
+
+            /**
+             * \brief The number of elements popped from the queue (the sequence of the DEQUEUE trace events).
+             * */
+            std::uint64_t popped_sequence = 0;
+#endif
 
             /**
              * \brief The channel's Receiver object.
@@ -107,21 +339,76 @@ namespace ese
             SenderType sender;
 
             /**
-             * \brief Pops the front object from the channel's queue.
-             * \return The popped object.
+             * \brief Locks the channel's mutex (timing the wait, when it is contended and metrics are enabled).
+             * \param role What the calling thread is doing (recorded only when the locks are profiled).
+             * \return The lock.
              * */
-            TElement pop_from_queue() noexcept;
+            LockType lock_queue(LockRole role);
+
+            /**
+             * \brief Pops the front objects from the channel's queue (and notifies the sleeping senders, if any).
+             * \param address The address where the popped objects are moved.
+             * \param max The maximal number of objects to pop.
+             * \return The number of popped objects.
+             * */
+            std::size_t pop_from_queue(TElement* address, std::size_t max) noexcept;
+
+            /**
+             * \brief Pushes an object in the channel's queue.
+             * \param element The object to push.
+             * */
+            template<typename TForward>
+            void push_to_queue(TForward&& element);
+
+            /**
+             * \brief Pushes an object in the channel's queue, applying the overflow policy if the channel is full.
+             * \param lock The lock on the channel's mutex.
+             * \param element The object to push (forwarded only if it is pushed).
+             * \param time The deadline until which a sender can wait for space (with OverflowPolicy::BLOCK).
+             * \return True if the object was pushed, false if it was dropped or the deadline was reached.
+             *
+             * Before waiting for space, the sleeping receivers are notified: the objects already pushed by the same
+             * sender (in a batch) have to be received to make space. \n
+             * */
+            template<typename TForward>
+            bool offer(LockType& lock, TForward&& element, const Deadline& time);
+
+            /**
+             * \brief Releases the lock on the channel's mutex and notifies the sleeping receivers and the listener (if
+             *     any).
+             * \param lock The lock on the channel's mutex.
+             * \param count The number of pushed objects (a single object wakes up a single receiver, none wakes up
+             *     nobody).
+             * */
+            void notify_receivers(LockType& lock, std::size_t count);
+
+            /**
+             * \brief Notifies the listener (if any) that elements were received (the mutex have to be unlocked).
+             * */
+            void notify_receive() noexcept;
 
             friend ReceiverType;
             friend SenderType;
         };
 
+        /**
+         * \brief A Channel whose queue is a RingQueue: once the queue reached its steady-state size, sending and
+         *     receiving do not allocate.
+         * \param TElement The type of elements to share.
+         * \param TAllocator The allocator of the queue.
+         * \param TWaitPolicy Tells to the receivers how to wait for elements.
+         * \sa ElementPool
+         * */
+        template<typename TElement, typename TAllocator = std::allocator<TElement>,
+            typename TWaitPolicy = BlockingWaitPolicy>
+        using RingQueueChannel = Channel<TElement, RingQueue<TElement, TAllocator>, TWaitPolicy>;
+
         /**
          * \brief Receives elements from a Channel.
          * \param TChannel The type of Channel from which it receives elements.
          */
         template<typename TChannel>
-        class ChannelReceiver: public Receiver<typename TChannel::ElementType>
+        class ChannelReceiver final: public Receiver<typename TChannel::ElementType>
         {
         public:
             /**
@@ -135,9 +422,9 @@ namespace ese
             typedef typename TChannel::ElementType ElementType;
 
             /**
-             * \brief Tries to receive an element until a time point.
+             * \brief Tries to receive an element until a deadline.
              * \param address The pointer to the address where the received element have to be moved.
-             * \param time The time_point to wait until (using boost::any time for accept different time_points).
+             * \param time The deadline.
              * \return True if the element was received (and moved to the address passed as argument), false otherwise.
              * \sa try_receive_until_1()
              *
@@ -145,7 +432,18 @@ namespace ese
              * Otherwise, if there is no object to receive (until the specified time point), nothing will
              * be moved to the passed address and the method will return false. \n
              * */
-            bool try_receive_until_0(ElementType* address, const boost::any& time) override;
+            bool try_receive_until_0(ElementType* address, const Deadline& time) override;
+
+            /**
+             * \brief Receives many elements at once, waiting until a deadline for the first one.
+             * \param address The address where the received elements are moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             *
+             * All the elements are taken under a single lock acquisition.
+             * */
+            std::size_t try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time) override;
 
         private:
             /**
@@ -165,17 +463,15 @@ namespace ese
             ChannelReceiver(ChannelType& channel) noexcept;
 
             /**
-             * \brief Tries to receive an element until a time point.
-             * \param address The pointer to the address where the received element have to be moved.
-             * \param time The time_point to wait until.
-             * \return True if the element was received (and moved to the address passed as argument), false otherwise.
+             * \brief Tries to receive (up to max) elements until a deadline.
+             * \param address The pointer to the address where the received elements have to be moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
              *
-             * The object will be moved to the address passed as argument and the method will return true. \n
-             * Otherwise, if there is no object to receive (until the specified time point), nothing will
-             * be moved to the passed address and the method will return false. \n
+             * The method waits (until the deadline) only for the first element. \n
              * */
-            template<class Clock, class Duration>
-            bool try_receive_until_1(ElementType* address, const std::chrono::time_point<Clock, Duration>& time);
+            std::size_t try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time);
 
             friend ChannelType;
         };
@@ -185,7 +481,7 @@ namespace ese
          * \param TChannel The type of Channel in which sends elements.
          * */
         template<typename TChannel>
-        class ChannelSender: public Sender<typename TChannel::ElementType>
+        class ChannelSender final: public Sender<typename TChannel::ElementType>
         {
         public:
             /**
@@ -201,15 +497,38 @@ namespace ese
             /**
              * \brief Send the element in the channel.
              * \param element The element to send.
+             *
+             * If the channel is full, the overflow policy is applied (OverflowPolicy::BLOCK waits for space).
              * */
             void send(ElementType&& element) override;
 
             /**
              * \brief Send the element in the channel.
              * \param element The element to send.
+             *
+             * If the channel is full, the overflow policy is applied (OverflowPolicy::BLOCK waits for space).
              * */
             void send(const ElementType& element) override;
 
+            /**
+             * \brief Send many elements in the channel.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * All the elements are pushed under a single lock acquisition and the receivers are notified once.
+             * */
+            void send_batch_0(ElementType* elements, std::size_t count) override;
+
+            /**
+             * \brief Tries to send the element, waiting for space until a deadline.
+             * \param element The address of the element to send (moved from there only if it was sent).
+             * \param time The deadline (used only with OverflowPolicy::BLOCK).
+             * \return True if the element entered the channel, false otherwise.
+             *
+             * With the other policies the method never waits: it returns false when the element is dropped.
+             * */
+            bool try_send_until_0(ElementType* element, const Deadline& time) override;
+
         private:
             /**
              * \brief The channel in which it sends elements.
@@ -0,0 +1,191 @@
+
+#ifndef ESE_FLOW_CONSUMERRUNNER_HXX
+#define ESE_FLOW_CONSUMERRUNNER_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/consumer.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/small-function.hxx>
+#include <ese/flow/thread.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells to a ConsumerRunner how to back off while its consumers find nothing to consume.
+         * */
+        typedef struct _ConsumerRunnerOptions_
+        {
+            /**
+             * \brief The number of idle rounds spent busy-waiting (with a "pause" instruction) before yielding.
+             * */
+            unsigned spins = 64;
+
+            /**
+             * \brief The number of idle rounds spent yielding the thread before sleeping.
+             * */
+            unsigned yields = 16;
+
+            /**
+             * \brief The first sleep, doubled on every further idle round up to max_sleep (used only by runners that
+             *     do not listen to a channel).
+             * */
+            std::chrono::microseconds min_sleep = std::chrono::microseconds(10);
+
+            /**
+             * \brief The longest sleep (it bounds the latency of an idle consumer).
+             * */
+            std::chrono::microseconds max_sleep = std::chrono::microseconds(1000);
+        } ConsumerRunnerOptions;
+
+        /**
+         * \brief Drives ::Consumer objects, each one on its own ::Thread, until a stop is required.
+         * \tparam TElement The type of the elements to consume.
+         * \sa Consumer
+         *
+         * Every thread calls Consumer::consume() in a loop, until Consumer::is_stop_required(): a round that consumed
+         * something is followed immediately by the next one, while idle rounds back off (spinning, then yielding,
+         * then parking) according to the ConsumerRunnerOptions. \n
+         * A runner built from a channel becomes its ChannelListener: parked threads sleep until elements are sent or
+         * a stop is required (both are checked again after registering as waiters, so no notification is lost).
+         * Other runners park for a growing sleep, that require_stop() interrupts. Either way the consumers have to be
+         * non-blocking (e.g. ConsumerFactory::create_adaptive(max), that batches when the queue is deep): a consumer
+         * blocked in its channel can not see the stop request. \n
+         * The methods of the runner have to be called by one thread at a time. \n
+         * */
+        template<typename TElement>
+        class ConsumerRunner: private ChannelListener
+        {
+        public:
+            /**
+             * \brief The type of the elements to consume.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief The type of the driven consumers.
+             * */
+            typedef Consumer<TElement> ConsumerType;
+
+            /**
+             * \brief Construct a runner with no consumers, that does not listen to any channel.
+             * \param options The back-off options.
+             * */
+            explicit ConsumerRunner(ConsumerRunnerOptions options = ConsumerRunnerOptions());
+
+            /**
+             * \brief Construct a runner with no consumers, that becomes the listener of the channel its consumers
+             *     receive from.
+             * \tparam TChannel The type of the channel (any channel with a set_listener() method).
+             * \param channel The channel (it have to outlive the runner).
+             * \param options The back-off options.
+             * \throw std::logic_error If the channel already has another listener.
+             *
+             * The runner can be built only while nobody is sending into the channel.
+             * */
+            template<typename TChannel, typename = decltype(std::declval<TChannel&>().set_listener(nullptr))>
+            explicit ConsumerRunner(TChannel& channel, ConsumerRunnerOptions options = ConsumerRunnerOptions());
+
+            ConsumerRunner(const ConsumerRunner&) = delete;
+
+            ConsumerRunner& operator=(const ConsumerRunner&) = delete;
+
+            /**
+             * \brief Stops the consumers and joins their threads.
+             * \sa stop()
+             * */
+            virtual ~ConsumerRunner();
+
+            /**
+             * \brief Starts driving a consumer, on a new thread.
+             * \param consumer The consumer.
+             * */
+            void add(ConsumerType&& consumer);
+
+            /**
+             * \brief Asks every consumer to stop, and wakes up the parked ones (without waiting for them).
+             * \sa stop()
+             * */
+            void require_stop() noexcept;
+
+            /**
+             * \brief Asks every consumer to stop, then waits until all the threads are joined.
+             * */
+            void stop();
+
+            /**
+             * \brief Return the number of consumers.
+             * \return The number of consumers.
+             * */
+            std::size_t get_consumers_count() const noexcept;
+
+            /**
+             * \brief Return the number of elements consumed by all the consumers (it can be read while they run).
+             * \return The number of consumed elements.
+             * */
+            int get_consumed_count() const noexcept;
+
+        private:
+            /**
+             * \brief Notified when elements are sent to the channel, and when a stop is required.
+             * */
+            EventCount event;
+
+            /**
+             * \brief True if the runner is the listener of its channel (so parked threads do not need a timeout).
+             * */
+            bool listening;
+
+            /**
+             * \brief Removes the runner from the listeners of its channel (empty if not listening).
+             * */
+            SmallFunction<void()> detach;
+
+            /**
+             * \brief The back-off options.
+             * */
+            ConsumerRunnerOptions options;
+
+            /**
+             * \brief The consumers (in a list, so that their addresses are stable).
+             * */
+            std::list<ConsumerType> consumers;
+
+            /**
+             * \brief The threads driving the consumers.
+             * */
+            std::vector<std::unique_ptr<Thread>> threads;
+
+            /**
+             * \brief The loop run by every thread.
+             * \param consumer The consumer to drive.
+             * */
+            void run(ConsumerType& consumer);
+
+            /**
+             * \brief Backs off after an idle round.
+             * \param consumer The idle consumer.
+             * \param round The number of idle rounds in a row (before this one).
+             * \return The number of elements consumed while backing off (then the consumer is not idle anymore).
+             * */
+            int back_off(ConsumerType& consumer, unsigned round);
+
+            /**
+             * \brief Wakes up the parked threads.
+             * */
+            void on_send() noexcept override;
+        };
+    }
+}
+
+#include "template/consumer-runner.txx"
+
+#endif
@@ -3,8 +3,18 @@
 #define ESE_FLOW_CONSUMER_HXX
 
 #include <atomic>
-#include <functional>
+#include <cstddef>
 #include <ese/flow/receiver.hxx>
+#include <ese/flow/small-function.hxx>
+
+#ifdef ESE_FLOW_METRICS
+#include <memory>
+#include <ese/flow/metrics.hxx>
+#endif
+
+#ifdef ESE_FLOW_TRACING
+#include <ese/flow/trace.hxx>
+#endif
 
 namespace ese
 {
@@ -99,6 +109,35 @@ namespace ese
             template<class Rep, class Period>
             ConsumerType create_one_for(const std::chrono::duration<Rep, Period>& duration);
 
+            /**
+             * \brief Create a ::Consumer object that consumes many elements at a time.
+             * \param max The maximal number of elements consumed by a single call.
+             * \param blocking If true, the consumer will block until (at least) an element is received, if false and
+             *     there is no element available, the consumer will return immediately.
+             * \return The created ::Consumer object.
+             * \sa consume_batch_0()
+             *
+             * The consumer receives all the available elements (up to max) with a single receive_batch() call and
+             * passes them to consume_batch_0().
+             * */
+            ConsumerType create_batch(std::size_t max, bool blocking = false);
+
+            /**
+             * \brief Create a ::Consumer object that consumes many elements at a time, adapting the batch size to the
+             *     depth of the queue.
+             * \param max The maximal number of elements consumed by a single call.
+             * \param blocking If true, the consumer will block until (at least) an element is received, if false and
+             *     there is no element available, the consumer will return immediately.
+             * \return The created ::Consumer object.
+             * \sa create_batch()
+             *
+             * The batch size starts from 1: it is doubled (up to max) every time a batch is filled, since the queue is
+             * deep and the per-call cost is worth amortizing, and it is halved every time a batch is not filled, so
+             * that a shallow queue is consumed one element at a time (each element is handed over without waiting
+             * for the others of its batch to be consumed).
+             * */
+            ConsumerType create_adaptive(std::size_t max, bool blocking = false);
+
             /**
              * \brief Consumes the passed element.
              * \param element The element to consume.
@@ -107,11 +146,47 @@ namespace ese
              * */
             virtual void consume_0(TElement&& element) = 0;
 
+            /**
+             * \brief Consumes the passed elements.
+             * \param elements The address of the first element to consume (elements can be moved from there).
+             * \param count The number of elements to consume.
+             *
+             * Used by the consumers created via create_batch(). The default implementation calls consume_0() for
+             * each element; implementations that can consume many elements at the cost of one should override it. \n
+             * With ESE_FLOW_METRICS, the default implementation times every consume_0() call, while the time of an
+             * overriding one is shared out evenly between its elements (their latencies are averages).
+             * */
+            virtual void consume_batch_0(TElement* elements, std::size_t count);
+
         private:
             /**
              * \brief The receiver from which the created consumers will receive elements.
              * */
             ReceiverType* receiver;
+
+            /**
+             * \brief Consumes an element on behalf of a consumer, updating its counts (and metrics).
+             * \param consumer The consumer.
+             * \param element The element.
+             * */
+            void consume_one(ConsumerType* consumer, TElement&& element);
+
+            /**
+             * \brief Consumes many elements on behalf of a consumer, updating its counts (and metrics).
+             * \param consumer The consumer.
+             * \param elements The address of the first element.
+             * \param count The number of elements.
+             * */
+            void consume_many(ConsumerType* consumer, TElement* elements, std::size_t count);
+
+#ifdef ESE_FLOW_METRICS
+            /**
+             * \brief Get the counters of the consumer whose batch the calling thread is consuming.
+             * \return The counters (thread-local): set by consume_many(), and cleared by the default consume_batch_0()
+             *     to tell that it timed the elements itself.
+             * */
+            static ConsumerCounters*& get_batch_counters() noexcept;
+#endif
         };
 
         /**
@@ -146,6 +221,11 @@ namespace ese
              * */
             typedef Receiver<TElement> ReceiverType;
 
+            /**
+             * \brief The type of the consumer's behaviour (the behaviours created by the factory are stored inline).
+             * */
+            typedef SmallFunction<int(ThisType*)> BehaviourType;
+
             /**
              * \brief Moves the object.
              * \param other The object to move.
@@ -153,7 +233,7 @@ namespace ese
             Consumer(Consumer<ElementType>&& other);
 
             /**
-             * \brief Delete the inner data.
+             * \brief Destroys the consumer.
              * */
             virtual ~Consumer();
 
@@ -174,14 +254,32 @@ namespace ese
             /**
              * \brief Return the number of overall (via multiple call of consume() method) consumed elements.
              * \return The number of overall consumed elements.
+             *
+             * It can be read by any thread, while another one drives the consumer.
              * */
             int get_consumed_count() const noexcept;
 
             /**
-             * \brief
+             * \brief Asks the loop driving this consumer (e.g. a ::ConsumerRunner) to stop.
+             * \sa is_stop_required()
              * */
             void require_stop() noexcept;
 
+            /**
+             * \brief Tells if a stop was required.
+             * \return True if require_stop() was called, false otherwise.
+             * */
+            bool is_stop_required() const noexcept;
+
+#ifdef ESE_FLOW_METRICS
+            /**
+             * \brief Reads the metrics of the consumer (available only when ESE_FLOW_METRICS is defined).
+             * \return The metrics.
+             * \sa MetricsRegistry
+             * */
+            ConsumerMetrics get_metrics() const noexcept;
+#endif
+
         private:
             /**
              * \brief Structure that stores the inner data of ::Consumer objects.
@@ -191,12 +289,13 @@ namespace ese
                 /**
                  * \brief The behaviour of the consumer.
                  * */
-                std::function<int(ThisType*)> behaviour;
+                BehaviourType behaviour;
 
                 /**
-                 * \brief Overall consumed elements count.
+                 * \brief Overall consumed elements count (written by the thread driving the consumer, readable by any
+                 *     thread).
                  * */
-                int consumed_count;
+                std::atomic_int consumed_count;
 
                 /**
                  * \brief Tells if a stop was required.
@@ -204,23 +303,43 @@ namespace ese
                  * */
                 std::atomic_bool stop_required;
 
+#ifdef ESE_FLOW_METRICS
+                /**
+                 * \brief The counters behind get_metrics() (on the heap: the histogram is large, and it have to keep
+                 *     its address when the consumer is moved).
+                 * */
+                std::unique_ptr<ConsumerCounters> counters;
+#endif
+
                 /**
                  * \brief Create the inner data structure with specified consumer behaviour.
                  * \param behaviour The consumer behaviour.
                  * */
-                _InnerData_(std::function<int(ThisType*)>&& behaviour);
+                _InnerData_(BehaviourType&& behaviour);
+
+                /**
+                 * \brief Moves the inner data structure.
+                 * \param other The inner data to move.
+                 * */
+                _InnerData_(_InnerData_&& other) noexcept;
             }
             InnerData;
 
             /**
-             * \brief The inner data.
+             * \brief The inner data (stored inline, so creating a consumer does not allocate).
              * */
-            InnerData* data;
+            InnerData data;
 
             /**
              * \brief Construct a consumer with the specified behaviour.
              * */
-            Consumer(std::function<int(ThisType*)>&& behaviour);
+            Consumer(BehaviourType&& behaviour);
+
+            /**
+             * \brief Adds to the consumed elements count.
+             * \param count The number of elements just consumed.
+             * */
+            void count_consumed(int count) noexcept;
 
             friend FactoryType;
         };
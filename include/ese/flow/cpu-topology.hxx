@@ -0,0 +1,117 @@
+
+#ifndef ESE_FLOW_CPUTOPOLOGY_HXX
+#define ESE_FLOW_CPUTOPOLOGY_HXX
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ese/flow/thread.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief The CPUs of the machine, with their cores, packages (sockets) and NUMA nodes.
+         * \sa layout()
+         *
+         * On Linux the topology is read from /sys, elsewhere (or if /sys is not readable) every CPU reported by
+         * std::thread::hardware_concurrency() is a core of its own, in no NUMA node. \n
+         * */
+        class CpuTopology
+        {
+        public:
+            /**
+             * \brief A CPU (a hardware thread).
+             * */
+            typedef struct _Cpu_
+            {
+                /**
+                 * \brief The index of the CPU (as used by Thread::set_current_affinity()).
+                 * */
+                int id;
+
+                /**
+                 * \brief The index of the core, within its package (hardware threads of a core share it).
+                 * */
+                int core;
+
+                /**
+                 * \brief The index of the package (socket).
+                 * */
+                int package;
+
+                /**
+                 * \brief The index of the NUMA node (-1 if unknown).
+                 * */
+                int node;
+            } Cpu;
+
+            /**
+             * \brief Construct a topology made of the specified CPUs.
+             * \param cpus The CPUs.
+             * */
+            explicit CpuTopology(std::vector<Cpu> cpus);
+
+            /**
+             * \brief Reads the topology of the machine (only the online CPUs on which the process may run).
+             * \return The topology.
+             * */
+            static CpuTopology detect();
+
+            /**
+             * \brief Parses a list of CPUs, in the format used by Linux (e.g. "0-3,8,10-11").
+             * \param list The list.
+             * \return The indexes of the CPUs.
+             * \throw std::invalid_argument If the list is malformed.
+             * */
+            static std::vector<int> parse_cpu_list(const std::string& list);
+
+            /**
+             * \brief Get the CPUs.
+             * \return The CPUs.
+             * */
+            const std::vector<Cpu>& get_cpus() const noexcept;
+
+            /**
+             * \brief Get the number of physical cores.
+             * \return The number of cores.
+             * */
+            std::size_t get_cores_count() const;
+
+            /**
+             * \brief Get the number of NUMA nodes (0 if unknown).
+             * \return The number of nodes.
+             * */
+            std::size_t get_nodes_count() const;
+
+            /**
+             * \brief Get the CPUs of a NUMA node.
+             * \param node The index of the node.
+             * \return The indexes of the CPUs.
+             * */
+            std::vector<int> get_node_cpus(int node) const;
+
+            /**
+             * \brief Lays out a number of threads (e.g. the threads of a pipeline, in stage order) on the CPUs.
+             * \param threads_count The number of threads.
+             * \param name_prefix If not empty, the i-th thread is named name_prefix followed by i.
+             * \return The options of every thread.
+             *
+             * Threads get a physical core each, filling a NUMA node (then a package) before moving to the next one,
+             * so that neighbouring threads (that share channels) share their caches and memory node. Once every core
+             * is used, the other hardware threads of the cores are used, then the layout starts again. Every thread
+             * is bound to its CPU and to the CPU's node. \n
+             * */
+            std::vector<ThreadOptions> layout(std::size_t threads_count, const std::string& name_prefix = "") const;
+
+        private:
+            /**
+             * \brief The CPUs, sorted by node, package, core and id.
+             * */
+            std::vector<Cpu> cpus;
+        };
+    }
+}
+
+#endif
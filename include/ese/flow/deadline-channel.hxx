@@ -0,0 +1,208 @@
+
+#ifndef ESE_FLOW_DEADLINECHANNEL_HXX
+#define ESE_FLOW_DEADLINECHANNEL_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/deadline.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Extracts the deadline of an element.
+         * \tparam TElement The type of the elements.
+         *
+         * The default implementation calls element.get_deadline(): specialize it (or pass another functor to
+         * DeadlineQueue) for elements that do not have such method.
+         * */
+        template<typename TElement>
+        struct DeadlineOf
+        {
+            /**
+             * \brief Get the deadline of an element.
+             * \param element The element.
+             * \return The deadline.
+             * */
+            Deadline operator()(const TElement& element) const;
+        };
+
+        /**
+         * \brief A queue that pops the elements in earliest-deadline-first order, using a calendar of buckets.
+         * \tparam TElement The type of the stored elements.
+         * \tparam TDeadlineOf The functor that extracts the deadline of an element.
+         * \tparam Buckets The number of buckets (a power of two, at least 64).
+         *
+         * Every bucket holds the elements whose deadlines fall in the same "resolution" long interval, sorted by
+         * deadline. The buckets cover the Buckets intervals that follow the earliest one: pushing an element in
+         * there and popping cost O(1) (the element is inserted from the back of its bucket, so elements sent in
+         * deadline order are simply appended). Elements whose deadline is beyond the covered horizon wait in a heap,
+         * and enter the buckets when the calendar advances; elements already late join the earliest bucket. \n
+         * It has the interface of std::queue, so it can be used as the queue of a Channel (see DeadlineChannel). \n
+         * */
+        template<typename TElement, typename TDeadlineOf = DeadlineOf<TElement>, std::size_t Buckets = 256>
+        class DeadlineQueue
+        {
+        public:
+            static_assert(Buckets >= 64 && (Buckets & (Buckets - 1)) == 0,
+                "The buckets of a DeadlineQueue have to be a power of two, at least 64.");
+
+            /**
+             * \brief The type of the stored elements.
+             * */
+            typedef TElement value_type;
+
+            /**
+             * \brief Construct an empty queue.
+             * \param resolution The length of the interval covered by every bucket.
+             * \param deadline_of The functor that extracts the deadline of an element.
+             * */
+            explicit DeadlineQueue(Deadline::duration resolution = std::chrono::milliseconds(1),
+                TDeadlineOf deadline_of = TDeadlineOf());
+
+            /**
+             * \brief Tells if the queue is empty.
+             * \return True if it is empty, false otherwise.
+             * */
+            bool empty() const noexcept;
+
+            /**
+             * \brief Get the number of stored elements.
+             * \return The number of elements.
+             * */
+            std::size_t size() const noexcept;
+
+            /**
+             * \brief Get the element with the earliest deadline.
+             * \return The element (the queue must not be empty).
+             * */
+            TElement& front();
+
+            /**
+             * \brief Removes the element with the earliest deadline.
+             *
+             * The queue must not be empty.
+             * */
+            void pop();
+
+            /**
+             * \brief Pushes an element in the queue.
+             * \param element The element to push.
+             * */
+            void push(TElement&& element);
+
+            /**
+             * \brief Pushes an element in the queue.
+             * \param element The element to push.
+             * */
+            void push(const TElement& element);
+
+        private:
+            /**
+             * \brief A stored element, with its deadline.
+             * */
+            typedef struct _Entry_
+            {
+                /**
+                 * \brief The deadline of the element.
+                 * */
+                Deadline deadline;
+
+                /**
+                 * \brief The element.
+                 * */
+                TElement element;
+            } Entry;
+
+            /**
+             * \brief The buckets (the one of tick t is buckets[t % Buckets]).
+             * */
+            std::deque<Entry> buckets[Buckets];
+
+            /**
+             * \brief One bit for every non-empty bucket.
+             * */
+            std::uint64_t occupied[Buckets / 64];
+
+            /**
+             * \brief The elements beyond the horizon of the buckets (a heap, the earliest deadline on top).
+             * */
+            std::vector<Entry> overflow;
+
+            /**
+             * \brief The tick of the earliest bucket (the horizon ends at base_tick + Buckets).
+             * */
+            std::int64_t base_tick;
+
+            /**
+             * \brief The number of stored elements.
+             * */
+            std::size_t count;
+
+            /**
+             * \brief The length of the interval covered by every bucket.
+             * */
+            const Deadline::duration resolution;
+
+            /**
+             * \brief The functor that extracts the deadline of an element.
+             * */
+            TDeadlineOf deadline_of;
+
+            /**
+             * \brief Get the tick (the index of the interval) of a deadline.
+             * \param deadline The deadline.
+             * \return The tick.
+             * */
+            std::int64_t tick_of(const Deadline& deadline) const noexcept;
+
+            /**
+             * \brief Pushes an entry.
+             * \param entry The entry.
+             * */
+            void push_entry(Entry&& entry);
+
+            /**
+             * \brief Moves an entry in its bucket (or in the overflow heap), without counting it.
+             * \param entry The entry.
+             * */
+            void place(Entry&& entry);
+
+            /**
+             * \brief Advances the calendar to the earliest non-empty bucket (the queue must not be empty).
+             * \return The earliest bucket.
+             * */
+            std::deque<Entry>& settle();
+        };
+
+        /**
+         * \brief A DeadlineQueue pops its elements in deadline order, not in the order they were pushed.
+         * */
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        struct IsFifoQueue<DeadlineQueue<TElement, TDeadlineOf, Buckets>>: std::false_type
+        {
+
+        };
+
+        /**
+         * \brief A Channel whose receivers get the elements in earliest-deadline-first order.
+         * \param TElement The type of elements to share.
+         * \param TDeadlineOf The functor that extracts the deadline of an element.
+         * \param TWaitPolicy Tells to the receivers how to wait for elements.
+         * */
+        template<typename TElement, typename TDeadlineOf = DeadlineOf<TElement>,
+            typename TWaitPolicy = BlockingWaitPolicy>
+        using DeadlineChannel = Channel<TElement, DeadlineQueue<TElement, TDeadlineOf>, TWaitPolicy>;
+    }
+}
+
+#include "template/deadline-channel.txx"
+
+#endif
@@ -0,0 +1,48 @@
+
+#ifndef ESE_FLOW_DEADLINE_HXX
+#define ESE_FLOW_DEADLINE_HXX
+
+#include <chrono>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief The canonical time point used by the receiving (and sending) interfaces.
+         *
+         * Deadline::min() means "do not wait at all" and Deadline::max() means "wait forever". \n
+         * Time points of other clocks are converted once (via to_deadline()), before entering the virtual methods.
+         * */
+        typedef std::chrono::steady_clock::time_point Deadline;
+
+        /**
+         * \brief Converts a time point of any clock into a Deadline.
+         * \param time The time point to convert.
+         * \return The Deadline. Time points already passed become Deadline::min(), the maximal time point of every
+         *     clock becomes Deadline::max().
+         * */
+        template<class Clock, class Duration>
+        Deadline to_deadline(const std::chrono::time_point<Clock, Duration>& time);
+
+        /**
+         * \brief Converts a steady_clock time point into a Deadline (no clock reading needed).
+         * \param time The time point to convert.
+         * \return The Deadline.
+         * */
+        template<class Duration>
+        Deadline to_deadline(const std::chrono::time_point<std::chrono::steady_clock, Duration>& time);
+
+        /**
+         * \brief Computes the Deadline that is reached after a specified amount of time from now.
+         * \param duration The amount of time.
+         * \return The Deadline (saturated to Deadline::max()).
+         * */
+        template<class Rep, class Period>
+        Deadline deadline_after(const std::chrono::duration<Rep, Period>& duration);
+    }
+}
+
+#include "template/deadline.txx"
+
+#endif
@@ -0,0 +1,394 @@
+
+#ifndef ESE_FLOW_DURABLECHANNEL_HXX
+#define ESE_FLOW_DURABLECHANNEL_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/durable-log.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/receiver.hxx>
+#include <ese/flow/sender.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        class DurableChannelReceiver;
+
+        template<typename TChannel>
+        class DurableChannelSender;
+
+        /**
+         * \brief Serializes trivially copyable elements as their raw bytes.
+         * \param TElement The type of elements to serialize.
+         *
+         * Any serializer for a DurableChannel has to offer the same two methods.
+         * */
+        template<typename TElement>
+        class TrivialSerializer
+        {
+            static_assert(std::is_trivially_copyable<TElement>::value,
+                "TrivialSerializer works only with trivially copyable elements");
+
+        public:
+            /**
+             * \brief Appends the bytes of an element to a buffer.
+             * \param element The element.
+             * \param buffer The buffer.
+             * */
+            void serialize(const TElement& element, std::string& buffer) const;
+
+            /**
+             * \brief Rebuilds an element from its bytes.
+             * \param data The address of the bytes.
+             * \param size The number of bytes.
+             * \param element Where the element is stored.
+             * \return True if the element was rebuilt, false if the bytes are not valid.
+             * */
+            bool deserialize(const char* data, std::size_t size, TElement* element) const;
+        };
+
+        /**
+         * \brief A channel whose elements survive a restart of the process: they are appended to a DurableLog.
+         * \param TElement The type of elements to share.
+         * \param TSerializer Turns elements into bytes and back (see TrivialSerializer).
+         * \sa DurableLog
+         *
+         * Sent elements are serialized into the memory-mapped segments of the log and flushed to disk in groups,
+         * according to the DurableLogOptions (a batch sent via send_batch() is flushed at most once). The flush
+         * interval is checked on every send and every receive, and commit() flushes the records it commits: the last
+         * elements sent to a channel that nobody uses are flushed only by sync() or by the destructor. \n
+         * The receiver reads the log from its offset: it starts from the committed offset of the log, stores its
+         * progress via commit() and can replay the log from any offset still on disk via seek(). \n
+         * The channel is unbounded (the log grows until compact() removes the committed segments). \n
+         * All operation (even those of receiver and sender) are thread-safe. \n
+         * */
+        template<typename TElement, typename TSerializer = TrivialSerializer<TElement>>
+        class DurableChannel
+        {
+        public:
+            /**
+             *  brief The type of elements to share.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             *  brief The type of serializer of the elements.
+             * */
+            typedef TSerializer SerializerType;
+
+            /**
+             * \brief The offset of an element in the log.
+             * */
+            typedef DurableLog::Offset Offset;
+
+            /**
+             * \brief The type of the Receiver that interacts with this DurableChannel.
+             * */
+            typedef DurableChannelReceiver<DurableChannel<TElement, TSerializer>> ReceiverType;
+
+            /**
+             * \brief The type of the Sender that interacts with this DurableChannel.
+             * */
+            typedef DurableChannelSender<DurableChannel<TElement, TSerializer>> SenderType;
+
+            /**
+             * \brief Construct a DurableChannel object, opening (or creating) its log.
+             * \param directory The directory of the log.
+             * \param options The layout and the flush policy of the log.
+             * \param serializer The serializer of the elements.
+             * \sa get_receiver()
+             * \sa get_sender()
+             * */
+            explicit DurableChannel(const std::string& directory, const DurableLogOptions& options = DurableLogOptions(),
+                const TSerializer& serializer = TSerializer());
+
+            DurableChannel(const DurableChannel&) = delete;
+
+            DurableChannel& operator=(const DurableChannel&) = delete;
+
+            /**
+             * \brief Get the channel's receiver.
+             * \return The receiver.
+             * */
+            ReceiverType& get_receiver() noexcept;
+
+            /**
+             * \brief Get the channel's sender.
+             * \return The sender.
+             * */
+            SenderType& get_sender() noexcept;
+
+            /**
+             * \brief Wakes up all the threads that are waiting to receive an element via the Receiver object
+             *     owned by this DurableChannel object.
+             * */
+            void wake_up() noexcept;
+
+            /**
+             * \brief Tells if the channel is (was, at the moment of the call) empty.
+             * \return True if the receiver read every element, false otherwise.
+             * */
+            bool is_empty() const;
+
+            /**
+             * \brief Sets the listener notified after every send.
+             * \param listener The listener (nullptr removes the current one).
+             * \return True if the listener was set, false if the channel already has another listener (that has to be
+             *     removed first).
+             *
+             * The listener can be changed only while nobody is sending into the channel.
+             * */
+            bool set_listener(ChannelListener* listener) noexcept;
+
+            /**
+             * \brief Flushes all the sent elements to disk.
+             * */
+            void sync();
+
+            /**
+             * \brief Removes the segments of the log whose elements are all before the committed offset.
+             * \return The number of removed segments.
+             * */
+            std::size_t compact();
+
+            /**
+             * \brief Get the offset that the next sent element will have.
+             * \return The offset.
+             * */
+            Offset get_end_offset() const;
+
+        private:
+            /**
+             * \brief Protects the log, the serializer and the receiver's position.
+             * */
+            mutable std::mutex mutex;
+
+            /**
+             * \brief The log in which the elements are stored.
+             * */
+            DurableLog log;
+
+            /**
+             * \brief The serializer of the elements.
+             * */
+            TSerializer serializer;
+
+            /**
+             * \brief Reused to serialize the elements.
+             * */
+            std::string buffer;
+
+            /**
+             * \brief Used to signal when new elements are in the log.
+             * */
+            EventCount not_empty_event;
+
+            /**
+             * \brief Incremented on every wake_up() call.
+             * */
+            std::atomic_uint wake_ups;
+
+            /**
+             * \brief The listener notified after every send (if any).
+             * */
+            std::atomic<ChannelListener*> listener;
+
+            /**
+             * \brief The channel's Receiver object.
+             * */
+            ReceiverType receiver;
+
+            /**
+             * \brief The channel's Sender object.
+             * */
+            SenderType sender;
+
+            /**
+             * \brief Serializes an element and appends it to the log (the mutex have to be locked).
+             * \param element The element.
+             * */
+            void append(const TElement& element);
+
+            /**
+             * \brief Wakes up the receivers and the listener, after elements were appended.
+             * \param count The number of appended elements.
+             * */
+            void notify_send(std::size_t count) noexcept;
+
+            friend ReceiverType;
+            friend SenderType;
+        };
+
+        /**
+         * \brief Receives elements from a DurableChannel.
+         * \param TChannel The type of DurableChannel from which it receives elements.
+         */
+        template<typename TChannel>
+        class DurableChannelReceiver final: public Receiver<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             *  brief The type of DurableChannel from which it receives elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             *  brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief The offset of an element in the log.
+             * */
+            typedef typename TChannel::Offset Offset;
+
+            /**
+             * \brief Tries to receive an element from the channel until a deadline.
+             * \param address The pointer to the address where the received element have to be stored.
+             * \param time The deadline.
+             * \return True if the element was received, false otherwise.
+             * */
+            bool try_receive_until_0(ElementType* address, const Deadline& time) override;
+
+            /**
+             * \brief Receives up to max elements, waiting (until a deadline) only for the first one.
+             * \param address The address where the received elements have to be stored.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             * */
+            std::size_t try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time) override;
+
+            /**
+             * \brief Stores (durably) the offset of the next element to receive: after a restart, the receiver
+             *     starts from there.
+             * */
+            void commit();
+
+            /**
+             * \brief Moves the receiver to an offset, e.g. to replay elements already received.
+             * \param offset The offset of the next element to receive.
+             * \return True if the offset is in the log, false otherwise (the receiver does not move).
+             * */
+            bool seek(Offset offset);
+
+            /**
+             * \brief Get the offset of the next element to receive.
+             * \return The offset.
+             * */
+            Offset get_offset() const;
+
+            /**
+             * \brief Get the last committed offset.
+             * \return The offset.
+             * */
+            Offset get_committed_offset() const;
+
+        private:
+            /**
+             * \brief The channel from which it receives elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief The position of the next element to receive (protected by the channel's mutex).
+             * */
+            DurableLog::Position position;
+
+            /**
+             * \brief Construct the receiver, that receives elements from a specified channel.
+             * \param channel The channel from which receives elements.
+             * */
+            DurableChannelReceiver(ChannelType& channel) noexcept;
+
+            /**
+             * \brief Reads up to max elements, without waiting.
+             * \param address The address where the read elements have to be stored.
+             * \param max The maximal number of elements to read.
+             * \return The number of read elements.
+             * */
+            std::size_t try_read(ElementType* address, std::size_t max);
+
+            /**
+             * \brief Receives up to max elements, waiting (until a deadline) only for the first one.
+             * \param address The address where the received elements have to be stored.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             * */
+            std::size_t try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time);
+
+            friend ChannelType;
+        };
+
+        /**
+         * \brief Send elements into a DurableChannel object.
+         * \param TChannel The type of DurableChannel in which sends elements.
+         * */
+        template<typename TChannel>
+        class DurableChannelSender final: public Sender<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             * \brief The type of DurableChannel in which sends elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             * \brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Send the element into the channel.
+             * \param element The element to send.
+             * */
+            void send(ElementType&& element) override;
+
+            /**
+             * \brief Send the element into the channel.
+             * \param element The element to send.
+             * */
+            void send(const ElementType& element) override;
+
+            /**
+             * \brief Send many elements into the channel, flushing the log at most once.
+             * \param elements The address of the first element to send.
+             * \param count The number of elements to send.
+             * */
+            void send_batch_0(ElementType* elements, std::size_t count) override;
+
+            /**
+             * \brief Send the element into the channel (it never waits: the channel is unbounded).
+             * \param element The address of the element to send.
+             * \param time The deadline (unused).
+             * \return Always true.
+             * */
+            bool try_send_until_0(ElementType* element, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel in which it sends elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the sender, that sends elements in a specified channel.
+             * \param channel The channel from in which sends elements.
+             * */
+            DurableChannelSender(ChannelType& channel) noexcept;
+
+            friend ChannelType;
+        };
+    }
+}
+
+#include "ese/flow/template/durable-channel.txx"
+
+#endif
@@ -0,0 +1,238 @@
+
+#ifndef ESE_FLOW_DURABLELOG_HXX
+#define ESE_FLOW_DURABLELOG_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells to a DurableLog how to lay out its files and when to flush them to disk.
+         * */
+        typedef struct _DurableLogOptions_
+        {
+            /**
+             * \brief The size of every segment file, in bytes (a record can not be larger than a segment).
+             * */
+            std::size_t segment_size = 64 * 1024 * 1024;
+
+            /**
+             * \brief Flush once this number of records is waiting to be flushed (0 disables this trigger).
+             * */
+            std::size_t sync_every = 1024;
+
+            /**
+             * \brief Flush when the last flush is older than this (0 disables this trigger).
+             * */
+            std::chrono::milliseconds sync_interval = std::chrono::milliseconds(10);
+        } DurableLogOptions;
+
+        /**
+         * \brief An append-only log of records (byte strings), stored in memory-mapped segment files.
+         * \sa DurableChannel
+         *
+         * Every record gets an offset: its index since the creation of the log. A segment file is named after the
+         * offset of its first record and is pre-allocated, then records are copied into its mapping. \n
+         * Appended records are readable immediately, but they are durable only after a sync(): syncs are grouped
+         * according to the DurableLogOptions (group commit), so that many appends share one flush. \n
+         * Records carry a checksum: when the log is opened again, the records are recovered up to the first torn
+         * one. \n
+         * The log also stores a committed offset (e.g. the offset of the first record not processed yet), to resume
+         * from it after a restart. \n
+         * The setup methods throw std::system_error when the operating system refuses a request. \n
+         * The log is not thread-safe: the caller have to serialize all the operations. \n
+         * */
+        class DurableLog
+        {
+        public:
+            /**
+             * \brief The offset of a record.
+             * */
+            typedef std::uint64_t Offset;
+
+            /**
+             * \brief The place of a record in the log, used to read records sequentially.
+             * */
+            typedef struct _Position_
+            {
+                /**
+                 * \brief The offset of the record.
+                 * */
+                Offset offset;
+
+                /**
+                 * \brief The offset of the first record of the segment that contains the record.
+                 * */
+                Offset segment;
+
+                /**
+                 * \brief The position of the record in its segment, in bytes.
+                 * */
+                std::size_t byte;
+            } Position;
+
+            /**
+             * \brief Opens the log stored in a directory (created if needed), recovering its records.
+             * \param directory The directory of the log.
+             * \param options The layout and the flush policy.
+             * */
+            explicit DurableLog(const std::string& directory, const DurableLogOptions& options = DurableLogOptions());
+
+            DurableLog(const DurableLog&) = delete;
+
+            DurableLog& operator=(const DurableLog&) = delete;
+
+            /**
+             * \brief Flushes the log and closes its files.
+             * */
+            ~DurableLog();
+
+            /**
+             * \brief Appends a record (not flushed yet).
+             * \param data The address of the record's bytes.
+             * \param size The size of the record (throws std::length_error if it does not fit in a segment).
+             * \return The offset of the record.
+             * */
+            Offset append(const void* data, std::size_t size);
+
+            /**
+             * \brief Flushes the appended records to disk, if the flush policy says so.
+             * \return True if the log was flushed, false otherwise.
+             *
+             * Meant to be called after a group of appends, or while reading: the interval is checked only here, so
+             * the records appended last stay unflushed until the next call, sync() or commit(). \n
+             * */
+            bool maybe_sync();
+
+            /**
+             * \brief Flushes all the appended records to disk.
+             * */
+            void sync();
+
+            /**
+             * \brief Finds the position of a record.
+             * \param offset The offset of the record (the end offset is allowed).
+             * \param position Where the position is stored.
+             * \return True if the record is in the log, false if it was removed (or never appended).
+             * */
+            bool seek(Offset offset, Position* position) const;
+
+            /**
+             * \brief Reads the record at a position, then moves the position to the next record.
+             * \param position The position of the record.
+             * \param data Where the address of the record's bytes is stored (valid until the next call that
+             *     modifies the log).
+             * \param size Where the size of the record is stored.
+             * \return True if the record was read, false if the position is at the end of the log.
+             * */
+            bool read(Position* position, const char** data, std::size_t* size) const;
+
+            /**
+             * \brief Stores (durably) the committed offset.
+             * \param offset The offset.
+             *
+             * The records before the offset are flushed first, so that a crash can not leave the committed offset
+             * past the end of the recovered log. The log clamps the committed offset to its end when it is opened
+             * (e.g. after a torn record). \n
+             * */
+            void commit(Offset offset);
+
+            /**
+             * \brief Removes the segments whose records are all before the committed offset.
+             * \return The number of removed segments.
+             * */
+            std::size_t compact();
+
+            /**
+             * \brief Get the offset of the first record still in the log.
+             * \return The offset.
+             * */
+            Offset get_begin_offset() const noexcept;
+
+            /**
+             * \brief Get the offset that the next appended record will have.
+             * \return The offset.
+             * */
+            Offset get_end_offset() const noexcept;
+
+            /**
+             * \brief Get the offset of the first record not flushed to disk yet.
+             * \return The offset.
+             * */
+            Offset get_synced_offset() const noexcept;
+
+            /**
+             * \brief Get the committed offset (0 if it was never stored).
+             * \return The offset.
+             * */
+            Offset get_committed_offset() const noexcept;
+
+        private:
+            /**
+             * \brief A mapped segment file.
+             * */
+            class Segment;
+
+            /**
+             * \brief The directory of the log.
+             * */
+            const std::string directory;
+
+            /**
+             * \brief The layout and the flush policy.
+             * */
+            const DurableLogOptions options;
+
+            /**
+             * \brief The segments, by the offset of their first record.
+             * */
+            std::map<Offset, std::unique_ptr<Segment>> segments;
+
+            /**
+             * \brief The offset that the next appended record will have.
+             * */
+            Offset end_offset;
+
+            /**
+             * \brief The offset of the first record not flushed to disk yet.
+             * */
+            Offset synced_offset;
+
+            /**
+             * \brief The committed offset.
+             * */
+            Offset committed_offset;
+
+            /**
+             * \brief When the log was flushed the last time.
+             * */
+            std::chrono::steady_clock::time_point last_sync;
+
+            /**
+             * \brief The file descriptor of the file that stores the committed offset.
+             * */
+            int committed_fd;
+
+            /**
+             * \brief Creates a new (empty) segment, at the end of the log.
+             * \return The segment.
+             * */
+            Segment& add_segment();
+
+            /**
+             * \brief Get the last segment.
+             * \return The last segment.
+             * */
+            Segment& get_last_segment() noexcept;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,98 @@
+
+#ifndef ESE_FLOW_ELEMENTPOOL_HXX
+#define ESE_FLOW_ELEMENTPOOL_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ese/flow/ring-buffer.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Recycles spent elements, so that their resources (e.g. the buffer of a std::vector) are reused.
+         * \tparam TElement The type of the elements. Have to be default constructible and move assignable, and
+         *     should keep its resources when moved (as standard containers do).
+         * \sa RingQueueChannel
+         *
+         * Consumers give back the elements they are done with via release(), producers take them via acquire()
+         * instead of building new ones: once enough elements circulate, the elements are never allocated nor
+         * freed. An acquired element keeps the content it had when released: the producer have to overwrite (or
+         * clear) it. \n
+         * The pool keeps at most capacity elements (the others are destroyed on release) in a lock-free
+         * MpmcRingBuffer: all operations are thread-safe. \n
+         * */
+        template<typename TElement>
+        class ElementPool
+        {
+        public:
+            /**
+             * \brief The type of the elements.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief Construct an empty pool.
+             * \param capacity The (minimal) number of released elements that the pool keeps.
+             * */
+            explicit ElementPool(std::size_t capacity = 1024);
+
+            ElementPool(const ElementPool&) = delete;
+
+            ElementPool& operator=(const ElementPool&) = delete;
+
+            /**
+             * \brief Takes a released element, or builds a new one if there are none.
+             * \return The element.
+             * */
+            TElement acquire();
+
+            /**
+             * \brief Gives back a spent element.
+             * \param element The element (moved into the pool).
+             * \return True if the pool kept the element, false if it was full (and the element was left untouched).
+             * */
+            bool release(TElement&& element);
+
+            /**
+             * \brief Get the number of elements built by acquire(), because the pool was empty.
+             * \return The number of built elements.
+             * */
+            std::uint64_t get_created_count() const noexcept;
+
+            /**
+             * \brief Get the number of elements taken from the pool by acquire().
+             * \return The number of recycled elements.
+             * */
+            std::uint64_t get_recycled_count() const noexcept;
+
+            /**
+             * \brief Get the number of elements that the pool can keep.
+             * \return The capacity.
+             * */
+            std::size_t get_capacity() const noexcept;
+
+        private:
+            /**
+             * \brief The released elements.
+             * */
+            MpmcRingBuffer<TElement> elements;
+
+            /**
+             * \brief The number of elements built by acquire().
+             * */
+            std::atomic<std::uint64_t> created_count;
+
+            /**
+             * \brief The number of elements taken from the pool.
+             * */
+            std::atomic<std::uint64_t> recycled_count;
+        };
+    }
+}
+
+#include "ese/flow/template/element-pool.txx"
+
+#endif
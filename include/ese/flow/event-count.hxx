@@ -0,0 +1,120 @@
+
+#ifndef ESE_FLOW_EVENTCOUNT_HXX
+#define ESE_FLOW_EVENTCOUNT_HXX
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief A notification primitive that lets threads sleep until "something happens", used on top of
+         *     lock-free data structures.
+         *
+         * A waiting thread announces itself via prepare_wait(), re-checks its condition and then calls wait_until()
+         * (or cancel_wait() if the condition became true in the meantime). \n
+         * A notifying thread first changes the state (e.g. pushes an element) and then calls notify_one() or
+         * notify_all(). The notify methods are nearly free (no lock, no system call) when nobody is waiting. \n
+         * All operations are thread-safe. \n
+         * */
+        class EventCount
+        {
+        public:
+            /**
+             * \brief Identifies the moment in which a thread prepared to wait.
+             * */
+            typedef std::uint64_t Key;
+
+            /**
+             * \brief Construct an EventCount object, with no waiting threads.
+             * */
+            EventCount() noexcept;
+
+            EventCount(const EventCount&) = delete;
+
+            EventCount& operator=(const EventCount&) = delete;
+
+            /**
+             * \brief Announces that the calling thread is going to wait.
+             * \return The key to pass to wait_until().
+             * \sa cancel_wait()
+             * \sa wait_until()
+             *
+             * After this call, the thread have to re-check its condition and then call wait_until() or cancel_wait().
+             * */
+            Key prepare_wait() noexcept;
+
+            /**
+             * \brief Withdraws an announce made via prepare_wait().
+             * */
+            void cancel_wait() noexcept;
+
+            /**
+             * \brief Waits until a notification (that occurred after the prepare_wait() call) or a time point.
+             * \param key The key returned by the prepare_wait() method.
+             * \param time The time point to wait until.
+             * \return True if a notification occurred, false if the time point was reached.
+             * */
+            template<class Clock, class Duration>
+            bool wait_until(Key key, const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Waits until a notification (that occurred after the prepare_wait() call).
+             * \param key The key returned by the prepare_wait() method.
+             * */
+            void wait(Key key);
+
+            /**
+             * \brief Wakes up one of the waiting threads (if any).
+             * */
+            void notify_one() noexcept;
+
+            /**
+             * \brief Wakes up all the waiting threads (if any).
+             * */
+            void notify_all() noexcept;
+
+            /**
+             * \brief Returns the number of threads that announced to wait.
+             * \return The number of waiting threads.
+             * */
+            int get_waiting_count() const noexcept;
+
+        private:
+            /**
+             * \brief Incremented on every notification (that finds waiting threads).
+             * */
+            std::atomic<Key> epoch;
+
+            /**
+             * \brief The number of threads that are waiting (or preparing to).
+             * */
+            std::atomic_int waiting;
+
+            /**
+             * \brief Mutex used to synchronize sleeping threads.
+             * */
+            std::mutex mutex;
+
+            /**
+             * \brief Condition variable on which threads sleep.
+             * */
+            std::condition_variable condition_variable;
+
+            /**
+             * \brief Increments the epoch if somebody is waiting.
+             * \return True if somebody is waiting, false otherwise.
+             * */
+            bool advance() noexcept;
+        };
+    }
+}
+
+#include "template/event-count.txx"
+
+#endif
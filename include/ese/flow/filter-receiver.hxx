@@ -5,6 +5,10 @@
 #include <ese/flow/filter.hxx>
 #include <ese/flow/receiver.hxx>
 
+#ifdef ESE_FLOW_TRACING
+#include <ese/flow/trace.hxx>
+#endif
+
 namespace ese
 {
     namespace flow
@@ -58,9 +62,9 @@ namespace ese
 
         protected:
             /**
-             * \brief Tries to receive an element for an amount of time.
+             * \brief Tries to receive an element until a deadline.
              * \param address The pointer to the address where the received element have to be moved.
-             * \param duration The amount of time to wait (using boost::any time for accept different time_points).
+             * \param time The deadline (passed as is to the other receiver).
              * \return True if the element was received (and moved to the address passed as argument), false otherwise.
              * \sa receive()
              * \sa try_receive()
@@ -68,10 +72,21 @@ namespace ese
              * \sa try_receive_for()
              *
              * The object will be moved to the address passed as argument and the method will return true. \n
-             * Otherwise, if there is no object to receive (for the entire specified amount of time), nothing will
-             * be moved to the passed address and the method will return false. \n
+             * Otherwise, if there is no object to receive (until the deadline), nothing will be moved to the passed
+             * address and the method will return false. \n
+             * */
+            bool try_receive_until_0(TOut* address, const Deadline& time) override;
+
+            /**
+             * \brief Receives many elements at once, waiting until a deadline for the first one.
+             * \param address The address where the received (and filtered) elements are moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             *
+             * The elements are received in batches from the other receiver and then filtered one by one.
              * */
-            bool try_receive_until_0(TOut* address, const boost::any& time) override;
+            std::size_t try_receive_batch_until_0(TOut* address, std::size_t max, const Deadline& time) override;
 
         private:
             /**
@@ -5,6 +5,10 @@
 #include <ese/flow/filter.hxx>
 #include <ese/flow/sender.hxx>
 
+#ifdef ESE_FLOW_TRACING
+#include <ese/flow/trace.hxx>
+#endif
+
 namespace ese
 {
     namespace flow
@@ -72,6 +76,26 @@ namespace ese
              * */
             void send(const TIn& element) override;
 
+            /**
+             * \brief Send many elements at once.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * It forwards the filtered elements to the specified sender, in batches.
+             * */
+            void send_batch_0(TIn* elements, std::size_t count) override;
+
+            /**
+             * \brief Tries to send the element, waiting for space until a deadline.
+             * \param element The address of the element to send.
+             * \param time The deadline.
+             * \return True if the filtered element was sent, false otherwise.
+             *
+             * The element is filtered as a constant reference (so it is left untouched when the specified sender
+             * refuses the filtered one) and forwarded to the try_send_until_0() of the specified sender.
+             * */
+            bool try_send_until_0(TIn* element, const Deadline& time) override;
+
         private:
             /**
              * \brief The the filter that filters sent elements.
@@ -2,7 +2,7 @@
 #ifndef ESE_FLOW_LAMBDAEXECUTABLE_HXX
 #define ESE_FLOW_LAMBDAEXECUTABLE_HXX
 
-#include <functional>
+#include <ese/flow/small-function.hxx>
 
 namespace ese
 {
@@ -10,8 +10,10 @@ namespace ese
     {
         /**
          * \brief Represent a C++ lambda function type that accepts no arguments and returns no value.
+         *
+         * It is a move-only SmallFunction: wrapping a typical lambda does not allocate.
          * */
-        typedef std::function<void()> LambdaExecutable;
+        typedef SmallFunction<void()> LambdaExecutable;
     }
 }
 
@@ -0,0 +1,347 @@
+
+#ifndef ESE_FLOW_LOCKFREECHANNEL_HXX
+#define ESE_FLOW_LOCKFREECHANNEL_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/receiver.hxx>
+#include <ese/flow/ring-buffer.hxx>
+#include <ese/flow/sender.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        class LockFreeChannelReceiver;
+
+        template<typename TChannel>
+        class LockFreeChannelSender;
+
+        /**
+         * \brief Used to safely share elements among threads, without locking on the send/receive path.
+         * \param TElement The type of elements to share.
+         * \param TBuffer The fixed-capacity buffer used to store sent elements that waits to be received. The
+         *     specified type have to implement at least try_push(), try_pop() and is_empty() methods, and have to be
+         *     constructible from a capacity (SpscRingBuffer and MpmcRingBuffer are both suitable as this template
+         *     parameter).
+         * \param TWaitPolicy Tells to the receivers how to wait for elements (BlockingWaitPolicy,
+         *     SpinThenParkWaitPolicy or BusyPollWaitPolicy).
+         * \sa SpscChannel
+         * \sa MpmcChannel
+         *
+         * It offers the same Receiver and Sender interfaces of the Channel class, but the elements are stored in a
+         * fixed-capacity lock-free buffer. \n
+         * The locks are taken only by threads that have to sleep: receivers waiting on an empty channel and
+         * senders waiting on a full channel. Waking them up is free when nobody sleeps. \n
+         * A ChannelListener (e.g. a Poller) can be notified of every send, to wait on many channels at once. \n
+         * All operation (even those of receiver and sender) are thread-safe, within the limits of TBuffer (an
+         * SpscChannel may have at most one sending and one receiving thread at a time). \n
+         * */
+        template <typename TElement, typename TBuffer = MpmcRingBuffer<TElement>,
+            typename TWaitPolicy = BlockingWaitPolicy>
+        class LockFreeChannel
+        {
+        public:
+            /**
+             *  brief The type of elements to share.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             *  brief The type of buffer where the sent (but not received yet) elements are stored.
+             * */
+            typedef TBuffer BufferType;
+
+            /**
+             *  brief The policy used by receivers to wait for elements.
+             * */
+            typedef TWaitPolicy WaitPolicyType;
+
+            /**
+             * \brief The type of the Receiver that interacts with this LockFreeChannel.
+             * */
+            typedef LockFreeChannelReceiver<LockFreeChannel<TElement, TBuffer, TWaitPolicy>> ReceiverType;
+
+            /**
+             * \brief The type of the Sender that interacts with this LockFreeChannel.
+             * */
+            typedef LockFreeChannelSender<LockFreeChannel<TElement, TBuffer, TWaitPolicy>> SenderType;
+
+            /**
+             * \brief Construct a LockFreeChannel object.
+             * \param capacity The (minimal) number of elements that can wait in the channel to be received. When
+             *     the channel is full, senders block until some element is received.
+             * \sa get_receiver()
+             * \sa get_sender()
+             * */
+            explicit LockFreeChannel(std::size_t capacity = 1024);
+
+            /**
+             * \brief Get the channel's receiver.
+             * \return The receiver.
+             * */
+            ReceiverType& get_receiver() noexcept;
+
+            /**
+             * \brief Get the channel's sender.
+             * \return The sender.
+             * */
+            SenderType& get_sender() noexcept;
+
+            /**
+             * \brief Wakes up all the threads that are waiting to receive an element via the Receiver object
+             *     owned by this LockFreeChannel object.
+             * */
+            void wake_up() noexcept;
+
+            /**
+             * \brief Get the number of sends that found the channel full.
+             * \return The number of blocked sends (those that waited and those that gave up).
+             * */
+            std::uint64_t get_blocked_count() const noexcept;
+
+            /**
+             * \brief Tells if the channel is (was, at the moment of the call) empty.
+             * \return True if there is no element to receive, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Sets the listener notified after every send (and receive).
+             * \param listener The listener (nullptr removes the current one).
+             * \return True if the listener was set, false if the channel already has another listener (that has to be
+             *     removed first).
+             *
+             * The listener can be changed only while nobody is sending into (or receiving from) the channel.
+             * */
+            bool set_listener(ChannelListener* listener) noexcept;
+
+        private:
+            /**
+             * \brief The channel's buffer.
+             * */
+            TBuffer buffer;
+
+            /**
+             * \brief Used to signal when the channel's buffer is no more empty.
+             * */
+            EventCount not_empty_event;
+
+            /**
+             * \brief Used to signal when the channel's buffer is no more full.
+             * */
+            EventCount not_full_event;
+
+            /**
+             * \brief Incremented on every wake_up() call, so that spinning receivers can notice it.
+             * */
+            std::atomic_uint wake_ups;
+
+            /**
+             * \brief The number of sends that found the channel full.
+             * */
+            std::atomic<std::uint64_t> blocked_count;
+
+            /**
+             * \brief The listener notified after every send and receive (if any).
+             * */
+            std::atomic<ChannelListener*> listener;
+
+            /**
+             * \brief The channel's Receiver object.
+             * */
+            ReceiverType receiver;
+
+            /**
+             * \brief The channel's Sender object.
+             * */
+            SenderType sender;
+
+            /**
+             * \brief Wakes up the receivers (one or all of them) and the listener, after elements were pushed.
+             * \param count The number of pushed elements.
+             * */
+            void notify_send(std::size_t count) noexcept;
+
+            friend ReceiverType;
+            friend SenderType;
+        };
+
+        /**
+         * \brief A LockFreeChannel with a wait-free single-producer/single-consumer ring buffer.
+         * \param TElement The type of elements to share.
+         * \param TWaitPolicy Tells to the receivers how to wait for elements.
+         * */
+        template<typename TElement, typename TWaitPolicy = BlockingWaitPolicy>
+        using SpscChannel = LockFreeChannel<TElement, SpscRingBuffer<TElement>, TWaitPolicy>;
+
+        /**
+         * \brief A LockFreeChannel with a lock-free multi-producer/multi-consumer ring buffer.
+         * \param TElement The type of elements to share.
+         * \param TWaitPolicy Tells to the receivers how to wait for elements.
+         * */
+        template<typename TElement, typename TWaitPolicy = BlockingWaitPolicy>
+        using MpmcChannel = LockFreeChannel<TElement, MpmcRingBuffer<TElement>, TWaitPolicy>;
+
+        /**
+         * \brief Receives elements from a LockFreeChannel.
+         * \param TChannel The type of LockFreeChannel from which it receives elements.
+         */
+        template<typename TChannel>
+        class LockFreeChannelReceiver final: public Receiver<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             *  brief The type of LockFreeChannel from which it receives elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             *  brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Tries to receive an element until a deadline.
+             * \param address The pointer to the address where the received element have to be moved.
+             * \param time The deadline.
+             * \return True if the element was received (and moved to the address passed as argument), false otherwise.
+             * \sa try_receive_until_1()
+             *
+             * The object will be moved to the address passed as argument and the method will return true. \n
+             * Otherwise, if there is no object to receive (until the specified time point), nothing will
+             * be moved to the passed address and the method will return false. \n
+             * */
+            bool try_receive_until_0(ElementType* address, const Deadline& time) override;
+
+            /**
+             * \brief Receives many elements at once, waiting until a deadline for the first one.
+             * \param address The address where the received elements are moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             *
+             * Senders waiting for space are notified once for the whole batch.
+             * */
+            std::size_t try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel from which it receives elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the receiver, that receives elements from a specified channel.
+             * \param channel The channel from which it receives elements.
+             * */
+            LockFreeChannelReceiver(ChannelType& channel) noexcept;
+
+            /**
+             * \brief Tries to pop (up to max) elements from the channel's buffer (without waiting).
+             * \param address The pointer to the address where the received elements have to be moved.
+             * \param max The maximal number of elements to pop.
+             * \return The number of popped elements.
+             * */
+            std::size_t try_pop(ElementType* address, std::size_t max);
+
+            /**
+             * \brief Tries to receive (up to max) elements until a deadline.
+             * \param address The pointer to the address where the received elements have to be moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             *
+             * The method waits (until the deadline) only for the first element. \n
+             * */
+            std::size_t try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time);
+
+            friend ChannelType;
+        };
+
+        /**
+         * \brief Send elements into a LockFreeChannel object.
+         * \param TChannel The type of LockFreeChannel in which sends elements.
+         * */
+        template<typename TChannel>
+        class LockFreeChannelSender final: public Sender<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             * \brief The type of LockFreeChannel in which sends elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             * \brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Send the element in the channel.
+             * \param element The element to send.
+             *
+             * If the channel is full, the method blocks until there is space for the element.
+             * */
+            void send(ElementType&& element) override;
+
+            /**
+             * \brief Send the element in the channel.
+             * \param element The element to send.
+             *
+             * If the channel is full, the method blocks until there is space for the element.
+             * */
+            void send(const ElementType& element) override;
+
+            /**
+             * \brief Send many elements in the channel.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * The receivers are notified once for the whole batch (or when the channel becomes full).
+             * */
+            void send_batch_0(ElementType* elements, std::size_t count) override;
+
+            /**
+             * \brief Tries to send the element, waiting for space until a deadline.
+             * \param element The address of the element to send (moved from there only if it was sent).
+             * \param time The deadline.
+             * \return True if the element was sent, false otherwise.
+             * */
+            bool try_send_until_0(ElementType* element, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel in which it sends elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the sender, that sends elements in a specified channel.
+             * \param channel The channel from in which sends elements.
+             * */
+            LockFreeChannelSender(ChannelType& channel) noexcept;
+
+            /**
+             * \brief Pushes the element in the channel's buffer, waiting while it is full (it does not notify the
+             *     receivers).
+             * \param element The element to send (forwarded to the buffer's try_push()).
+             * \param time The deadline until which it waits for space.
+             * \return True if the element was pushed, false if the deadline was reached.
+             * */
+            template<typename TForward>
+            bool push(TForward&& element, const Deadline& time);
+
+            friend ChannelType;
+        };
+    }
+}
+
+#include "ese/flow/template/lock-free-channel.txx"
+
+#endif
@@ -0,0 +1,31 @@
+
+#ifndef ESE_FLOW_LOCKROLE_HXX
+#define ESE_FLOW_LOCKROLE_HXX
+
+#include <cstddef>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells to a ProfiledMutex what the locking thread is doing, so that waits can be blamed on roles.
+         *
+         * SENDER and RECEIVER are the threads sending to and receiving from a channel. \n
+         * OTHER is anything else (e.g. a wake-up). \n
+         * */
+        enum class LockRole
+        {
+            OTHER,
+            SENDER,
+            RECEIVER
+        };
+
+        /**
+         * \brief The number of LockRole values.
+         * */
+        static constexpr std::size_t LOCK_ROLES_COUNT = 3;
+    }
+}
+
+#endif
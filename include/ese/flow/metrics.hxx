@@ -0,0 +1,478 @@
+
+#ifndef ESE_FLOW_METRICS_HXX
+#define ESE_FLOW_METRICS_HXX
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ese/flow/cache-line.hxx>
+
+/**
+ * \brief The number of stripes of a MetricCounter (threads are spread on them, so that they rarely share one).
+ * */
+#ifndef ESE_FLOW_METRIC_STRIPES
+#define ESE_FLOW_METRIC_STRIPES (16)
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief A counter incremented by many threads, each on its own stripe, and aggregated on read.
+         *
+         * An increment is a relaxed fetch_add on a cache line that (most of the times) only the calling thread
+         * writes: it does not bounce between the cores. \n
+         * */
+        class MetricCounter
+        {
+        public:
+            /**
+             * \brief Construct a counter set to zero.
+             * */
+            MetricCounter() noexcept;
+
+            MetricCounter(const MetricCounter&) = delete;
+
+            MetricCounter& operator=(const MetricCounter&) = delete;
+
+            /**
+             * \brief Increments the counter.
+             * \param count The increment.
+             * */
+            void add(std::uint64_t count = 1) noexcept;
+
+            /**
+             * \brief Get the value of the counter (the sum of the stripes).
+             * \return The value.
+             * */
+            std::uint64_t get() const noexcept;
+
+        private:
+            /**
+             * \brief A stripe, alone in its cache line.
+             * */
+            typedef struct alignas(ESE_FLOW_CACHE_LINE_SIZE) _Stripe_
+            {
+                /**
+                 * \brief The part of the value counted on this stripe.
+                 * */
+                std::atomic<std::uint64_t> value;
+            } Stripe;
+
+            /**
+             * \brief The stripes.
+             * */
+            Stripe stripes[ESE_FLOW_METRIC_STRIPES];
+        };
+
+        /**
+         * \brief A summary of a LatencyHistogram.
+         * */
+        typedef struct _LatencySummary_
+        {
+            /**
+             * \brief The number of recorded values.
+             * */
+            std::uint64_t count = 0;
+
+            /**
+             * \brief The mean value, in nanoseconds.
+             * */
+            double mean = 0;
+
+            /**
+             * \brief The median, in nanoseconds.
+             * */
+            std::uint64_t p50 = 0;
+
+            /**
+             * \brief The 90th percentile, in nanoseconds.
+             * */
+            std::uint64_t p90 = 0;
+
+            /**
+             * \brief The 99th percentile, in nanoseconds.
+             * */
+            std::uint64_t p99 = 0;
+
+            /**
+             * \brief The 99.9th percentile, in nanoseconds.
+             * */
+            std::uint64_t p999 = 0;
+
+            /**
+             * \brief The largest value, in nanoseconds.
+             * */
+            std::uint64_t max = 0;
+        } LatencySummary;
+
+        /**
+         * \brief A histogram of latencies, with log-linear buckets (as a HDR histogram).
+         *
+         * Every power of two is split into 16 linear buckets, so a percentile is reported with a relative error
+         * below 6.25%, from nanoseconds up to hours, in a fixed array of counters. \n
+         * Recording is wait-free (relaxed atomic increments): it is meant to be written by one thread (e.g. the
+         * thread of a consumer) and read by any other. \n
+         * */
+        class LatencyHistogram
+        {
+        public:
+            /**
+             * \brief The number of buckets.
+             * */
+            static constexpr std::size_t BUCKETS_COUNT = 16 + 60 * 16;
+
+            /**
+             * \brief Construct an empty histogram.
+             * */
+            LatencyHistogram() noexcept;
+
+            LatencyHistogram(const LatencyHistogram&) = delete;
+
+            LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+            /**
+             * \brief Records a value.
+             * \param nanoseconds The value.
+             * \param count The number of times the value is recorded.
+             * */
+            void record(std::uint64_t nanoseconds, std::uint64_t count = 1) noexcept;
+
+            /**
+             * \brief Get the number of recorded values.
+             * \return The number of values.
+             * */
+            std::uint64_t get_count() const noexcept;
+
+            /**
+             * \brief Get a percentile of the recorded values.
+             * \param percentile The percentile (between 0 and 100).
+             * \return The largest value of the bucket that contains the percentile (0 if the histogram is empty).
+             * */
+            std::uint64_t get_percentile(double percentile) const noexcept;
+
+            /**
+             * \brief Summarizes the histogram.
+             * \return The summary.
+             * */
+            LatencySummary get_summary() const noexcept;
+
+            /**
+             * \brief Get the bucket of a value.
+             * \param nanoseconds The value.
+             * \return The index of the bucket.
+             * */
+            static std::size_t get_bucket(std::uint64_t nanoseconds) noexcept;
+
+            /**
+             * \brief Get the largest value of a bucket.
+             * \param bucket The index of the bucket.
+             * \return The value.
+             * */
+            static std::uint64_t get_bucket_max(std::size_t bucket) noexcept;
+
+        private:
+            /**
+             * \brief The number of values of every bucket.
+             * */
+            std::atomic<std::uint64_t> buckets[BUCKETS_COUNT];
+
+            /**
+             * \brief The number of values.
+             * */
+            std::atomic<std::uint64_t> count;
+
+            /**
+             * \brief The sum of the values.
+             * */
+            std::atomic<std::uint64_t> sum;
+
+            /**
+             * \brief The largest value.
+             * */
+            std::atomic<std::uint64_t> max;
+        };
+
+        /**
+         * \brief The metrics of a Channel, read by Channel::get_metrics().
+         *
+         * Counters grow monotonically: rates are computed by the exporter, from the difference between two
+         * snapshots. \n
+         * */
+        typedef struct _ChannelMetrics_
+        {
+            /**
+             * \brief The number of enqueued elements.
+             * */
+            std::uint64_t enqueued = 0;
+
+            /**
+             * \brief The number of dequeued elements.
+             * */
+            std::uint64_t dequeued = 0;
+
+            /**
+             * \brief The number of elements in the channel.
+             * */
+            std::uint64_t depth = 0;
+
+            /**
+             * \brief The largest depth reached.
+             * */
+            std::uint64_t high_water_mark = 0;
+
+            /**
+             * \brief The number of elements dropped by the overflow policy.
+             * */
+            std::uint64_t dropped = 0;
+
+            /**
+             * \brief The number of sends that found the channel full.
+             * */
+            std::uint64_t blocked = 0;
+
+            /**
+             * \brief The number of times the mutex was found locked.
+             * */
+            std::uint64_t lock_contentions = 0;
+
+            /**
+             * \brief The time spent waiting for the mutex, in nanoseconds.
+             * */
+            std::uint64_t lock_wait_ns = 0;
+
+            /**
+             * \brief The number of receiver waits that ended while spinning (with an element).
+             * */
+            std::uint64_t spun_waits = 0;
+
+            /**
+             * \brief The number of receiver waits that ended in a sleep (parked, then woken with an element).
+             * */
+            std::uint64_t slept_waits = 0;
+
+            /**
+             * \brief The number of receiver waits that ended with no element (timeout or wake_up()).
+             * */
+            std::uint64_t timed_out_waits = 0;
+        } ChannelMetrics;
+
+        /**
+         * \brief The counters of a Channel (present only when ESE_FLOW_METRICS is defined).
+         * */
+        typedef struct _ChannelCounters_
+        {
+            /**
+             * \brief The number of enqueued elements.
+             * */
+            MetricCounter enqueued;
+
+            /**
+             * \brief The number of dequeued elements.
+             * */
+            MetricCounter dequeued;
+
+            /**
+             * \brief The number of times the mutex was found locked.
+             * */
+            MetricCounter lock_contentions;
+
+            /**
+             * \brief The time spent waiting for the mutex, in nanoseconds.
+             * */
+            MetricCounter lock_wait_ns;
+
+            /**
+             * \brief The number of receiver waits that ended while spinning.
+             * */
+            MetricCounter spun_waits;
+
+            /**
+             * \brief The number of receiver waits that ended in a sleep.
+             * */
+            MetricCounter slept_waits;
+
+            /**
+             * \brief The number of receiver waits that ended with no element.
+             * */
+            MetricCounter timed_out_waits;
+
+            /**
+             * \brief The largest depth reached (updated under the mutex of the channel).
+             * */
+            std::atomic<std::uint64_t> high_water_mark{0};
+        } ChannelCounters;
+
+        /**
+         * \brief The metrics of a Consumer, read by Consumer::get_metrics().
+         * */
+        typedef struct _ConsumerMetrics_
+        {
+            /**
+             * \brief The number of consumed elements.
+             * */
+            std::uint64_t consumed = 0;
+
+            /**
+             * \brief The time spent consuming an element (in consume_0(), or its share of an overriding
+             *     consume_batch_0() call).
+             * */
+            LatencySummary latency;
+        } ConsumerMetrics;
+
+        /**
+         * \brief The counters of a Consumer (present only when ESE_FLOW_METRICS is defined).
+         * */
+        typedef struct _ConsumerCounters_
+        {
+            /**
+             * \brief The number of consumed elements (only the thread of the consumer writes it, it is not striped).
+             * */
+            std::atomic<std::uint64_t> consumed{0};
+
+            /**
+             * \brief The time spent consuming every element.
+             * */
+            LatencyHistogram latency;
+        } ConsumerCounters;
+
+        /**
+         * \brief The metrics of the Thread objects.
+         * */
+        typedef struct _ThreadMetrics_
+        {
+            /**
+             * \brief The number of running threads (see Thread::get_native_running_count()).
+             * */
+            std::uint64_t running = 0;
+
+            /**
+             * \brief The number of threads started since the program started (see Thread::get_started_count()).
+             * */
+            std::uint64_t started = 0;
+        } ThreadMetrics;
+
+        /**
+         * \brief The metrics of all the registered objects, at a point in time.
+         * \sa MetricsRegistry::snapshot()
+         * */
+        typedef struct _MetricsSnapshot_
+        {
+            /**
+             * \brief When the snapshot was taken.
+             * */
+            std::chrono::steady_clock::time_point time;
+
+            /**
+             * \brief The metrics of the channels, by name.
+             * */
+            std::map<std::string, ChannelMetrics> channels;
+
+            /**
+             * \brief The metrics of the consumers, by name.
+             * */
+            std::map<std::string, ConsumerMetrics> consumers;
+
+            /**
+             * \brief The metrics of the threads.
+             * */
+            ThreadMetrics threads;
+
+            /**
+             * \brief Flattens the snapshot into (name, value) samples, for exporters.
+             * \return The samples, named as "channel.<name>.enqueued", "consumer.<name>.latency.p99",
+             *     "threads.running" and so on.
+             * */
+            std::vector<std::pair<std::string, double>> get_samples() const;
+        } MetricsSnapshot;
+
+        /**
+         * \brief The named objects whose metrics are exported together.
+         *
+         * Channels and consumers are registered by reference: they have to be removed before being destroyed (or
+         * moved). Without ESE_FLOW_METRICS the registry still works, but only thread metrics are available. \n
+         * All the methods are thread-safe. \n
+         * */
+        class MetricsRegistry
+        {
+        public:
+            /**
+             * \brief Get the registry of the program.
+             * \return The registry.
+             * */
+            static MetricsRegistry& get_default();
+
+            /**
+             * \brief Registers a channel.
+             * \param name The name of the channel (replaces any channel with the same name).
+             * \param source Returns the metrics of the channel.
+             * */
+            void add_channel(const std::string& name, std::function<ChannelMetrics()> source);
+
+            /**
+             * \brief Registers a channel (requires ESE_FLOW_METRICS).
+             * \param name The name of the channel.
+             * \param channel The channel (a Channel, or any object with a get_metrics() method). A callable is
+             *     registered by the other overload only if it is passed as a std::function.
+             * */
+            template<typename TChannel>
+            void add_channel(const std::string& name, const TChannel& channel);
+
+            /**
+             * \brief Registers a consumer.
+             * \param name The name of the consumer (replaces any consumer with the same name).
+             * \param source Returns the metrics of the consumer.
+             * */
+            void add_consumer(const std::string& name, std::function<ConsumerMetrics()> source);
+
+            /**
+             * \brief Registers a consumer (requires ESE_FLOW_METRICS).
+             * \param name The name of the consumer.
+             * \param consumer The consumer (a Consumer, or any object with a get_metrics() method). A callable is
+             *     registered by the other overload only if it is passed as a std::function.
+             * */
+            template<typename TConsumer>
+            void add_consumer(const std::string& name, const TConsumer& consumer);
+
+            /**
+             * \brief Removes a channel or a consumer.
+             * \param name The name.
+             * */
+            void remove(const std::string& name);
+
+            /**
+             * \brief Reads the metrics of all the registered objects.
+             * \return The snapshot.
+             * */
+            MetricsSnapshot snapshot() const;
+
+        private:
+            /**
+             * \brief Protects the sources.
+             * */
+            mutable std::mutex mutex;
+
+            /**
+             * \brief The registered channels.
+             * */
+            std::map<std::string, std::function<ChannelMetrics()>> channels;
+
+            /**
+             * \brief The registered consumers.
+             * */
+            std::map<std::string, std::function<ConsumerMetrics()>> consumers;
+        };
+    }
+}
+
+#include "template/metrics.txx"
+
+#endif
@@ -0,0 +1,30 @@
+
+#ifndef ESE_FLOW_OVERFLOWPOLICY_HXX
+#define ESE_FLOW_OVERFLOWPOLICY_HXX
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells to a bounded channel what to do with an element sent while the channel is full.
+         *
+         * BLOCK makes the sender wait until there is space (try_send() waits only until its deadline). \n
+         * DROP_NEWEST discards the sent element. \n
+         * DROP_OLDEST discards the element that would be received next, to make space for the sent one. \n
+         * SAMPLE keeps only one of every "sample period" overflowing elements (in place of the element that would
+         * be received next) and discards the others. \n
+         * The senders never wait with a policy other than BLOCK. DROP_OLDEST and SAMPLE require a FIFO queue: in a
+         * priority queue the element received next is not the oldest one. \n
+         * */
+        enum class OverflowPolicy
+        {
+            BLOCK,
+            DROP_NEWEST,
+            DROP_OLDEST,
+            SAMPLE
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,235 @@
+
+#ifndef ESE_FLOW_PARALLELFILTER_HXX
+#define ESE_FLOW_PARALLELFILTER_HXX
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <ese/flow/executor.hxx>
+#include <ese/flow/filter.hxx>
+#include <ese/flow/lambda-executable.hxx>
+#include <ese/flow/sender.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells to a ParallelFilter in which order the filtered elements of a batch are forwarded.
+         *
+         * ORDERED forwards the whole filtered batch at once, in the order of the sent elements. \n
+         * UNORDERED lets every worker forward its slice as soon as it is filtered (the specified sender has to be
+         * thread-safe): slices of the same batch can arrive in any order. \n
+         * */
+        enum class ParallelOrder
+        {
+            ORDERED,
+            UNORDERED
+        };
+
+        /**
+         * \brief A Sender implementation that filters the sent batches in parallel, on an Executor.
+         * \tparam TIn The type of sent elements before filtering.
+         * \tparam TOut The type of sent elements after filtering (it have to be default constructible and move
+         *     assignable).
+         *
+         * It is like a FilterSender, but every batch sent via send_batch_0() is split in up to "parallelism" slices,
+         * filtered by as many executables submitted to the executor (e.g. a ThreadPoolExecutor), while the calling
+         * thread filters the first slice itself. send_batch_0() returns when the whole batch was filtered and
+         * forwarded. send_batch() passes at most ESE_FLOW_BATCH_CHUNK_SIZE elements at a time: cheaper filters
+         * scale better with bigger batches, sent directly via send_batch_0(). \n
+         * Every slice is filtered by its own filter instance, created by a factory: filters that are not
+         * thread-safe can be used this way. Otherwise, a single (thread-safe) filter can be shared by all slices. \n
+         * Single elements are filtered on the calling thread. Sending is serialized: concurrent senders wait for each
+         * other. If a filter throws, the exception is re-thrown by send_batch_0() once every slice finished (in
+         * ORDERED mode, nothing of that batch is forwarded). \n
+         * The sending methods must not be called by an executable running on the same executor.
+         * */
+        template<typename TIn, typename TOut>
+        class ParallelFilter: public Sender<TIn>
+        {
+        public:
+            /**
+             * \brief The type of sent elements before filtering.
+             * */
+            typedef TIn InType;
+
+            /**
+             * \brief The type of sent elements after filtering.
+             * */
+            typedef TOut OutType;
+
+            /**
+             * \brief The type of the filters that filter sent elements.
+             * */
+            typedef Filter<TIn, TOut> FilterType;
+
+            /**
+             * \brief The type of sender that will receive the forwarded elements.
+             * */
+            typedef Sender<TOut> SenderType;
+
+            /**
+             * \brief The type of the executor that filters the slices.
+             * */
+            typedef Executor<LambdaExecutable> ExecutorType;
+
+            /**
+             * \brief Construct a ParallelFilter object, whose slices share the same (thread-safe) filter.
+             * \param executor The executor that filters the slices.
+             * \param parallelism The maximal number of slices of a batch.
+             * \param filter The filter that filters sent elements.
+             * \param sender The sender that will receive the forwarded elements.
+             * \param order The order in which filtered elements are forwarded.
+             * \param min_slice_size The minimal number of elements of a slice (smaller batches use less slices).
+             * */
+            ParallelFilter(ExecutorType* executor, std::size_t parallelism, FilterType* filter, SenderType* sender,
+                ParallelOrder order = ParallelOrder::ORDERED, std::size_t min_slice_size = 1);
+
+            /**
+             * \brief Construct a ParallelFilter object, whose slices have their own filter instances.
+             * \param executor The executor that filters the slices.
+             * \param parallelism The maximal number of slices of a batch (and the number of filter instances).
+             * \param factory Called "parallelism" times, to create the filter instances.
+             * \param sender The sender that will receive the forwarded elements.
+             * \param order The order in which filtered elements are forwarded.
+             * \param min_slice_size The minimal number of elements of a slice (smaller batches use less slices).
+             * */
+            ParallelFilter(ExecutorType* executor, std::size_t parallelism,
+                const std::function<std::unique_ptr<FilterType>()>& factory, SenderType* sender,
+                ParallelOrder order = ParallelOrder::ORDERED, std::size_t min_slice_size = 1);
+
+            /**
+             * \brief Empty implementation.
+             * */
+            virtual ~ParallelFilter() noexcept;
+
+            /**
+             * \brief Send the element.
+             * \param element The element to send.
+             *
+             * It forwards the filtered element to the specified sender (the element is filtered on the calling
+             * thread).
+             * */
+            void send(TIn&& element) override;
+
+            /**
+             * \brief Send the element.
+             * \param element The element to send.
+             *
+             * It forwards the filtered element to the specified sender (the element is filtered on the calling
+             * thread).
+             * */
+            void send(const TIn& element) override;
+
+            /**
+             * \brief Send many elements at once.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * The elements are filtered in parallel slices and forwarded to the specified sender.
+             * */
+            void send_batch_0(TIn* elements, std::size_t count) override;
+
+            /**
+             * \brief Tries to send the element, waiting for space until a deadline.
+             * \param element The address of the element to send.
+             * \param time The deadline.
+             * \return True if the filtered element was sent, false otherwise.
+             *
+             * The element is filtered as a constant reference (so it is left untouched when the specified sender
+             * refuses the filtered one), on the calling thread.
+             * */
+            bool try_send_until_0(TIn* element, const Deadline& time) override;
+
+            /**
+             * \brief Get the maximal number of slices of a batch.
+             * \return The parallelism.
+             * */
+            std::size_t get_parallelism() const noexcept;
+
+        private:
+            /**
+             * \brief The executor that filters the slices.
+             * */
+            ExecutorType* executor;
+
+            /**
+             * \brief The filters used by the slices (the i-th slice uses the i-th filter).
+             * */
+            std::vector<FilterType*> filters;
+
+            /**
+             * \brief The filter instances created by the factory (if any).
+             * */
+            std::vector<std::unique_ptr<FilterType>> owned_filters;
+
+            /**
+             * \brief The sender that will receive the forwarded elements.
+             * */
+            SenderType* sender;
+
+            /**
+             * \brief The order in which filtered elements are forwarded.
+             * */
+            const ParallelOrder order;
+
+            /**
+             * \brief The minimal number of elements of a slice.
+             * */
+            const std::size_t min_slice_size;
+
+            /**
+             * \brief Serializes the senders.
+             * */
+            std::mutex send_mutex;
+
+            /**
+             * \brief The filtered elements of the current batch (ORDERED mode only).
+             * */
+            std::vector<TOut> output;
+
+            /**
+             * \brief The exceptions thrown by the slices of the current batch.
+             * */
+            std::vector<std::exception_ptr> errors;
+
+            /**
+             * \brief Mutex used (with finished_condition_variable) to wait for the slices.
+             * */
+            std::mutex slices_mutex;
+
+            /**
+             * \brief Condition variable used to signal when every slice of the batch was filtered.
+             * */
+            std::condition_variable finished_condition_variable;
+
+            /**
+             * \brief The number of slices of the current batch that are still running (protected by slices_mutex).
+             * */
+            std::size_t running_slices;
+
+            /**
+             * \brief Filters (and, in UNORDERED mode, forwards) a slice of the current batch.
+             * \param index The index of the slice.
+             * \param elements The address of the first element of the slice.
+             * \param offset The position of the slice in the batch.
+             * \param count The number of elements of the slice.
+             * */
+            void filter_slice(std::size_t index, TIn* elements, std::size_t offset, std::size_t count) noexcept;
+
+            /**
+             * \brief Marks the end of a slice.
+             * */
+            void finish_slice();
+        };
+    }
+}
+
+#include "template/parallel-filter.txx"
+
+#endif
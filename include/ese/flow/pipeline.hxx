@@ -0,0 +1,552 @@
+
+#ifndef ESE_FLOW_PIPELINE_HXX
+#define ESE_FLOW_PIPELINE_HXX
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/cpu-topology.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/filter.hxx>
+#include <ese/flow/lambda-executable.hxx>
+#include <ese/flow/receiver.hxx>
+#include <ese/flow/sender.hxx>
+#include <ese/flow/small-function.hxx>
+#include <ese/flow/thread.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        class Pipeline;
+
+        class RunningPipeline;
+
+        /**
+         * \brief A filter that starts a new stage of a Pipeline, run by a specified number of threads.
+         * \tparam TIn The type of input elements.
+         * \tparam TOut The type of output elements.
+         * \sa parallel()
+         * \sa stage()
+         *
+         * The first filter of the stage is either shared by all its threads, or created for each thread by a
+         * factory. \n
+         * */
+        template<typename TIn, typename TOut>
+        class ParallelStage
+        {
+        public:
+            /**
+             * \brief The type of the factories that create the filter of each thread.
+             * */
+            typedef std::function<std::unique_ptr<Filter<TIn, TOut>>()> FactoryType;
+
+            /**
+             * \brief Construct the stage, whose threads share the same filter.
+             * \param parallelism The number of threads that run the stage.
+             * \param filter The first filter of the stage.
+             * */
+            ParallelStage(std::size_t parallelism, Filter<TIn, TOut>* filter) noexcept;
+
+            /**
+             * \brief Construct the stage, whose threads have their own filter.
+             * \param parallelism The number of threads that run the stage.
+             * \param factory Called once for each thread, to create its filter.
+             * */
+            ParallelStage(std::size_t parallelism, FactoryType factory);
+
+            /**
+             * \brief The number of threads that run the stage.
+             * */
+            const std::size_t parallelism;
+
+            /**
+             * \brief The first filter of the stage (nullptr if created by the factory).
+             * */
+            Filter<TIn, TOut>* const filter;
+
+            /**
+             * \brief The factory of the first filter of each thread (empty if the filter is shared).
+             * */
+            const FactoryType factory;
+        };
+
+        /**
+         * \brief A filter without mutable state, that a Pipeline can fuse into a stage run by many threads.
+         * \tparam TIn The type of input elements.
+         * \tparam TOut The type of output elements.
+         * \sa stateless()
+         * */
+        template<typename TIn, typename TOut>
+        class StatelessFilter
+        {
+        public:
+            /**
+             * \brief Construct the wrapper.
+             * \param filter The filter (it have to be thread-safe).
+             * */
+            explicit StatelessFilter(Filter<TIn, TOut>* filter) noexcept;
+
+            /**
+             * \brief The filter.
+             * */
+            Filter<TIn, TOut>* const filter;
+        };
+
+        /**
+         * \brief Starts a new pipeline stage, run by the specified number of threads that share the same filter.
+         * \param parallelism The number of threads (the filter has to be thread-safe when greater than one).
+         * \param filter The first filter of the stage.
+         * \return The stage, to append to a Pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        ParallelStage<TIn, TOut> parallel(std::size_t parallelism, Filter<TIn, TOut>& filter) noexcept;
+
+        /**
+         * \brief Starts a new pipeline stage, run by the specified number of threads that have their own filter.
+         * \tparam TFactory The type of the factory (a callable that returns a std::unique_ptr to a Filter).
+         * \tparam TFilter The type of the created filters.
+         * \param parallelism The number of threads.
+         * \param factory Called once for each thread, to create its filter (that does not need to be thread-safe).
+         * \return The stage, to append to a Pipeline.
+         * */
+        template<typename TFactory,
+            typename TFilter = typename std::decay<decltype(*std::declval<TFactory&>()())>::type>
+        ParallelStage<typename TFilter::InType, typename TFilter::OutType> parallel(std::size_t parallelism,
+            TFactory factory);
+
+        /**
+         * \brief Marks a filter as stateless, so that it is fused into the last stage even when that stage is run by
+         *     many threads.
+         * \param filter The filter (it have to be thread-safe).
+         * \return The wrapper, to append to a Pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        StatelessFilter<TIn, TOut> stateless(Filter<TIn, TOut>& filter) noexcept;
+
+        /**
+         * \brief Starts a new pipeline stage, run by a single thread.
+         * \param filter The first filter of the stage.
+         * \return The stage, to append to a Pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        ParallelStage<TIn, TOut> stage(Filter<TIn, TOut>& filter) noexcept;
+
+        /**
+         * \brief The resources of a pipeline: its channels, fused senders, stages and thread bodies.
+         *
+         * Used internally by Pipeline and RunningPipeline.
+         * */
+        class PipelineState
+        {
+        public:
+            /**
+             * \brief The control block of a stage, that listens to its input channel.
+             * */
+            typedef struct _Stage_: public ChannelListener
+            {
+                /**
+                 * \brief The number of running threads of the stage.
+                 * */
+                std::atomic_int running;
+
+                /**
+                 * \brief The stage that feeds this one (nullptr for the stage that receives from the source).
+                 * */
+                const _Stage_* upstream;
+
+                /**
+                 * \brief The number of threads that run the stage.
+                 * */
+                const std::size_t parallelism;
+
+                /**
+                 * \brief True if the input notifies input_event (otherwise the threads poll the input).
+                 * */
+                bool listening;
+
+                /**
+                 * \brief Notified when elements are sent to the input, and when the input finished.
+                 * */
+                EventCount input_event;
+
+                /**
+                 * \brief Removes the stage from the listeners of its input (empty for the channels between stages).
+                 * */
+                SmallFunction<void()> detach;
+
+                /**
+                 * \brief Construct a stage with no running threads.
+                 * \param upstream The stage that feeds this one.
+                 * \param parallelism The number of threads that run the stage.
+                 * */
+                _Stage_(const _Stage_* upstream, std::size_t parallelism) noexcept;
+
+                /**
+                 * \brief Removes the stage from the listeners of its input.
+                 * */
+                ~_Stage_() noexcept;
+
+                /**
+                 * \brief Wakes up the threads parked on the input.
+                 * */
+                void on_send() noexcept override;
+            } Stage;
+
+            /**
+             * \brief Construct the state of an empty pipeline.
+             * \param channel_capacity The capacity of the channels between stages.
+             * \param poll_interval How often the first stage checks if the pipeline was stopped, when its source is not
+             *     a channel.
+             * */
+            PipelineState(std::size_t channel_capacity, std::chrono::milliseconds poll_interval);
+
+            /**
+             * \brief The capacity of the channels between stages.
+             * */
+            const std::size_t channel_capacity;
+
+            /**
+             * \brief How often the first stage checks if the pipeline was stopped, when its source is not a channel.
+             * */
+            const std::chrono::milliseconds poll_interval;
+
+            /**
+             * \brief Set by RunningPipeline::stop().
+             * */
+            std::atomic_bool stop_requested;
+
+            /**
+             * \brief Channels and fused senders, owned by the pipeline.
+             * */
+            std::vector<std::shared_ptr<void>> resources;
+
+            /**
+             * \brief The stages.
+             * */
+            std::vector<std::unique_ptr<Stage>> stages;
+
+            /**
+             * \brief The bodies of the threads, started when the pipeline is connected to its sink.
+             * */
+            std::vector<LambdaExecutable> bodies;
+
+            /**
+             * \brief Creates a new stage.
+             * \param upstream The stage that feeds the new one.
+             * \param parallelism The number of threads that run the new stage.
+             * \return The new stage.
+             * */
+            Stage* add_stage(const Stage* upstream, std::size_t parallelism);
+
+            /**
+             * \brief Tells if a stage will not receive any other element from its input.
+             * \param stage The stage.
+             * \return True if the upstream stage finished (or, for the first stage, if the pipeline was stopped).
+             * */
+            bool is_input_finished(const Stage& stage) const noexcept;
+
+            /**
+             * \brief Marks the exit of a stage's thread (the last one wakes up the downstream stage).
+             * \param stage The stage.
+             * */
+            void finish_thread(Stage& stage);
+        };
+
+        /**
+         * \brief A pipeline under construction, whose last stage outputs elements of type TElement.
+         * \tparam TElement The type of the elements output by the pipeline.
+         * \sa pipeline()
+         *
+         * Pipelines are built with the | operator: pipeline(source) | filter_a | filter_b | parallel(4, filter_c) |
+         * sink. \n
+         * Adjacent filters are fused into the same stage: they are called one after the other by the stage's threads,
+         * without any queue between them. A new stage (with its own threads, fed by a bounded Channel) is started by
+         * parallel() and stage(). A filter that follows a parallel(n, ...) stage (n > 1) would be called by n threads,
+         * so it is fused only if marked via stateless(): otherwise it gets a new stage, run by a single thread.
+         * Parallel stages do not preserve the order of elements. \n
+         * Every stage is the ChannelListener of its input channel: its idle threads park until elements are sent, or
+         * until the previous stage finished. The first stage parks in the same way (and is woken up by stop()) only
+         * if built from a channel: a first stage that receives from any other Receiver polls it. \n
+         * Connecting the pipeline to the sink (a thread-safe Sender) starts all its threads and returns the
+         * RunningPipeline. \n
+         * */
+        template<typename TElement>
+        class Pipeline
+        {
+        public:
+            /**
+             * \brief The type of the elements output by the pipeline.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief Construct a pipeline whose first stage polls the specified source.
+             * \param source The receiver from which the pipeline takes its elements.
+             * \param channel_capacity The capacity of the channels between stages.
+             * \param poll_interval How often the first stage checks if the pipeline was stopped.
+             * */
+            explicit Pipeline(Receiver<TElement>& source, std::size_t channel_capacity = 1024,
+                std::chrono::milliseconds poll_interval = std::chrono::milliseconds(10));
+
+            /**
+             * \brief Construct a pipeline whose first stage receives elements from the specified channel, becoming its
+             *     listener.
+             * \tparam TChannel The type of the channel (any channel with get_receiver() and set_listener() methods).
+             * \param source The channel from which the pipeline takes its elements (it have to outlive the pipeline).
+             * \param channel_capacity The capacity of the channels between stages.
+             * \throw std::logic_error If the channel already has another listener.
+             *
+             * The pipeline can be built only while nobody is sending into the channel.
+             * */
+            template<typename TChannel, typename = decltype(std::declval<TChannel&>().set_listener(nullptr))>
+            explicit Pipeline(TChannel& source, std::size_t channel_capacity = 1024);
+
+            Pipeline(Pipeline&&) = default;
+
+            /**
+             * \brief Appends a filter to the last stage (fusing it with the previous filters) if that stage is run by
+             *     a single thread, otherwise to a new single-threaded stage.
+             * \param filter The filter.
+             * \return The extended pipeline (this one is left empty).
+             * */
+            template<typename TNext>
+            Pipeline<TNext> then(Filter<TElement, TNext>& filter);
+
+            /**
+             * \brief Appends a stateless filter to the last stage (fusing it with the previous filters).
+             * \param filter The filter.
+             * \return The extended pipeline (this one is left empty).
+             * */
+            template<typename TNext>
+            Pipeline<TNext> then(const StatelessFilter<TElement, TNext>& filter);
+
+            /**
+             * \brief Appends a new stage, fed by a channel.
+             * \param stage The stage.
+             * \return The extended pipeline (this one is left empty).
+             * */
+            template<typename TNext>
+            Pipeline<TNext> then(const ParallelStage<TElement, TNext>& stage);
+
+            /**
+             * \brief Connects the pipeline to its sink and starts the threads.
+             * \param sink The sender that receives the output of the pipeline (it have to be thread-safe).
+             * \return The running pipeline (this one is left empty).
+             * */
+            RunningPipeline into(Sender<TElement>& sink);
+
+            /**
+             * \brief Connects the pipeline to its sink and starts the threads, laid out on the CPUs.
+             * \param sink The sender that receives the output of the pipeline (it have to be thread-safe).
+             * \param topology The CPUs on which the threads are laid out (in stage order: see CpuTopology::layout()).
+             * \return The running pipeline (this one is left empty).
+             *
+             * Every thread is bound to a core and to its NUMA node, and it is named "flow-" followed by its index.
+             * Adjacent stages share a node, so the buffers of the channel between them (allocated by the sending
+             * stage) are local to both. \n
+             * */
+            RunningPipeline into(Sender<TElement>& sink, const CpuTopology& topology);
+
+        private:
+            /**
+             * \brief The resources of the pipeline.
+             * */
+            std::unique_ptr<PipelineState> state;
+
+            /**
+             * \brief The last (still open) stage.
+             * */
+            PipelineState::Stage* stage;
+
+            /**
+             * \brief Closes the last stage, so that it sends its output into the specified sender.
+             * */
+            SmallFunction<void(Sender<TElement>*)> close;
+
+            /**
+             * \brief Construct a pipeline from its parts.
+             * */
+            Pipeline(std::unique_ptr<PipelineState>&& state, PipelineState::Stage* stage,
+                SmallFunction<void(Sender<TElement>*)>&& close) noexcept;
+
+            /**
+             * \brief Appends a filter to the last stage.
+             * \param filter The filter.
+             * \return The extended pipeline (this one is left empty).
+             * */
+            template<typename TNext>
+            Pipeline<TNext> fuse(Filter<TElement, TNext>* filter);
+
+            /**
+             * \brief Adds the body of a stage's thread, that receives from the input and sends to the output.
+             * \param state The resources of the pipeline.
+             * \param stage The stage.
+             * \param input The input of the stage.
+             * \param output The output of the thread.
+             * */
+            static void add_body(PipelineState* state, PipelineState::Stage* stage, Receiver<TElement>* input,
+                Sender<TElement>* output);
+
+            template<typename TOther>
+            friend class Pipeline;
+        };
+
+        /**
+         * \brief A pipeline whose threads are running.
+         *
+         * Destroying the object stops the pipeline and waits for its threads.
+         * */
+        class RunningPipeline
+        {
+        public:
+            /**
+             * \brief Construct the running pipeline and starts its threads.
+             * \param state The resources of the pipeline.
+             * \param options The options of the threads, in stage order (threads with no options are not placed).
+             * */
+            explicit RunningPipeline(std::unique_ptr<PipelineState>&& state,
+                std::vector<ThreadOptions> options = std::vector<ThreadOptions>());
+
+            RunningPipeline(RunningPipeline&&) = default;
+
+            /**
+             * \brief Stops the pipeline and waits for its threads.
+             * \sa stop()
+             * \sa join()
+             * */
+            ~RunningPipeline();
+
+            /**
+             * \brief Requires the pipeline to stop (and wakes up the first stage, if it listens to its channel).
+             *
+             * The first stage stops when the source has nothing more to receive. Every other stage stops once it
+             * processed all the elements sent by the previous one, so no received element is lost.
+             * */
+            void stop() noexcept;
+
+            /**
+             * \brief Waits until all the threads of the pipeline exit (they exit only after a stop() call).
+             * */
+            void join();
+
+            /**
+             * \brief Get the number of stages (each stage has its own threads and is fed by a channel, except the
+             *     first one).
+             * \return The number of stages.
+             * */
+            std::size_t get_stages_count() const noexcept;
+
+            /**
+             * \brief Get the number of threads of the pipeline.
+             * \return The number of threads.
+             * */
+            std::size_t get_threads_count() const noexcept;
+
+        private:
+            /**
+             * \brief The resources of the pipeline.
+             * */
+            std::unique_ptr<PipelineState> state;
+
+            /**
+             * \brief The threads of the pipeline.
+             * */
+            std::vector<std::unique_ptr<Thread>> threads;
+        };
+
+        /**
+         * \brief Starts the construction of a pipeline, that polls its source.
+         * \param source The receiver from which the pipeline takes its elements.
+         * \param channel_capacity The capacity of the channels between stages.
+         * \return The pipeline.
+         * */
+        template<typename TElement>
+        Pipeline<TElement> pipeline(Receiver<TElement>& source, std::size_t channel_capacity = 1024);
+
+        /**
+         * \brief Starts the construction of a pipeline, that becomes the listener of its source channel.
+         * \tparam TChannel The type of the channel (any channel with get_receiver() and set_listener() methods).
+         * \param source The channel from which the pipeline takes its elements.
+         * \param channel_capacity The capacity of the channels between stages.
+         * \return The pipeline.
+         * \throw std::logic_error If the channel already has another listener.
+         * */
+        template<typename TChannel, typename = decltype(std::declval<TChannel&>().set_listener(nullptr))>
+        Pipeline<typename TChannel::ElementType> pipeline(TChannel& source, std::size_t channel_capacity = 1024);
+
+        /**
+         * \brief Starts a pipeline that receives elements from the source and filters them.
+         * \param source The receiver from which the pipeline takes its elements.
+         * \param filter The filter.
+         * \return The pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Receiver<TIn>& source, Filter<TIn, TOut>& filter);
+
+        /**
+         * \brief Starts a pipeline that receives elements from the source and filters them with a stateless filter.
+         * \param source The receiver from which the pipeline takes its elements.
+         * \param filter The filter.
+         * \return The pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Receiver<TIn>& source, const StatelessFilter<TIn, TOut>& filter);
+
+        /**
+         * \brief Starts a pipeline that receives elements from the source and passes them to a new stage.
+         * \param source The receiver from which the pipeline takes its elements.
+         * \param stage The stage.
+         * \return The pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Receiver<TIn>& source, const ParallelStage<TIn, TOut>& stage);
+
+        /**
+         * \brief Appends a filter to the last stage of the pipeline.
+         * \param pipeline The pipeline.
+         * \param filter The filter.
+         * \return The extended pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Pipeline<TIn>&& pipeline, Filter<TIn, TOut>& filter);
+
+        /**
+         * \brief Appends a stateless filter to the last stage of the pipeline.
+         * \param pipeline The pipeline.
+         * \param filter The filter.
+         * \return The extended pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Pipeline<TIn>&& pipeline, const StatelessFilter<TIn, TOut>& filter);
+
+        /**
+         * \brief Appends a stage to the pipeline.
+         * \param pipeline The pipeline.
+         * \param stage The stage.
+         * \return The extended pipeline.
+         * */
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Pipeline<TIn>&& pipeline, const ParallelStage<TIn, TOut>& stage);
+
+        /**
+         * \brief Connects the pipeline to its sink and starts it.
+         * \param pipeline The pipeline.
+         * \param sink The sender that receives the output of the pipeline.
+         * \return The running pipeline.
+         * */
+        template<typename TElement>
+        RunningPipeline operator|(Pipeline<TElement>&& pipeline, Sender<TElement>& sink);
+    }
+}
+
+#include "template/pipeline.txx"
+
+#endif
@@ -0,0 +1,171 @@
+
+#ifndef ESE_FLOW_POLLER_HXX
+#define ESE_FLOW_POLLER_HXX
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/deadline.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/small-function.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Waits until any of a set of channels has elements to receive.
+         *
+         * Channels (Channel, LockFreeChannel and their variants) are added via add(): the poller becomes their
+         * ChannelListener, so senders wake it up through a single EventCount, and nobody spins while all the
+         * channels are empty. \n
+         * The wait methods return the index of a ready channel (as returned by add()), whose receiver can then be
+         * used without blocking. Ready channels are served in round-robin order: a channel added with weight w is
+         * returned up to w times in a row (while it stays ready) before the next ready channel gets its turn. \n
+         * A poller is used by one thread at a time. Channels can be added only while nobody is sending into them,
+         * and the poller can be destroyed only after the senders stopped. \n
+         * */
+        class Poller: private ChannelListener
+        {
+        public:
+            /**
+             * \brief The index returned when no channel is ready.
+             * */
+            static const std::size_t NONE = static_cast<std::size_t>(-1);
+
+            /**
+             * \brief Construct a poller, with no channels.
+             * */
+            Poller();
+
+            Poller(const Poller&) = delete;
+
+            Poller& operator=(const Poller&) = delete;
+
+            /**
+             * \brief Removes the poller from the listeners of its channels.
+             * */
+            virtual ~Poller();
+
+            /**
+             * \brief Adds a channel to the poller.
+             * \param channel The channel (it have to outlive the poller).
+             * \param weight How many times in a row the channel can be returned, while it stays ready.
+             * \return The index of the channel.
+             * \throw std::logic_error If the channel already has another listener (e.g. another poller).
+             * */
+            template<typename TChannel>
+            std::size_t add(TChannel& channel, unsigned weight = 1);
+
+            /**
+             * \brief Get the index of a ready channel, without waiting.
+             * \return The index of the channel, or NONE if no channel is ready.
+             * */
+            std::size_t poll();
+
+            /**
+             * \brief Waits until a channel is ready (or wake_up() is called).
+             * \return The index of the channel, or NONE if woken up.
+             * */
+            std::size_t wait();
+
+            /**
+             * \brief Waits until a channel is ready, or until a time point.
+             * \param time The time point to wait until.
+             * \return The index of the channel, or NONE if the time point was reached (or wake_up() was called).
+             * */
+            template<class Clock, class Duration>
+            std::size_t wait_until(const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Waits until a channel is ready, or for an amount of time.
+             * \param duration The amount of time to wait.
+             * \return The index of the channel, or NONE if the time passed (or wake_up() was called).
+             * */
+            template<class Rep, class Period>
+            std::size_t wait_for(const std::chrono::duration<Rep, Period>& duration);
+
+            /**
+             * \brief Waits until a channel is ready, or until a deadline.
+             * \param time The deadline (Deadline::min() to not wait, Deadline::max() to wait forever).
+             * \return The index of the channel, or NONE if the deadline was reached (or wake_up() was called).
+             * */
+            std::size_t wait_until_0(const Deadline& time);
+
+            /**
+             * \brief Wakes up the thread waiting on the poller (its wait returns NONE).
+             * */
+            void wake_up() noexcept;
+
+            /**
+             * \brief Get the number of channels.
+             * \return The number of channels.
+             * */
+            std::size_t get_channels_count() const noexcept;
+
+        private:
+            /**
+             * \brief A channel of the poller.
+             * */
+            typedef struct _Source_
+            {
+                /**
+                 * \brief Tells if the channel has elements to receive.
+                 * */
+                SmallFunction<bool()> is_ready;
+
+                /**
+                 * \brief Removes the poller from the listeners of the channel.
+                 * */
+                SmallFunction<void()> detach;
+
+                /**
+                 * \brief How many times in a row the channel can be returned.
+                 * */
+                unsigned weight;
+            } Source;
+
+            /**
+             * \brief The channels.
+             * */
+            std::vector<Source> sources;
+
+            /**
+             * \brief The index of the last returned channel.
+             * */
+            std::size_t current;
+
+            /**
+             * \brief How many more times in a row the current channel can be returned.
+             * */
+            unsigned credits;
+
+            /**
+             * \brief Notified by the channels after every send.
+             * */
+            EventCount event;
+
+            /**
+             * \brief Incremented on every wake_up() call.
+             * */
+            std::atomic_uint wake_ups;
+
+            /**
+             * \brief Called by the channels after every send.
+             * */
+            void on_send() noexcept override;
+
+            /**
+             * \brief Finds the next ready channel, in weighted round-robin order.
+             * \return The index of the channel, or NONE if no channel is ready.
+             * */
+            std::size_t find_ready();
+        };
+    }
+}
+
+#include "template/poller.txx"
+
+#endif
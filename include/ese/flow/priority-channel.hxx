@@ -0,0 +1,164 @@
+
+#ifndef ESE_FLOW_PRIORITYCHANNEL_HXX
+#define ESE_FLOW_PRIORITYCHANNEL_HXX
+
+#include <cstddef>
+#include <type_traits>
+#include <ese/flow/lock-free-channel.hxx>
+#include <ese/flow/ring-buffer.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Extracts the priority level of an element (0 is the most urgent level).
+         * \tparam TElement The type of the elements.
+         *
+         * The default implementation calls element.get_priority(): specialize it (or pass another functor to
+         * PriorityRingBuffer) for elements that do not have such method.
+         * */
+        template<typename TElement>
+        struct PriorityOf
+        {
+            /**
+             * \brief Get the priority level of an element.
+             * \param element The element.
+             * \return The priority level.
+             * */
+            std::size_t operator()(const TElement& element) const;
+        };
+
+        /**
+         * \brief A fixed-capacity buffer with a fixed number of priority levels, for any number of producer and
+         *     consumer threads.
+         * \tparam TElement The type of the stored elements. Have to be default constructible and move assignable.
+         * \tparam Levels The number of priority levels.
+         * \tparam TPriorityOf The functor that extracts the priority level of an element (levels greater than
+         *     Levels - 1 are clamped to the last level).
+         *
+         * Every level is a lock-free MpmcRingBuffer: try_push() touches only the element's level and try_pop() pops
+         * from the most urgent non-empty level, so both cost O(Levels) at most, whatever the number of stored
+         * elements. Elements of the same level are popped in FIFO order. \n
+         * It has the interface of the ring buffers, so it can be used as the buffer of a LockFreeChannel (see
+         * PriorityChannel). \n
+         * */
+        template<typename TElement, std::size_t Levels = 4, typename TPriorityOf = PriorityOf<TElement>>
+        class PriorityRingBuffer
+        {
+        public:
+            static_assert(Levels > 0, "A PriorityRingBuffer needs at least one level.");
+
+            /**
+             * \brief The type of the stored elements.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief Construct a buffer whose levels can store (at least) the specified number of elements each.
+             * \param capacity The minimal capacity of every level.
+             * \param priority_of The functor that extracts the priority level of an element.
+             *
+             * If a level can not be constructed, the levels already constructed are destroyed before rethrowing.
+             * */
+            explicit PriorityRingBuffer(std::size_t capacity, TPriorityOf priority_of = TPriorityOf());
+
+            PriorityRingBuffer(const PriorityRingBuffer&) = delete;
+
+            PriorityRingBuffer& operator=(const PriorityRingBuffer&) = delete;
+
+            /**
+             * \brief Destroys the levels.
+             * */
+            ~PriorityRingBuffer();
+
+            /**
+             * \brief Tries to push the element in its level.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if its level is full (the element is left untouched).
+             * */
+            bool try_push(TElement&& element);
+
+            /**
+             * \brief Tries to push the element in its level.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if its level is full.
+             * */
+            bool try_push(const TElement& element);
+
+            /**
+             * \brief Tries to pop an element from the most urgent non-empty level.
+             * \param address The pointer to the address where the popped element have to be moved.
+             * \return True if an element was popped, false if the buffer is empty.
+             * */
+            bool try_pop(TElement* address);
+
+            /**
+             * \brief Tells if the buffer is (was, at the moment of the call) empty.
+             * \return True if every level is empty, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Returns the capacity of every level.
+             * \return The capacity of a level.
+             * */
+            std::size_t get_capacity() const noexcept;
+
+        private:
+            /**
+             * \brief The storage of the levels (constructed in place, ring buffers can not be moved).
+             * */
+            typename std::aligned_storage<sizeof(MpmcRingBuffer<TElement>), alignof(MpmcRingBuffer<TElement>)>::type
+                storage[Levels];
+
+            /**
+             * \brief The functor that extracts the priority level of an element.
+             * */
+            TPriorityOf priority_of;
+
+            /**
+             * \brief Get a level.
+             * \param index The index of the level.
+             * \return The level.
+             * */
+            MpmcRingBuffer<TElement>& level(std::size_t index) noexcept;
+
+            /**
+             * \brief Get a level.
+             * \param index The index of the level.
+             * \return The level.
+             * */
+            const MpmcRingBuffer<TElement>& level(std::size_t index) const noexcept;
+
+            /**
+             * \brief Get the level of an element.
+             * \param element The element.
+             * \return The level (clamped to the last one).
+             * */
+            MpmcRingBuffer<TElement>& level_of(const TElement& element);
+        };
+
+        /**
+         * \brief A LockFreeChannel whose receivers get the elements of the most urgent priority level first.
+         * \param TElement The type of elements to share.
+         * \param Levels The number of priority levels (the capacity passed to the channel is the one of every
+         *     level).
+         * \param TPriorityOf The functor that extracts the priority level of an element.
+         * \param TWaitPolicy Tells to the receivers how to wait for elements.
+         *
+         * Control messages sent with level 0 overtake the bulk traffic of the other levels, at the cost of a lock-free
+         * push and pop (there is no heap to rebalance, unlike a Channel with a std::priority_queue). \n
+         * A sender blocks only when the level of its element is full.
+         * */
+        template<typename TElement, std::size_t Levels = 4, typename TPriorityOf = PriorityOf<TElement>,
+            typename TWaitPolicy = BlockingWaitPolicy>
+        using PriorityChannel = LockFreeChannel<TElement, PriorityRingBuffer<TElement, Levels, TPriorityOf>,
+            TWaitPolicy>;
+    }
+}
+
+#include "template/priority-channel.txx"
+
+#endif
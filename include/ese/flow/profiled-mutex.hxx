@@ -0,0 +1,261 @@
+
+#ifndef ESE_FLOW_PROFILEDMUTEX_HXX
+#define ESE_FLOW_PROFILEDMUTEX_HXX
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ese/flow/lock-role.hxx>
+#include <ese/flow/metrics.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief How a ProfiledMutex was used, read by ProfiledMutex::get_profile().
+         *
+         * Counters grow monotonically, as those of ChannelMetrics. \n
+         * */
+        typedef struct _LockProfile_
+        {
+            /**
+             * \brief The number of times the mutex was locked.
+             * */
+            std::uint64_t acquisitions = 0;
+
+            /**
+             * \brief The number of times the mutex was found locked.
+             * */
+            std::uint64_t contentions = 0;
+
+            /**
+             * \brief The time spent waiting for the mutex, in nanoseconds.
+             * */
+            std::uint64_t wait_ns = 0;
+
+            /**
+             * \brief The time spent sleeping on the condition variables of the mutex, in nanoseconds.
+             * */
+            std::uint64_t sleep_ns = 0;
+
+            /**
+             * \brief The time spent waiting for the mutex, by the role of the waiter and the role of the holder
+             *     (e.g. blocked_ns[SENDER][RECEIVER] is the time senders waited for receivers), in nanoseconds.
+             * */
+            std::uint64_t blocked_ns[LOCK_ROLES_COUNT][LOCK_ROLES_COUNT] = {};
+
+            /**
+             * \brief The waits of the contended acquisitions.
+             * */
+            LatencySummary wait;
+
+            /**
+             * \brief The time the mutex was held, by every acquisition.
+             * */
+            LatencySummary hold;
+
+            /**
+             * \brief The sleeps on the condition variables.
+             * */
+            LatencySummary sleep;
+        } LockProfile;
+
+        /**
+         * \brief A mutex that measures how long it is waited for and held, and who waits for whom.
+         * \sa LockProfiler
+         *
+         * It is a drop-in replacement of std::mutex (to be used with std::condition_variable_any), which Channel
+         * uses when ESE_FLOW_LOCK_PROFILING is defined. An uncontended lock costs two more reads of the clock;
+         * the role of the locking thread is the last one set by set_current_role(). \n
+         * Everything is recorded while the mutex is held, so no counter is contended. \n
+         * */
+        class ProfiledMutex
+        {
+        public:
+            /**
+             * \brief Construct an unlocked mutex, with an empty profile.
+             * */
+            ProfiledMutex() noexcept;
+
+            ProfiledMutex(const ProfiledMutex&) = delete;
+
+            ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+            /**
+             * \brief Locks the mutex, timing the wait if it is contended.
+             * */
+            void lock();
+
+            /**
+             * \brief Tries to lock the mutex, without waiting.
+             * \return True if the mutex was locked, false otherwise.
+             * */
+            bool try_lock();
+
+            /**
+             * \brief Unlocks the mutex, recording how long it was held.
+             * */
+            void unlock();
+
+            /**
+             * \brief Records a sleep on a condition variable of the mutex (the mutex has to be locked).
+             * \param duration How long the thread slept.
+             *
+             * The time between the release and the reacquisition of the mutex is not counted as held. \n
+             * */
+            void record_sleep(std::chrono::steady_clock::duration duration) noexcept;
+
+            /**
+             * \brief Reads the profile of the mutex.
+             * \return The profile.
+             * */
+            LockProfile get_profile() const noexcept;
+
+            /**
+             * \brief Sets the role of the current thread, for the next locks of any ProfiledMutex.
+             * \param role The role.
+             * */
+            static void set_current_role(LockRole role) noexcept;
+
+            /**
+             * \brief Get the role of the current thread.
+             * \return The role.
+             * */
+            static LockRole get_current_role() noexcept;
+
+        private:
+            /**
+             * \brief The actual mutex.
+             * */
+            std::mutex mutex;
+
+            /**
+             * \brief The role of the thread holding the mutex (read by the waiting threads).
+             * */
+            std::atomic<LockRole> holder;
+
+            /**
+             * \brief When the mutex was locked (protected by the mutex).
+             * */
+            std::chrono::steady_clock::time_point locked_at;
+
+            /**
+             * \brief The number of acquisitions.
+             * */
+            std::atomic<std::uint64_t> acquisitions;
+
+            /**
+             * \brief The number of contended acquisitions.
+             * */
+            std::atomic<std::uint64_t> contentions;
+
+            /**
+             * \brief The time spent sleeping on the condition variables.
+             * */
+            std::atomic<std::uint64_t> sleep_ns;
+
+            /**
+             * \brief The time spent waiting, by the role of the waiter and of the holder.
+             * */
+            std::atomic<std::uint64_t> blocked_ns[LOCK_ROLES_COUNT][LOCK_ROLES_COUNT];
+
+            /**
+             * \brief The waits of the contended acquisitions.
+             * */
+            LatencyHistogram wait_histogram;
+
+            /**
+             * \brief The hold times.
+             * */
+            LatencyHistogram hold_histogram;
+
+            /**
+             * \brief The sleeps on the condition variables.
+             * */
+            LatencyHistogram sleep_histogram;
+
+            /**
+             * \brief Records an acquisition (the mutex has to be locked).
+             * */
+            void acquired() noexcept;
+        };
+
+        /**
+         * \brief The named channels whose locks are profiled, ranked by the time spent waiting for their mutexes.
+         *
+         * The channels with the most waiting are the first ones to move to a lock-free backend (e.g. an
+         * MpmcChannel, or a ShardedChannel). Channels are registered by reference, as in MetricsRegistry. \n
+         * All the methods are thread-safe. \n
+         * */
+        class LockProfiler
+        {
+        public:
+            /**
+             * \brief Get the profiler of the program.
+             * \return The profiler.
+             * */
+            static LockProfiler& get_default();
+
+            /**
+             * \brief Registers a mutex.
+             * \param name The name of the mutex (replaces any mutex with the same name).
+             * \param source Returns the profile of the mutex.
+             * */
+            void add(const std::string& name, std::function<LockProfile()> source);
+
+            /**
+             * \brief Registers a channel (requires ESE_FLOW_LOCK_PROFILING).
+             * \param name The name of the channel.
+             * \param channel The channel (a Channel, or any object with a get_lock_profile() method).
+             * */
+            template<typename TChannel>
+            void add(const std::string& name, const TChannel& channel);
+
+            /**
+             * \brief Removes a mutex.
+             * \param name The name.
+             * */
+            void remove(const std::string& name);
+
+            /**
+             * \brief Reads the profiles of all the registered mutexes.
+             * \return The profiles, by decreasing wait time (the time spent waiting for the mutex).
+             * */
+            std::vector<std::pair<std::string, LockProfile>> rank() const;
+
+            /**
+             * \brief Writes a table of the ranked profiles.
+             * \param out Where the table is written.
+             *
+             * Every row tells the total wait and sleep times, the contention rate, the wait and hold percentiles
+             * and the roles that waited for the longest, e.g. "sender<-receiver" if senders waited mostly for the
+             * receivers. \n
+             * */
+            void report(std::ostream& out) const;
+
+        private:
+            /**
+             * \brief Protects the sources.
+             * */
+            mutable std::mutex mutex;
+
+            /**
+             * \brief The registered mutexes.
+             * */
+            std::map<std::string, std::function<LockProfile()>> sources;
+        };
+    }
+}
+
+#include "template/profiled-mutex.txx"
+
+#endif
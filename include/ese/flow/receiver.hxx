@@ -3,7 +3,9 @@
 #define ESE_FLOW_RECEIVER_HXX
 
 #include <chrono>
-#include <boost/any.hpp>
+#include <cstddef>
+#include <ese/flow/batch.hxx>
+#include <ese/flow/deadline.hxx>
 
 namespace ese
 {
@@ -14,7 +16,8 @@ namespace ese
          * \param TElement The type of the elements to receive.
          *
          * The only method that have to be implemented is try_receive_until_0(). Any other method at the end
-         * will use this one.
+         * will use this one. \n
+         * Time points are converted to a Deadline before the virtual call: receivers never see other clocks.
          */
         template<typename TElement>
         class Receiver
@@ -87,9 +90,9 @@ namespace ese
             bool try_receive_for(TElement* address, const std::chrono::duration<Rep, Period>& duration);
 
             /**
-             * \brief Tries to receive an element for an amount of time.
+             * \brief Tries to receive an element until a deadline.
              * \param address The pointer to the address where the received element have to be moved.
-             * \param duration The amount of time to wait (using boost::any time for accept different time_points).
+             * \param time The deadline (Deadline::min() to not wait, Deadline::max() to wait forever).
              * \return True if the element was received (and moved to the address passed as argument), false otherwise.
              * \sa receive()
              * \sa try_receive()
@@ -97,10 +100,62 @@ namespace ese
              * \sa try_receive_for()
              *
              * The object will be moved to the address passed as argument and the method will return true. \n
-             * Otherwise, if there is no object to receive (for the entire specified amount of time), nothing will
-             * be moved to the passed address and the method will return false. \n
+             * Otherwise, if there is no object to receive (until the deadline), nothing will be moved to the passed
+             * address and the method will return false. \n
              */
-            virtual bool try_receive_until_0(TElement* address, const boost::any& duration) = 0;
+            virtual bool try_receive_until_0(TElement* address, const Deadline& time) = 0;
+
+            /**
+             * \brief Receives many elements at once, waiting until a time point for the first one.
+             * \param out The output iterator where the received elements are moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The time point to wait until (for the first element).
+             * \return The number of received elements.
+             * \sa try_receive_batch_until_0()
+             *
+             * Once the first element is received, the method does not wait anymore: it takes the elements that are
+             * already available (up to max) and returns. \n
+             * The elements pass (in chunks) through a stack buffer, unless out is a TElement pointer.
+             * */
+            template<class TOutputIterator, class Clock, class Duration>
+            std::size_t receive_batch(TOutputIterator out, std::size_t max,
+                const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Receives many elements at once, waiting until a time point for the first one.
+             * \param address The address where the received elements are moved (there have to be space for max
+             *     elements).
+             * \param max The maximal number of elements to receive.
+             * \param time The time point to wait until (for the first element).
+             * \return The number of received elements.
+             * */
+            template<class Clock, class Duration>
+            std::size_t receive_batch(TElement* address, std::size_t max,
+                const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Receives many elements at once.
+             * \param out The output iterator where the received elements are moved.
+             * \param max The maximal number of elements to receive.
+             * \param blocking If true, the method will block until (at least) an element is received.
+             * \return The number of received elements.
+             * */
+            template<class TOutputIterator>
+            std::size_t receive_batch(TOutputIterator out, std::size_t max, bool blocking = false);
+
+            /**
+             * \brief Receives many elements at once, waiting until a time point for the first one.
+             * \param address The address where the received elements are moved (there have to be space for max
+             *     elements).
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline (for the first element).
+             * \return The number of received elements.
+             * \sa receive_batch()
+             *
+             * The default implementation calls try_receive_until_0() once for each element. Implementations that can
+             * receive many elements at the cost of one (one lock acquisition) should override it.
+             * */
+            virtual std::size_t try_receive_batch_until_0(TElement* address, std::size_t max, const Deadline& time);
         };
 
     }
@@ -0,0 +1,223 @@
+
+#ifndef ESE_FLOW_RINGBUFFER_HXX
+#define ESE_FLOW_RINGBUFFER_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ese/flow/cache-line.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief A fixed-capacity ring buffer, for exactly one producer thread and one consumer thread.
+         * \tparam TElement The type of the stored elements. Have to be default constructible and move assignable.
+         *
+         * Both try_push() and try_pop() are wait-free. \n
+         * The capacity is rounded up to the next power of two. \n
+         * Only one thread at a time may push and only one thread at a time may pop (but the two can be different
+         * threads). \n
+         * */
+        template<typename TElement>
+        class SpscRingBuffer
+        {
+        public:
+            /**
+             * \brief The type of the stored elements.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief Construct a ring buffer that can store (at least) the specified number of elements.
+             * \param capacity The minimal capacity of the buffer.
+             * */
+            explicit SpscRingBuffer(std::size_t capacity);
+
+            SpscRingBuffer(const SpscRingBuffer&) = delete;
+
+            SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+            /**
+             * \brief Tries to push the element in the buffer.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if the buffer is full (the element is left untouched).
+             * */
+            bool try_push(TElement&& element);
+
+            /**
+             * \brief Tries to push the element in the buffer.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if the buffer is full.
+             * */
+            bool try_push(const TElement& element);
+
+            /**
+             * \brief Tries to pop an element from the buffer.
+             * \param address The pointer to the address where the popped element have to be moved.
+             * \return True if an element was popped, false if the buffer is empty.
+             * */
+            bool try_pop(TElement* address);
+
+            /**
+             * \brief Tells if the buffer is (was, at the moment of the call) empty.
+             * \return True if it is empty, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Returns the capacity of the buffer.
+             * \return The capacity.
+             * */
+            std::size_t get_capacity() const noexcept;
+
+        private:
+            /**
+             * \brief capacity - 1, used to map positions to slots.
+             * */
+            const std::size_t mask;
+
+            /**
+             * \brief The storage of the elements.
+             * */
+            std::unique_ptr<TElement[]> slots;
+
+            /**
+             * \brief The position of the next element to pop (written only by the consumer).
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::size_t> head;
+
+            /**
+             * \brief The consumer's cached copy of the tail, reloaded only when the buffer looks empty.
+             * */
+            std::size_t cached_tail;
+
+            /**
+             * \brief The position of the next element to push (written only by the producer).
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::size_t> tail;
+
+            /**
+             * \brief The producer's cached copy of the head, reloaded only when the buffer looks full.
+             * */
+            std::size_t cached_head;
+
+            /**
+             * \brief Takes the next free slot (if any).
+             * \return The slot or nullptr if the buffer is full.
+             * */
+            TElement* acquire_push_slot() noexcept;
+        };
+
+        /**
+         * \brief A fixed-capacity ring buffer, for any number of producer and consumer threads.
+         * \tparam TElement The type of the stored elements. Have to be default constructible and move assignable.
+         *
+         * Both try_push() and try_pop() are lock-free (every slot carries a sequence number, that tells to producers
+         * and consumers in which "lap" the slot is). \n
+         * The capacity is rounded up to the next power of two. \n
+         * */
+        template<typename TElement>
+        class MpmcRingBuffer
+        {
+        public:
+            /**
+             * \brief The type of the stored elements.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief Construct a ring buffer that can store (at least) the specified number of elements.
+             * \param capacity The minimal capacity of the buffer.
+             * */
+            explicit MpmcRingBuffer(std::size_t capacity);
+
+            MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+
+            MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+            /**
+             * \brief Tries to push the element in the buffer.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if the buffer is full (the element is left untouched).
+             * */
+            bool try_push(TElement&& element);
+
+            /**
+             * \brief Tries to push the element in the buffer.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if the buffer is full.
+             * */
+            bool try_push(const TElement& element);
+
+            /**
+             * \brief Tries to pop an element from the buffer.
+             * \param address The pointer to the address where the popped element have to be moved.
+             * \return True if an element was popped, false if the buffer is empty.
+             * */
+            bool try_pop(TElement* address);
+
+            /**
+             * \brief Tells if the buffer is (was, at the moment of the call) empty.
+             * \return True if it is empty, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Returns the capacity of the buffer.
+             * \return The capacity.
+             * */
+            std::size_t get_capacity() const noexcept;
+
+        private:
+            /**
+             * \brief A slot of the buffer.
+             * */
+            typedef struct _Slot_
+            {
+                /**
+                 * \brief Equal to the position for a free slot, equal to position + 1 for a full slot.
+                 * */
+                std::atomic<std::size_t> sequence;
+
+                /**
+                 * \brief The stored element.
+                 * */
+                TElement element;
+            }
+            Slot;
+
+            /**
+             * \brief capacity - 1, used to map positions to slots.
+             * */
+            const std::size_t mask;
+
+            /**
+             * \brief The slots.
+             * */
+            std::unique_ptr<Slot[]> slots;
+
+            /**
+             * \brief The position of the next element to pop.
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::size_t> head;
+
+            /**
+             * \brief The position of the next element to push.
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::size_t> tail;
+
+            /**
+             * \brief Claims the next free slot (if any).
+             * \param position Where the claimed position is stored.
+             * \return The slot or nullptr if the buffer is full.
+             * */
+            Slot* acquire_push_slot(std::size_t* position) noexcept;
+        };
+    }
+}
+
+#include "template/ring-buffer.txx"
+
+#endif
@@ -0,0 +1,155 @@
+
+#ifndef ESE_FLOW_RINGQUEUE_HXX
+#define ESE_FLOW_RINGQUEUE_HXX
+
+#include <cstddef>
+#include <memory>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief A FIFO queue stored in a growable ring, that never gives its memory back.
+         * \tparam TElement The type of the stored elements.
+         * \tparam TAllocator The allocator of the ring.
+         * \sa RingQueueChannel
+         *
+         * It offers the push(), front(), pop() and empty() methods of std::queue, so it can be the queue of a
+         * Channel. Unlike a std::deque, that allocates and frees chunks while it grows and shrinks, the ring is
+         * reallocated only when it is full (doubling its capacity): once the queue reached its steady-state size,
+         * pushing and popping do not allocate. \n
+         * The capacity is always a power of two. \n
+         * */
+        template<typename TElement, typename TAllocator = std::allocator<TElement>>
+        class RingQueue
+        {
+        public:
+            /**
+             * \brief The type of the stored elements.
+             * */
+            typedef TElement value_type;
+
+            /**
+             * \brief The type of the allocator.
+             * */
+            typedef TAllocator allocator_type;
+
+            /**
+             * \brief The type used for sizes.
+             * */
+            typedef std::size_t size_type;
+
+            /**
+             * \brief Construct an empty queue, that allocates nothing until the first push.
+             * \param allocator The allocator of the ring.
+             * */
+            explicit RingQueue(const TAllocator& allocator = TAllocator());
+
+            RingQueue(const RingQueue&) = delete;
+
+            RingQueue& operator=(const RingQueue&) = delete;
+
+            /**
+             * \brief Destroys the stored elements and frees the ring.
+             * */
+            ~RingQueue();
+
+            /**
+             * \brief Pushes an element at the back of the queue.
+             * \param element The element to push.
+             * */
+            void push(TElement&& element);
+
+            /**
+             * \brief Pushes an element at the back of the queue.
+             * \param element The element to push.
+             * */
+            void push(const TElement& element);
+
+            /**
+             * \brief Get the element at the front of the queue (the queue must not be empty).
+             * \return The element.
+             * */
+            TElement& front() noexcept;
+
+            /**
+             * \brief Get the element at the front of the queue (the queue must not be empty).
+             * \return The element.
+             * */
+            const TElement& front() const noexcept;
+
+            /**
+             * \brief Removes the element at the front of the queue (the queue must not be empty).
+             * */
+            void pop() noexcept;
+
+            /**
+             * \brief Tells if the queue is empty.
+             * \return True if it is empty, false otherwise.
+             * */
+            bool empty() const noexcept;
+
+            /**
+             * \brief Get the number of elements in the queue.
+             * \return The number of elements.
+             * */
+            std::size_t size() const noexcept;
+
+            /**
+             * \brief Get the number of elements that the ring can store without growing.
+             * \return The capacity.
+             * */
+            std::size_t capacity() const noexcept;
+
+            /**
+             * \brief Grows the ring in advance, so that no push allocates until the queue holds more elements.
+             * \param capacity The minimal capacity.
+             * */
+            void reserve(std::size_t capacity);
+
+        private:
+            /**
+             * \brief The allocator of the ring.
+             * */
+            TAllocator allocator;
+
+            /**
+             * \brief The ring (nullptr until the first push).
+             * */
+            TElement* ring;
+
+            /**
+             * \brief capacity - 1, used to map positions to places in the ring (-1 while there is no ring).
+             * */
+            std::size_t mask;
+
+            /**
+             * \brief The position of the front element.
+             * */
+            std::size_t head;
+
+            /**
+             * \brief The number of elements.
+             * */
+            std::size_t count;
+
+            /**
+             * \brief Moves the elements into a new ring.
+             * \param capacity The capacity of the new ring (a power of two).
+             * */
+            void reallocate(std::size_t capacity);
+
+            /**
+             * \brief Constructs an element at the back of the queue.
+             * \param element The element (forwarded).
+             * */
+            template<typename TForward>
+            void emplace_back(TForward&& element);
+        };
+    }
+}
+
+#include "ese/flow/template/ring-queue.txx"
+
+#endif
@@ -2,6 +2,11 @@
 #ifndef ESE_FLOW_SENDER_HXX
 #define ESE_FLOW_SENDER_HXX
 
+#include <chrono>
+#include <cstddef>
+#include <ese/flow/batch.hxx>
+#include <ese/flow/deadline.hxx>
+
 namespace ese
 {
     namespace flow
@@ -10,7 +15,9 @@ namespace ese
          * \brief Interface that sends elements of a specified type TElement.
          * \param TElement The type of the elements to send.
          *
-         * The methods that have to be implemented are both send().
+         * The methods that have to be implemented are both send(). \n
+         * Bounded implementations should also override try_send_until_0(), the only method used by the try_send()
+         * family.
          */
         template<typename TElement>
         class Sender
@@ -38,6 +45,96 @@ namespace ese
              * */
             virtual void send(const ElementType& element) = 0;
 
+            /**
+             * \brief Send many elements at once.
+             * \param first The iterator to the first element to send.
+             * \param last The iterator past the last element to send.
+             * \sa send_batch_0()
+             *
+             * The elements are assigned from *first (use std::make_move_iterator() to move them) to a stack buffer and
+             * sent in chunks, via send_batch_0().
+             * */
+            template<class TIterator>
+            void send_batch(TIterator first, TIterator last);
+
+            /**
+             * \brief Send many elements at once.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * The default implementation calls send() for each element. Implementations that can send many elements
+             * at the cost of one (one lock acquisition, one wake-up) should override it.
+             * */
+            virtual void send_batch_0(ElementType* elements, std::size_t count);
+
+            /**
+             * \brief Tries to send the element, optionally waiting for space.
+             * \param element The element to send (moved only if it was sent).
+             * \param blocking Tells if the method should wait until there is space for the element.
+             * \return True if the element was sent, false otherwise.
+             * \sa try_send_until_0()
+             * */
+            bool try_send(ElementType&& element, bool blocking = false);
+
+            /**
+             * \brief Tries to send a copy of the element, optionally waiting for space.
+             * \param element The element to send.
+             * \param blocking Tells if the method should wait until there is space for the element.
+             * \return True if the element was sent, false otherwise.
+             * \sa try_send_until_0()
+             * */
+            bool try_send(const ElementType& element, bool blocking = false);
+
+            /**
+             * \brief Tries to send the element, waiting for space until a time point.
+             * \param element The element to send (moved only if it was sent).
+             * \param time The time point to wait until.
+             * \return True if the element was sent, false otherwise.
+             * \sa try_send_until_0()
+             * */
+            template<class Clock, class Duration>
+            bool try_send_until(ElementType&& element, const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Tries to send a copy of the element, waiting for space until a time point.
+             * \param element The element to send.
+             * \param time The time point to wait until.
+             * \return True if the element was sent, false otherwise.
+             * \sa try_send_until_0()
+             * */
+            template<class Clock, class Duration>
+            bool try_send_until(const ElementType& element, const std::chrono::time_point<Clock, Duration>& time);
+
+            /**
+             * \brief Tries to send the element, waiting for space for an amount of time.
+             * \param element The element to send (moved only if it was sent).
+             * \param duration The amount of time to wait.
+             * \return True if the element was sent, false otherwise.
+             * \sa try_send_until_0()
+             * */
+            template<class Rep, class Period>
+            bool try_send_for(ElementType&& element, const std::chrono::duration<Rep, Period>& duration);
+
+            /**
+             * \brief Tries to send a copy of the element, waiting for space for an amount of time.
+             * \param element The element to send.
+             * \param duration The amount of time to wait.
+             * \return True if the element was sent, false otherwise.
+             * \sa try_send_until_0()
+             * */
+            template<class Rep, class Period>
+            bool try_send_for(const ElementType& element, const std::chrono::duration<Rep, Period>& duration);
+
+            /**
+             * \brief Tries to send the element, waiting for space until a deadline.
+             * \param element The address of the element to send (moved from there only if it was sent).
+             * \param time The deadline (Deadline::min() to not wait, Deadline::max() to wait forever).
+             * \return True if the element was sent, false otherwise.
+             *
+             * The default implementation (suitable for unbounded senders) calls send() and returns true.
+             * */
+            virtual bool try_send_until_0(ElementType* element, const Deadline& time);
+
             /**
              * \brief Send the element.
              * \param element The element to send.
@@ -0,0 +1,352 @@
+
+#ifndef ESE_FLOW_SHARDEDCHANNEL_HXX
+#define ESE_FLOW_SHARDEDCHANNEL_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <ese/flow/aligned-ptr.hxx>
+#include <ese/flow/cache-line.hxx>
+#include <ese/flow/channel-listener.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/receiver.hxx>
+#include <ese/flow/sender.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        class ShardedChannelReceiver;
+
+        template<typename TChannel>
+        class ShardedChannelSender;
+
+        /**
+         * \brief Tells to a ShardedChannel how much order its senders need.
+         *
+         * PER_PRODUCER_FIFO keeps every sending thread on its own shard: the elements sent by the same thread are
+         * received in the order in which they were sent. \n
+         * RELAXED lets a sending thread move to another shard when its own is locked: there is no order among the
+         * sent elements, but senders almost never wait for each other. \n
+         * */
+        enum class ShardOrdering
+        {
+            PER_PRODUCER_FIFO,
+            RELAXED
+        };
+
+        /**
+         * \brief Used to share elements among threads, when many threads send at the same time.
+         * \param TElement The type of elements to share.
+         * \param TWaitPolicy Tells to the receivers how to wait for elements (BlockingWaitPolicy,
+         *     SpinThenParkWaitPolicy or BusyPollWaitPolicy).
+         *
+         * It offers the same Receiver and Sender interfaces of the Channel class, but the elements are stored in
+         * many unbounded sub-queues (shards), each one with its own mutex and on its own cache lines. Every sending
+         * thread has its home shard (threads are spread over the shards in the order in which they first send), so
+         * senders on different shards never contend. \n
+         * Receivers drain the shards in round-robin order: a batch receive takes the elements of many shards at
+         * once. There is no order among elements of different shards. \n
+         * Receivers sleep on an EventCount, so waking them up is free when nobody sleeps. \n
+         * All operation (even those of receiver and sender) are thread-safe. \n
+         * */
+        template<typename TElement, typename TWaitPolicy = BlockingWaitPolicy>
+        class ShardedChannel
+        {
+        public:
+            /**
+             *  brief The type of elements to share.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             *  brief The policy used by receivers to wait for elements.
+             * */
+            typedef TWaitPolicy WaitPolicyType;
+
+            /**
+             * \brief The type of the Receiver that interacts with this ShardedChannel.
+             * */
+            typedef ShardedChannelReceiver<ShardedChannel<TElement, TWaitPolicy>> ReceiverType;
+
+            /**
+             * \brief The type of the Sender that interacts with this ShardedChannel.
+             * */
+            typedef ShardedChannelSender<ShardedChannel<TElement, TWaitPolicy>> SenderType;
+
+            /**
+             * \brief Construct a ShardedChannel object.
+             * \param shards_count The number of shards (0 means one per hardware thread).
+             * \param ordering How much order the senders need.
+             * \sa get_receiver()
+             * \sa get_sender()
+             * */
+            explicit ShardedChannel(std::size_t shards_count = 0,
+                ShardOrdering ordering = ShardOrdering::PER_PRODUCER_FIFO);
+
+            ShardedChannel(const ShardedChannel&) = delete;
+
+            ShardedChannel& operator=(const ShardedChannel&) = delete;
+
+            /**
+             * \brief Get the channel's receiver.
+             * \return The receiver.
+             * */
+            ReceiverType& get_receiver() noexcept;
+
+            /**
+             * \brief Get the channel's sender.
+             * \return The sender.
+             * */
+            SenderType& get_sender() noexcept;
+
+            /**
+             * \brief Wakes up all the threads that are waiting to receive an element via the Receiver object
+             *     owned by this ShardedChannel object.
+             * */
+            void wake_up() noexcept;
+
+            /**
+             * \brief Tells if the channel is (was, at the moment of the call) empty.
+             * \return True if every shard is empty, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Sets the listener notified after every send.
+             * \param listener The listener (nullptr removes the current one).
+             * \return True if the listener was set, false if the channel already has another listener (that has to be
+             *     removed first).
+             *
+             * The listener can be changed only while nobody is sending into the channel.
+             * */
+            bool set_listener(ChannelListener* listener) noexcept;
+
+            /**
+             * \brief Get the number of shards.
+             * \return The number of shards.
+             * */
+            std::size_t get_shards_count() const noexcept;
+
+            /**
+             * \brief Get how much order the senders need.
+             * \return The ordering.
+             * */
+            ShardOrdering get_ordering() const noexcept;
+
+        private:
+            /**
+             * \brief A sub-queue of the channel.
+             * */
+            typedef struct alignas(ESE_FLOW_CACHE_LINE_SIZE) _Shard_
+            {
+                /**
+                 * \brief Mutex used to synchronize access to the shard's queue.
+                 * */
+                std::mutex mutex;
+
+                /**
+                 * \brief The elements sent into the shard (and not received yet).
+                 * */
+                std::deque<TElement> queue;
+
+                /**
+                 * \brief The number of elements in the shard, readable without locking the mutex.
+                 * */
+                std::atomic_size_t size;
+            } Shard;
+
+            /**
+             * \brief The shards.
+             * */
+            std::vector<AlignedPtr<Shard>> shards;
+
+            /**
+             * \brief How much order the senders need.
+             * */
+            const ShardOrdering ordering;
+
+            /**
+             * \brief The shard from which the next receive starts.
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic_size_t next_shard;
+
+            /**
+             * \brief Used to signal when the channel is no more empty.
+             * */
+            EventCount not_empty_event;
+
+            /**
+             * \brief Incremented on every wake_up() call, so that spinning receivers can notice it.
+             * */
+            std::atomic_uint wake_ups;
+
+            /**
+             * \brief The listener notified after every send (if any).
+             * */
+            std::atomic<ChannelListener*> listener;
+
+            /**
+             * \brief The channel's Receiver object.
+             * */
+            ReceiverType receiver;
+
+            /**
+             * \brief The channel's Sender object.
+             * */
+            SenderType sender;
+
+            /**
+             * \brief Locks the shard in which the calling thread sends.
+             * \param shard Where the address of the locked shard is stored.
+             * \return The lock on the shard's mutex.
+             * */
+            std::unique_lock<std::mutex> lock_shard_for_send(Shard** shard);
+
+            /**
+             * \brief Wakes up the receivers (one or all of them) and the listener, after elements were pushed.
+             * \param count The number of pushed elements.
+             * */
+            void notify_send(std::size_t count) noexcept;
+
+            friend ReceiverType;
+            friend SenderType;
+        };
+
+        /**
+         * \brief Receives elements from a ShardedChannel.
+         * \param TChannel The type of ShardedChannel from which it receives elements.
+         */
+        template<typename TChannel>
+        class ShardedChannelReceiver final: public Receiver<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             *  brief The type of ShardedChannel from which it receives elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             *  brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Tries to receive an element until a deadline.
+             * \param address The pointer to the address where the received element have to be moved.
+             * \param time The deadline.
+             * \return True if the element was received (and moved to the address passed as argument), false otherwise.
+             * \sa try_receive_until_1()
+             * */
+            bool try_receive_until_0(ElementType* address, const Deadline& time) override;
+
+            /**
+             * \brief Receives many elements at once, waiting until a deadline for the first one.
+             * \param address The address where the received elements are moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             *
+             * The elements are taken from as many shards as needed, with one lock acquisition per shard.
+             * */
+            std::size_t try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel from which it receives elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the receiver, that receives elements from a specified channel.
+             * \param channel The channel from which it receives elements.
+             * */
+            ShardedChannelReceiver(ChannelType& channel) noexcept;
+
+            /**
+             * \brief Tries to pop (up to max) elements from the shards (without waiting).
+             * \param address The pointer to the address where the received elements have to be moved.
+             * \param max The maximal number of elements to pop.
+             * \return The number of popped elements.
+             * */
+            std::size_t try_pop(ElementType* address, std::size_t max);
+
+            /**
+             * \brief Tries to receive (up to max) elements until a deadline.
+             * \param address The pointer to the address where the received elements have to be moved.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             *
+             * The method waits (until the deadline) only for the first element. \n
+             * */
+            std::size_t try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time);
+
+            friend ChannelType;
+        };
+
+        /**
+         * \brief Send elements into a ShardedChannel object.
+         * \param TChannel The type of ShardedChannel in which sends elements.
+         * */
+        template<typename TChannel>
+        class ShardedChannelSender final: public Sender<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             * \brief The type of ShardedChannel in which sends elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             * \brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Send the element in the channel.
+             * \param element The element to send.
+             * */
+            void send(ElementType&& element) override;
+
+            /**
+             * \brief Send the element in the channel.
+             * \param element The element to send.
+             * */
+            void send(const ElementType& element) override;
+
+            /**
+             * \brief Send many elements in the channel.
+             * \param elements The address of the first element to send (elements are moved from there).
+             * \param count The number of elements to send.
+             *
+             * All the elements are pushed in the same shard, under a single lock acquisition, and the receivers are
+             * notified once.
+             * */
+            void send_batch_0(ElementType* elements, std::size_t count) override;
+
+        private:
+            /**
+             * \brief The channel in which it sends elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the sender, that sends elements in a specified channel.
+             * \param channel The channel from in which sends elements.
+             * */
+            ShardedChannelSender(ChannelType& channel) noexcept;
+
+            friend ChannelType;
+        };
+    }
+}
+
+#include "ese/flow/template/sharded-channel.txx"
+
+#endif
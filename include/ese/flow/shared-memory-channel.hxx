@@ -0,0 +1,405 @@
+
+#ifndef ESE_FLOW_SHAREDMEMORYCHANNEL_HXX
+#define ESE_FLOW_SHAREDMEMORYCHANNEL_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <ese/flow/cache-line.hxx>
+#include <ese/flow/receiver.hxx>
+#include <ese/flow/sender.hxx>
+#include <ese/flow/shared-memory.hxx>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        class SharedMemoryChannelReceiver;
+
+        template<typename TChannel>
+        class SharedMemoryChannelSender;
+
+        /**
+         * \brief Used to share elements among processes, through a lock-free ring in shared memory.
+         * \param TElement The type of elements to share. Have to be trivially copyable (and must not point into
+         *     the memory of a process).
+         * \param TWaitPolicy Tells to the receivers how to wait for elements (BlockingWaitPolicy,
+         *     SpinThenParkWaitPolicy or BusyPollWaitPolicy).
+         * \sa SharedMemory
+         *
+         * The whole channel (a fixed-capacity ring of slots, the head and tail positions and the futexes on which
+         * senders and receivers sleep) lives in a SharedMemory region: one process creates the channel (that
+         * initializes the region), the others attach to it. Elements are copied once into a slot and once out of
+         * it, never serialized. \n
+         * It offers the same Receiver and Sender interfaces of the LockFreeChannel class: any number of senders and
+         * receivers, in any process, may work at the same time. \n
+         * A process that dies while sending or receiving may leave its slot claimed forever: the channel offers no
+         * recovery. \n
+         * */
+        template<typename TElement, typename TWaitPolicy = BlockingWaitPolicy>
+        class SharedMemoryChannel
+        {
+            static_assert(std::is_trivially_copyable<TElement>::value,
+                "elements of a SharedMemoryChannel have to be trivially copyable");
+
+            static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+                "a SharedMemoryChannel needs lock-free (address-free) atomics");
+
+        public:
+            /**
+             *  brief The type of elements to share.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             *  brief The policy used by receivers to wait for elements.
+             * */
+            typedef TWaitPolicy WaitPolicyType;
+
+            /**
+             * \brief The type of the Receiver that interacts with this SharedMemoryChannel.
+             * */
+            typedef SharedMemoryChannelReceiver<SharedMemoryChannel<TElement, TWaitPolicy>> ReceiverType;
+
+            /**
+             * \brief The type of the Sender that interacts with this SharedMemoryChannel.
+             * */
+            typedef SharedMemoryChannelSender<SharedMemoryChannel<TElement, TWaitPolicy>> SenderType;
+
+            /**
+             * \brief Get the size of the shared memory needed by a channel.
+             * \param capacity The (minimal) number of elements that can wait in the channel to be received.
+             * \return The size, in bytes.
+             * */
+            static std::size_t get_required_size(std::size_t capacity) noexcept;
+
+            /**
+             * \brief Construct a SharedMemoryChannel object, initializing the channel in a shared memory region.
+             * \param memory The region (at least get_required_size() bytes), owned by the channel.
+             * \param capacity The (minimal) number of elements that can wait in the channel to be received. When
+             *     the channel is full, senders block until some element is received.
+             *
+             * Throws std::invalid_argument if the region is too small. The other processes have to attach only
+             * after this constructor returned.
+             * */
+            SharedMemoryChannel(SharedMemory&& memory, std::size_t capacity);
+
+            /**
+             * \brief Construct a SharedMemoryChannel object, attaching to a channel already initialized in a shared
+             *     memory region (by another SharedMemoryChannel, usually in another process).
+             * \param memory The region, owned by the channel.
+             *
+             * Throws std::invalid_argument if the region does not contain a channel of this element type.
+             * */
+            explicit SharedMemoryChannel(SharedMemory&& memory);
+
+            SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+
+            SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+            /**
+             * \brief Get the channel's receiver.
+             * \return The receiver.
+             * */
+            ReceiverType& get_receiver() noexcept;
+
+            /**
+             * \brief Get the channel's sender.
+             * \return The sender.
+             * */
+            SenderType& get_sender() noexcept;
+
+            /**
+             * \brief Wakes up all the threads (of every process) that are waiting to receive an element.
+             * */
+            void wake_up() noexcept;
+
+            /**
+             * \brief Tells if the channel is (was, at the moment of the call) empty.
+             * \return True if there is no element to receive, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+            /**
+             * \brief Get the capacity of the channel.
+             * \return The capacity.
+             * */
+            std::size_t get_capacity() const noexcept;
+
+            /**
+             * \brief Get the shared memory region in which the channel lives.
+             * \return The region.
+             * */
+            const SharedMemory& get_memory() const noexcept;
+
+        private:
+            /**
+             * \brief Tells that a region contains an initialized channel (and the version of its layout).
+             * */
+            static constexpr std::uint64_t MAGIC = 0x65736521666c6f01ull;
+
+            /**
+             * \brief The beginning of the region.
+             * */
+            typedef struct _Header_
+            {
+                /**
+                 * \brief Equal to MAGIC once the channel is initialized.
+                 * */
+                std::atomic<std::uint64_t> magic;
+
+                /**
+                 * \brief The size of the elements (checked when attaching).
+                 * */
+                std::uint64_t element_size;
+
+                /**
+                 * \brief The capacity of the ring (a power of two).
+                 * */
+                std::uint64_t capacity;
+
+                /**
+                 * \brief The position of the next element to pop.
+                 * */
+                alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;
+
+                /**
+                 * \brief The position of the next element to push.
+                 * */
+                alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail;
+
+                /**
+                 * \brief Used to signal when the ring is no more empty.
+                 * */
+                alignas(ESE_FLOW_CACHE_LINE_SIZE) SharedEventCount not_empty_event;
+
+                /**
+                 * \brief Used to signal when the ring is no more full.
+                 * */
+                SharedEventCount not_full_event;
+
+                /**
+                 * \brief Incremented on every wake_up() call, so that spinning receivers can notice it.
+                 * */
+                std::atomic<std::uint32_t> wake_ups;
+            } Header;
+
+            /**
+             * \brief A slot of the ring.
+             * */
+            typedef struct _Slot_
+            {
+                /**
+                 * \brief Equal to the position for a free slot, equal to position + 1 for a full slot.
+                 * */
+                std::atomic<std::uint64_t> sequence;
+
+                /**
+                 * \brief The stored element (raw storage: elements are only copied in and out).
+                 * */
+                typename std::aligned_storage<sizeof(TElement), alignof(TElement)>::type element;
+            } Slot;
+
+            /**
+             * \brief The region in which the channel lives.
+             * */
+            SharedMemory memory;
+
+            /**
+             * \brief The header, at the beginning of the region.
+             * */
+            Header* header;
+
+            /**
+             * \brief The slots, after the header.
+             * */
+            Slot* slots;
+
+            /**
+             * \brief capacity - 1, used to map positions to slots.
+             * */
+            std::uint64_t mask;
+
+            /**
+             * \brief The channel's Receiver object.
+             * */
+            ReceiverType receiver;
+
+            /**
+             * \brief The channel's Sender object.
+             * */
+            SenderType sender;
+
+            /**
+             * \brief Get the offset of the slots from the beginning of the region.
+             * \return The offset, in bytes.
+             * */
+            static constexpr std::size_t get_slots_offset() noexcept;
+
+            /**
+             * \brief Tries to push the element in the ring.
+             * \param element The element to push.
+             * \return True if the element was pushed, false if the ring is full.
+             * */
+            bool try_push(const TElement& element) noexcept;
+
+            /**
+             * \brief Tries to pop an element from the ring.
+             * \param address The pointer to the address where the popped element have to be copied.
+             * \return True if an element was popped, false if the ring is empty.
+             * */
+            bool try_pop(TElement* address) noexcept;
+
+            friend ReceiverType;
+            friend SenderType;
+        };
+
+        /**
+         * \brief Receives elements from a SharedMemoryChannel.
+         * \param TChannel The type of SharedMemoryChannel from which it receives elements.
+         */
+        template<typename TChannel>
+        class SharedMemoryChannelReceiver final: public Receiver<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             *  brief The type of SharedMemoryChannel from which it receives elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             *  brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Tries to receive an element from the channel until a deadline.
+             * \param address The pointer to the address where the received element have to be copied.
+             * \param time The deadline.
+             * \return True if the element was received, false otherwise.
+             * */
+            bool try_receive_until_0(ElementType* address, const Deadline& time) override;
+
+            /**
+             * \brief Receives up to max elements, waiting (until a deadline) only for the first one.
+             * \param address The address where the received elements have to be copied.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             * */
+            std::size_t try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel from which it receives elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the receiver, that receives elements from a specified channel.
+             * \param channel The channel from which receives elements.
+             * */
+            SharedMemoryChannelReceiver(ChannelType& channel) noexcept;
+
+            /**
+             * \brief Pops up to max elements, without waiting, and wakes up the senders.
+             * \param address The address where the popped elements have to be copied.
+             * \param max The maximal number of elements to pop.
+             * \return The number of popped elements.
+             * */
+            std::size_t try_pop(ElementType* address, std::size_t max);
+
+            /**
+             * \brief Receives up to max elements, waiting (until a deadline) only for the first one.
+             * \param address The address where the received elements have to be copied.
+             * \param max The maximal number of elements to receive.
+             * \param time The deadline.
+             * \return The number of received elements.
+             * */
+            std::size_t try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time);
+
+            friend ChannelType;
+        };
+
+        /**
+         * \brief Send elements into a SharedMemoryChannel object.
+         * \param TChannel The type of SharedMemoryChannel in which sends elements.
+         * */
+        template<typename TChannel>
+        class SharedMemoryChannelSender final: public Sender<typename TChannel::ElementType>
+        {
+        public:
+            /**
+             * \brief The type of SharedMemoryChannel in which sends elements.
+             * */
+            typedef TChannel ChannelType;
+
+            /**
+             * \brief The type of receiving elements.
+             * */
+            typedef typename TChannel::ElementType ElementType;
+
+            /**
+             * \brief Send the element into the channel (waiting while the channel is full).
+             * \param element The element to send.
+             * */
+            void send(ElementType&& element) override;
+
+            /**
+             * \brief Send the element into the channel (waiting while the channel is full).
+             * \param element The element to send.
+             * */
+            void send(const ElementType& element) override;
+
+            /**
+             * \brief Send many elements into the channel, waking up the receivers once.
+             * \param elements The address of the first element to send.
+             * \param count The number of elements to send.
+             * */
+            void send_batch_0(ElementType* elements, std::size_t count) override;
+
+            /**
+             * \brief Tries to send the element, waiting (until a deadline) while the channel is full.
+             * \param element The address of the element to send.
+             * \param time The deadline.
+             * \return True if the element was sent, false otherwise.
+             * */
+            bool try_send_until_0(ElementType* element, const Deadline& time) override;
+
+        private:
+            /**
+             * \brief The channel in which it sends elements.
+             * */
+            ChannelType& channel;
+
+            /**
+             * \brief Construct the sender, that sends elements in a specified channel.
+             * \param channel The channel from in which sends elements.
+             * */
+            SharedMemoryChannelSender(ChannelType& channel) noexcept;
+
+            /**
+             * \brief Pushes the element, waiting (until a deadline) while the channel is full.
+             * \param element The element to push.
+             * \param time The deadline.
+             * \return True if the element was pushed, false otherwise.
+             * */
+            bool push(const ElementType& element, const Deadline& time);
+
+            /**
+             * \brief Wakes up the receivers (one or all of them), after elements were pushed.
+             * \param count The number of pushed elements.
+             * */
+            void notify_send(std::size_t count) noexcept;
+
+            friend ChannelType;
+        };
+    }
+}
+
+#include "ese/flow/template/shared-memory-channel.txx"
+
+#endif
@@ -0,0 +1,206 @@
+
+#ifndef ESE_FLOW_SHAREDMEMORY_HXX
+#define ESE_FLOW_SHAREDMEMORY_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <ese/flow/deadline.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief A region of memory mapped by many processes (a POSIX shared memory object or a memfd).
+         *
+         * The object owns the mapping and its file descriptor: both are released on destruction (a named object
+         * survives until unlink() is called). \n
+         * The setup methods throw std::system_error when the operating system refuses the request. \n
+         * */
+        class SharedMemory
+        {
+        public:
+            /**
+             * \brief Creates (and maps) a new named shared memory object, filled with zeros.
+             * \param name The name of the object (e.g. "/my-channel"). It must not exist yet.
+             * \param size The size of the object, in bytes.
+             * \return The mapped region.
+             * \sa unlink()
+             * */
+            static SharedMemory create(const std::string& name, std::size_t size);
+
+            /**
+             * \brief Maps an existing named shared memory object (all of it).
+             * \param name The name of the object.
+             * \return The mapped region.
+             * */
+            static SharedMemory open(const std::string& name);
+
+            /**
+             * \brief Creates (and maps) an anonymous shared memory object, filled with zeros.
+             * \param size The size of the object, in bytes.
+             * \return The mapped region.
+             *
+             * The object can be shared only via its file descriptor (inherited by forked processes or passed through
+             * a Unix socket), then mapped via from_fd().
+             * */
+            static SharedMemory create_anonymous(std::size_t size);
+
+            /**
+             * \brief Maps a shared memory object, given its file descriptor (all of it).
+             * \param fd The file descriptor, that is owned (and closed) by the returned object.
+             * \return The mapped region.
+             * */
+            static SharedMemory from_fd(int fd);
+
+            /**
+             * \brief Removes a named shared memory object (the mapped regions remain valid).
+             * \param name The name of the object.
+             * \return True if the object was removed, false otherwise.
+             * */
+            static bool unlink(const std::string& name) noexcept;
+
+            SharedMemory(SharedMemory&& other) noexcept;
+
+            SharedMemory& operator=(SharedMemory&& other) noexcept;
+
+            SharedMemory(const SharedMemory&) = delete;
+
+            SharedMemory& operator=(const SharedMemory&) = delete;
+
+            /**
+             * \brief Unmaps the region and closes the file descriptor.
+             * */
+            ~SharedMemory();
+
+            /**
+             * \brief Get the address of the mapped region (in this process).
+             * \return The address.
+             * */
+            void* get_address() const noexcept;
+
+            /**
+             * \brief Get the size of the mapped region.
+             * \return The size, in bytes.
+             * */
+            std::size_t get_size() const noexcept;
+
+            /**
+             * \brief Get the file descriptor of the shared memory object.
+             * \return The file descriptor.
+             * */
+            int get_fd() const noexcept;
+
+        private:
+            /**
+             * \brief The file descriptor of the shared memory object (-1 once moved away).
+             * */
+            int fd;
+
+            /**
+             * \brief The address of the mapped region.
+             * */
+            void* address;
+
+            /**
+             * \brief The size of the mapped region.
+             * */
+            std::size_t size;
+
+            /**
+             * \brief Construct the object, that owns the file descriptor and the mapping.
+             * \param fd The file descriptor.
+             * \param address The address of the mapped region.
+             * \param size The size of the mapped region.
+             * */
+            SharedMemory(int fd, void* address, std::size_t size) noexcept;
+
+            /**
+             * \brief Maps a shared memory object (closing the file descriptor on failure).
+             * \param fd The file descriptor.
+             * \param size The size to map.
+             * \return The mapped region.
+             * */
+            static SharedMemory map(int fd, std::size_t size);
+        };
+
+        /**
+         * \brief An EventCount that works among processes: it have to be placed in shared memory.
+         * \sa EventCount
+         *
+         * Threads sleep on a futex (on Linux: other systems fall back to sleeping in short steps), so the object
+         * has no pointers nor process-local state: it can be constructed by one process and used by all the
+         * processes that map it. \n
+         * All operations are thread-safe. \n
+         * */
+        class SharedEventCount
+        {
+        public:
+            /**
+             * \brief Identifies the moment in which a thread prepared to wait.
+             * */
+            typedef std::uint32_t Key;
+
+            /**
+             * \brief Construct a SharedEventCount object, with no waiting threads.
+             * */
+            SharedEventCount() noexcept;
+
+            SharedEventCount(const SharedEventCount&) = delete;
+
+            SharedEventCount& operator=(const SharedEventCount&) = delete;
+
+            /**
+             * \brief Announces that the calling thread is going to wait.
+             * \return The key to pass to wait_until().
+             *
+             * After this call, the thread have to re-check its condition and then call wait_until() or cancel_wait().
+             * */
+            Key prepare_wait() noexcept;
+
+            /**
+             * \brief Withdraws an announce made via prepare_wait().
+             * */
+            void cancel_wait() noexcept;
+
+            /**
+             * \brief Waits until a notification (that occurred after the prepare_wait() call) or a deadline.
+             * \param key The key returned by the prepare_wait() method.
+             * \param time The deadline.
+             * \return True if a notification occurred, false if the deadline was reached.
+             * */
+            bool wait_until(Key key, const Deadline& time) noexcept;
+
+            /**
+             * \brief Wakes up one of the waiting threads (if any).
+             * */
+            void notify_one() noexcept;
+
+            /**
+             * \brief Wakes up all the waiting threads (if any).
+             * */
+            void notify_all() noexcept;
+
+        private:
+            /**
+             * \brief Incremented on every notification (that finds waiting threads): the futex word.
+             * */
+            std::atomic<std::uint32_t> epoch;
+
+            /**
+             * \brief The number of threads that are waiting (or preparing to), in any process.
+             * */
+            std::atomic<std::uint32_t> waiting;
+
+            /**
+             * \brief Increments the epoch if somebody is waiting.
+             * \return True if somebody is waiting, false otherwise.
+             * */
+            bool advance() noexcept;
+        };
+    }
+}
+
+#endif
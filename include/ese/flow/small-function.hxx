@@ -0,0 +1,198 @@
+
+#ifndef ESE_FLOW_SMALLFUNCTION_HXX
+#define ESE_FLOW_SMALLFUNCTION_HXX
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * \brief The default number of bytes that a SmallFunction can store inline (without heap allocation).
+ *
+ * It can be overridden by defining it before including any ese-flow header. The default makes a SmallFunction as big
+ * as a cache line (on 64-bit platforms).
+ * */
+#ifndef ESE_FLOW_SMALL_FUNCTION_CAPACITY
+#define ESE_FLOW_SMALL_FUNCTION_CAPACITY (48)
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TSignature, std::size_t Capacity = ESE_FLOW_SMALL_FUNCTION_CAPACITY>
+        class SmallFunction;
+
+        /**
+         * \brief A move-only polymorphic function wrapper, that stores small callables inline.
+         * \tparam TResult The type returned by the call.
+         * \tparam TArgs The types of the call's arguments.
+         * \tparam Capacity The number of bytes available to store the callable inline.
+         *
+         * It is like a std::function, but callables up to Capacity bytes (with nothrow move constructor and
+         * fundamental alignment) are stored inside the object, so wrapping a typical lambda does not allocate. Bigger
+         * callables are moved on the heap. \n
+         * Not being copyable, it can wrap move-only callables (e.g. lambdas that own a std::unique_ptr). \n
+         * */
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        class SmallFunction<TResult(TArgs...), Capacity>
+        {
+        public:
+            /**
+             * \brief The type returned by the call.
+             * */
+            typedef TResult ResultType;
+
+            /**
+             * \brief Construct an empty function.
+             * */
+            SmallFunction() noexcept;
+
+            /**
+             * \brief Construct an empty function.
+             * */
+            SmallFunction(std::nullptr_t) noexcept;
+
+            /**
+             * \brief Construct a function that wraps the specified callable.
+             * \param callable The callable (moved or copied inside the function).
+             * */
+            template<typename TCallable, typename = typename std::enable_if<
+                !std::is_same<typename std::decay<TCallable>::type, SmallFunction>::value>::type>
+            SmallFunction(TCallable&& callable);
+
+            /**
+             * \brief Moves the function (the other one becomes empty).
+             * \param other The function to move.
+             * */
+            SmallFunction(SmallFunction&& other) noexcept;
+
+            SmallFunction(const SmallFunction&) = delete;
+
+            /**
+             * \brief Destroys the wrapped callable (if any).
+             * */
+            ~SmallFunction();
+
+            /**
+             * \brief Moves the function (the other one becomes empty).
+             * \param other The function to move.
+             * \return Reference to this function.
+             * */
+            SmallFunction& operator=(SmallFunction&& other) noexcept;
+
+            SmallFunction& operator=(const SmallFunction&) = delete;
+
+            /**
+             * \brief Calls the wrapped callable.
+             * \param args The arguments of the call.
+             * \return The value returned by the callable.
+             *
+             * Throws std::bad_function_call if the function is empty.
+             * */
+            TResult operator()(TArgs... args) const;
+
+            /**
+             * \brief Tells if the function wraps a callable.
+             * \return True if it is not empty, false otherwise.
+             * */
+            explicit operator bool() const noexcept;
+
+            /**
+             * \brief Tells if the wrapped callable is stored inline (or if the function is empty).
+             * \return True if no heap memory is used, false otherwise.
+             * */
+            bool is_inline() const noexcept;
+
+        private:
+            /**
+             * \brief The operations done by a manager.
+             * */
+            enum Operation
+            {
+                MOVE,
+                DESTROY,
+                IS_INLINE
+            };
+
+            /**
+             * \brief Calls the callable stored in the storage.
+             * */
+            typedef TResult (*Invoker)(void* storage, TArgs&&... args);
+
+            /**
+             * \brief Moves (from the source to the destination storage) or destroys (the destination storage) the
+             *     callable, or tells if it is stored inline (returning true).
+             * */
+            typedef bool (*Manager)(Operation operation, void* destination, void* source);
+
+            /**
+             * \brief The inline callable, or the pointer to the callable on the heap.
+             * */
+            alignas(std::max_align_t) mutable unsigned char storage[Capacity < sizeof(void*) ? sizeof(void*) : Capacity];
+
+            /**
+             * \brief Calls the wrapped callable (nullptr if empty).
+             * */
+            Invoker invoker;
+
+            /**
+             * \brief Moves and destroys the wrapped callable (nullptr if empty).
+             * */
+            Manager manager;
+
+            /**
+             * \brief Tells if a callable of the specified type is stored inline.
+             * */
+            template<typename TCallable>
+            struct _FitsInline_: std::integral_constant<bool,
+                sizeof(TCallable) <= sizeof(storage)
+                && alignof(std::max_align_t) % alignof(TCallable) == 0
+                && std::is_nothrow_move_constructible<TCallable>::value> {};
+
+            /**
+             * \brief Stores the callable (inline).
+             * */
+            template<typename TCallable, typename TForward>
+            void store(TForward&& callable, std::true_type);
+
+            /**
+             * \brief Stores the callable (on the heap).
+             * */
+            template<typename TCallable, typename TForward>
+            void store(TForward&& callable, std::false_type);
+
+            /**
+             * \brief Calls an inline callable.
+             * */
+            template<typename TCallable>
+            static TResult invoke_inline(void* storage, TArgs&&... args);
+
+            /**
+             * \brief Calls a callable on the heap.
+             * */
+            template<typename TCallable>
+            static TResult invoke_heap(void* storage, TArgs&&... args);
+
+            /**
+             * \brief Manages an inline callable.
+             * */
+            template<typename TCallable>
+            static bool manage_inline(Operation operation, void* destination, void* source) noexcept;
+
+            /**
+             * \brief Manages a callable on the heap.
+             * */
+            template<typename TCallable>
+            static bool manage_heap(Operation operation, void* destination, void* source) noexcept;
+
+            /**
+             * \brief Destroys the wrapped callable (if any), leaving the function empty.
+             * */
+            void reset() noexcept;
+        };
+    }
+}
+
+#include "template/small-function.txx"
+
+#endif
@@ -0,0 +1,202 @@
+
+#ifndef ESE_FLOW_STATICFILTER_HXX
+#define ESE_FLOW_STATICFILTER_HXX
+
+#include <type_traits>
+#include <utility>
+#include <ese/flow/filter.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Base class (CRTP) of the filters that are resolved at compile-time.
+         * \tparam TDerived The derived filter class, that implements (non-virtual) filter() methods.
+         *
+         * Unlike Filter, calling a StaticFilter does not go through a vtable, so the compiler can inline it. Static
+         * filters can be composed with the | operator into a single FusedFilter, that inlines the whole chain. \n
+         * Any callable can be used as static filter, via static_filter(). The fused chain can then be used where a
+         * (virtual) Filter is expected, via to_filter(): the chain costs one indirect call, instead of one per
+         * filter. \n
+         * */
+        template<typename TDerived>
+        class StaticFilter
+        {
+        public:
+            /**
+             * \brief Filters input element into output element.
+             * \param in The input element.
+             * \return The output element (as returned by the derived class' filter() method).
+             *
+             * TSelf defers the lookup of filter() until the call, when the derived class is complete.
+             * */
+            template<typename TIn, typename TSelf = TDerived>
+            auto operator()(TIn&& in) -> decltype(std::declval<TSelf&>().filter(std::forward<TIn>(in)));
+        };
+
+        /**
+         * \brief Tells if a type is a static filter (derived from StaticFilter).
+         * \tparam T The type.
+         * */
+        template<typename T>
+        struct IsStaticFilter: std::is_base_of<StaticFilter<T>, T> {};
+
+        /**
+         * \brief A static filter that wraps a callable.
+         * \tparam TCallable The type of the callable.
+         * \sa static_filter()
+         * */
+        template<typename TCallable>
+        class CallableFilter: public StaticFilter<CallableFilter<TCallable>>
+        {
+        public:
+            /**
+             * \brief Construct the filter.
+             * \param callable The callable that filters the elements.
+             * */
+            explicit CallableFilter(TCallable callable);
+
+            /**
+             * \brief Filters input element into output element.
+             * \param in The input element.
+             * \return The output element.
+             * */
+            template<typename TIn>
+            auto filter(TIn&& in) -> decltype(std::declval<TCallable&>()(std::forward<TIn>(in)));
+
+        private:
+            /**
+             * \brief The callable that filters the elements.
+             * */
+            TCallable callable;
+        };
+
+        /**
+         * \brief A static filter that passes the elements through two other filters, one after the other.
+         * \tparam TFirst The type of the first filter.
+         * \tparam TSecond The type of the second filter (its input is the output of the first one).
+         * */
+        template<typename TFirst, typename TSecond>
+        class FusedFilter: public StaticFilter<FusedFilter<TFirst, TSecond>>
+        {
+        public:
+            /**
+             * \brief Construct the filter.
+             * \param first The first filter.
+             * \param second The second filter.
+             * */
+            FusedFilter(TFirst first, TSecond second);
+
+            /**
+             * \brief Filters input element into output element.
+             * \param in The input element.
+             * \return The output element.
+             * */
+            template<typename TIn>
+            auto filter(TIn&& in) -> decltype(std::declval<TSecond&>()(std::declval<TFirst&>()(std::forward<TIn>(in))));
+
+        private:
+            /**
+             * \brief The first filter.
+             * */
+            TFirst first;
+
+            /**
+             * \brief The second filter.
+             * */
+            TSecond second;
+        };
+
+        /**
+         * \brief Adapts a static filter to the (virtual) Filter interface.
+         * \tparam TIn The type of input elements.
+         * \tparam TOut The type of output elements.
+         * \tparam TStatic The type of the static filter.
+         * \sa to_filter()
+         * */
+        template<typename TIn, typename TOut, typename TStatic>
+        class StaticFilterAdapter: public Filter<TIn, TOut>
+        {
+        public:
+            /**
+             * \brief Construct the adapter.
+             * \param inner The adapted static filter.
+             * */
+            explicit StaticFilterAdapter(TStatic inner);
+
+            /**
+             * \brief Filters input element into output element.
+             * \param in The input element.
+             * \return The output element.
+             * */
+            TOut filter(TIn&& in) override;
+
+            /**
+             * \brief Filters input element into output element.
+             * \param in The input element.
+             * \return The output element.
+             * */
+            TOut filter(const TIn& in) override;
+
+            /**
+             * \brief Get the adapted static filter.
+             * \return The static filter.
+             * */
+            TStatic& get_static_filter() noexcept;
+
+        private:
+            /**
+             * \brief The adapted static filter.
+             * */
+            TStatic inner;
+        };
+
+        /**
+         * \brief Wraps a callable into a static filter.
+         * \param callable The callable.
+         * \return The static filter.
+         * */
+        template<typename TCallable>
+        CallableFilter<typename std::decay<TCallable>::type> static_filter(TCallable&& callable);
+
+        /**
+         * \brief Adapts a static filter to the (virtual) Filter interface.
+         * \tparam TIn The type of input elements.
+         * \tparam TOut The type of output elements.
+         * \param filter The static filter (copied or moved into the adapter).
+         * \return The adapter.
+         * */
+        template<typename TIn, typename TOut, typename TStatic>
+        StaticFilterAdapter<TIn, TOut, typename std::decay<TStatic>::type> to_filter(TStatic&& filter);
+
+        /**
+         * \brief Composes two static filters into a single one.
+         * \param first The first filter.
+         * \param second The second filter.
+         * \return The fused filter (that holds copies of the two filters).
+         * */
+        template<typename TFirst, typename TSecond>
+        typename std::enable_if<
+            IsStaticFilter<typename std::decay<TFirst>::type>::value
+            && IsStaticFilter<typename std::decay<TSecond>::type>::value,
+            FusedFilter<typename std::decay<TFirst>::type, typename std::decay<TSecond>::type>>::type operator|(
+            TFirst&& first, TSecond&& second);
+
+        /**
+         * \brief Filters input element into output element.
+         * \param in The input element.
+         * \param filter The static filter.
+         * \return The output element.
+         * */
+        template<typename TIn, typename TFilter>
+        inline auto operator|(TIn&& in, TFilter&& filter) -> typename std::enable_if<
+            !IsStaticFilter<typename std::decay<TIn>::type>::value
+            && IsStaticFilter<typename std::decay<TFilter>::type>::value,
+            decltype(filter(std::forward<TIn>(in)))>::type;
+    }
+}
+
+#include "template/static-filter.txx"
+
+#endif
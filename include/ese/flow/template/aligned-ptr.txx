@@ -0,0 +1,44 @@
+#include <ese/flow/aligned-ptr.hxx>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename T>
+        void AlignedDelete<T>::operator()(T* object) const noexcept
+        {
+            unsigned char* storage = reinterpret_cast<unsigned char*>(object);
+            const unsigned char offset = storage[-1];
+
+            object->~T();
+            ::operator delete(storage - offset);
+        }
+
+        template<typename T, typename... TArgs>
+        AlignedPtr<T> make_aligned(TArgs&&... args)
+        {
+            static_assert(alignof(T) < 256, "make_aligned() supports alignments up to 128 bytes");
+
+            // the storage is over-allocated by the alignment: the byte before the object tells how far it was shifted
+            unsigned char* raw = static_cast<unsigned char*>(::operator new(sizeof(T) + alignof(T)));
+            const unsigned char offset = static_cast<unsigned char>(
+                alignof(T) - reinterpret_cast<std::uintptr_t>(raw) % alignof(T));
+            unsigned char* storage = raw + offset;
+
+            storage[-1] = offset;
+
+            try
+            {
+                return AlignedPtr<T>(new (storage) T(std::forward<TArgs>(args)...));
+            }
+            catch (...)
+            {
+                ::operator delete(raw);
+                throw;
+            }
+        }
+    }
+}
@@ -0,0 +1,250 @@
+#include <ese/flow/async-channel.hxx>
+#include <stdexcept>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        inline ResumeOnAwaitable::ResumeOnAwaitable(Executor<LambdaExecutable>& executor) noexcept:
+            executor(executor)
+        {
+
+        }
+
+        inline bool ResumeOnAwaitable::await_ready() const noexcept
+        {
+            return false;
+        }
+
+        inline void ResumeOnAwaitable::await_suspend(std::coroutine_handle<> handle)
+        {
+            executor.execute(LambdaExecutable([handle] ()
+                {
+                    handle.resume();
+                }));
+        }
+
+        inline void ResumeOnAwaitable::await_resume() const noexcept
+        {
+
+        }
+
+        inline ResumeOnAwaitable resume_on(Executor<LambdaExecutable>& executor) noexcept
+        {
+            return ResumeOnAwaitable(executor);
+        }
+
+        template<typename TChannel>
+        AsyncChannel<TChannel>::AsyncChannel(TChannel& channel, Executor<LambdaExecutable>& executor):
+            channel(channel),
+            executor(executor),
+            receiver(*this),
+            sender(*this)
+        {
+            if (!channel.set_listener(this))
+            {
+                throw std::logic_error("the channel already has a listener");
+            }
+        }
+
+        template<typename TChannel>
+        AsyncChannel<TChannel>::~AsyncChannel()
+        {
+            channel.set_listener(nullptr);
+        }
+
+        template<typename TChannel>
+        typename AsyncChannel<TChannel>::ReceiverType& AsyncChannel<TChannel>::get_receiver() noexcept
+        {
+            return receiver;
+        }
+
+        template<typename TChannel>
+        typename AsyncChannel<TChannel>::SenderType& AsyncChannel<TChannel>::get_sender() noexcept
+        {
+            return sender;
+        }
+
+        template<typename TChannel>
+        void AsyncChannel<TChannel>::on_send() noexcept
+        {
+            wake(receive_waiters);
+        }
+
+        template<typename TChannel>
+        void AsyncChannel<TChannel>::on_receive() noexcept
+        {
+            wake(send_waiters);
+        }
+
+        template<typename TChannel>
+        void AsyncChannel<TChannel>::wake(WaitQueue& queue) noexcept
+        {
+            Waiter* waiter;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.epoch.fetch_add(1, std::memory_order_release);
+                waiter = queue.head;
+
+                if (waiter == nullptr)
+                    return;
+
+                queue.head = waiter->next;
+
+                if (queue.head == nullptr)
+                    queue.tail = nullptr;
+            }
+
+            executor.execute(LambdaExecutable([this, waiter, &queue] ()
+                {
+                    retry(*waiter, queue);
+                }));
+        }
+
+        template<typename TChannel>
+        bool AsyncChannel<TChannel>::suspend(Waiter& waiter, WaitQueue& queue)
+        {
+            while (true)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    const std::uint64_t epoch = queue.epoch.load(std::memory_order_acquire);
+
+                    // no notification since the last attempt: the next one will find the waiter
+                    if (epoch == waiter.epoch)
+                    {
+                        waiter.next = nullptr;
+
+                        if (queue.tail == nullptr)
+                            queue.head = &waiter;
+                        else
+                            queue.tail->next = &waiter;
+
+                        queue.tail = &waiter;
+                        return true;
+                    }
+
+                    waiter.epoch = epoch;
+                }
+
+                if (waiter.attempt())
+                    return false;
+            }
+        }
+
+        template<typename TChannel>
+        void AsyncChannel<TChannel>::retry(Waiter& waiter, WaitQueue& queue)
+        {
+            waiter.epoch = queue.epoch.load(std::memory_order_acquire);
+
+            if (!waiter.attempt())
+            {
+                if (suspend(waiter, queue))
+                    return;
+            }
+            else
+            {
+                // a single notification may stand for many elements (or much space): pass it on
+                wake(queue);
+            }
+
+            waiter.handle.resume();
+        }
+
+        template<typename TAsyncChannel>
+        AsyncChannelReceiver<TAsyncChannel>::AsyncChannelReceiver(TAsyncChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TAsyncChannel>
+        typename AsyncChannelReceiver<TAsyncChannel>::Awaitable AsyncChannelReceiver<TAsyncChannel>::async_receive()
+        {
+            return Awaitable(channel);
+        }
+
+        template<typename TAsyncChannel>
+        AsyncChannelReceiver<TAsyncChannel>::Awaitable::Awaitable(TAsyncChannel& channel):
+            channel(channel),
+            element()
+        {
+
+        }
+
+        template<typename TAsyncChannel>
+        bool AsyncChannelReceiver<TAsyncChannel>::Awaitable::attempt()
+        {
+            return channel.channel.get_receiver().try_receive(&element);
+        }
+
+        template<typename TAsyncChannel>
+        bool AsyncChannelReceiver<TAsyncChannel>::Awaitable::await_ready()
+        {
+            this->epoch = channel.receive_waiters.epoch.load(std::memory_order_acquire);
+            return attempt();
+        }
+
+        template<typename TAsyncChannel>
+        bool AsyncChannelReceiver<TAsyncChannel>::Awaitable::await_suspend(std::coroutine_handle<> handle)
+        {
+            this->handle = handle;
+            return channel.suspend(*this, channel.receive_waiters);
+        }
+
+        template<typename TAsyncChannel>
+        typename AsyncChannelReceiver<TAsyncChannel>::ElementType AsyncChannelReceiver<TAsyncChannel>::Awaitable::await_resume()
+        {
+            return std::move(element);
+        }
+
+        template<typename TAsyncChannel>
+        AsyncChannelSender<TAsyncChannel>::AsyncChannelSender(TAsyncChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TAsyncChannel>
+        typename AsyncChannelSender<TAsyncChannel>::Awaitable AsyncChannelSender<TAsyncChannel>::async_send(ElementType element)
+        {
+            return Awaitable(channel, std::move(element));
+        }
+
+        template<typename TAsyncChannel>
+        AsyncChannelSender<TAsyncChannel>::Awaitable::Awaitable(TAsyncChannel& channel, ElementType&& element):
+            channel(channel),
+            element(std::move(element))
+        {
+
+        }
+
+        template<typename TAsyncChannel>
+        bool AsyncChannelSender<TAsyncChannel>::Awaitable::attempt()
+        {
+            return channel.channel.get_sender().try_send(std::move(element));
+        }
+
+        template<typename TAsyncChannel>
+        bool AsyncChannelSender<TAsyncChannel>::Awaitable::await_ready()
+        {
+            this->epoch = channel.send_waiters.epoch.load(std::memory_order_acquire);
+            return attempt();
+        }
+
+        template<typename TAsyncChannel>
+        bool AsyncChannelSender<TAsyncChannel>::Awaitable::await_suspend(std::coroutine_handle<> handle)
+        {
+            this->handle = handle;
+            return channel.suspend(*this, channel.send_waiters);
+        }
+
+        template<typename TAsyncChannel>
+        void AsyncChannelSender<TAsyncChannel>::Awaitable::await_resume() const noexcept
+        {
+
+        }
+    }
+}
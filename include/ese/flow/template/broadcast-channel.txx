@@ -0,0 +1,439 @@
+#include <ese/flow/broadcast-channel.hxx>
+#include <algorithm>
+#include <utility>
+#include <ese/flow/ring-buffer.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement, typename TWaitPolicy>
+        BroadcastChannel<TElement, TWaitPolicy>::BroadcastChannel(std::size_t capacity, SlowSubscriberPolicy policy):
+            mask(ring_buffer_round_capacity(capacity) - 1),
+            slots(new Slot[mask + 1]),
+            policy(policy),
+            next(0),
+            cached_gating(0),
+            wake_ups(0),
+            listener(nullptr),
+            sender(*this)
+        {
+            for (std::uint64_t i = 0; i <= mask; ++i)
+                slots[i].sequence.store(0, std::memory_order_relaxed);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        typename BroadcastChannel<TElement, TWaitPolicy>::ReceiverType& BroadcastChannel<TElement, TWaitPolicy>::subscribe()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            subscribers.push_back(make_aligned<ReceiverType>(*this, next));
+            return *subscribers.back();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        void BroadcastChannel<TElement, TWaitPolicy>::unsubscribe(ReceiverType& receiver)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                    [&receiver] (const AlignedPtr<ReceiverType>& subscriber)
+                    {
+                        return subscriber.get() == &receiver;
+                    }), subscribers.end());
+            }
+
+            // a sender may be waiting for the removed subscriber
+            consumed_event.notify_all();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        typename BroadcastChannel<TElement, TWaitPolicy>::SenderType& BroadcastChannel<TElement, TWaitPolicy>::get_sender() noexcept
+        {
+            return sender;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        void BroadcastChannel<TElement, TWaitPolicy>::wake_up() noexcept
+        {
+            wake_ups.fetch_add(1, std::memory_order_release);
+            published_event.notify_all();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool BroadcastChannel<TElement, TWaitPolicy>::set_listener(ChannelListener* listener) noexcept
+        {
+            if (listener == nullptr)
+            {
+                this->listener.store(nullptr, std::memory_order_release);
+                return true;
+            }
+
+            ChannelListener* current = nullptr;
+
+            return this->listener.compare_exchange_strong(current, listener, std::memory_order_acq_rel)
+                || current == listener;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::size_t BroadcastChannel<TElement, TWaitPolicy>::get_capacity() const noexcept
+        {
+            return static_cast<std::size_t>(mask + 1);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        SlowSubscriberPolicy BroadcastChannel<TElement, TWaitPolicy>::get_policy() const noexcept
+        {
+            return policy;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::size_t BroadcastChannel<TElement, TWaitPolicy>::get_subscribers_count() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return subscribers.size();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::uint64_t BroadcastChannel<TElement, TWaitPolicy>::compute_gating() const noexcept
+        {
+            std::uint64_t gating = next;
+
+            for (const AlignedPtr<ReceiverType>& subscriber: subscribers)
+                gating = std::min(gating, subscriber->cursor.load(std::memory_order_acquire) & ~ReceiverType::BUSY);
+
+            return gating;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool BroadcastChannel<TElement, TWaitPolicy>::claim(std::unique_lock<std::mutex>& lock, const Deadline& time)
+        {
+            while (true)
+            {
+                if (next <= mask)
+                    return true;
+
+                // the sequence of the element that the next one overwrites
+                const std::uint64_t wrap = next - mask - 1;
+
+                if (cached_gating > wrap)
+                    return true;
+
+                cached_gating = compute_gating();
+
+                if (cached_gating > wrap)
+                    return true;
+
+                if (policy != SlowSubscriberPolicy::BLOCK)
+                {
+                    for (const AlignedPtr<ReceiverType>& subscriber: subscribers)
+                    {
+                        std::uint64_t cursor = subscriber->cursor.load(std::memory_order_acquire);
+
+                        while ((cursor & ~ReceiverType::BUSY) <= wrap)
+                        {
+                            // the subscriber is reading the slot: it takes no longer than a visit
+                            if ((cursor & ReceiverType::BUSY) != 0)
+                            {
+                                cpu_relax();
+                                cursor = subscriber->cursor.load(std::memory_order_acquire);
+                                continue;
+                            }
+
+                            if (subscriber->cursor.compare_exchange_weak(cursor, wrap + 1, std::memory_order_acq_rel))
+                            {
+                                subscriber->skipped_count.fetch_add(wrap + 1 - cursor, std::memory_order_relaxed);
+
+                                if (policy == SlowSubscriberPolicy::LAG_DETECT)
+                                    subscriber->lagged.store(true, std::memory_order_release);
+
+                                break;
+                            }
+                        }
+                    }
+
+                    cached_gating = wrap + 1;
+                    return true;
+                }
+
+                if (time == Deadline::min())
+                    return false;
+
+                EventCount::Key key = consumed_event.prepare_wait();
+
+                if (compute_gating() > wrap)
+                {
+                    consumed_event.cancel_wait();
+                    continue;
+                }
+
+                // the subscribers do not need the mutex, but subscribe() and unsubscribe() do
+                lock.unlock();
+                const bool notified = consumed_event.wait_until(key, time);
+                lock.lock();
+
+                if (!notified)
+                {
+                    cached_gating = compute_gating();
+                    return next <= mask || cached_gating > next - mask - 1;
+                }
+            }
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        template<typename TForward>
+        void BroadcastChannel<TElement, TWaitPolicy>::publish(TForward&& element)
+        {
+            Slot& slot = slots[next & mask];
+            slot.element = std::forward<TForward>(element);
+            slot.sequence.store(next + 1, std::memory_order_release);
+            ++next;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        void BroadcastChannel<TElement, TWaitPolicy>::notify_send() noexcept
+        {
+            published_event.notify_all();
+
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+                listener->on_send();
+        }
+
+        template<typename TChannel>
+        constexpr std::uint64_t BroadcastReceiver<TChannel>::BUSY;
+
+        template<typename TChannel>
+        BroadcastReceiver<TChannel>::BroadcastReceiver(TChannel& channel, std::uint64_t cursor) noexcept:
+            channel(channel),
+            cursor(cursor),
+            lagged(false),
+            skipped_count(0)
+        {
+
+        }
+
+        template<typename TChannel>
+        template<class TVisitor>
+        bool BroadcastReceiver<TChannel>::try_visit(TVisitor& visitor)
+        {
+            while (true)
+            {
+                if (lagged.load(std::memory_order_acquire))
+                    return false;
+
+                std::uint64_t position = cursor.load(std::memory_order_acquire);
+                typename TChannel::Slot& slot = channel.slots[position & channel.mask];
+
+                if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+                {
+                    // a sender may have moved the cursor (and overwritten the slot) in the meantime
+                    if (cursor.load(std::memory_order_acquire) != position)
+                        continue;
+
+                    return false;
+                }
+
+                // with BLOCK no sender overwrites an element not read yet, otherwise the slot is "locked" by the
+                // BUSY bit (the senders wait for it, or move the cursor before it is set)
+                if (channel.policy != SlowSubscriberPolicy::BLOCK
+                    && !cursor.compare_exchange_strong(position, position | BUSY, std::memory_order_acq_rel))
+                    continue;
+
+                visitor(static_cast<const ElementType&>(slot.element));
+                cursor.store(position + 1, std::memory_order_release);
+
+                if (channel.policy == SlowSubscriberPolicy::BLOCK)
+                    channel.consumed_event.notify_all();
+
+                return true;
+            }
+        }
+
+        template<typename TChannel>
+        template<class TVisitor>
+        bool BroadcastReceiver<TChannel>::read_until(TVisitor& visitor, const Deadline& time)
+        {
+            using WaitPolicy = typename TChannel::WaitPolicyType;
+
+            const unsigned wake_ups = channel.wake_ups.load(std::memory_order_acquire);
+
+            if (try_visit(visitor))
+                return true;
+
+            if (time == Deadline::min())
+                return false;
+
+            if (WaitPolicy::spins)
+            {
+                const bool ready = WaitPolicy::spin([this, wake_ups] ()
+                    {
+                        return !is_empty() || channel.wake_ups.load(std::memory_order_acquire) != wake_ups;
+                    }, time);
+
+                if (try_visit(visitor))
+                    return true;
+
+                if (ready || !WaitPolicy::parks)
+                    return false;
+            }
+
+            // a notification does not guarantee an element to visit (e.g. it was for an element already visited):
+            // wait again until the deadline
+            while (true)
+            {
+                EventCount::Key key = channel.published_event.prepare_wait();
+
+                if (try_visit(visitor))
+                {
+                    channel.published_event.cancel_wait();
+                    return true;
+                }
+
+                if (channel.wake_ups.load(std::memory_order_acquire) != wake_ups)
+                {
+                    channel.published_event.cancel_wait();
+                    return false;
+                }
+
+                if (!channel.published_event.wait_until(key, time))
+                    return try_visit(visitor);
+            }
+        }
+
+        template<typename TChannel>
+        template<class TVisitor>
+        bool BroadcastReceiver<TChannel>::try_read(TVisitor&& visitor, bool blocking)
+        {
+            return read_until(visitor, blocking ? Deadline::max() : Deadline::min());
+        }
+
+        template<typename TChannel>
+        template<class TVisitor, class Clock, class Duration>
+        bool BroadcastReceiver<TChannel>::try_read_until(TVisitor&& visitor,
+            const std::chrono::time_point<Clock, Duration>& time)
+        {
+            return read_until(visitor, to_deadline(time));
+        }
+
+        template<typename TChannel>
+        template<class TVisitor, class Rep, class Period>
+        bool BroadcastReceiver<TChannel>::try_read_for(TVisitor&& visitor,
+            const std::chrono::duration<Rep, Period>& duration)
+        {
+            return read_until(visitor, deadline_after(duration));
+        }
+
+        template<typename TChannel>
+        bool BroadcastReceiver<TChannel>::try_receive_until_0(ElementType* address, const Deadline& time)
+        {
+            auto copy = [address] (const ElementType& element)
+                {
+                    *address = element;
+                };
+
+            return read_until(copy, time);
+        }
+
+        template<typename TChannel>
+        bool BroadcastReceiver<TChannel>::is_empty() const noexcept
+        {
+            if (lagged.load(std::memory_order_acquire))
+                return true;
+
+            const std::uint64_t position = cursor.load(std::memory_order_acquire) & ~BUSY;
+            return channel.slots[position & channel.mask].sequence.load(std::memory_order_acquire) != position + 1;
+        }
+
+        template<typename TChannel>
+        bool BroadcastReceiver<TChannel>::is_lagged() const noexcept
+        {
+            return lagged.load(std::memory_order_acquire);
+        }
+
+        template<typename TChannel>
+        void BroadcastReceiver<TChannel>::resync() noexcept
+        {
+            lagged.store(false, std::memory_order_release);
+        }
+
+        template<typename TChannel>
+        std::uint64_t BroadcastReceiver<TChannel>::get_skipped_count() const noexcept
+        {
+            return skipped_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TChannel>
+        BroadcastSender<TChannel>::BroadcastSender(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        void BroadcastSender<TChannel>::send(ElementType&& element)
+        {
+            {
+                std::unique_lock<std::mutex> lock(channel.mutex);
+                channel.claim(lock, Deadline::max());
+                channel.publish(std::move(element));
+            }
+
+            channel.notify_send();
+        }
+
+        template<typename TChannel>
+        void BroadcastSender<TChannel>::send(const ElementType& element)
+        {
+            {
+                std::unique_lock<std::mutex> lock(channel.mutex);
+                channel.claim(lock, Deadline::max());
+                channel.publish(element);
+            }
+
+            channel.notify_send();
+        }
+
+        template<typename TChannel>
+        void BroadcastSender<TChannel>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            if (count == 0)
+                return;
+
+            {
+                std::unique_lock<std::mutex> lock(channel.mutex);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    // the subscribers have to see the elements already published, to make room
+                    if (!channel.claim(lock, Deadline::min()))
+                    {
+                        lock.unlock();
+                        channel.notify_send();
+                        lock.lock();
+                        channel.claim(lock, Deadline::max());
+                    }
+
+                    channel.publish(std::move(elements[i]));
+                }
+            }
+
+            channel.notify_send();
+        }
+
+        template<typename TChannel>
+        bool BroadcastSender<TChannel>::try_send_until_0(ElementType* element, const Deadline& time)
+        {
+            {
+                std::unique_lock<std::mutex> lock(channel.mutex);
+
+                if (!channel.claim(lock, time))
+                    return false;
+
+                channel.publish(std::move(*element));
+            }
+
+            channel.notify_send();
+            return true;
+        }
+    }
+}
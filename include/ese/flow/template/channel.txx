@@ -1,36 +1,168 @@
 #include <ese/flow/channel.hxx>
+#include <chrono>
+#include <stdexcept>
 #include <utility>
 
 namespace ese
 {
     namespace flow
     {
-        template<typename TElement, typename TQueue>
-        Channel<TElement, TQueue>::Channel():
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        Channel<TElement, TQueue, TWaitPolicy>::Channel():
+            Channel(0)
+        {
+
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        Channel<TElement, TQueue, TWaitPolicy>::Channel(std::size_t capacity, OverflowPolicy overflow_policy,
+                std::size_t sample_period):
+            capacity(capacity),
+            overflow_policy(overflow_policy),
+            sample_period(sample_period == 0 ? 1 : sample_period),
+            overflows(0),
+            size(0),
+            sleeping_receivers(0),
+            sleeping_senders(0),
+            dropped_count(0),
+            blocked_count(0),
+            wake_ups(0),
+            listener(nullptr),
             receiver(*this),
             sender(*this)
         {
-
+            // a queue that reorders its elements would drop the element to be received next, not the oldest one
+            if (!IsFifoQueue<TQueue>::value
+                && (overflow_policy == OverflowPolicy::DROP_OLDEST || overflow_policy == OverflowPolicy::SAMPLE))
+                throw std::invalid_argument("DROP_OLDEST and SAMPLE require a FIFO queue");
         }
 
-        template<typename TElement, typename TQueue>
-        typename Channel<TElement, TQueue>::ReceiverType& Channel<TElement, TQueue>::get_receiver() noexcept
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        typename Channel<TElement, TQueue, TWaitPolicy>::ReceiverType& Channel<TElement, TQueue, TWaitPolicy>::get_receiver() noexcept
         {
             return receiver;
         }
 
-        template<typename TElement, typename TQueue>
-        typename Channel<TElement, TQueue>::SenderType& Channel<TElement, TQueue>::get_sender() noexcept
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        typename Channel<TElement, TQueue, TWaitPolicy>::SenderType& Channel<TElement, TQueue, TWaitPolicy>::get_sender() noexcept
         {
             return sender;
         }
 
-        template<typename TElement, typename TQueue>
-        void Channel<TElement, TQueue>::wake_up() noexcept
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        void Channel<TElement, TQueue, TWaitPolicy>::wake_up() noexcept
         {
+            {
+                LockType lock = lock_queue(LockRole::OTHER);
+                wake_ups.fetch_add(1, std::memory_order_release);
+            }
+
             condition_variable.notify_all();
         }
 
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        std::size_t Channel<TElement, TQueue, TWaitPolicy>::get_capacity() const noexcept
+        {
+            return capacity;
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        OverflowPolicy Channel<TElement, TQueue, TWaitPolicy>::get_overflow_policy() const noexcept
+        {
+            return overflow_policy;
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        std::uint64_t Channel<TElement, TQueue, TWaitPolicy>::get_dropped_count() const noexcept
+        {
+            return dropped_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        std::uint64_t Channel<TElement, TQueue, TWaitPolicy>::get_blocked_count() const noexcept
+        {
+            return blocked_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        bool Channel<TElement, TQueue, TWaitPolicy>::is_empty() const noexcept
+        {
+            return size.load(std::memory_order_acquire) == 0;
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        bool Channel<TElement, TQueue, TWaitPolicy>::set_listener(ChannelListener* listener) noexcept
+        {
+            if (listener == nullptr)
+            {
+                this->listener.store(nullptr, std::memory_order_release);
+                return true;
+            }
+
+            ChannelListener* current = nullptr;
+
+            return this->listener.compare_exchange_strong(current, listener, std::memory_order_acq_rel)
+                || current == listener;
+        }
+
+#ifdef ESE_FLOW_METRICS
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        ChannelMetrics Channel<TElement, TQueue, TWaitPolicy>::get_metrics() const noexcept
+        {
+            ChannelMetrics metrics;
+            metrics.enqueued = counters.enqueued.get();
+            metrics.dequeued = counters.dequeued.get();
+            metrics.depth = size.load(std::memory_order_relaxed);
+            metrics.high_water_mark = counters.high_water_mark.load(std::memory_order_relaxed);
+            metrics.dropped = dropped_count.load(std::memory_order_relaxed);
+            metrics.blocked = blocked_count.load(std::memory_order_relaxed);
+            metrics.lock_contentions = counters.lock_contentions.get();
+            metrics.lock_wait_ns = counters.lock_wait_ns.get();
+            metrics.spun_waits = counters.spun_waits.get();
+            metrics.slept_waits = counters.slept_waits.get();
+            metrics.timed_out_waits = counters.timed_out_waits.get();
+            return metrics;
+        }
+#endif
+
+#ifdef ESE_FLOW_LOCK_PROFILING
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        LockProfile Channel<TElement, TQueue, TWaitPolicy>::get_lock_profile() const noexcept
+        {
+            return mutex.get_profile();
+        }
+#endif
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        typename Channel<TElement, TQueue, TWaitPolicy>::LockType Channel<TElement, TQueue, TWaitPolicy>::lock_queue(
+                LockRole role)
+        {
+#ifdef ESE_FLOW_LOCK_PROFILING
+            ProfiledMutex::set_current_role(role);
+#else
+            (void) role;
+#endif
+
+#ifdef ESE_FLOW_METRICS
+            LockType lock(mutex, std::try_to_lock);
+
+            // the clock is read only when the mutex is contended
+            if (!lock.owns_lock())
+            {
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                lock.lock();
+
+                counters.lock_contentions.add();
+                counters.lock_wait_ns.add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count()));
+            }
+
+            return lock;
+#else
+            return LockType(mutex);
+#endif
+        }
+
         template <typename TQueue>
         static auto front_or_top(TQueue& queue) -> decltype(queue.top())
         {
@@ -43,12 +175,180 @@ namespace ese
             return queue.front();
         }
 
-        template<typename TElement, typename TQueue>
-        TElement Channel<TElement, TQueue>::pop_from_queue() noexcept
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        std::size_t Channel<TElement, TQueue, TWaitPolicy>::pop_from_queue(TElement* address, std::size_t max) noexcept
+        {
+            std::size_t count = 0;
+
+            for (; count < max && !queue.empty(); ++count)
+            {
+                address[count] = std::move(front_or_top(queue));
+                queue.pop();
+
+#ifdef ESE_FLOW_TRACING
+                // the elements of a priority queue do not leave it in order: their waits can not be paired
+                if (IsFifoQueue<TQueue>::value && Tracer::is_sampled(popped_sequence))
+                    Tracer::record({TraceEventType::DEQUEUE, "queue", this, popped_sequence, Tracer::now(), 0, 0});
+
+                ++popped_sequence;
+#endif
+            }
+
+            size.store(size.load(std::memory_order_relaxed) - count, std::memory_order_relaxed);
+
+#ifdef ESE_FLOW_METRICS
+            if (count != 0)
+                counters.dequeued.add(count);
+#endif
+
+            if (count != 0 && sleeping_senders != 0)
+            {
+                if (count == 1)
+                    not_full_condition_variable.notify_one();
+                else
+                    not_full_condition_variable.notify_all();
+            }
+
+            return count;
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        template<typename TForward>
+        void Channel<TElement, TQueue, TWaitPolicy>::push_to_queue(TForward&& element)
+        {
+            queue.push(std::forward<TForward>(element));
+
+#ifdef ESE_FLOW_TRACING
+            if (IsFifoQueue<TQueue>::value && Tracer::is_sampled(pushed_sequence))
+                Tracer::record({TraceEventType::ENQUEUE, "queue", this, pushed_sequence, Tracer::now(), 0, 0});
+
+            ++pushed_sequence;
+#endif
+
+            const std::size_t depth = size.load(std::memory_order_relaxed) + 1;
+            size.store(depth, std::memory_order_release);
+
+#ifdef ESE_FLOW_METRICS
+            counters.enqueued.add();
+
+            // protected by the mutex: a plain load and store are enough
+            if (depth > counters.high_water_mark.load(std::memory_order_relaxed))
+                counters.high_water_mark.store(depth, std::memory_order_relaxed);
+#endif
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        template<typename TForward>
+        bool Channel<TElement, TQueue, TWaitPolicy>::offer(LockType& lock, TForward&& element, const Deadline& time)
+        {
+            if (capacity == 0 || size.load(std::memory_order_relaxed) < capacity)
+            {
+                push_to_queue(std::forward<TForward>(element));
+                return true;
+            }
+
+            switch (overflow_policy)
+            {
+                case OverflowPolicy::DROP_NEWEST:
+                    dropped_count.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+
+                case OverflowPolicy::SAMPLE:
+                    if (++overflows % sample_period != 0)
+                    {
+                        dropped_count.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+
+                    // the sampled element replaces the oldest one
+                    // fall through
+                case OverflowPolicy::DROP_OLDEST:
+                    queue.pop();
+#ifdef ESE_FLOW_TRACING
+                    ++popped_sequence;
+#endif
+                    size.store(size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                    dropped_count.fetch_add(1, std::memory_order_relaxed);
+                    push_to_queue(std::forward<TForward>(element));
+                    return true;
+
+                case OverflowPolicy::BLOCK:
+                    break;
+            }
+
+            blocked_count.fetch_add(1, std::memory_order_relaxed);
+
+            if (time == Deadline::min())
+                return false;
+
+            if (sleeping_receivers != 0)
+                condition_variable.notify_all();
+
+            // the listener (e.g. a Poller) has to learn about the elements queued (but not notified yet) by a batch too,
+            // or nobody receives them to make space
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+            {
+                lock.unlock();
+                listener->on_send();
+                lock.lock();
+            }
+
+            auto not_full = [this] ()
+                {
+                    return size.load(std::memory_order_relaxed) < capacity;
+                };
+
+            ++sleeping_senders;
+            bool ready = true;
+
+#ifdef ESE_FLOW_LOCK_PROFILING
+            const std::chrono::steady_clock::time_point slept_at = std::chrono::steady_clock::now();
+#endif
+
+            if (time == Deadline::max())
+                not_full_condition_variable.wait(lock, not_full);
+            else
+                ready = not_full_condition_variable.wait_until(lock, time, not_full);
+
+#ifdef ESE_FLOW_LOCK_PROFILING
+            mutex.record_sleep(std::chrono::steady_clock::now() - slept_at);
+#endif
+
+            --sleeping_senders;
+
+            if (!ready)
+                return false;
+
+            push_to_queue(std::forward<TForward>(element));
+            return true;
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        void Channel<TElement, TQueue, TWaitPolicy>::notify_receivers(LockType& lock, std::size_t count)
+        {
+            const int sleeping = sleeping_receivers;
+            lock.unlock();
+
+            if (count == 0)
+                return;
+
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+                listener->on_send();
+
+            if (sleeping == 0)
+                return;
+
+            if (count == 1)
+                condition_variable.notify_one();
+            else
+                condition_variable.notify_all();
+        }
+
+        template<typename TElement, typename TQueue, typename TWaitPolicy>
+        void Channel<TElement, TQueue, TWaitPolicy>::notify_receive() noexcept
         {
-            TElement element = std::move(front_or_top(queue));
-            queue.pop();
-            return std::move(element);
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+                listener->on_receive();
         }
 
         template<typename TChannel>
@@ -63,38 +363,120 @@ namespace ese
         }
 
         template<typename TChannel>
-        bool ChannelReceiver<TChannel>::try_receive_until_0(ElementType *address, const boost::any &time)
-        {
-            using time_point_high = std::chrono::time_point<std::chrono::high_resolution_clock>;
-            using time_point_steady = std::chrono::time_point<std::chrono::steady_clock>;
-            using time_point_system = std::chrono::time_point<std::chrono::system_clock>;
-
-            if (time.type() == typeid(time_point_high))
-                return try_receive_until_1(address, boost::any_cast<time_point_high>(time));
-            else if (time.type() == typeid(time_point_steady))
-                return try_receive_until_1(address, boost::any_cast<time_point_steady>(time));
-            else if (time.type() == typeid(time_point_system))
-                return try_receive_until_1(address, boost::any_cast<time_point_system>(time));
-            else
-                throw std::exception(); // time_point type unknown
+        bool ChannelReceiver<TChannel>::try_receive_until_0(ElementType* address, const Deadline& time)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("receive");
+#endif
+
+            const bool received = try_receive_until_1(address, 1, time) != 0;
+
+            if (received)
+                channel.notify_receive();
+
+            return received;
         }
 
         template<typename TChannel>
-        template<class Clock, class Duration>
-        bool ChannelReceiver<TChannel>::try_receive_until_1(ElementType* address, const std::chrono::time_point<Clock, Duration>& time)
+        std::size_t ChannelReceiver<TChannel>::try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time)
         {
-            std::unique_lock<std::mutex> lock(channel.mutex);
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("receive");
+#endif
 
-            if (!channel_queue_not_empty_predicate())
+            if (max == 0)
+                return 0;
+
+            const std::size_t count = try_receive_until_1(address, max, time);
+
+            if (count != 0)
+                channel.notify_receive();
+
+            return count;
+        }
+
+        template<typename TChannel>
+        std::size_t ChannelReceiver<TChannel>::try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            using WaitPolicy = typename TChannel::WaitPolicyType;
+
+            typename TChannel::LockType lock = channel.lock_queue(LockRole::RECEIVER);
+            const unsigned wake_ups = channel.wake_ups.load(std::memory_order_relaxed);
+
+            if (channel_queue_not_empty_predicate())
+            {
+                return channel.pop_from_queue(address, max);
+            }
+
+            if (time == Deadline::min())
+                return 0;
+
+            if (WaitPolicy::spins)
+            {
+                lock.unlock();
+
+                const bool ready = WaitPolicy::spin([&channel = channel, wake_ups] ()
+                    {
+                        return channel.size.load(std::memory_order_acquire) != 0
+                            || channel.wake_ups.load(std::memory_order_acquire) != wake_ups;
+                    }, time);
+
+                lock = channel.lock_queue(LockRole::RECEIVER);
+
+                if (channel_queue_not_empty_predicate())
+                {
+#ifdef ESE_FLOW_METRICS
+                    channel.counters.spun_waits.add();
+#endif
+                    return channel.pop_from_queue(address, max);
+                }
+
+                if (ready || !WaitPolicy::parks)
+                {
+#ifdef ESE_FLOW_METRICS
+                    channel.counters.timed_out_waits.add();
+#endif
+                    return 0;
+                }
+            }
+
+            if (channel.wake_ups.load(std::memory_order_relaxed) != wake_ups)
             {
+#ifdef ESE_FLOW_METRICS
+                channel.counters.timed_out_waits.add();
+#endif
+                return 0;
+            }
+
+            ++channel.sleeping_receivers;
+
+#ifdef ESE_FLOW_LOCK_PROFILING
+            const std::chrono::steady_clock::time_point slept_at = std::chrono::steady_clock::now();
+#endif
+
+            if (time == Deadline::max())
+                channel.condition_variable.wait(lock);
+            else
                 channel.condition_variable.wait_until(lock, time);
 
-                if (!channel_queue_not_empty_predicate())
-                    return false;
+#ifdef ESE_FLOW_LOCK_PROFILING
+            channel.mutex.record_sleep(std::chrono::steady_clock::now() - slept_at);
+#endif
+
+            --channel.sleeping_receivers;
+
+            if (!channel_queue_not_empty_predicate())
+            {
+#ifdef ESE_FLOW_METRICS
+                channel.counters.timed_out_waits.add();
+#endif
+                return 0;
             }
 
-            *address = std::move(channel.pop_from_queue());
-            return true;
+#ifdef ESE_FLOW_METRICS
+            channel.counters.slept_waits.add();
+#endif
+            return channel.pop_from_queue(address, max);
         }
 
         template<typename TChannel>
@@ -107,17 +489,60 @@ namespace ese
         template<typename TChannel>
         void ChannelSender<TChannel>::send(ElementType&& element)
         {
-            std::lock_guard<std::mutex> lock(channel.mutex);
-            channel.queue.push(std::move(element));
-            channel.condition_variable.notify_one();
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("send");
+#endif
+
+            typename TChannel::LockType lock = channel.lock_queue(LockRole::SENDER);
+            const bool pushed = channel.offer(lock, std::move(element), Deadline::max());
+            channel.notify_receivers(lock, pushed ? 1 : 0);
         }
 
         template<typename TChannel>
         void ChannelSender<TChannel>::send(const ElementType& element)
         {
-            std::lock_guard<std::mutex> lock(channel.mutex);
-            channel.queue.push(element);
-            channel.condition_variable.notify_one();
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("send");
+#endif
+
+            typename TChannel::LockType lock = channel.lock_queue(LockRole::SENDER);
+            const bool pushed = channel.offer(lock, element, Deadline::max());
+            channel.notify_receivers(lock, pushed ? 1 : 0);
+        }
+
+        template<typename TChannel>
+        void ChannelSender<TChannel>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            if (count == 0)
+                return;
+
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("send");
+#endif
+
+            typename TChannel::LockType lock = channel.lock_queue(LockRole::SENDER);
+            std::size_t pushed = 0;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (channel.offer(lock, std::move(elements[i]), Deadline::max()))
+                    ++pushed;
+            }
+
+            channel.notify_receivers(lock, pushed);
+        }
+
+        template<typename TChannel>
+        bool ChannelSender<TChannel>::try_send_until_0(ElementType* element, const Deadline& time)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("send");
+#endif
+
+            typename TChannel::LockType lock = channel.lock_queue(LockRole::SENDER);
+            const bool pushed = channel.offer(lock, std::move(*element), time);
+            channel.notify_receivers(lock, pushed ? 1 : 0);
+            return pushed;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <ese/flow/consumer-runner.hxx>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <ese/flow/wait-policy.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        ConsumerRunner<TElement>::ConsumerRunner(ConsumerRunnerOptions options):
+            listening(false),
+            options(options)
+        {
+
+        }
+
+        template<typename TElement>
+        template<typename TChannel, typename>
+        ConsumerRunner<TElement>::ConsumerRunner(TChannel& channel, ConsumerRunnerOptions options):
+            ConsumerRunner(options)
+        {
+            if (!channel.set_listener(this))
+                throw std::logic_error("the channel already has a listener");
+
+            TChannel* address = &channel;
+            listening = true;
+            detach = [address] ()
+                {
+                    address->set_listener(nullptr);
+                };
+        }
+
+        template<typename TElement>
+        ConsumerRunner<TElement>::~ConsumerRunner()
+        {
+            stop();
+
+            if (detach)
+                detach();
+        }
+
+        template<typename TElement>
+        void ConsumerRunner<TElement>::add(ConsumerType&& consumer)
+        {
+            consumers.push_back(std::move(consumer));
+            ConsumerType& added = consumers.back();
+
+            threads.emplace_back(new Thread([this, &added] ()
+                {
+                    run(added);
+                }));
+        }
+
+        template<typename TElement>
+        void ConsumerRunner<TElement>::require_stop() noexcept
+        {
+            for (ConsumerType& consumer: consumers)
+                consumer.require_stop();
+
+            event.notify_all();
+        }
+
+        template<typename TElement>
+        void ConsumerRunner<TElement>::stop()
+        {
+            require_stop();
+
+            for (std::unique_ptr<Thread>& thread: threads)
+                thread->join();
+        }
+
+        template<typename TElement>
+        std::size_t ConsumerRunner<TElement>::get_consumers_count() const noexcept
+        {
+            return consumers.size();
+        }
+
+        template<typename TElement>
+        int ConsumerRunner<TElement>::get_consumed_count() const noexcept
+        {
+            int count = 0;
+
+            for (const ConsumerType& consumer: consumers)
+                count += consumer.get_consumed_count();
+
+            return count;
+        }
+
+        template<typename TElement>
+        void ConsumerRunner<TElement>::run(ConsumerType& consumer)
+        {
+            unsigned idle_rounds = 0;
+
+            while (!consumer.is_stop_required())
+            {
+                if (consumer.consume() != 0 || back_off(consumer, idle_rounds++) != 0)
+                    idle_rounds = 0;
+            }
+        }
+
+        template<typename TElement>
+        int ConsumerRunner<TElement>::back_off(ConsumerType& consumer, unsigned round)
+        {
+            if (round < options.spins)
+            {
+                cpu_relax();
+                return 0;
+            }
+
+            round -= options.spins;
+
+            if (round < options.yields)
+            {
+                std::this_thread::yield();
+                return 0;
+            }
+
+            // the stop request and the elements sent before prepare_wait() are checked again, so their
+            // notifications can not be lost
+            EventCount::Key key = event.prepare_wait();
+
+            if (consumer.is_stop_required())
+            {
+                event.cancel_wait();
+                return 0;
+            }
+
+            const int consumed = consumer.consume();
+
+            if (consumed != 0)
+            {
+                event.cancel_wait();
+                return consumed;
+            }
+
+            if (listening)
+            {
+                event.wait(key);
+                return 0;
+            }
+
+            // doubles up to max_sleep (the shift is bounded, so it can not overflow)
+            round = std::min(round - options.yields, 16u);
+            event.wait_until(key, std::chrono::steady_clock::now()
+                + std::min(options.min_sleep * (1 << round), options.max_sleep));
+            return 0;
+        }
+
+        template<typename TElement>
+        void ConsumerRunner<TElement>::on_send() noexcept
+        {
+            event.notify_all();
+        }
+    }
+}
@@ -1,5 +1,8 @@
 #include <ese/flow/consumer.hxx>
+#include <algorithm>
+#include <chrono>
 #include <utility>
+#include <vector>
 
 namespace ese
 {
@@ -21,15 +24,14 @@ namespace ese
         template<typename TElement>
         typename ConsumerFactory<TElement>::ConsumerType ConsumerFactory<TElement>::create_one(bool blocking)
         {
-            std::function<int(ConsumerType*)> behaviour = [this, blocking] (ConsumerType* consumer) -> int
+            typename ConsumerType::BehaviourType behaviour = [this, blocking] (ConsumerType* consumer) -> int
                 {
                     TElement element;
 
                     if (!this->receiver->try_receive(&element, blocking))
                         return 0;
 
-                    this->consume_0(std::move(element));
-                    ++consumer->data->consumed_count;
+                    this->consume_one(consumer, std::move(element));
                     return 1;
                 };
 
@@ -40,15 +42,14 @@ namespace ese
         template<class Clock, class Duration>
         typename ConsumerFactory<TElement>::ConsumerType ConsumerFactory<TElement>::create_one_until(const std::chrono::time_point<Clock, Duration> &time)
         {
-            std::function<int(ConsumerType*)> behaviour = [this, time = time] (ConsumerType* consumer) -> int
+            typename ConsumerType::BehaviourType behaviour = [this, time = time] (ConsumerType* consumer) -> int
                 {
                     TElement element;
 
                     if (!this->receiver->try_receive_until(&element, time))
                         return 0;
 
-                    this->consume_0(std::move(element));
-                    ++consumer->data->consumed_count;
+                    this->consume_one(consumer, std::move(element));
                     return 1;
                 };
 
@@ -59,45 +60,190 @@ namespace ese
         template<class Rep, class Period>
         typename ConsumerFactory<TElement>::ConsumerType ConsumerFactory<TElement>::create_one_for(const std::chrono::duration<Rep, Period>& duration)
         {
-            std::function<int(ConsumerType*)> behaviour = [this, duration = duration] (ConsumerType* consumer) -> int
+            typename ConsumerType::BehaviourType behaviour = [this, duration = duration] (ConsumerType* consumer) -> int
                 {
                     TElement element;
 
                     if (!this->receiver->try_receive_for(&element, duration))
                         return 0;
 
-                    this->consume_0(std::move(element));
-                    ++consumer->data->consumed_count;
+                    this->consume_one(consumer, std::move(element));
                     return 1;
                 };
 
             return ConsumerType(std::move(behaviour));
         }
 
+        template<typename TElement>
+        typename ConsumerFactory<TElement>::ConsumerType ConsumerFactory<TElement>::create_batch(std::size_t max, bool blocking)
+        {
+            typename ConsumerType::BehaviourType behaviour = [this, blocking, buffer = std::vector<TElement>(max)] (ConsumerType* consumer) mutable -> int
+                {
+                    const std::size_t count = this->receiver->receive_batch(buffer.data(), buffer.size(), blocking);
+
+                    if (count == 0)
+                        return 0;
+
+                    this->consume_many(consumer, buffer.data(), count);
+                    return static_cast<int>(count);
+                };
+
+            return ConsumerType(std::move(behaviour));
+        }
+
+        template<typename TElement>
+        typename ConsumerFactory<TElement>::ConsumerType ConsumerFactory<TElement>::create_adaptive(std::size_t max, bool blocking)
+        {
+            typename ConsumerType::BehaviourType behaviour = [this, blocking, size = std::min(std::size_t(1), max), buffer = std::vector<TElement>(max)] (ConsumerType* consumer) mutable -> int
+                {
+                    const std::size_t count = this->receiver->receive_batch(buffer.data(), size, blocking);
+
+                    if (count == 0)
+                        return 0;
+
+                    if (count == size)
+                        size = std::min(size * 2, buffer.size());
+                    else
+                        size = std::max(size / 2, std::size_t(1));
+
+                    this->consume_many(consumer, buffer.data(), count);
+                    return static_cast<int>(count);
+                };
+
+            return ConsumerType(std::move(behaviour));
+        }
+
+        template<typename TElement>
+        void ConsumerFactory<TElement>::consume_batch_0(TElement* elements, std::size_t count)
+        {
+#ifdef ESE_FLOW_METRICS
+            ConsumerCounters* counters = get_batch_counters();
+
+            if (counters != nullptr)
+            {
+                get_batch_counters() = nullptr;
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    consume_0(std::move(elements[i]));
+                    const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+                    counters->latency.record(static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+                }
+
+                return;
+            }
+#endif
+
+            for (std::size_t i = 0; i < count; ++i)
+                consume_0(std::move(elements[i]));
+        }
+
+        template<typename TElement>
+        void ConsumerFactory<TElement>::consume_one(ConsumerType* consumer, TElement&& element)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("consume");
+#endif
+
+#ifdef ESE_FLOW_METRICS
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            consume_0(std::move(element));
+            const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+            consumer->data.counters->consumed.fetch_add(1, std::memory_order_relaxed);
+            consumer->data.counters->latency.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+#else
+            consume_0(std::move(element));
+#endif
+
+            consumer->count_consumed(1);
+        }
+
+        template<typename TElement>
+        void ConsumerFactory<TElement>::consume_many(ConsumerType* consumer, TElement* elements, std::size_t count)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("consume");
+#endif
+
+#ifdef ESE_FLOW_METRICS
+            ConsumerCounters*& batch_counters = get_batch_counters();
+            batch_counters = consumer->data.counters.get();
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            try
+            {
+                consume_batch_0(elements, count);
+            }
+            catch (...)
+            {
+                batch_counters = nullptr;
+                throw;
+            }
+
+            const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            consumer->data.counters->consumed.fetch_add(count, std::memory_order_relaxed);
+
+            // the default consume_batch_0() clears the counters once it has timed every element, an overriding one
+            // can only be timed as a whole: every element of the batch is accounted its share of the call
+            if (batch_counters != nullptr)
+            {
+                batch_counters = nullptr;
+                consumer->data.counters->latency.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count, count);
+            }
+#else
+            consume_batch_0(elements, count);
+#endif
+
+            consumer->count_consumed(static_cast<int>(count));
+        }
+
+#ifdef ESE_FLOW_METRICS
+        template<typename TElement>
+        ConsumerCounters*& ConsumerFactory<TElement>::get_batch_counters() noexcept
+        {
+            static thread_local ConsumerCounters* counters = nullptr;
+            return counters;
+        }
+#endif
+
         template<typename TElement>
         Consumer<TElement>::Consumer(Consumer<ElementType>&& other):
             data(std::move(other.data))
         {
-            other.data = nullptr;
+
         }
 
         template<typename TElement>
         Consumer<TElement>::~Consumer()
         {
-            if (data != nullptr)
-                delete data;
+
         }
 
         template<typename TElement>
         int Consumer<TElement>::consume()
         {
-            return data->behaviour(this);
+            return data.behaviour(this);
         }
 
         template<typename TElement>
         int Consumer<TElement>::get_consumed_count() const noexcept
         {
-            return data->consumed_count;
+            return data.consumed_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        inline void Consumer<TElement>::count_consumed(int count) noexcept
+        {
+            // only the thread driving the consumer writes the count: a plain load and store are enough
+            data.consumed_count.store(data.consumed_count.load(std::memory_order_relaxed) + count,
+                std::memory_order_relaxed);
         }
 
         template<typename TElement>
@@ -109,21 +255,53 @@ namespace ese
         template<typename TElement>
         void Consumer<TElement>::require_stop() noexcept
         {
-            data->stop_required = true;
+            data.stop_required = true;
+        }
+
+        template<typename TElement>
+        bool Consumer<TElement>::is_stop_required() const noexcept
+        {
+            return data.stop_required.load(std::memory_order_acquire);
         }
 
+#ifdef ESE_FLOW_METRICS
         template<typename TElement>
-        Consumer<TElement>::InnerData::_InnerData_(std::function<int(ThisType*)>&& behaviour):
+        ConsumerMetrics Consumer<TElement>::get_metrics() const noexcept
+        {
+            ConsumerMetrics metrics;
+            metrics.consumed = data.counters->consumed.load(std::memory_order_relaxed);
+            metrics.latency = data.counters->latency.get_summary();
+            return metrics;
+        }
+#endif
+
+        template<typename TElement>
+        Consumer<TElement>::InnerData::_InnerData_(BehaviourType&& behaviour):
             behaviour(std::move(behaviour)),
             consumed_count(0),
             stop_required(false)
+#ifdef ESE_FLOW_METRICS
+            , counters(new ConsumerCounters())
+#endif
+        {
+
+        }
+
+        template<typename TElement>
+        Consumer<TElement>::InnerData::_InnerData_(_InnerData_&& other) noexcept:
+            behaviour(std::move(other.behaviour)),
+            consumed_count(other.consumed_count.load(std::memory_order_relaxed)),
+            stop_required(other.stop_required.load())
+#ifdef ESE_FLOW_METRICS
+            , counters(std::move(other.counters))
+#endif
         {
 
         }
 
         template<typename TElement>
-        Consumer<TElement>::Consumer(std::function<int(ThisType*)>&& behaviour):
-                data(new InnerData(std::move(behaviour)))
+        Consumer<TElement>::Consumer(BehaviourType&& behaviour):
+                data(std::move(behaviour))
         {
 
         }
@@ -0,0 +1,191 @@
+#include <ese/flow/deadline-channel.hxx>
+#include <algorithm>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        Deadline DeadlineOf<TElement>::operator()(const TElement& element) const
+        {
+            return element.get_deadline();
+        }
+
+        inline unsigned deadline_queue_lowest_bit(std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+            unsigned bit = 0;
+
+            while ((word & 1) == 0)
+            {
+                word >>= 1;
+                ++bit;
+            }
+
+            return bit;
+#endif
+        }
+
+        template<typename TEntry>
+        struct DeadlineQueueLater
+        {
+            bool operator()(const TEntry& a, const TEntry& b) const noexcept
+            {
+                return a.deadline > b.deadline;
+            }
+        };
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        DeadlineQueue<TElement, TDeadlineOf, Buckets>::DeadlineQueue(Deadline::duration resolution,
+            TDeadlineOf deadline_of):
+            occupied(),
+            base_tick(0),
+            count(0),
+            resolution(resolution.count() > 0 ? resolution : Deadline::duration(1)),
+            deadline_of(std::move(deadline_of))
+        {
+
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        bool DeadlineQueue<TElement, TDeadlineOf, Buckets>::empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        std::size_t DeadlineQueue<TElement, TDeadlineOf, Buckets>::size() const noexcept
+        {
+            return count;
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        TElement& DeadlineQueue<TElement, TDeadlineOf, Buckets>::front()
+        {
+            return settle().front().element;
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        void DeadlineQueue<TElement, TDeadlineOf, Buckets>::pop()
+        {
+            std::deque<Entry>& bucket = settle();
+            bucket.pop_front();
+            --count;
+
+            if (bucket.empty())
+            {
+                const std::size_t index = static_cast<std::uint64_t>(base_tick) % Buckets;
+                occupied[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+            }
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        void DeadlineQueue<TElement, TDeadlineOf, Buckets>::push(TElement&& element)
+        {
+            const Deadline deadline = deadline_of(element);
+            push_entry(Entry{deadline, std::move(element)});
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        void DeadlineQueue<TElement, TDeadlineOf, Buckets>::push(const TElement& element)
+        {
+            push_entry(Entry{deadline_of(element), element});
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        std::int64_t DeadlineQueue<TElement, TDeadlineOf, Buckets>::tick_of(const Deadline& deadline) const noexcept
+        {
+            return static_cast<std::int64_t>(deadline.time_since_epoch() / resolution);
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        void DeadlineQueue<TElement, TDeadlineOf, Buckets>::push_entry(Entry&& entry)
+        {
+            // an empty calendar starts from the first element
+            if (count == 0)
+                base_tick = tick_of(entry.deadline);
+
+            place(std::move(entry));
+            ++count;
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        void DeadlineQueue<TElement, TDeadlineOf, Buckets>::place(Entry&& entry)
+        {
+            const std::int64_t tick = std::max(tick_of(entry.deadline), base_tick);
+
+            // unsigned arithmetic: the distance does not overflow, even for Deadline::min() and Deadline::max()
+            if (static_cast<std::uint64_t>(tick) - static_cast<std::uint64_t>(base_tick) >= Buckets)
+            {
+                overflow.push_back(std::move(entry));
+                std::push_heap(overflow.begin(), overflow.end(), DeadlineQueueLater<Entry>());
+                return;
+            }
+
+            const std::size_t index = static_cast<std::uint64_t>(tick) % Buckets;
+            std::deque<Entry>& bucket = buckets[index];
+            auto position = bucket.end();
+
+            while (position != bucket.begin() && entry.deadline < (position - 1)->deadline)
+                --position;
+
+            bucket.insert(position, std::move(entry));
+            occupied[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+
+        template<typename TElement, typename TDeadlineOf, std::size_t Buckets>
+        std::deque<typename DeadlineQueue<TElement, TDeadlineOf, Buckets>::Entry>&
+            DeadlineQueue<TElement, TDeadlineOf, Buckets>::settle()
+        {
+            static const std::size_t words = Buckets / 64;
+
+            const std::size_t start = static_cast<std::uint64_t>(base_tick) % Buckets;
+
+            if (!buckets[start].empty())
+                return buckets[start];
+
+            bool found = false;
+            std::size_t distance = 0;
+
+            // the scan visits the word of the start twice: first the bits from the start, finally those before it
+            for (std::size_t i = 0; i <= words && !found; ++i)
+            {
+                const std::size_t word = (start / 64 + i) % words;
+                std::uint64_t bits = occupied[word];
+
+                if (i == 0)
+                    bits &= ~std::uint64_t(0) << (start % 64);
+                else if (i == words)
+                    bits &= ~(~std::uint64_t(0) << (start % 64));
+
+                if (bits != 0)
+                {
+                    const std::size_t index = word * 64 + deadline_queue_lowest_bit(bits);
+                    distance = (index + Buckets - start) % Buckets;
+                    found = true;
+                }
+            }
+
+            if (found)
+                base_tick += static_cast<std::int64_t>(distance);
+            else
+                base_tick = tick_of(overflow.front().deadline);
+
+            // the horizon moved forward: the overflowing elements that are now covered enter the buckets
+            while (!overflow.empty()
+                && static_cast<std::uint64_t>(tick_of(overflow.front().deadline))
+                    - static_cast<std::uint64_t>(base_tick) < Buckets)
+            {
+                std::pop_heap(overflow.begin(), overflow.end(), DeadlineQueueLater<Entry>());
+                Entry entry = std::move(overflow.back());
+                overflow.pop_back();
+                place(std::move(entry));
+            }
+
+            return buckets[static_cast<std::uint64_t>(base_tick) % Buckets];
+        }
+    }
+}
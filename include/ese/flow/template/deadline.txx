@@ -0,0 +1,52 @@
+#include <ese/flow/deadline.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<class Clock, class Duration>
+        Deadline to_deadline(const std::chrono::time_point<Clock, Duration>& time)
+        {
+            if (time == std::chrono::time_point<Clock, Duration>::max())
+                return Deadline::max();
+
+            const auto now = Clock::now();
+
+            if (time <= now)
+                return Deadline::min();
+
+            return deadline_after(time - now);
+        }
+
+        template<class Duration>
+        Deadline to_deadline(const std::chrono::time_point<std::chrono::steady_clock, Duration>& time)
+        {
+            using time_point = std::chrono::time_point<std::chrono::steady_clock, Duration>;
+
+            if (time == time_point::max())
+                return Deadline::max();
+
+            if (time == time_point::min())
+                return Deadline::min();
+
+            return std::chrono::time_point_cast<Deadline::duration>(time);
+        }
+
+        template<class Rep, class Period>
+        Deadline deadline_after(const std::chrono::duration<Rep, Period>& duration)
+        {
+            using seconds = std::chrono::duration<double>;
+
+            if (duration <= std::chrono::duration<Rep, Period>::zero())
+                return Deadline::min();
+
+            const Deadline now = Deadline::clock::now();
+
+            // compared as floating point, so that huge durations (e.g. hours::max()) can not overflow
+            if (seconds(duration) >= seconds(Deadline::max() - now))
+                return Deadline::max();
+
+            return now + std::chrono::duration_cast<Deadline::duration>(duration);
+        }
+    }
+}
@@ -0,0 +1,276 @@
+#include <ese/flow/durable-channel.hxx>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        void TrivialSerializer<TElement>::serialize(const TElement& element, std::string& buffer) const
+        {
+            buffer.append(reinterpret_cast<const char*>(&element), sizeof(TElement));
+        }
+
+        template<typename TElement>
+        bool TrivialSerializer<TElement>::deserialize(const char* data, std::size_t size, TElement* element) const
+        {
+            if (size != sizeof(TElement))
+                return false;
+
+            std::memcpy(element, data, sizeof(TElement));
+            return true;
+        }
+
+        template<typename TElement, typename TSerializer>
+        DurableChannel<TElement, TSerializer>::DurableChannel(const std::string& directory,
+            const DurableLogOptions& options, const TSerializer& serializer):
+            log(directory, options),
+            serializer(serializer),
+            wake_ups(0),
+            listener(nullptr),
+            receiver(*this),
+            sender(*this)
+        {
+            const Offset start = std::min(std::max(log.get_committed_offset(), log.get_begin_offset()),
+                log.get_end_offset());
+
+            log.seek(start, &receiver.position);
+        }
+
+        template<typename TElement, typename TSerializer>
+        typename DurableChannel<TElement, TSerializer>::ReceiverType& DurableChannel<TElement, TSerializer>::get_receiver() noexcept
+        {
+            return receiver;
+        }
+
+        template<typename TElement, typename TSerializer>
+        typename DurableChannel<TElement, TSerializer>::SenderType& DurableChannel<TElement, TSerializer>::get_sender() noexcept
+        {
+            return sender;
+        }
+
+        template<typename TElement, typename TSerializer>
+        void DurableChannel<TElement, TSerializer>::wake_up() noexcept
+        {
+            wake_ups.fetch_add(1, std::memory_order_release);
+            not_empty_event.notify_all();
+        }
+
+        template<typename TElement, typename TSerializer>
+        bool DurableChannel<TElement, TSerializer>::is_empty() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return receiver.position.offset >= log.get_end_offset();
+        }
+
+        template<typename TElement, typename TSerializer>
+        bool DurableChannel<TElement, TSerializer>::set_listener(ChannelListener* listener) noexcept
+        {
+            if (listener == nullptr)
+            {
+                this->listener.store(nullptr, std::memory_order_release);
+                return true;
+            }
+
+            ChannelListener* current = nullptr;
+
+            return this->listener.compare_exchange_strong(current, listener, std::memory_order_acq_rel)
+                || current == listener;
+        }
+
+        template<typename TElement, typename TSerializer>
+        void DurableChannel<TElement, TSerializer>::sync()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            log.sync();
+        }
+
+        template<typename TElement, typename TSerializer>
+        std::size_t DurableChannel<TElement, TSerializer>::compact()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return log.compact();
+        }
+
+        template<typename TElement, typename TSerializer>
+        typename DurableChannel<TElement, TSerializer>::Offset DurableChannel<TElement, TSerializer>::get_end_offset() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return log.get_end_offset();
+        }
+
+        template<typename TElement, typename TSerializer>
+        void DurableChannel<TElement, TSerializer>::append(const TElement& element)
+        {
+            buffer.clear();
+            serializer.serialize(element, buffer);
+            log.append(buffer.data(), buffer.size());
+        }
+
+        template<typename TElement, typename TSerializer>
+        void DurableChannel<TElement, TSerializer>::notify_send(std::size_t count) noexcept
+        {
+            if (count == 0)
+                return;
+
+            if (count == 1)
+                not_empty_event.notify_one();
+            else
+                not_empty_event.notify_all();
+
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+                listener->on_send();
+        }
+
+        template<typename TChannel>
+        DurableChannelReceiver<TChannel>::DurableChannelReceiver(TChannel& channel) noexcept:
+            channel(channel),
+            position({0, 0, 0})
+        {
+
+        }
+
+        template<typename TChannel>
+        bool DurableChannelReceiver<TChannel>::try_receive_until_0(ElementType* address, const Deadline& time)
+        {
+            return try_receive_until_1(address, 1, time) != 0;
+        }
+
+        template<typename TChannel>
+        std::size_t DurableChannelReceiver<TChannel>::try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            if (max == 0)
+                return 0;
+
+            return try_receive_until_1(address, max, time);
+        }
+
+        template<typename TChannel>
+        std::size_t DurableChannelReceiver<TChannel>::try_read(ElementType* address, std::size_t max)
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            std::size_t count = 0;
+            const char* data;
+            std::size_t size;
+
+            while (count < max)
+            {
+                DurableLog::Position next = position;
+
+                if (!channel.log.read(&next, &data, &size))
+                    break;
+
+                if (!channel.serializer.deserialize(data, size, address + count))
+                    throw std::runtime_error("an element of the durable channel can not be deserialized");
+
+                position = next;
+                ++count;
+            }
+
+            // the flush interval is checked only when the log is used: an idle sender leaves its tail to the receiver
+            if (count != 0)
+                channel.log.maybe_sync();
+
+            return count;
+        }
+
+        template<typename TChannel>
+        std::size_t DurableChannelReceiver<TChannel>::try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            const unsigned wake_ups = channel.wake_ups.load(std::memory_order_acquire);
+            std::size_t count = try_read(address, max);
+
+            if (count != 0 || time == Deadline::min())
+                return count;
+
+            EventCount::Key key = channel.not_empty_event.prepare_wait();
+            count = try_read(address, max);
+
+            if (count != 0 || channel.wake_ups.load(std::memory_order_acquire) != wake_ups)
+            {
+                channel.not_empty_event.cancel_wait();
+                return count;
+            }
+
+            channel.not_empty_event.wait_until(key, time);
+            return try_read(address, max);
+        }
+
+        template<typename TChannel>
+        void DurableChannelReceiver<TChannel>::commit()
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            channel.log.commit(position.offset);
+        }
+
+        template<typename TChannel>
+        bool DurableChannelReceiver<TChannel>::seek(Offset offset)
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            return channel.log.seek(offset, &position);
+        }
+
+        template<typename TChannel>
+        typename DurableChannelReceiver<TChannel>::Offset DurableChannelReceiver<TChannel>::get_offset() const
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            return position.offset;
+        }
+
+        template<typename TChannel>
+        typename DurableChannelReceiver<TChannel>::Offset DurableChannelReceiver<TChannel>::get_committed_offset() const
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            return channel.log.get_committed_offset();
+        }
+
+        template<typename TChannel>
+        DurableChannelSender<TChannel>::DurableChannelSender(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        void DurableChannelSender<TChannel>::send(ElementType&& element)
+        {
+            send(static_cast<const ElementType&>(element));
+        }
+
+        template<typename TChannel>
+        void DurableChannelSender<TChannel>::send(const ElementType& element)
+        {
+            {
+                std::lock_guard<std::mutex> lock(channel.mutex);
+                channel.append(element);
+                channel.log.maybe_sync();
+            }
+
+            channel.notify_send(1);
+        }
+
+        template<typename TChannel>
+        void DurableChannelSender<TChannel>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            {
+                std::lock_guard<std::mutex> lock(channel.mutex);
+
+                for (std::size_t i = 0; i < count; ++i)
+                    channel.append(elements[i]);
+
+                channel.log.maybe_sync();
+            }
+
+            channel.notify_send(count);
+        }
+
+        template<typename TChannel>
+        bool DurableChannelSender<TChannel>::try_send_until_0(ElementType* element, const Deadline&)
+        {
+            send(static_cast<const ElementType&>(*element));
+            return true;
+        }
+    }
+}
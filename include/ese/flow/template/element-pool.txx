@@ -0,0 +1,54 @@
+#include <ese/flow/element-pool.hxx>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        ElementPool<TElement>::ElementPool(std::size_t capacity):
+            elements(capacity),
+            created_count(0),
+            recycled_count(0)
+        {
+
+        }
+
+        template<typename TElement>
+        TElement ElementPool<TElement>::acquire()
+        {
+            TElement element;
+
+            if (elements.try_pop(&element))
+                recycled_count.fetch_add(1, std::memory_order_relaxed);
+            else
+                created_count.fetch_add(1, std::memory_order_relaxed);
+
+            return element;
+        }
+
+        template<typename TElement>
+        bool ElementPool<TElement>::release(TElement&& element)
+        {
+            return elements.try_push(std::move(element));
+        }
+
+        template<typename TElement>
+        std::uint64_t ElementPool<TElement>::get_created_count() const noexcept
+        {
+            return created_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        std::uint64_t ElementPool<TElement>::get_recycled_count() const noexcept
+        {
+            return recycled_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        std::size_t ElementPool<TElement>::get_capacity() const noexcept
+        {
+            return elements.get_capacity();
+        }
+    }
+}
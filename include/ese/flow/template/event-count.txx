@@ -0,0 +1,32 @@
+#include <ese/flow/event-count.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<class Clock, class Duration>
+        bool EventCount::wait_until(Key key, const std::chrono::time_point<Clock, Duration>& time)
+        {
+            if (time == std::chrono::time_point<Clock, Duration>::max())
+            {
+                wait(key);
+                return true;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            bool notified = true;
+
+            while (epoch.load(std::memory_order_relaxed) == key)
+            {
+                if (condition_variable.wait_until(lock, time) == std::cv_status::timeout)
+                {
+                    notified = epoch.load(std::memory_order_relaxed) != key;
+                    break;
+                }
+            }
+
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+            return notified;
+        }
+    }
+}
@@ -20,8 +20,12 @@ namespace ese
         }
 
         template<typename TIn, typename TOut>
-        bool FilterReceiver<TIn, TOut>::try_receive_until_0(TOut *address, const boost::any &time)
+        bool FilterReceiver<TIn, TOut>::try_receive_until_0(TOut* address, const Deadline& time)
         {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("filter");
+#endif
+
             TIn in;
 
             if (!receiver->try_receive_until_0(&in, time))
@@ -30,5 +34,37 @@ namespace ese
             *address = filter->filter(std::move(in));
             return true;
         }
+
+        template<typename TIn, typename TOut>
+        std::size_t FilterReceiver<TIn, TOut>::try_receive_batch_until_0(TOut* address, std::size_t max, const Deadline& time)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("filter");
+#endif
+
+            TIn chunk[ESE_FLOW_BATCH_CHUNK_SIZE];
+            std::size_t received = 0;
+
+            while (received < max)
+            {
+                const std::size_t wanted = max - received < ESE_FLOW_BATCH_CHUNK_SIZE
+                    ? max - received
+                    : ESE_FLOW_BATCH_CHUNK_SIZE;
+
+                const std::size_t count = received == 0
+                    ? receiver->try_receive_batch_until_0(chunk, wanted, time)
+                    : receiver->try_receive_batch_until_0(chunk, wanted, Deadline::min());
+
+                for (std::size_t i = 0; i < count; ++i)
+                    address[received + i] = filter->filter(std::move(chunk[i]));
+
+                received += count;
+
+                if (count < wanted)
+                    break;
+            }
+
+            return received;
+        }
     }
 }
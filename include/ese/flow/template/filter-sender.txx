@@ -22,13 +22,52 @@ namespace ese
         template<typename TIn, typename TOut>
         void FilterSender<TIn, TOut>::send(TIn&& element)
         {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("filter");
+#endif
+
             sender->send(filter->filter(std::move(element)));
         }
 
         template<typename TIn, typename TOut>
         void FilterSender<TIn, TOut>::send(const TIn& element)
         {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("filter");
+#endif
+
             sender->send(filter->filter(element));
         }
+
+        template<typename TIn, typename TOut>
+        void FilterSender<TIn, TOut>::send_batch_0(TIn* elements, std::size_t count)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("filter");
+#endif
+
+            TOut chunk[ESE_FLOW_BATCH_CHUNK_SIZE];
+
+            for (std::size_t sent = 0; sent < count;)
+            {
+                std::size_t filtered = 0;
+
+                for (; sent < count && filtered < ESE_FLOW_BATCH_CHUNK_SIZE; ++sent, ++filtered)
+                    chunk[filtered] = filter->filter(std::move(elements[sent]));
+
+                sender->send_batch_0(chunk, filtered);
+            }
+        }
+
+        template<typename TIn, typename TOut>
+        bool FilterSender<TIn, TOut>::try_send_until_0(TIn* element, const Deadline& time)
+        {
+#ifdef ESE_FLOW_TRACING
+            TraceSpan span("filter");
+#endif
+
+            TOut filtered = filter->filter(static_cast<const TIn&>(*element));
+            return sender->try_send_until_0(&filtered, time);
+        }
     }
 }
@@ -0,0 +1,244 @@
+#include <ese/flow/lock-free-channel.hxx>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        LockFreeChannel<TElement, TBuffer, TWaitPolicy>::LockFreeChannel(std::size_t capacity):
+            buffer(capacity),
+            wake_ups(0),
+            blocked_count(0),
+            listener(nullptr),
+            receiver(*this),
+            sender(*this)
+        {
+
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        typename LockFreeChannel<TElement, TBuffer, TWaitPolicy>::ReceiverType& LockFreeChannel<TElement, TBuffer, TWaitPolicy>::get_receiver() noexcept
+        {
+            return receiver;
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        typename LockFreeChannel<TElement, TBuffer, TWaitPolicy>::SenderType& LockFreeChannel<TElement, TBuffer, TWaitPolicy>::get_sender() noexcept
+        {
+            return sender;
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        void LockFreeChannel<TElement, TBuffer, TWaitPolicy>::wake_up() noexcept
+        {
+            wake_ups.fetch_add(1, std::memory_order_release);
+            not_empty_event.notify_all();
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        std::uint64_t LockFreeChannel<TElement, TBuffer, TWaitPolicy>::get_blocked_count() const noexcept
+        {
+            return blocked_count.load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        bool LockFreeChannel<TElement, TBuffer, TWaitPolicy>::is_empty() const noexcept
+        {
+            return buffer.is_empty();
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        bool LockFreeChannel<TElement, TBuffer, TWaitPolicy>::set_listener(ChannelListener* listener) noexcept
+        {
+            if (listener == nullptr)
+            {
+                this->listener.store(nullptr, std::memory_order_release);
+                return true;
+            }
+
+            ChannelListener* current = nullptr;
+
+            return this->listener.compare_exchange_strong(current, listener, std::memory_order_acq_rel)
+                || current == listener;
+        }
+
+        template<typename TElement, typename TBuffer, typename TWaitPolicy>
+        void LockFreeChannel<TElement, TBuffer, TWaitPolicy>::notify_send(std::size_t count) noexcept
+        {
+            if (count == 0)
+                return;
+
+            if (count == 1)
+                not_empty_event.notify_one();
+            else
+                not_empty_event.notify_all();
+
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+                listener->on_send();
+        }
+
+        template<typename TChannel>
+        LockFreeChannelReceiver<TChannel>::LockFreeChannelReceiver(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        bool LockFreeChannelReceiver<TChannel>::try_receive_until_0(ElementType* address, const Deadline& time)
+        {
+            return try_receive_until_1(address, 1, time) != 0;
+        }
+
+        template<typename TChannel>
+        std::size_t LockFreeChannelReceiver<TChannel>::try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            if (max == 0)
+                return 0;
+
+            return try_receive_until_1(address, max, time);
+        }
+
+        template<typename TChannel>
+        std::size_t LockFreeChannelReceiver<TChannel>::try_pop(ElementType* address, std::size_t max)
+        {
+            std::size_t count = 0;
+
+            while (count < max && channel.buffer.try_pop(address + count))
+                ++count;
+
+            if (count == 0)
+                return 0;
+
+            if (count == 1)
+                channel.not_full_event.notify_one();
+            else
+                channel.not_full_event.notify_all();
+
+            if (ChannelListener* listener = channel.listener.load(std::memory_order_acquire))
+                listener->on_receive();
+
+            return count;
+        }
+
+        template<typename TChannel>
+        std::size_t LockFreeChannelReceiver<TChannel>::try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            using WaitPolicy = typename TChannel::WaitPolicyType;
+
+            const unsigned wake_ups = channel.wake_ups.load(std::memory_order_acquire);
+            std::size_t count = try_pop(address, max);
+
+            if (count != 0 || time == Deadline::min())
+                return count;
+
+            if (WaitPolicy::spins)
+            {
+                const bool ready = WaitPolicy::spin([&channel = channel, wake_ups] ()
+                    {
+                        return !channel.buffer.is_empty()
+                            || channel.wake_ups.load(std::memory_order_acquire) != wake_ups;
+                    }, time);
+
+                count = try_pop(address, max);
+
+                if (count != 0 || ready || !WaitPolicy::parks)
+                    return count;
+            }
+
+            // a notification may be for an element already received (by this receiver before waiting, or by another
+            // one): wait again until the deadline
+            while (true)
+            {
+                EventCount::Key key = channel.not_empty_event.prepare_wait();
+                count = try_pop(address, max);
+
+                if (count != 0 || channel.wake_ups.load(std::memory_order_acquire) != wake_ups)
+                {
+                    channel.not_empty_event.cancel_wait();
+                    return count;
+                }
+
+                if (!channel.not_empty_event.wait_until(key, time))
+                    return try_pop(address, max);
+            }
+        }
+
+        template<typename TChannel>
+        LockFreeChannelSender<TChannel>::LockFreeChannelSender(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        template<typename TForward>
+        bool LockFreeChannelSender<TChannel>::push(TForward&& element, const Deadline& time)
+        {
+            // try_push() leaves the element untouched on failure, so it can be forwarded again
+            if (channel.buffer.try_push(std::forward<TForward>(element)))
+                return true;
+
+            channel.blocked_count.fetch_add(1, std::memory_order_relaxed);
+
+            if (time == Deadline::min())
+                return false;
+
+            do
+            {
+                // elements pushed (but not notified yet) by a batch have to be received to make space
+                channel.not_empty_event.notify_all();
+
+                if (ChannelListener* listener = channel.listener.load(std::memory_order_acquire))
+                    listener->on_send();
+                EventCount::Key key = channel.not_full_event.prepare_wait();
+
+                if (channel.buffer.try_push(std::forward<TForward>(element)))
+                {
+                    channel.not_full_event.cancel_wait();
+                    return true;
+                }
+
+                if (!channel.not_full_event.wait_until(key, time))
+                    return channel.buffer.try_push(std::forward<TForward>(element));
+            }
+            while (!channel.buffer.try_push(std::forward<TForward>(element)));
+
+            return true;
+        }
+
+        template<typename TChannel>
+        void LockFreeChannelSender<TChannel>::send(ElementType&& element)
+        {
+            push(std::move(element), Deadline::max());
+            channel.notify_send(1);
+        }
+
+        template<typename TChannel>
+        void LockFreeChannelSender<TChannel>::send(const ElementType& element)
+        {
+            push(element, Deadline::max());
+            channel.notify_send(1);
+        }
+
+        template<typename TChannel>
+        void LockFreeChannelSender<TChannel>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                push(std::move(elements[i]), Deadline::max());
+
+            channel.notify_send(count);
+        }
+
+        template<typename TChannel>
+        bool LockFreeChannelSender<TChannel>::try_send_until_0(ElementType* element, const Deadline& time)
+        {
+            if (!push(std::move(*element), time))
+                return false;
+
+            channel.notify_send(1);
+            return true;
+        }
+    }
+}
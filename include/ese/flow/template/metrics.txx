@@ -0,0 +1,150 @@
+#include <ese/flow/metrics.hxx>
+#include <algorithm>
+#include <cmath>
+
+namespace ese
+{
+    namespace flow
+    {
+        inline std::size_t metric_thread_slot() noexcept
+        {
+            static std::atomic_size_t next_slot(0);
+            static thread_local const std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+
+        inline MetricCounter::MetricCounter() noexcept
+        {
+            for (Stripe& stripe: stripes)
+                stripe.value.store(0, std::memory_order_relaxed);
+        }
+
+        inline void MetricCounter::add(std::uint64_t count) noexcept
+        {
+            stripes[metric_thread_slot() % ESE_FLOW_METRIC_STRIPES].value.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        inline std::uint64_t MetricCounter::get() const noexcept
+        {
+            std::uint64_t value = 0;
+
+            for (const Stripe& stripe: stripes)
+                value += stripe.value.load(std::memory_order_relaxed);
+
+            return value;
+        }
+
+        inline LatencyHistogram::LatencyHistogram() noexcept:
+            count(0),
+            sum(0),
+            max(0)
+        {
+            for (std::atomic<std::uint64_t>& bucket: buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+
+        inline void LatencyHistogram::record(std::uint64_t nanoseconds, std::uint64_t count) noexcept
+        {
+            buckets[get_bucket(nanoseconds)].fetch_add(count, std::memory_order_relaxed);
+            this->count.fetch_add(count, std::memory_order_relaxed);
+            sum.fetch_add(nanoseconds * count, std::memory_order_relaxed);
+
+            std::uint64_t current = max.load(std::memory_order_relaxed);
+
+            while (nanoseconds > current && !max.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed))
+                ;
+        }
+
+        inline std::uint64_t LatencyHistogram::get_count() const noexcept
+        {
+            return count.load(std::memory_order_relaxed);
+        }
+
+        inline std::uint64_t LatencyHistogram::get_percentile(double percentile) const noexcept
+        {
+            std::uint64_t total = 0;
+
+            for (const std::atomic<std::uint64_t>& bucket: buckets)
+                total += bucket.load(std::memory_order_relaxed);
+
+            if (total == 0)
+                return 0;
+
+            // the rank of the percentile, counting from 1
+            const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+            const std::uint64_t rank = std::max<std::uint64_t>(1,
+                static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total))));
+            std::uint64_t seen = 0;
+
+            for (std::size_t i = 0; i < BUCKETS_COUNT; ++i)
+            {
+                seen += buckets[i].load(std::memory_order_relaxed);
+
+                if (seen >= rank)
+                    return std::min(get_bucket_max(i), max.load(std::memory_order_relaxed));
+            }
+
+            return max.load(std::memory_order_relaxed);
+        }
+
+        inline LatencySummary LatencyHistogram::get_summary() const noexcept
+        {
+            LatencySummary summary;
+            summary.count = get_count();
+
+            if (summary.count != 0)
+                summary.mean = static_cast<double>(sum.load(std::memory_order_relaxed))
+                    / static_cast<double>(summary.count);
+
+            summary.p50 = get_percentile(50);
+            summary.p90 = get_percentile(90);
+            summary.p99 = get_percentile(99);
+            summary.p999 = get_percentile(99.9);
+            summary.max = max.load(std::memory_order_relaxed);
+            return summary;
+        }
+
+        inline std::size_t LatencyHistogram::get_bucket(std::uint64_t nanoseconds) noexcept
+        {
+            if (nanoseconds < 16)
+                return static_cast<std::size_t>(nanoseconds);
+
+            // the position of the leading bit, then the 4 bits that follow it
+            std::size_t leading = 0;
+
+            for (std::uint64_t value = nanoseconds; value > 1; value >>= 1)
+                ++leading;
+
+            const std::size_t shift = leading - 4;
+            return 16 + shift * 16 + static_cast<std::size_t>((nanoseconds >> shift) & 15);
+        }
+
+        inline std::uint64_t LatencyHistogram::get_bucket_max(std::size_t bucket) noexcept
+        {
+            if (bucket < 16)
+                return bucket;
+
+            const std::size_t shift = (bucket - 16) / 16;
+            const std::uint64_t first = (16 + static_cast<std::uint64_t>((bucket - 16) % 16)) << shift;
+            return first + ((std::uint64_t(1) << shift) - 1);
+        }
+
+        template<typename TChannel>
+        void MetricsRegistry::add_channel(const std::string& name, const TChannel& channel)
+        {
+            add_channel(name, std::function<ChannelMetrics()>([&channel] ()
+                {
+                    return channel.get_metrics();
+                }));
+        }
+
+        template<typename TConsumer>
+        void MetricsRegistry::add_consumer(const std::string& name, const TConsumer& consumer)
+        {
+            add_consumer(name, std::function<ConsumerMetrics()>([&consumer] ()
+                {
+                    return consumer.get_metrics();
+                }));
+        }
+    }
+}
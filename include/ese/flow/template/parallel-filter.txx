@@ -0,0 +1,163 @@
+#include <ese/flow/parallel-filter.hxx>
+#include <algorithm>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TIn, typename TOut>
+        ParallelFilter<TIn, TOut>::ParallelFilter(ExecutorType* executor, std::size_t parallelism, FilterType* filter,
+            SenderType* sender, ParallelOrder order, std::size_t min_slice_size):
+            executor(executor),
+            filters(std::max<std::size_t>(parallelism, 1), filter),
+            sender(sender),
+            order(order),
+            min_slice_size(std::max<std::size_t>(min_slice_size, 1)),
+            errors(filters.size()),
+            running_slices(0)
+        {
+
+        }
+
+        template<typename TIn, typename TOut>
+        ParallelFilter<TIn, TOut>::ParallelFilter(ExecutorType* executor, std::size_t parallelism,
+            const std::function<std::unique_ptr<FilterType>()>& factory, SenderType* sender, ParallelOrder order,
+            std::size_t min_slice_size):
+            ParallelFilter(executor, parallelism, static_cast<FilterType*>(nullptr), sender, order, min_slice_size)
+        {
+            for (FilterType*& filter: filters)
+            {
+                owned_filters.push_back(factory());
+                filter = owned_filters.back().get();
+            }
+        }
+
+        template<typename TIn, typename TOut>
+        ParallelFilter<TIn, TOut>::~ParallelFilter() noexcept
+        {
+
+        }
+
+        template<typename TIn, typename TOut>
+        void ParallelFilter<TIn, TOut>::send(TIn&& element)
+        {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            sender->send(filters[0]->filter(std::move(element)));
+        }
+
+        template<typename TIn, typename TOut>
+        void ParallelFilter<TIn, TOut>::send(const TIn& element)
+        {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            sender->send(filters[0]->filter(element));
+        }
+
+        template<typename TIn, typename TOut>
+        void ParallelFilter<TIn, TOut>::send_batch_0(TIn* elements, std::size_t count)
+        {
+            if (count == 0)
+                return;
+
+            std::lock_guard<std::mutex> lock(send_mutex);
+            const std::size_t slices = std::min(filters.size(), (count + min_slice_size - 1) / min_slice_size);
+            const std::size_t slice_size = count / slices;
+            const std::size_t remainder = count % slices;
+
+            if (order == ParallelOrder::ORDERED)
+                output.resize(count);
+
+            running_slices = slices;
+
+            // the first slices get one more element, so that the sizes differ by one at most
+            for (std::size_t index = slices - 1, offset = count; index > 0; --index)
+            {
+                const std::size_t size = slice_size + (index < remainder ? 1 : 0);
+                offset -= size;
+                executor->execute([this, index, elements, offset, size] ()
+                    {
+                        filter_slice(index, elements + offset, offset, size);
+                    });
+            }
+
+            filter_slice(0, elements, 0, slice_size + (remainder > 0 ? 1 : 0));
+
+            {
+                std::unique_lock<std::mutex> slices_lock(slices_mutex);
+                finished_condition_variable.wait(slices_lock, [this] () { return running_slices == 0; });
+            }
+
+            for (std::size_t index = 0; index < slices; ++index)
+            {
+                if (errors[index])
+                {
+                    std::exception_ptr error = std::move(errors[index]);
+                    std::fill(errors.begin(), errors.end(), nullptr);
+                    std::rethrow_exception(error);
+                }
+            }
+
+            if (order == ParallelOrder::ORDERED)
+                sender->send_batch_0(output.data(), count);
+        }
+
+        template<typename TIn, typename TOut>
+        bool ParallelFilter<TIn, TOut>::try_send_until_0(TIn* element, const Deadline& time)
+        {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            TOut filtered = filters[0]->filter(static_cast<const TIn&>(*element));
+            return sender->try_send_until_0(&filtered, time);
+        }
+
+        template<typename TIn, typename TOut>
+        std::size_t ParallelFilter<TIn, TOut>::get_parallelism() const noexcept
+        {
+            return filters.size();
+        }
+
+        template<typename TIn, typename TOut>
+        void ParallelFilter<TIn, TOut>::filter_slice(std::size_t index, TIn* elements, std::size_t offset,
+            std::size_t count) noexcept
+        {
+            FilterType* filter = filters[index];
+
+            try
+            {
+                if (order == ParallelOrder::ORDERED)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                        output[offset + i] = filter->filter(std::move(elements[i]));
+                }
+                else
+                {
+                    TOut chunk[ESE_FLOW_BATCH_CHUNK_SIZE];
+
+                    for (std::size_t sent = 0; sent < count;)
+                    {
+                        std::size_t filtered = 0;
+
+                        for (; sent < count && filtered < ESE_FLOW_BATCH_CHUNK_SIZE; ++sent, ++filtered)
+                            chunk[filtered] = filter->filter(std::move(elements[sent]));
+
+                        sender->send_batch_0(chunk, filtered);
+                    }
+                }
+            }
+            catch (...)
+            {
+                errors[index] = std::current_exception();
+            }
+
+            finish_slice();
+        }
+
+        template<typename TIn, typename TOut>
+        void ParallelFilter<TIn, TOut>::finish_slice()
+        {
+            std::lock_guard<std::mutex> lock(slices_mutex);
+
+            if (--running_slices == 0)
+                finished_condition_variable.notify_all();
+        }
+    }
+}
@@ -0,0 +1,306 @@
+#include <ese/flow/pipeline.hxx>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/filter-sender.hxx>
+#include <stdexcept>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TIn, typename TOut>
+        ParallelStage<TIn, TOut>::ParallelStage(std::size_t parallelism, Filter<TIn, TOut>* filter) noexcept:
+            parallelism(parallelism == 0 ? 1 : parallelism),
+            filter(filter)
+        {
+
+        }
+
+        template<typename TIn, typename TOut>
+        ParallelStage<TIn, TOut>::ParallelStage(std::size_t parallelism, FactoryType factory):
+            parallelism(parallelism == 0 ? 1 : parallelism),
+            filter(nullptr),
+            factory(std::move(factory))
+        {
+
+        }
+
+        template<typename TIn, typename TOut>
+        StatelessFilter<TIn, TOut>::StatelessFilter(Filter<TIn, TOut>* filter) noexcept:
+            filter(filter)
+        {
+
+        }
+
+        template<typename TIn, typename TOut>
+        ParallelStage<TIn, TOut> parallel(std::size_t parallelism, Filter<TIn, TOut>& filter) noexcept
+        {
+            return ParallelStage<TIn, TOut>(parallelism, &filter);
+        }
+
+        template<typename TFactory, typename TFilter>
+        ParallelStage<typename TFilter::InType, typename TFilter::OutType> parallel(std::size_t parallelism,
+            TFactory factory)
+        {
+            return ParallelStage<typename TFilter::InType, typename TFilter::OutType>(parallelism, std::move(factory));
+        }
+
+        template<typename TIn, typename TOut>
+        ParallelStage<TIn, TOut> stage(Filter<TIn, TOut>& filter) noexcept
+        {
+            return ParallelStage<TIn, TOut>(1, &filter);
+        }
+
+        template<typename TIn, typename TOut>
+        StatelessFilter<TIn, TOut> stateless(Filter<TIn, TOut>& filter) noexcept
+        {
+            return StatelessFilter<TIn, TOut>(&filter);
+        }
+
+        template<typename TElement>
+        Pipeline<TElement>::Pipeline(Receiver<TElement>& source, std::size_t channel_capacity,
+            std::chrono::milliseconds poll_interval):
+            state(new PipelineState(channel_capacity, poll_interval))
+        {
+            PipelineState* state = this->state.get();
+            PipelineState::Stage* stage = state->add_stage(nullptr, 1);
+            Receiver<TElement>* input = &source;
+
+            this->stage = stage;
+            close = [state, stage, input] (Sender<TElement>* output)
+                {
+                    add_body(state, stage, input, output);
+                };
+        }
+
+        template<typename TElement>
+        template<typename TChannel, typename>
+        Pipeline<TElement>::Pipeline(TChannel& source, std::size_t channel_capacity):
+            Pipeline(source.get_receiver(), channel_capacity)
+        {
+            if (!source.set_listener(stage))
+                throw std::logic_error("the channel already has a listener");
+
+            TChannel* address = &source;
+            stage->listening = true;
+            stage->detach = [address] ()
+                {
+                    address->set_listener(nullptr);
+                };
+        }
+
+        template<typename TElement>
+        Pipeline<TElement>::Pipeline(std::unique_ptr<PipelineState>&& state, PipelineState::Stage* stage,
+            SmallFunction<void(Sender<TElement>*)>&& close) noexcept:
+            state(std::move(state)),
+            stage(stage),
+            close(std::move(close))
+        {
+
+        }
+
+        template<typename TElement>
+        void Pipeline<TElement>::add_body(PipelineState* state, PipelineState::Stage* stage,
+            Receiver<TElement>* input, Sender<TElement>* output)
+        {
+            stage->running.fetch_add(1, std::memory_order_relaxed);
+
+            state->bodies.emplace_back([state, stage, input, output] ()
+                {
+                    TElement element;
+
+                    while (true)
+                    {
+                        const bool received = stage->listening
+                            ? input->try_receive(&element)
+                            : input->try_receive_for(&element, state->poll_interval);
+
+                        if (received)
+                        {
+                            output->send(std::move(element));
+                            continue;
+                        }
+
+                        if (stage->listening)
+                        {
+                            // the finished input is checked after prepare_wait() too, so its notification is not lost
+                            EventCount::Key key = stage->input_event.prepare_wait();
+
+                            if (input->try_receive(&element))
+                            {
+                                stage->input_event.cancel_wait();
+                                output->send(std::move(element));
+                                continue;
+                            }
+
+                            if (!state->is_input_finished(*stage))
+                            {
+                                stage->input_event.wait(key);
+                                continue;
+                            }
+
+                            stage->input_event.cancel_wait();
+                        }
+                        else if (!state->is_input_finished(*stage))
+                            continue;
+
+                        // nothing else will be sent to the input: forward what is left and exit
+                        while (input->try_receive(&element))
+                            output->send(std::move(element));
+
+                        break;
+                    }
+
+                    state->finish_thread(*stage);
+                });
+        }
+
+        template<typename TElement>
+        template<typename TNext>
+        Pipeline<TNext> Pipeline<TElement>::then(Filter<TElement, TNext>& filter)
+        {
+            // the threads of a parallel stage would share the filter: it gets its own thread instead
+            if (stage->parallelism > 1)
+                return then(ParallelStage<TElement, TNext>(1, &filter));
+
+            return fuse(&filter);
+        }
+
+        template<typename TElement>
+        template<typename TNext>
+        Pipeline<TNext> Pipeline<TElement>::then(const StatelessFilter<TElement, TNext>& filter)
+        {
+            return fuse(filter.filter);
+        }
+
+        template<typename TElement>
+        template<typename TNext>
+        Pipeline<TNext> Pipeline<TElement>::fuse(Filter<TElement, TNext>* filter)
+        {
+            PipelineState* state = this->state.get();
+
+            // the filter is fused into the open stage: its threads call it before sending to the next sender
+            return Pipeline<TNext>(std::move(this->state), stage,
+                [state, filter, previous = std::move(close)] (Sender<TNext>* output)
+                    {
+                        std::shared_ptr<FilterSender<TElement, TNext>> sender =
+                            std::make_shared<FilterSender<TElement, TNext>>(filter, output);
+
+                        state->resources.push_back(sender);
+                        previous(sender.get());
+                    });
+        }
+
+        template<typename TElement>
+        template<typename TNext>
+        Pipeline<TNext> Pipeline<TElement>::then(const ParallelStage<TElement, TNext>& stage)
+        {
+            PipelineState* state = this->state.get();
+            std::shared_ptr<Channel<TElement>> channel =
+                std::make_shared<Channel<TElement>>(state->channel_capacity);
+
+            state->resources.push_back(channel);
+            close(&channel->get_sender());
+
+            PipelineState::Stage* next = state->add_stage(this->stage, stage.parallelism);
+            Receiver<TElement>* input = &channel->get_receiver();
+
+            // the threads of the new stage park on the channel, until the open stage finished
+            channel->set_listener(next);
+            next->listening = true;
+
+            return Pipeline<TNext>(std::move(this->state), next,
+                [state, next, input, stage] (Sender<TNext>* output)
+                    {
+                        for (std::size_t i = 0; i < stage.parallelism; ++i)
+                        {
+                            Filter<TElement, TNext>* filter = stage.filter;
+
+                            if (stage.factory)
+                            {
+                                std::shared_ptr<Filter<TElement, TNext>> owned = stage.factory();
+                                state->resources.push_back(owned);
+                                filter = owned.get();
+                            }
+
+                            std::shared_ptr<FilterSender<TElement, TNext>> sender =
+                                std::make_shared<FilterSender<TElement, TNext>>(filter, output);
+
+                            state->resources.push_back(sender);
+                            add_body(state, next, input, sender.get());
+                        }
+                    });
+        }
+
+        template<typename TElement>
+        RunningPipeline Pipeline<TElement>::into(Sender<TElement>& sink)
+        {
+            close(&sink);
+            return RunningPipeline(std::move(state));
+        }
+
+        template<typename TElement>
+        RunningPipeline Pipeline<TElement>::into(Sender<TElement>& sink, const CpuTopology& topology)
+        {
+            close(&sink);
+
+            // the bodies are added stage after stage, so that adjacent stages get adjacent cores
+            std::vector<ThreadOptions> options = topology.layout(state->bodies.size(), "flow-");
+            return RunningPipeline(std::move(state), std::move(options));
+        }
+
+        template<typename TElement>
+        Pipeline<TElement> pipeline(Receiver<TElement>& source, std::size_t channel_capacity)
+        {
+            return Pipeline<TElement>(source, channel_capacity);
+        }
+
+        template<typename TChannel, typename>
+        Pipeline<typename TChannel::ElementType> pipeline(TChannel& source, std::size_t channel_capacity)
+        {
+            return Pipeline<typename TChannel::ElementType>(source, channel_capacity);
+        }
+
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Receiver<TIn>& source, Filter<TIn, TOut>& filter)
+        {
+            return pipeline(source).then(filter);
+        }
+
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Receiver<TIn>& source, const StatelessFilter<TIn, TOut>& filter)
+        {
+            return pipeline(source).then(filter);
+        }
+
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Receiver<TIn>& source, const ParallelStage<TIn, TOut>& stage)
+        {
+            return pipeline(source).then(stage);
+        }
+
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Pipeline<TIn>&& pipeline, Filter<TIn, TOut>& filter)
+        {
+            return pipeline.then(filter);
+        }
+
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Pipeline<TIn>&& pipeline, const StatelessFilter<TIn, TOut>& filter)
+        {
+            return pipeline.then(filter);
+        }
+
+        template<typename TIn, typename TOut>
+        Pipeline<TOut> operator|(Pipeline<TIn>&& pipeline, const ParallelStage<TIn, TOut>& stage)
+        {
+            return pipeline.then(stage);
+        }
+
+        template<typename TElement>
+        RunningPipeline operator|(Pipeline<TElement>&& pipeline, Sender<TElement>& sink)
+        {
+            return pipeline.into(sink);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include <ese/flow/poller.hxx>
+#include <stdexcept>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        std::size_t Poller::add(TChannel& channel, unsigned weight)
+        {
+            if (!channel.set_listener(this))
+            {
+                throw std::logic_error("the channel already has a listener");
+            }
+
+            TChannel* address = &channel;
+
+            try
+            {
+                sources.push_back(Source{
+                    [address] () { return !address->is_empty(); },
+                    [address] () { address->set_listener(nullptr); },
+                    weight == 0 ? 1 : weight});
+            }
+            catch (...)
+            {
+                channel.set_listener(nullptr);
+                throw;
+            }
+
+            return sources.size() - 1;
+        }
+
+        template<class Clock, class Duration>
+        std::size_t Poller::wait_until(const std::chrono::time_point<Clock, Duration>& time)
+        {
+            return wait_until_0(to_deadline(time));
+        }
+
+        template<class Rep, class Period>
+        std::size_t Poller::wait_for(const std::chrono::duration<Rep, Period>& duration)
+        {
+            return wait_until_0(deadline_after(duration));
+        }
+    }
+}
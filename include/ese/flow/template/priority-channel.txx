@@ -0,0 +1,108 @@
+#include <ese/flow/priority-channel.hxx>
+#include <new>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        std::size_t PriorityOf<TElement>::operator()(const TElement& element) const
+        {
+            return static_cast<std::size_t>(element.get_priority());
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        PriorityRingBuffer<TElement, Levels, TPriorityOf>::PriorityRingBuffer(std::size_t capacity,
+            TPriorityOf priority_of):
+            priority_of(std::move(priority_of))
+        {
+            std::size_t constructed = 0;
+
+            try
+            {
+                for (; constructed < Levels; ++constructed)
+                    new (&storage[constructed]) MpmcRingBuffer<TElement>(capacity);
+            }
+            catch (...)
+            {
+                // the destructor does not run for a partially constructed object
+                while (constructed > 0)
+                    level(--constructed).~MpmcRingBuffer<TElement>();
+
+                throw;
+            }
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        PriorityRingBuffer<TElement, Levels, TPriorityOf>::~PriorityRingBuffer()
+        {
+            for (std::size_t i = 0; i < Levels; ++i)
+                level(i).~MpmcRingBuffer<TElement>();
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        inline MpmcRingBuffer<TElement>& PriorityRingBuffer<TElement, Levels, TPriorityOf>::level(
+            std::size_t index) noexcept
+        {
+            return *reinterpret_cast<MpmcRingBuffer<TElement>*>(&storage[index]);
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        inline const MpmcRingBuffer<TElement>& PriorityRingBuffer<TElement, Levels, TPriorityOf>::level(
+            std::size_t index) const noexcept
+        {
+            return *reinterpret_cast<const MpmcRingBuffer<TElement>*>(&storage[index]);
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        inline MpmcRingBuffer<TElement>& PriorityRingBuffer<TElement, Levels, TPriorityOf>::level_of(
+            const TElement& element)
+        {
+            const std::size_t index = priority_of(element);
+            return level(index < Levels ? index : Levels - 1);
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        bool PriorityRingBuffer<TElement, Levels, TPriorityOf>::try_push(TElement&& element)
+        {
+            return level_of(element).try_push(std::move(element));
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        bool PriorityRingBuffer<TElement, Levels, TPriorityOf>::try_push(const TElement& element)
+        {
+            return level_of(element).try_push(element);
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        bool PriorityRingBuffer<TElement, Levels, TPriorityOf>::try_pop(TElement* address)
+        {
+            for (std::size_t i = 0; i < Levels; ++i)
+            {
+                if (level(i).try_pop(address))
+                    return true;
+            }
+
+            return false;
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        bool PriorityRingBuffer<TElement, Levels, TPriorityOf>::is_empty() const noexcept
+        {
+            for (std::size_t i = 0; i < Levels; ++i)
+            {
+                if (!level(i).is_empty())
+                    return false;
+            }
+
+            return true;
+        }
+
+        template<typename TElement, std::size_t Levels, typename TPriorityOf>
+        std::size_t PriorityRingBuffer<TElement, Levels, TPriorityOf>::get_capacity() const noexcept
+        {
+            return level(0).get_capacity();
+        }
+    }
+}
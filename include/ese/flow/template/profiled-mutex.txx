@@ -0,0 +1,16 @@
+#include <ese/flow/profiled-mutex.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TChannel>
+        void LockProfiler::add(const std::string& name, const TChannel& channel)
+        {
+            add(name, std::function<LockProfile()>([&channel] ()
+                {
+                    return channel.get_lock_profile();
+                }));
+        }
+    }
+}
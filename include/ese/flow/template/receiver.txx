@@ -1,4 +1,5 @@
 #include <ese/flow/receiver.hxx>
+#include <algorithm>
 #include <chrono>
 #include <utility>
 
@@ -23,22 +24,79 @@ namespace ese
         template<typename TElement>
         bool Receiver<TElement>::try_receive(TElement* address, bool blocking)
         {
-            using time_point = std::chrono::time_point<std::chrono::high_resolution_clock>;
-            return try_receive_until(address, blocking ? time_point::max() : time_point::min());
+            return try_receive_until_0(address, blocking ? Deadline::max() : Deadline::min());
         }
 
         template<typename TElement>
         template<class Clock, class Duration>
         bool Receiver<TElement>::try_receive_until(TElement* address, const std::chrono::time_point<Clock, Duration>& time)
         {
-            return try_receive_until_0(address, std::chrono::time_point_cast<typename Clock::duration>(time));
+            return try_receive_until_0(address, to_deadline(time));
         }
 
         template<typename TElement>
         template<class Rep, class Period>
         bool Receiver<TElement>::try_receive_for(TElement* address, const std::chrono::duration<Rep, Period>& duration)
         {
-            return try_receive_until(address, std::chrono::high_resolution_clock::now() + duration);
+            return try_receive_until_0(address, deadline_after(duration));
+        }
+
+        template<typename TElement>
+        template<class TOutputIterator, class Clock, class Duration>
+        std::size_t Receiver<TElement>::receive_batch(TOutputIterator out, std::size_t max,
+            const std::chrono::time_point<Clock, Duration>& time)
+        {
+            TElement chunk[ESE_FLOW_BATCH_CHUNK_SIZE];
+            const Deadline deadline = to_deadline(time);
+            std::size_t received = 0;
+
+            while (received < max)
+            {
+                const std::size_t wanted = max - received < ESE_FLOW_BATCH_CHUNK_SIZE
+                    ? max - received
+                    : ESE_FLOW_BATCH_CHUNK_SIZE;
+
+                const std::size_t count = received == 0
+                    ? try_receive_batch_until_0(chunk, wanted, deadline)
+                    : try_receive_batch_until_0(chunk, wanted, Deadline::min());
+
+                out = std::move(chunk, chunk + count, out);
+                received += count;
+
+                if (count < wanted)
+                    break;
+            }
+
+            return received;
+        }
+
+        template<typename TElement>
+        template<class Clock, class Duration>
+        std::size_t Receiver<TElement>::receive_batch(TElement* address, std::size_t max,
+            const std::chrono::time_point<Clock, Duration>& time)
+        {
+            return try_receive_batch_until_0(address, max, to_deadline(time));
+        }
+
+        template<typename TElement>
+        template<class TOutputIterator>
+        std::size_t Receiver<TElement>::receive_batch(TOutputIterator out, std::size_t max, bool blocking)
+        {
+            return receive_batch(out, max, blocking ? Deadline::max() : Deadline::min());
+        }
+
+        template<typename TElement>
+        std::size_t Receiver<TElement>::try_receive_batch_until_0(TElement* address, std::size_t max, const Deadline& time)
+        {
+            if (max == 0 || !try_receive_until_0(address, time))
+                return 0;
+
+            std::size_t received = 1;
+
+            while (received < max && try_receive_until_0(address + received, Deadline::min()))
+                ++received;
+
+            return received;
         }
     }
 }
\ No newline at end of file
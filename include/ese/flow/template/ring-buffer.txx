@@ -0,0 +1,216 @@
+#include <ese/flow/ring-buffer.hxx>
+#include <cstdint>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        inline std::size_t ring_buffer_round_capacity(std::size_t capacity) noexcept
+        {
+            std::size_t rounded = 1;
+
+            while (rounded < capacity)
+                rounded <<= 1;
+
+            return rounded;
+        }
+
+        template<typename TElement>
+        SpscRingBuffer<TElement>::SpscRingBuffer(std::size_t capacity):
+            mask(ring_buffer_round_capacity(capacity) - 1),
+            slots(new TElement[mask + 1]),
+            head(0),
+            cached_tail(0),
+            tail(0),
+            cached_head(0)
+        {
+
+        }
+
+        template<typename TElement>
+        TElement* SpscRingBuffer<TElement>::acquire_push_slot() noexcept
+        {
+            const std::size_t position = tail.load(std::memory_order_relaxed);
+
+            if (position - cached_head > mask)
+            {
+                cached_head = head.load(std::memory_order_acquire);
+
+                if (position - cached_head > mask)
+                    return nullptr;
+            }
+
+            return &slots[position & mask];
+        }
+
+        template<typename TElement>
+        bool SpscRingBuffer<TElement>::try_push(TElement&& element)
+        {
+            TElement* slot = acquire_push_slot();
+
+            if (slot == nullptr)
+                return false;
+
+            *slot = std::move(element);
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement>
+        bool SpscRingBuffer<TElement>::try_push(const TElement& element)
+        {
+            TElement* slot = acquire_push_slot();
+
+            if (slot == nullptr)
+                return false;
+
+            *slot = element;
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement>
+        bool SpscRingBuffer<TElement>::try_pop(TElement* address)
+        {
+            const std::size_t position = head.load(std::memory_order_relaxed);
+
+            if (position == cached_tail)
+            {
+                cached_tail = tail.load(std::memory_order_acquire);
+
+                if (position == cached_tail)
+                    return false;
+            }
+
+            *address = std::move(slots[position & mask]);
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement>
+        bool SpscRingBuffer<TElement>::is_empty() const noexcept
+        {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+        template<typename TElement>
+        std::size_t SpscRingBuffer<TElement>::get_capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+        template<typename TElement>
+        MpmcRingBuffer<TElement>::MpmcRingBuffer(std::size_t capacity):
+            mask(ring_buffer_round_capacity(capacity) - 1),
+            slots(new Slot[mask + 1]),
+            head(0),
+            tail(0)
+        {
+            for (std::size_t i = 0; i <= mask; ++i)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        typename MpmcRingBuffer<TElement>::Slot* MpmcRingBuffer<TElement>::acquire_push_slot(std::size_t* position) noexcept
+        {
+            std::size_t current = tail.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Slot* slot = &slots[current & mask];
+                const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const std::intptr_t difference = static_cast<std::intptr_t>(sequence - current);
+
+                if (difference == 0)
+                {
+                    if (tail.compare_exchange_weak(current, current + 1, std::memory_order_relaxed))
+                    {
+                        *position = current;
+                        return slot;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return nullptr;
+                }
+                else
+                {
+                    current = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template<typename TElement>
+        bool MpmcRingBuffer<TElement>::try_push(TElement&& element)
+        {
+            std::size_t position;
+            Slot* slot = acquire_push_slot(&position);
+
+            if (slot == nullptr)
+                return false;
+
+            slot->element = std::move(element);
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement>
+        bool MpmcRingBuffer<TElement>::try_push(const TElement& element)
+        {
+            std::size_t position;
+            Slot* slot = acquire_push_slot(&position);
+
+            if (slot == nullptr)
+                return false;
+
+            slot->element = element;
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement>
+        bool MpmcRingBuffer<TElement>::try_pop(TElement* address)
+        {
+            std::size_t current = head.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            for (;;)
+            {
+                slot = &slots[current & mask];
+                const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const std::intptr_t difference = static_cast<std::intptr_t>(sequence - (current + 1));
+
+                if (difference == 0)
+                {
+                    if (head.compare_exchange_weak(current, current + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    current = head.load(std::memory_order_relaxed);
+                }
+            }
+
+            *address = std::move(slot->element);
+            slot->sequence.store(current + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement>
+        bool MpmcRingBuffer<TElement>::is_empty() const noexcept
+        {
+            return head.load(std::memory_order_acquire) >= tail.load(std::memory_order_acquire);
+        }
+
+        template<typename TElement>
+        std::size_t MpmcRingBuffer<TElement>::get_capacity() const noexcept
+        {
+            return mask + 1;
+        }
+    }
+}
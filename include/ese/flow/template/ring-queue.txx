@@ -0,0 +1,121 @@
+#include <ese/flow/ring-queue.hxx>
+#include <utility>
+#include <ese/flow/ring-buffer.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement, typename TAllocator>
+        RingQueue<TElement, TAllocator>::RingQueue(const TAllocator& allocator):
+            allocator(allocator),
+            ring(nullptr),
+            mask(static_cast<std::size_t>(-1)),
+            head(0),
+            count(0)
+        {
+
+        }
+
+        template<typename TElement, typename TAllocator>
+        RingQueue<TElement, TAllocator>::~RingQueue()
+        {
+            while (count != 0)
+                pop();
+
+            if (ring != nullptr)
+                std::allocator_traits<TAllocator>::deallocate(allocator, ring, mask + 1);
+        }
+
+        template<typename TElement, typename TAllocator>
+        void RingQueue<TElement, TAllocator>::reallocate(std::size_t capacity)
+        {
+            TElement* grown = std::allocator_traits<TAllocator>::allocate(allocator, capacity);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                TElement& element = ring[(head + i) & mask];
+                std::allocator_traits<TAllocator>::construct(allocator, grown + i, std::move_if_noexcept(element));
+                std::allocator_traits<TAllocator>::destroy(allocator, &element);
+            }
+
+            if (ring != nullptr)
+                std::allocator_traits<TAllocator>::deallocate(allocator, ring, mask + 1);
+
+            ring = grown;
+            mask = capacity - 1;
+            head = 0;
+        }
+
+        template<typename TElement, typename TAllocator>
+        template<typename TForward>
+        void RingQueue<TElement, TAllocator>::emplace_back(TForward&& element)
+        {
+            if (count == mask + 1)
+                reallocate(ring == nullptr ? 16 : 2 * (mask + 1));
+
+            std::allocator_traits<TAllocator>::construct(allocator, ring + ((head + count) & mask),
+                std::forward<TForward>(element));
+            ++count;
+        }
+
+        template<typename TElement, typename TAllocator>
+        void RingQueue<TElement, TAllocator>::push(TElement&& element)
+        {
+            emplace_back(std::move(element));
+        }
+
+        template<typename TElement, typename TAllocator>
+        void RingQueue<TElement, TAllocator>::push(const TElement& element)
+        {
+            emplace_back(element);
+        }
+
+        template<typename TElement, typename TAllocator>
+        TElement& RingQueue<TElement, TAllocator>::front() noexcept
+        {
+            return ring[head];
+        }
+
+        template<typename TElement, typename TAllocator>
+        const TElement& RingQueue<TElement, TAllocator>::front() const noexcept
+        {
+            return ring[head];
+        }
+
+        template<typename TElement, typename TAllocator>
+        void RingQueue<TElement, TAllocator>::pop() noexcept
+        {
+            std::allocator_traits<TAllocator>::destroy(allocator, ring + head);
+            head = (head + 1) & mask;
+            --count;
+        }
+
+        template<typename TElement, typename TAllocator>
+        bool RingQueue<TElement, TAllocator>::empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        template<typename TElement, typename TAllocator>
+        std::size_t RingQueue<TElement, TAllocator>::size() const noexcept
+        {
+            return count;
+        }
+
+        template<typename TElement, typename TAllocator>
+        std::size_t RingQueue<TElement, TAllocator>::capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+        template<typename TElement, typename TAllocator>
+        void RingQueue<TElement, TAllocator>::reserve(std::size_t capacity)
+        {
+            const std::size_t rounded = ring_buffer_round_capacity(capacity);
+
+            if (rounded > mask + 1)
+                reallocate(rounded);
+        }
+    }
+}
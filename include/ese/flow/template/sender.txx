@@ -11,6 +11,80 @@ namespace ese
 
         }
 
+        template<typename TElement>
+        template<class TIterator>
+        void Sender<TElement>::send_batch(TIterator first, TIterator last)
+        {
+            TElement chunk[ESE_FLOW_BATCH_CHUNK_SIZE];
+
+            while (first != last)
+            {
+                std::size_t count = 0;
+
+                for (; first != last && count < ESE_FLOW_BATCH_CHUNK_SIZE; ++first)
+                    chunk[count++] = *first;
+
+                send_batch_0(chunk, count);
+            }
+        }
+
+        template<typename TElement>
+        void Sender<TElement>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                send(std::move(elements[i]));
+        }
+
+        template<typename TElement>
+        bool Sender<TElement>::try_send(ElementType&& element, bool blocking)
+        {
+            return try_send_until_0(&element, blocking ? Deadline::max() : Deadline::min());
+        }
+
+        template<typename TElement>
+        bool Sender<TElement>::try_send(const ElementType& element, bool blocking)
+        {
+            ElementType copy(element);
+            return try_send_until_0(&copy, blocking ? Deadline::max() : Deadline::min());
+        }
+
+        template<typename TElement>
+        template<class Clock, class Duration>
+        bool Sender<TElement>::try_send_until(ElementType&& element, const std::chrono::time_point<Clock, Duration>& time)
+        {
+            return try_send_until_0(&element, to_deadline(time));
+        }
+
+        template<typename TElement>
+        template<class Clock, class Duration>
+        bool Sender<TElement>::try_send_until(const ElementType& element, const std::chrono::time_point<Clock, Duration>& time)
+        {
+            ElementType copy(element);
+            return try_send_until_0(&copy, to_deadline(time));
+        }
+
+        template<typename TElement>
+        template<class Rep, class Period>
+        bool Sender<TElement>::try_send_for(ElementType&& element, const std::chrono::duration<Rep, Period>& duration)
+        {
+            return try_send_until_0(&element, deadline_after(duration));
+        }
+
+        template<typename TElement>
+        template<class Rep, class Period>
+        bool Sender<TElement>::try_send_for(const ElementType& element, const std::chrono::duration<Rep, Period>& duration)
+        {
+            ElementType copy(element);
+            return try_send_until_0(&copy, deadline_after(duration));
+        }
+
+        template<typename TElement>
+        bool Sender<TElement>::try_send_until_0(ElementType* element, const Deadline&)
+        {
+            send(std::move(*element));
+            return true;
+        }
+
         template<typename TElement>
         Sender<TElement>& Sender<TElement>::operator<<(ElementType&& element)
         {
@@ -0,0 +1,283 @@
+#include <ese/flow/sharded-channel.hxx>
+#include <thread>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        inline std::size_t sharded_channel_thread_slot() noexcept
+        {
+            static std::atomic_size_t next_slot(0);
+            static thread_local const std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        ShardedChannel<TElement, TWaitPolicy>::ShardedChannel(std::size_t shards_count, ShardOrdering ordering):
+            ordering(ordering),
+            next_shard(0),
+            wake_ups(0),
+            listener(nullptr),
+            receiver(*this),
+            sender(*this)
+        {
+            if (shards_count == 0)
+                shards_count = std::thread::hardware_concurrency();
+
+            if (shards_count == 0)
+                shards_count = 1;
+
+            for (std::size_t i = 0; i < shards_count; ++i)
+            {
+                shards.push_back(make_aligned<Shard>());
+                shards.back()->size.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        typename ShardedChannel<TElement, TWaitPolicy>::ReceiverType& ShardedChannel<TElement, TWaitPolicy>::get_receiver() noexcept
+        {
+            return receiver;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        typename ShardedChannel<TElement, TWaitPolicy>::SenderType& ShardedChannel<TElement, TWaitPolicy>::get_sender() noexcept
+        {
+            return sender;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        void ShardedChannel<TElement, TWaitPolicy>::wake_up() noexcept
+        {
+            wake_ups.fetch_add(1, std::memory_order_release);
+            not_empty_event.notify_all();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool ShardedChannel<TElement, TWaitPolicy>::is_empty() const noexcept
+        {
+            for (const AlignedPtr<Shard>& shard: shards)
+            {
+                if (shard->size.load(std::memory_order_acquire) != 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool ShardedChannel<TElement, TWaitPolicy>::set_listener(ChannelListener* listener) noexcept
+        {
+            if (listener == nullptr)
+            {
+                this->listener.store(nullptr, std::memory_order_release);
+                return true;
+            }
+
+            ChannelListener* current = nullptr;
+
+            return this->listener.compare_exchange_strong(current, listener, std::memory_order_acq_rel)
+                || current == listener;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::size_t ShardedChannel<TElement, TWaitPolicy>::get_shards_count() const noexcept
+        {
+            return shards.size();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        ShardOrdering ShardedChannel<TElement, TWaitPolicy>::get_ordering() const noexcept
+        {
+            return ordering;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::unique_lock<std::mutex> ShardedChannel<TElement, TWaitPolicy>::lock_shard_for_send(Shard** shard)
+        {
+            const std::size_t count = shards.size();
+            const std::size_t home = sharded_channel_thread_slot() % count;
+
+            if (ordering == ShardOrdering::RELAXED)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    Shard* candidate = shards[(home + i) % count].get();
+                    std::unique_lock<std::mutex> lock(candidate->mutex, std::try_to_lock);
+
+                    if (lock.owns_lock())
+                    {
+                        *shard = candidate;
+                        return lock;
+                    }
+                }
+            }
+
+            *shard = shards[home].get();
+            return std::unique_lock<std::mutex>((*shard)->mutex);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        void ShardedChannel<TElement, TWaitPolicy>::notify_send(std::size_t count) noexcept
+        {
+            if (count == 0)
+                return;
+
+            if (count == 1)
+                not_empty_event.notify_one();
+            else
+                not_empty_event.notify_all();
+
+            if (ChannelListener* listener = this->listener.load(std::memory_order_acquire))
+                listener->on_send();
+        }
+
+        template<typename TChannel>
+        ShardedChannelReceiver<TChannel>::ShardedChannelReceiver(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        bool ShardedChannelReceiver<TChannel>::try_receive_until_0(ElementType* address, const Deadline& time)
+        {
+            return try_receive_until_1(address, 1, time) != 0;
+        }
+
+        template<typename TChannel>
+        std::size_t ShardedChannelReceiver<TChannel>::try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            if (max == 0)
+                return 0;
+
+            return try_receive_until_1(address, max, time);
+        }
+
+        template<typename TChannel>
+        std::size_t ShardedChannelReceiver<TChannel>::try_pop(ElementType* address, std::size_t max)
+        {
+            const std::size_t shards_count = channel.shards.size();
+            const std::size_t start = channel.next_shard.fetch_add(1, std::memory_order_relaxed);
+            std::size_t count = 0;
+
+            for (std::size_t i = 0; i < shards_count && count < max; ++i)
+            {
+                typename TChannel::Shard& shard = *channel.shards[(start + i) % shards_count];
+
+                if (shard.size.load(std::memory_order_acquire) == 0)
+                    continue;
+
+                std::lock_guard<std::mutex> lock(shard.mutex);
+
+                for (; count < max && !shard.queue.empty(); ++count)
+                {
+                    address[count] = std::move(shard.queue.front());
+                    shard.queue.pop_front();
+                }
+
+                shard.size.store(shard.queue.size(), std::memory_order_relaxed);
+            }
+
+            return count;
+        }
+
+        template<typename TChannel>
+        std::size_t ShardedChannelReceiver<TChannel>::try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            using WaitPolicy = typename TChannel::WaitPolicyType;
+
+            const unsigned wake_ups = channel.wake_ups.load(std::memory_order_acquire);
+            std::size_t count = try_pop(address, max);
+
+            if (count != 0 || time == Deadline::min())
+                return count;
+
+            if (WaitPolicy::spins)
+            {
+                const bool ready = WaitPolicy::spin([&channel = channel, wake_ups] ()
+                    {
+                        return !channel.is_empty() || channel.wake_ups.load(std::memory_order_acquire) != wake_ups;
+                    }, time);
+
+                count = try_pop(address, max);
+
+                if (count != 0 || ready || !WaitPolicy::parks)
+                    return count;
+            }
+
+            // a notification may be for an element already received (by this receiver before waiting, or by another
+            // one): wait again until the deadline
+            while (true)
+            {
+                EventCount::Key key = channel.not_empty_event.prepare_wait();
+                count = try_pop(address, max);
+
+                if (count != 0 || channel.wake_ups.load(std::memory_order_acquire) != wake_ups)
+                {
+                    channel.not_empty_event.cancel_wait();
+                    return count;
+                }
+
+                if (!channel.not_empty_event.wait_until(key, time))
+                    return try_pop(address, max);
+            }
+        }
+
+        template<typename TChannel>
+        ShardedChannelSender<TChannel>::ShardedChannelSender(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        void ShardedChannelSender<TChannel>::send(ElementType&& element)
+        {
+            typename TChannel::Shard* shard;
+
+            {
+                std::unique_lock<std::mutex> lock = channel.lock_shard_for_send(&shard);
+                shard->queue.push_back(std::move(element));
+                shard->size.store(shard->queue.size(), std::memory_order_release);
+            }
+
+            channel.notify_send(1);
+        }
+
+        template<typename TChannel>
+        void ShardedChannelSender<TChannel>::send(const ElementType& element)
+        {
+            typename TChannel::Shard* shard;
+
+            {
+                std::unique_lock<std::mutex> lock = channel.lock_shard_for_send(&shard);
+                shard->queue.push_back(element);
+                shard->size.store(shard->queue.size(), std::memory_order_release);
+            }
+
+            channel.notify_send(1);
+        }
+
+        template<typename TChannel>
+        void ShardedChannelSender<TChannel>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            if (count == 0)
+                return;
+
+            typename TChannel::Shard* shard;
+
+            {
+                std::unique_lock<std::mutex> lock = channel.lock_shard_for_send(&shard);
+
+                for (std::size_t i = 0; i < count; ++i)
+                    shard->queue.push_back(std::move(elements[i]));
+
+                shard->size.store(shard->queue.size(), std::memory_order_release);
+            }
+
+            channel.notify_send(count);
+        }
+    }
+}
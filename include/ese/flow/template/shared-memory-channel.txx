@@ -0,0 +1,349 @@
+#include <ese/flow/shared-memory-channel.hxx>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <ese/flow/ring-buffer.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement, typename TWaitPolicy>
+        constexpr std::uint64_t SharedMemoryChannel<TElement, TWaitPolicy>::MAGIC;
+
+        template<typename TElement, typename TWaitPolicy>
+        constexpr std::size_t SharedMemoryChannel<TElement, TWaitPolicy>::get_slots_offset() noexcept
+        {
+            return (sizeof(Header) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::size_t SharedMemoryChannel<TElement, TWaitPolicy>::get_required_size(std::size_t capacity) noexcept
+        {
+            return get_slots_offset() + ring_buffer_round_capacity(capacity) * sizeof(Slot);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        SharedMemoryChannel<TElement, TWaitPolicy>::SharedMemoryChannel(SharedMemory&& memory, std::size_t capacity):
+            memory(std::move(memory)),
+            header(nullptr),
+            slots(nullptr),
+            mask(ring_buffer_round_capacity(capacity) - 1),
+            receiver(*this),
+            sender(*this)
+        {
+            if (this->memory.get_size() < get_required_size(capacity))
+                throw std::invalid_argument("the shared memory is too small for the channel");
+
+            char* base = static_cast<char*>(this->memory.get_address());
+            header = new (base) Header();
+            slots = reinterpret_cast<Slot*>(base + get_slots_offset());
+
+            header->element_size = sizeof(TElement);
+            header->capacity = mask + 1;
+            header->head.store(0, std::memory_order_relaxed);
+            header->tail.store(0, std::memory_order_relaxed);
+            header->wake_ups.store(0, std::memory_order_relaxed);
+
+            for (std::uint64_t i = 0; i <= mask; ++i)
+                new (&slots[i]) Slot();
+
+            for (std::uint64_t i = 0; i <= mask; ++i)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+
+            // published last: attaching processes see the whole initialization
+            header->magic.store(MAGIC, std::memory_order_release);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        SharedMemoryChannel<TElement, TWaitPolicy>::SharedMemoryChannel(SharedMemory&& memory):
+            memory(std::move(memory)),
+            header(nullptr),
+            slots(nullptr),
+            mask(0),
+            receiver(*this),
+            sender(*this)
+        {
+            if (this->memory.get_size() < sizeof(Header))
+                throw std::invalid_argument("the shared memory does not contain a channel");
+
+            char* base = static_cast<char*>(this->memory.get_address());
+            header = reinterpret_cast<Header*>(base);
+
+            if (header->magic.load(std::memory_order_acquire) != MAGIC)
+                throw std::invalid_argument("the shared memory does not contain a channel");
+
+            if (header->element_size != sizeof(TElement))
+                throw std::invalid_argument("the shared memory contains a channel of another element type");
+
+            mask = header->capacity - 1;
+
+            if (this->memory.get_size() < get_required_size(static_cast<std::size_t>(header->capacity)))
+                throw std::invalid_argument("the shared memory is too small for the channel");
+
+            slots = reinterpret_cast<Slot*>(base + get_slots_offset());
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        typename SharedMemoryChannel<TElement, TWaitPolicy>::ReceiverType& SharedMemoryChannel<TElement, TWaitPolicy>::get_receiver() noexcept
+        {
+            return receiver;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        typename SharedMemoryChannel<TElement, TWaitPolicy>::SenderType& SharedMemoryChannel<TElement, TWaitPolicy>::get_sender() noexcept
+        {
+            return sender;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        void SharedMemoryChannel<TElement, TWaitPolicy>::wake_up() noexcept
+        {
+            header->wake_ups.fetch_add(1, std::memory_order_release);
+            header->not_empty_event.notify_all();
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool SharedMemoryChannel<TElement, TWaitPolicy>::is_empty() const noexcept
+        {
+            const std::uint64_t position = header->head.load(std::memory_order_acquire);
+            return slots[position & mask].sequence.load(std::memory_order_acquire) != position + 1;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        std::size_t SharedMemoryChannel<TElement, TWaitPolicy>::get_capacity() const noexcept
+        {
+            return static_cast<std::size_t>(mask + 1);
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        const SharedMemory& SharedMemoryChannel<TElement, TWaitPolicy>::get_memory() const noexcept
+        {
+            return memory;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool SharedMemoryChannel<TElement, TWaitPolicy>::try_push(const TElement& element) noexcept
+        {
+            std::uint64_t current = header->tail.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            for (;;)
+            {
+                slot = &slots[current & mask];
+                const std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const std::int64_t difference = static_cast<std::int64_t>(sequence - current);
+
+                if (difference == 0)
+                {
+                    if (header->tail.compare_exchange_weak(current, current + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    current = header->tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::memcpy(&slot->element, &element, sizeof(TElement));
+            slot->sequence.store(current + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TElement, typename TWaitPolicy>
+        bool SharedMemoryChannel<TElement, TWaitPolicy>::try_pop(TElement* address) noexcept
+        {
+            std::uint64_t current = header->head.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            for (;;)
+            {
+                slot = &slots[current & mask];
+                const std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const std::int64_t difference = static_cast<std::int64_t>(sequence - (current + 1));
+
+                if (difference == 0)
+                {
+                    if (header->head.compare_exchange_weak(current, current + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    current = header->head.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::memcpy(address, &slot->element, sizeof(TElement));
+            slot->sequence.store(current + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename TChannel>
+        SharedMemoryChannelReceiver<TChannel>::SharedMemoryChannelReceiver(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        bool SharedMemoryChannelReceiver<TChannel>::try_receive_until_0(ElementType* address, const Deadline& time)
+        {
+            return try_receive_until_1(address, 1, time) != 0;
+        }
+
+        template<typename TChannel>
+        std::size_t SharedMemoryChannelReceiver<TChannel>::try_receive_batch_until_0(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            if (max == 0)
+                return 0;
+
+            return try_receive_until_1(address, max, time);
+        }
+
+        template<typename TChannel>
+        std::size_t SharedMemoryChannelReceiver<TChannel>::try_pop(ElementType* address, std::size_t max)
+        {
+            std::size_t count = 0;
+
+            while (count < max && channel.try_pop(address + count))
+                ++count;
+
+            if (count == 1)
+                channel.header->not_full_event.notify_one();
+            else if (count > 1)
+                channel.header->not_full_event.notify_all();
+
+            return count;
+        }
+
+        template<typename TChannel>
+        std::size_t SharedMemoryChannelReceiver<TChannel>::try_receive_until_1(ElementType* address, std::size_t max, const Deadline& time)
+        {
+            using WaitPolicy = typename TChannel::WaitPolicyType;
+
+            const std::uint32_t wake_ups = channel.header->wake_ups.load(std::memory_order_acquire);
+            std::size_t count = try_pop(address, max);
+
+            if (count != 0 || time == Deadline::min())
+                return count;
+
+            if (WaitPolicy::spins)
+            {
+                const bool ready = WaitPolicy::spin([&channel = channel, wake_ups] ()
+                    {
+                        return !channel.is_empty()
+                            || channel.header->wake_ups.load(std::memory_order_acquire) != wake_ups;
+                    }, time);
+
+                count = try_pop(address, max);
+
+                if (count != 0 || ready || !WaitPolicy::parks)
+                    return count;
+            }
+
+            // a notification may be for an element already received (by this receiver before waiting, or by another
+            // one, possibly in another process): wait again until the deadline
+            while (true)
+            {
+                SharedEventCount::Key key = channel.header->not_empty_event.prepare_wait();
+                count = try_pop(address, max);
+
+                if (count != 0 || channel.header->wake_ups.load(std::memory_order_acquire) != wake_ups)
+                {
+                    channel.header->not_empty_event.cancel_wait();
+                    return count;
+                }
+
+                if (!channel.header->not_empty_event.wait_until(key, time))
+                    return try_pop(address, max);
+            }
+        }
+
+        template<typename TChannel>
+        SharedMemoryChannelSender<TChannel>::SharedMemoryChannelSender(TChannel& channel) noexcept:
+            channel(channel)
+        {
+
+        }
+
+        template<typename TChannel>
+        bool SharedMemoryChannelSender<TChannel>::push(const ElementType& element, const Deadline& time)
+        {
+            if (channel.try_push(element))
+                return true;
+
+            if (time == Deadline::min())
+                return false;
+
+            do
+            {
+                // elements pushed (but not notified yet) by a batch have to be received to make space
+                channel.header->not_empty_event.notify_all();
+                SharedEventCount::Key key = channel.header->not_full_event.prepare_wait();
+
+                if (channel.try_push(element))
+                {
+                    channel.header->not_full_event.cancel_wait();
+                    return true;
+                }
+
+                if (!channel.header->not_full_event.wait_until(key, time))
+                    return channel.try_push(element);
+            }
+            while (!channel.try_push(element));
+
+            return true;
+        }
+
+        template<typename TChannel>
+        void SharedMemoryChannelSender<TChannel>::notify_send(std::size_t count) noexcept
+        {
+            if (count == 1)
+                channel.header->not_empty_event.notify_one();
+            else if (count > 1)
+                channel.header->not_empty_event.notify_all();
+        }
+
+        template<typename TChannel>
+        void SharedMemoryChannelSender<TChannel>::send(ElementType&& element)
+        {
+            push(element, Deadline::max());
+            notify_send(1);
+        }
+
+        template<typename TChannel>
+        void SharedMemoryChannelSender<TChannel>::send(const ElementType& element)
+        {
+            push(element, Deadline::max());
+            notify_send(1);
+        }
+
+        template<typename TChannel>
+        void SharedMemoryChannelSender<TChannel>::send_batch_0(ElementType* elements, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                push(elements[i], Deadline::max());
+
+            notify_send(count);
+        }
+
+        template<typename TChannel>
+        bool SharedMemoryChannelSender<TChannel>::try_send_until_0(ElementType* element, const Deadline& time)
+        {
+            if (!push(*element, time))
+                return false;
+
+            notify_send(1);
+            return true;
+        }
+    }
+}
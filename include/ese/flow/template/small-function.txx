@@ -0,0 +1,178 @@
+#include <ese/flow/small-function.hxx>
+#include <functional>
+#include <new>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        SmallFunction<TResult(TArgs...), Capacity>::SmallFunction() noexcept:
+            invoker(nullptr),
+            manager(nullptr)
+        {
+
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        SmallFunction<TResult(TArgs...), Capacity>::SmallFunction(std::nullptr_t) noexcept:
+            invoker(nullptr),
+            manager(nullptr)
+        {
+
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable, typename>
+        SmallFunction<TResult(TArgs...), Capacity>::SmallFunction(TCallable&& callable):
+            invoker(nullptr),
+            manager(nullptr)
+        {
+            typedef typename std::decay<TCallable>::type Callable;
+            store<Callable>(std::forward<TCallable>(callable), _FitsInline_<Callable>());
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        SmallFunction<TResult(TArgs...), Capacity>::SmallFunction(SmallFunction&& other) noexcept:
+            invoker(other.invoker),
+            manager(other.manager)
+        {
+            if (manager != nullptr)
+                manager(MOVE, storage, other.storage);
+
+            other.invoker = nullptr;
+            other.manager = nullptr;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        SmallFunction<TResult(TArgs...), Capacity>::~SmallFunction()
+        {
+            reset();
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        SmallFunction<TResult(TArgs...), Capacity>& SmallFunction<TResult(TArgs...), Capacity>::operator=(SmallFunction&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            reset();
+            invoker = other.invoker;
+            manager = other.manager;
+
+            if (manager != nullptr)
+                manager(MOVE, storage, other.storage);
+
+            other.invoker = nullptr;
+            other.manager = nullptr;
+            return *this;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        TResult SmallFunction<TResult(TArgs...), Capacity>::operator()(TArgs... args) const
+        {
+            if (invoker == nullptr)
+                throw std::bad_function_call();
+
+            return invoker(storage, std::forward<TArgs>(args)...);
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        SmallFunction<TResult(TArgs...), Capacity>::operator bool() const noexcept
+        {
+            return invoker != nullptr;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        bool SmallFunction<TResult(TArgs...), Capacity>::is_inline() const noexcept
+        {
+            return manager == nullptr || manager(IS_INLINE, nullptr, nullptr);
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable, typename TForward>
+        void SmallFunction<TResult(TArgs...), Capacity>::store(TForward&& callable, std::true_type)
+        {
+            new (storage) TCallable(std::forward<TForward>(callable));
+            invoker = &invoke_inline<TCallable>;
+            manager = &manage_inline<TCallable>;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable, typename TForward>
+        void SmallFunction<TResult(TArgs...), Capacity>::store(TForward&& callable, std::false_type)
+        {
+            *reinterpret_cast<TCallable**>(storage) = new TCallable(std::forward<TForward>(callable));
+            invoker = &invoke_heap<TCallable>;
+            manager = &manage_heap<TCallable>;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable>
+        TResult SmallFunction<TResult(TArgs...), Capacity>::invoke_inline(void* storage, TArgs&&... args)
+        {
+            return (*reinterpret_cast<TCallable*>(storage))(std::forward<TArgs>(args)...);
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable>
+        TResult SmallFunction<TResult(TArgs...), Capacity>::invoke_heap(void* storage, TArgs&&... args)
+        {
+            return (**reinterpret_cast<TCallable**>(storage))(std::forward<TArgs>(args)...);
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable>
+        bool SmallFunction<TResult(TArgs...), Capacity>::manage_inline(Operation operation, void* destination, void* source) noexcept
+        {
+            switch (operation)
+            {
+                case MOVE:
+                    new (destination) TCallable(std::move(*reinterpret_cast<TCallable*>(source)));
+                    reinterpret_cast<TCallable*>(source)->~TCallable();
+                    break;
+
+                case DESTROY:
+                    reinterpret_cast<TCallable*>(destination)->~TCallable();
+                    break;
+
+                case IS_INLINE:
+                    break;
+            }
+
+            return true;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        template<typename TCallable>
+        bool SmallFunction<TResult(TArgs...), Capacity>::manage_heap(Operation operation, void* destination, void* source) noexcept
+        {
+            switch (operation)
+            {
+                case MOVE:
+                    *reinterpret_cast<TCallable**>(destination) = *reinterpret_cast<TCallable**>(source);
+                    break;
+
+                case DESTROY:
+                    delete *reinterpret_cast<TCallable**>(destination);
+                    break;
+
+                case IS_INLINE:
+                    break;
+            }
+
+            return false;
+        }
+
+        template<typename TResult, typename... TArgs, std::size_t Capacity>
+        void SmallFunction<TResult(TArgs...), Capacity>::reset() noexcept
+        {
+            if (manager != nullptr)
+                manager(DESTROY, storage, nullptr);
+
+            invoker = nullptr;
+            manager = nullptr;
+        }
+    }
+}
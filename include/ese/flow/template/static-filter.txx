@@ -0,0 +1,103 @@
+#include <ese/flow/static-filter.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TDerived>
+        template<typename TIn, typename TSelf>
+        inline auto StaticFilter<TDerived>::operator()(TIn&& in)
+            -> decltype(std::declval<TSelf&>().filter(std::forward<TIn>(in)))
+        {
+            return static_cast<TSelf&>(*this).filter(std::forward<TIn>(in));
+        }
+
+        template<typename TCallable>
+        CallableFilter<TCallable>::CallableFilter(TCallable callable):
+            callable(std::move(callable))
+        {
+
+        }
+
+        template<typename TCallable>
+        template<typename TIn>
+        inline auto CallableFilter<TCallable>::filter(TIn&& in)
+            -> decltype(std::declval<TCallable&>()(std::forward<TIn>(in)))
+        {
+            return callable(std::forward<TIn>(in));
+        }
+
+        template<typename TFirst, typename TSecond>
+        FusedFilter<TFirst, TSecond>::FusedFilter(TFirst first, TSecond second):
+            first(std::move(first)),
+            second(std::move(second))
+        {
+
+        }
+
+        template<typename TFirst, typename TSecond>
+        template<typename TIn>
+        inline auto FusedFilter<TFirst, TSecond>::filter(TIn&& in)
+            -> decltype(std::declval<TSecond&>()(std::declval<TFirst&>()(std::forward<TIn>(in))))
+        {
+            return second(first(std::forward<TIn>(in)));
+        }
+
+        template<typename TIn, typename TOut, typename TStatic>
+        StaticFilterAdapter<TIn, TOut, TStatic>::StaticFilterAdapter(TStatic inner):
+            inner(std::move(inner))
+        {
+
+        }
+
+        template<typename TIn, typename TOut, typename TStatic>
+        TOut StaticFilterAdapter<TIn, TOut, TStatic>::filter(TIn&& in)
+        {
+            return inner(std::move(in));
+        }
+
+        template<typename TIn, typename TOut, typename TStatic>
+        TOut StaticFilterAdapter<TIn, TOut, TStatic>::filter(const TIn& in)
+        {
+            return inner(in);
+        }
+
+        template<typename TIn, typename TOut, typename TStatic>
+        TStatic& StaticFilterAdapter<TIn, TOut, TStatic>::get_static_filter() noexcept
+        {
+            return inner;
+        }
+
+        template<typename TCallable>
+        CallableFilter<typename std::decay<TCallable>::type> static_filter(TCallable&& callable)
+        {
+            return CallableFilter<typename std::decay<TCallable>::type>(std::forward<TCallable>(callable));
+        }
+
+        template<typename TIn, typename TOut, typename TStatic>
+        StaticFilterAdapter<TIn, TOut, typename std::decay<TStatic>::type> to_filter(TStatic&& filter)
+        {
+            return StaticFilterAdapter<TIn, TOut, typename std::decay<TStatic>::type>(std::forward<TStatic>(filter));
+        }
+
+        template<typename TFirst, typename TSecond>
+        typename std::enable_if<
+            IsStaticFilter<typename std::decay<TFirst>::type>::value
+            && IsStaticFilter<typename std::decay<TSecond>::type>::value,
+            FusedFilter<typename std::decay<TFirst>::type, typename std::decay<TSecond>::type>>::type operator|(
+            TFirst&& first, TSecond&& second)
+        {
+            return FusedFilter<typename std::decay<TFirst>::type, typename std::decay<TSecond>::type>(
+                std::forward<TFirst>(first), std::forward<TSecond>(second));
+        }
+
+        template<typename TIn, typename TFilter>
+        inline auto operator|(TIn&& in, TFilter&& filter) -> typename std::enable_if<
+            !IsStaticFilter<typename std::decay<TIn>::type>::value
+            && IsStaticFilter<typename std::decay<TFilter>::type>::value,
+            decltype(filter(std::forward<TIn>(in)))>::type
+        {
+            return filter(std::forward<TIn>(in));
+        }
+    }
+}
@@ -0,0 +1,327 @@
+#include <ese/flow/thread-pool-executor.hxx>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        template <typename TExecutable>
+        ThreadPoolExecutor<TExecutable>::ThreadPoolExecutor(std::size_t workers_count, std::vector<int> cpus):
+            injection_queue(64),
+            injection_head(0),
+            injected_count(0),
+            shared_free_count(0),
+            unfinished_count(0),
+            stopping(false),
+            cpus(std::move(cpus))
+        {
+            if (workers_count == 0)
+                workers_count = std::thread::hardware_concurrency();
+
+            if (workers_count == 0)
+                workers_count = 1;
+
+            for (std::size_t i = 0; i < workers_count; ++i)
+                workers.push_back(make_aligned<Worker>());
+
+            // every deque exists before any worker starts (and tries to steal)
+            for (std::size_t i = 0; i < workers_count; ++i)
+                workers[i]->thread.reset(new Thread([this, i] ()
+                    {
+                        this->work(i);
+                    }));
+        }
+
+        template <typename TExecutable>
+        ThreadPoolExecutor<TExecutable>::~ThreadPoolExecutor()
+        {
+            shutdown();
+        }
+
+        template <typename TExecutable>
+        typename ThreadPoolExecutor<TExecutable>::Context& ThreadPoolExecutor<TExecutable>::get_context() noexcept
+        {
+            static thread_local Context context = {nullptr, 0};
+            return context;
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::execute(TExecutable&& executable)
+        {
+            if (!admit())
+            {
+                executable();
+                return;
+            }
+
+            try
+            {
+                submit(std::move(executable));
+            }
+            catch (...)
+            {
+                finish();
+                throw;
+            }
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::execute(const TExecutable& executable)
+        {
+            execute_copy(executable, std::is_copy_constructible<TExecutable>());
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::execute_copy(const TExecutable& executable, std::true_type)
+        {
+            execute(TExecutable(executable));
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::execute_copy(const TExecutable& executable, std::false_type)
+        {
+            executable();
+        }
+
+        template <typename TExecutable>
+        bool ThreadPoolExecutor<TExecutable>::admit() noexcept
+        {
+            // both sequentially consistent, paired with the store of stopping and the load of drain() in shutdown()
+            unfinished_count.fetch_add(1, std::memory_order_seq_cst);
+
+            if (!stopping.load(std::memory_order_seq_cst))
+                return true;
+
+            finish();
+            return false;
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::finish() noexcept
+        {
+            if (unfinished_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(drain_mutex);
+                drained_condition_variable.notify_all();
+            }
+
+            // the sleeping workers have to notice that they can exit
+            if (stopping.load(std::memory_order_acquire))
+                work_event.notify_all();
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::submit(TExecutable&& executable)
+        {
+            Context& context = get_context();
+
+            if (context.pool == this)
+            {
+                Worker& worker = *workers[context.index];
+                TExecutable* node = acquire_node(worker);
+                *node = std::move(executable);
+                worker.deque.push(node);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(injection_mutex);
+                const std::size_t size = injected_count.load(std::memory_order_relaxed);
+                const std::size_t capacity = injection_queue.size();
+
+                if (size == capacity)
+                {
+                    // the ring is full: unroll it into a ring of double capacity
+                    std::vector<TExecutable> ring(capacity * 2);
+
+                    for (std::size_t i = 0; i < size; ++i)
+                        ring[i] = std::move(injection_queue[(injection_head + i) % capacity]);
+
+                    injection_queue.swap(ring);
+                    injection_head = 0;
+                }
+
+                injection_queue[(injection_head + size) % injection_queue.size()] = std::move(executable);
+                injected_count.store(size + 1, std::memory_order_release);
+            }
+
+            work_event.notify_one();
+        }
+
+        template <typename TExecutable>
+        bool ThreadPoolExecutor<TExecutable>::find(std::size_t index, TExecutable* executable)
+        {
+            Worker& worker = *workers[index];
+            TExecutable* node;
+            bool found = worker.deque.pop(&node);
+
+            if (!found && injected_count.load(std::memory_order_acquire) != 0)
+            {
+                std::lock_guard<std::mutex> lock(injection_mutex);
+                const std::size_t size = injected_count.load(std::memory_order_relaxed);
+
+                if (size != 0)
+                {
+                    *executable = std::move(injection_queue[injection_head]);
+                    injection_head = (injection_head + 1) % injection_queue.size();
+                    injected_count.store(size - 1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            const std::size_t count = workers.size();
+
+            for (std::size_t i = 1; !found && i < count; ++i)
+                found = workers[(index + i) % count]->deque.steal(&node);
+
+            if (!found)
+                return false;
+
+            // the node is recycled by the worker that takes it
+            *executable = std::move(*node);
+            release_node(worker, node);
+            return true;
+        }
+
+        template <typename TExecutable>
+        TExecutable* ThreadPoolExecutor<TExecutable>::acquire_node(Worker& worker)
+        {
+            if (worker.free_nodes.empty() && shared_free_count.load(std::memory_order_relaxed) != 0)
+            {
+                std::lock_guard<std::mutex> lock(injection_mutex);
+
+                for (std::unique_ptr<TExecutable>& node: shared_free_nodes)
+                    worker.free_nodes.push_back(std::move(node));
+
+                shared_free_nodes.clear();
+                shared_free_count.store(0, std::memory_order_relaxed);
+            }
+
+            if (worker.free_nodes.empty())
+                return new TExecutable();
+
+            TExecutable* node = worker.free_nodes.back().release();
+            worker.free_nodes.pop_back();
+            return node;
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::release_node(Worker& worker, TExecutable* node)
+        {
+            static const std::size_t max_free_nodes = 256;
+
+            worker.free_nodes.emplace_back(node);
+
+            if (worker.free_nodes.size() < max_free_nodes)
+                return;
+
+            // a worker that mostly runs executables submitted by others gives its nodes back to the submitters
+            std::lock_guard<std::mutex> lock(injection_mutex);
+
+            while (worker.free_nodes.size() > max_free_nodes / 2)
+            {
+                shared_free_nodes.push_back(std::move(worker.free_nodes.back()));
+                worker.free_nodes.pop_back();
+            }
+
+            shared_free_count.store(shared_free_nodes.size(), std::memory_order_relaxed);
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::run(TExecutable& executable)
+        {
+            executable();
+            executable = TExecutable();
+            finish();
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::work(std::size_t index)
+        {
+            Context& context = get_context();
+            context.pool = this;
+            context.index = index;
+
+            if (!cpus.empty())
+                Thread::set_current_affinity(cpus[index % cpus.size()]);
+
+            TExecutable executable;
+
+            while (true)
+            {
+                if (find(index, &executable))
+                {
+                    run(executable);
+                    continue;
+                }
+
+                EventCount::Key key = work_event.prepare_wait();
+
+                if (find(index, &executable))
+                {
+                    work_event.cancel_wait();
+                    run(executable);
+                    continue;
+                }
+
+                if (stopping.load(std::memory_order_acquire)
+                    && unfinished_count.load(std::memory_order_acquire) == 0)
+                {
+                    work_event.cancel_wait();
+                    break;
+                }
+
+                work_event.wait(key);
+            }
+
+            context.pool = nullptr;
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::drain()
+        {
+            if (get_context().pool == this)
+                throw std::logic_error("a pool can not be drained by one of its own workers");
+
+            std::unique_lock<std::mutex> lock(drain_mutex);
+
+            drained_condition_variable.wait(lock, [this] ()
+                {
+                    return unfinished_count.load(std::memory_order_seq_cst) == 0;
+                });
+        }
+
+        template <typename TExecutable>
+        void ThreadPoolExecutor<TExecutable>::shutdown()
+        {
+            if (get_context().pool == this)
+                throw std::logic_error("a pool can not be shut down by one of its own workers");
+
+            std::lock_guard<std::mutex> lock(shutdown_mutex);
+
+            if (workers.empty())
+                return;
+
+            drain();
+            stopping.store(true, std::memory_order_seq_cst);
+            work_event.notify_all();
+
+            // the executables admitted before stopping was set are waited for, the later ones run inline
+            drain();
+
+            for (AlignedPtr<Worker>& worker: workers)
+                worker->thread->join();
+
+            workers.clear();
+        }
+
+        template <typename TExecutable>
+        std::size_t ThreadPoolExecutor<TExecutable>::get_workers_count() const noexcept
+        {
+            return workers.size();
+        }
+    }
+}
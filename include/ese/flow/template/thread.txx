@@ -1,6 +1,7 @@
 #include <ese/flow/thread.hxx>
-#include <functional>
+#include <type_traits>
 #include <utility>
+#include <ese/flow/thread-pool.hxx>
 
 namespace ese
 {
@@ -8,20 +9,51 @@ namespace ese
     {
         extern std::atomic_int running_native_threads;
 
+        extern std::atomic<std::uint64_t> started_native_threads;
+
         template <typename TExecutable>
-        Thread::Thread(TExecutable&& executable):
-            status(Status::NOT_STARTED)
+        Thread::Thread(TExecutable&& executable, ThreadOptions options):
+            status(Status::NOT_STARTED),
+            placed(false)
         {
-            std::function<void()> wrapper = [this, inner = std::move(executable)] () mutable
+            // std::thread accepts move-only callables: no type-erased wrapper is needed
+            native_thread = new std::thread([this, inner = std::move(executable), options = std::move(options)] () mutable
                 {
                     ++running_native_threads;
+                    started_native_threads.fetch_add(1, std::memory_order_relaxed);
+                    this->placed = set_current_options(options);
                     this->status = Status::RUNNING;
                     inner();
                     this->status = Status::FINISHED;
                     --running_native_threads;
-                };
+                });
+        }
+
+        template <typename TExecutable>
+        Thread::Thread(TExecutable&& executable, ThreadPool& pool):
+            native_thread(nullptr),
+            status(Status::NOT_STARTED),
+            placed(true)
+        {
+            pool.submit([this, inner = std::move(executable)] () mutable
+                {
+                    ++running_native_threads;
+                    started_native_threads.fetch_add(1, std::memory_order_relaxed);
+                    this->status = Status::RUNNING;
+
+                    {
+                        // the worker outlives the thread: destroy the executable now, not when it is reused
+                        typename std::decay<TExecutable>::type body(std::move(inner));
+                        body();
+                    }
+
+                    --running_native_threads;
 
-            native_thread = new std::thread(std::move(wrapper));
+                    // join() may return (and the object be destroyed) as soon as the mutex is released
+                    std::lock_guard<std::mutex> lock(finished_mutex);
+                    this->status = Status::FINISHED;
+                    finished_condition.notify_all();
+                });
         }
     }
 }
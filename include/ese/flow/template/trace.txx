@@ -0,0 +1,83 @@
+#include <ese/flow/trace.hxx>
+#include <chrono>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ESE_FLOW_TRACE_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ESE_FLOW_TRACE_TSC
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief The sampling period of the Tracer (0 if tracing is disabled).
+         * */
+        inline std::atomic<std::uint64_t>& trace_period() noexcept
+        {
+            static std::atomic<std::uint64_t> period(0);
+            return period;
+        }
+
+        /**
+         * \brief The number of traced spans open on the current thread.
+         * */
+        inline unsigned& trace_depth() noexcept
+        {
+            static thread_local unsigned depth = 0;
+            return depth;
+        }
+
+        inline std::uint64_t Tracer::get_sampling() noexcept
+        {
+            return trace_period().load(std::memory_order_relaxed);
+        }
+
+        inline bool Tracer::sample() noexcept
+        {
+            static thread_local std::uint64_t calls = 0;
+            const std::uint64_t period = trace_period().load(std::memory_order_relaxed);
+            return period != 0 && (++calls & (period - 1)) == 0;
+        }
+
+        inline bool Tracer::is_sampled(std::uint64_t sequence) noexcept
+        {
+            const std::uint64_t period = trace_period().load(std::memory_order_relaxed);
+            return period != 0 && (sequence & (period - 1)) == 0;
+        }
+
+        inline std::uint64_t Tracer::now() noexcept
+        {
+#ifdef ESE_FLOW_TRACE_TSC
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        inline TraceSpan::TraceSpan(const char* name) noexcept:
+            name(name),
+            start(0)
+        {
+            if (trace_depth() != 0 || Tracer::sample())
+            {
+                ++trace_depth();
+                start = Tracer::now();
+            }
+        }
+
+        inline TraceSpan::~TraceSpan()
+        {
+            if (start == 0)
+                return;
+
+            const std::uint64_t end = Tracer::now();
+            --trace_depth();
+            Tracer::record({TraceEventType::SPAN, name, nullptr, 0, start, end - start, 0});
+        }
+    }
+}
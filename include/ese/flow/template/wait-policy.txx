@@ -0,0 +1,74 @@
+#include <ese/flow/wait-policy.hxx>
+#include <thread>
+
+namespace ese
+{
+    namespace flow
+    {
+        inline void cpu_relax() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield");
+#endif
+        }
+
+        template<class TPredicate, class Clock, class Duration>
+        bool BlockingWaitPolicy::spin(TPredicate&&, const std::chrono::time_point<Clock, Duration>&) noexcept
+        {
+            return false;
+        }
+
+        template<std::size_t SpinCount, std::size_t YieldCount>
+        template<class TPredicate, class Clock, class Duration>
+        bool SpinThenParkWaitPolicy<SpinCount, YieldCount>::spin(TPredicate&& predicate, const std::chrono::time_point<Clock, Duration>& time)
+        {
+            if (time == std::chrono::time_point<Clock, Duration>::min())
+                return predicate();
+
+            for (std::size_t i = 0; i < SpinCount; ++i)
+            {
+                if (predicate())
+                    return true;
+
+                cpu_relax();
+            }
+
+            for (std::size_t i = 0; i < YieldCount; ++i)
+            {
+                if (predicate())
+                    return true;
+
+                if (Clock::now() >= time)
+                    return false;
+
+                std::this_thread::yield();
+            }
+
+            return predicate();
+        }
+
+        template<class TPredicate, class Clock, class Duration>
+        bool BusyPollWaitPolicy::spin(TPredicate&& predicate, const std::chrono::time_point<Clock, Duration>& time)
+        {
+            if (time == std::chrono::time_point<Clock, Duration>::max())
+            {
+                while (!predicate())
+                    cpu_relax();
+
+                return true;
+            }
+
+            while (!predicate())
+            {
+                if (Clock::now() >= time)
+                    return false;
+
+                cpu_relax();
+            }
+
+            return true;
+        }
+    }
+}
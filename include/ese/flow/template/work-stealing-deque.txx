@@ -0,0 +1,122 @@
+#include <ese/flow/work-stealing-deque.hxx>
+#include <ese/flow/ring-buffer.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        template<typename TElement>
+        WorkStealingDeque<TElement>::_Array_::_Array_(std::int64_t capacity):
+            mask(capacity - 1),
+            slots(new std::atomic<TElement>[capacity])
+        {
+
+        }
+
+        template<typename TElement>
+        void WorkStealingDeque<TElement>::_Array_::put(std::int64_t position, TElement element) noexcept
+        {
+            slots[position & mask].store(element, std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        TElement WorkStealingDeque<TElement>::_Array_::get(std::int64_t position) const noexcept
+        {
+            return slots[position & mask].load(std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        WorkStealingDeque<TElement>::WorkStealingDeque(std::size_t capacity):
+            top(0),
+            bottom(0)
+        {
+            arrays.emplace_back(new Array(static_cast<std::int64_t>(ring_buffer_round_capacity(capacity))));
+            array.store(arrays.back().get(), std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        typename WorkStealingDeque<TElement>::Array* WorkStealingDeque<TElement>::grow(std::int64_t bottom, std::int64_t top)
+        {
+            Array* old_array = array.load(std::memory_order_relaxed);
+            arrays.emplace_back(new Array((old_array->mask + 1) * 2));
+            Array* new_array = arrays.back().get();
+
+            for (std::int64_t i = top; i < bottom; ++i)
+                new_array->put(i, old_array->get(i));
+
+            array.store(new_array, std::memory_order_release);
+            return new_array;
+        }
+
+        template<typename TElement>
+        void WorkStealingDeque<TElement>::push(TElement element)
+        {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            const std::int64_t t = top.load(std::memory_order_acquire);
+            Array* a = array.load(std::memory_order_relaxed);
+
+            if (b - t > a->mask)
+                a = grow(b, t);
+
+            a->put(b, element);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        template<typename TElement>
+        bool WorkStealingDeque<TElement>::pop(TElement* address) noexcept
+        {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            Array* a = array.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // the deque was empty
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            *address = a->get(b);
+
+            if (t != b)
+                return true;
+
+            // the last element: race against the thieves
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        template<typename TElement>
+        bool WorkStealingDeque<TElement>::steal(TElement* address) noexcept
+        {
+            std::int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return false;
+
+            Array* a = array.load(std::memory_order_acquire);
+            TElement element = a->get(t);
+
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return false;
+
+            *address = element;
+            return true;
+        }
+
+        template<typename TElement>
+        bool WorkStealingDeque<TElement>::is_empty() const noexcept
+        {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            const std::int64_t t = top.load(std::memory_order_relaxed);
+            return b <= t;
+        }
+    }
+}
@@ -0,0 +1,283 @@
+
+#ifndef ESE_FLOW_THREADPOOLEXECUTOR_HXX
+#define ESE_FLOW_THREADPOOLEXECUTOR_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include <ese/flow/aligned-ptr.hxx>
+#include <ese/flow/event-count.hxx>
+#include <ese/flow/executor.hxx>
+#include <ese/flow/lambda-executable.hxx>
+#include <ese/flow/thread.hxx>
+#include <ese/flow/work-stealing-deque.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Executor that executes the executables in parallel, on a pool of worker threads.
+         * \param TExecutable The executables executed by the executor. Have to implement operator() (that should not
+         *     throw), and have to be default constructible and move assignable.
+         *
+         * Every worker owns a WorkStealingDeque: executables submitted by a worker (e.g. by a running executable) are
+         * pushed to its own deque, those submitted by other threads go to a shared injection queue. An idle worker
+         * first pops from its own deque, then takes from the injection queue and finally steals from the other
+         * workers. Workers with nothing to do sleep on an EventCount, so submitting is nearly free when every
+         * worker is busy. \n
+         * Submitted executables are moved into recycled storage (task nodes and the injection ring): once the pool
+         * is warm, submitting does not allocate (unless the executable itself does, when moved). \n
+         * drain() waits until every submitted executable was executed, shutdown() drains the pool and joins the
+         * workers (executables submitted after the shutdown are executed inline, on the caller's thread). \n
+         * Being an Executor, it can replace the (inline) default Executor without changing the calling code. \n
+         * */
+        template <typename TExecutable = LambdaExecutable>
+        class ThreadPoolExecutor: public Executor<TExecutable>
+        {
+            public:
+                /**
+                 * \brief Construct the pool and start its workers.
+                 * \param workers_count The number of worker threads (0 means one per hardware thread).
+                 * \param cpus The CPUs to which the workers are bound (the i-th worker is bound to
+                 *     cpus[i % cpus.size()]). If empty, the workers are not bound.
+                 * */
+                explicit ThreadPoolExecutor(std::size_t workers_count = 0, std::vector<int> cpus = {});
+
+                ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+
+                ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+                /**
+                 * \brief Shuts down the pool.
+                 * \sa shutdown()
+                 * */
+                virtual ~ThreadPoolExecutor();
+
+                /**
+                 * \brief Submits an executable object to the pool.
+                 * \param executable The object to execute.
+                 * */
+                void execute(TExecutable&& executable) override;
+
+                /**
+                 * \brief Submits a copy of an executable object to the pool.
+                 * \param executable The object to execute.
+                 *
+                 * Executables that can not be copied (e.g. LambdaExecutable) are executed inline, on the caller's
+                 * thread: pass them as rvalue to run them on the pool.
+                 * */
+                void execute(const TExecutable& executable) override;
+
+                /**
+                 * \brief Waits until every submitted executable (even those submitted meanwhile) was executed.
+                 * \throw std::logic_error If called by an executable running on this pool (it would wait for itself).
+                 * */
+                void drain();
+
+                /**
+                 * \brief Drains the pool, stops the workers and joins them.
+                 * \throw std::logic_error If called by an executable running on this pool (it would wait for itself).
+                 *
+                 * Calling it more than once is harmless. \n
+                 * */
+                void shutdown();
+
+                /**
+                 * \brief Get the number of worker threads.
+                 * \return The number of workers.
+                 * */
+                std::size_t get_workers_count() const noexcept;
+
+            private:
+                /**
+                 * \brief A worker thread, with its own deque.
+                 * */
+                typedef struct _Worker_
+                {
+                    /**
+                     * \brief The executables submitted by this worker (stolen by the others).
+                     * */
+                    WorkStealingDeque<TExecutable*> deque;
+
+                    /**
+                     * \brief Task nodes executed by this worker, reused for the executables it submits.
+                     * */
+                    std::vector<std::unique_ptr<TExecutable>> free_nodes;
+
+                    /**
+                     * \brief The worker's thread.
+                     * */
+                    std::unique_ptr<Thread> thread;
+                } Worker;
+
+                /**
+                 * \brief The workers.
+                 * */
+                std::vector<AlignedPtr<Worker>> workers;
+
+                /**
+                 * \brief Executables submitted by non-worker threads (a ring that grows when full).
+                 * */
+                std::vector<TExecutable> injection_queue;
+
+                /**
+                 * \brief The position of the first executable in the injection ring.
+                 * */
+                std::size_t injection_head;
+
+                /**
+                 * \brief Mutex used to synchronize access to the injection queue.
+                 * */
+                std::mutex injection_mutex;
+
+                /**
+                 * \brief The number of executables in the injection ring (written under the injection mutex, but
+                 *     readable without locking).
+                 * */
+                std::atomic_size_t injected_count;
+
+                /**
+                 * \brief Task nodes given back by workers that have too many of them (protected by the injection
+                 *     mutex), taken by workers that have none.
+                 * */
+                std::vector<std::unique_ptr<TExecutable>> shared_free_nodes;
+
+                /**
+                 * \brief The number of shared task nodes, readable without locking.
+                 * */
+                std::atomic_size_t shared_free_count;
+
+                /**
+                 * \brief The number of submitted executables that were not executed yet.
+                 * */
+                std::atomic_size_t unfinished_count;
+
+                /**
+                 * \brief Used to wake up sleeping workers, when an executable is submitted (or on shutdown).
+                 * */
+                EventCount work_event;
+
+                /**
+                 * \brief Mutex used (with drained_condition_variable) by the threads waiting in drain().
+                 * */
+                std::mutex drain_mutex;
+
+                /**
+                 * \brief Condition variable used to signal when every submitted executable was executed.
+                 * */
+                std::condition_variable drained_condition_variable;
+
+                /**
+                 * \brief Set by shutdown(): the workers exit when there is nothing left to execute.
+                 * */
+                std::atomic_bool stopping;
+
+                /**
+                 * \brief Mutex used to serialize shutdown() calls.
+                 * */
+                std::mutex shutdown_mutex;
+
+                /**
+                 * \brief The CPUs to which the workers are bound.
+                 * */
+                const std::vector<int> cpus;
+
+                /**
+                 * \brief Counts an executable as unfinished, unless the pool is stopping.
+                 * \return True if the executable has to be submitted, false if it has to be executed inline.
+                 *
+                 * The executable is counted before stopping is checked: shutdown() either waits for it, or this call
+                 * sees that the pool is stopping. \n
+                 * */
+                bool admit() noexcept;
+
+                /**
+                 * \brief Counts an executable as finished, waking up drain() and the stopping workers if it was the last.
+                 * */
+                void finish() noexcept;
+
+                /**
+                 * \brief Submits an executable (already admitted).
+                 * \param executable The executable (moved into a task node or into the injection ring).
+                 * */
+                void submit(TExecutable&& executable);
+
+                /**
+                 * \brief Finds an executable for a worker: from its deque, the injection ring or another worker.
+                 * \param index The index of the worker.
+                 * \param executable Where the found executable is moved.
+                 * \return True if an executable was found, false if there is nothing to execute.
+                 * */
+                bool find(std::size_t index, TExecutable* executable);
+
+                /**
+                 * \brief Takes a recycled task node for the calling worker (or allocates a new one).
+                 * \param worker The calling worker.
+                 * \return The task node.
+                 * */
+                TExecutable* acquire_node(Worker& worker);
+
+                /**
+                 * \brief Recycles a task node of the calling worker.
+                 * \param worker The calling worker.
+                 * \param node The task node.
+                 * */
+                void release_node(Worker& worker, TExecutable* node);
+
+                /**
+                 * \brief Executes an executable and counts it as finished.
+                 * \param executable The executable.
+                 * */
+                void run(TExecutable& executable);
+
+                /**
+                 * \brief Submits a copy of the executable.
+                 * \param executable The executable.
+                 * */
+                void execute_copy(const TExecutable& executable, std::true_type);
+
+                /**
+                 * \brief Executes the (non-copyable) executable inline.
+                 * \param executable The executable.
+                 * */
+                void execute_copy(const TExecutable& executable, std::false_type);
+
+                /**
+                 * \brief The main loop of a worker thread.
+                 * \param index The index of the worker.
+                 * */
+                void work(std::size_t index);
+
+                /**
+                 * \brief The pool (and the worker index) of the calling thread, if it is a worker.
+                 * */
+                typedef struct _Context_
+                {
+                    /**
+                     * \brief The pool that owns the calling thread (nullptr if not a worker).
+                     * */
+                    ThreadPoolExecutor* pool;
+
+                    /**
+                     * \brief The index of the calling worker.
+                     * */
+                    std::size_t index;
+                } Context;
+
+                /**
+                 * \brief Get the context of the calling thread.
+                 * \return The context (thread-local).
+                 * */
+                static Context& get_context() noexcept;
+        };
+    }
+}
+
+#include "template/thread-pool-executor.txx"
+
+#endif
@@ -0,0 +1,158 @@
+
+#ifndef ESE_FLOW_THREADPOOL_HXX
+#define ESE_FLOW_THREADPOOL_HXX
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <ese/flow/lambda-executable.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells to a ThreadPool how many workers to keep.
+         * */
+        typedef struct _ThreadPoolOptions_
+        {
+            /**
+             * \brief The number of workers spawned by the constructor, and never retired.
+             * */
+            std::size_t min_size = 0;
+
+            /**
+             * \brief The maximal number of workers (once reached, submitted executables wait for a free worker).
+             * */
+            std::size_t max_size = 1024;
+
+            /**
+             * \brief A worker idle for this long is retired (unless there are only min_size workers).
+             * */
+            std::chrono::milliseconds idle_timeout = std::chrono::milliseconds(10000);
+        } ThreadPoolOptions;
+
+        /**
+         * \brief A pool of pre-spawned native threads, that run the executables of pooled ::Thread objects.
+         * \sa Thread
+         *
+         * Submitting an executable hands it over to an idle worker (a queue push and a notification): a new native
+         * thread is spawned only when every worker is busy, up to the maximal size. Workers idle for longer than
+         * the idle timeout exit, down to the minimal size. \n
+         * Unlike a ThreadPoolExecutor, that runs short executables on a fixed number of workers, every executable
+         * gets a worker of its own (as long as the maximal size is not reached), so it can block for as long as a
+         * thread would. \n
+         * The destructor runs the pending executables, then waits for all the workers to exit. \n
+         * All the methods are thread-safe. \n
+         * */
+        class ThreadPool
+        {
+        public:
+            /**
+             * \brief Construct the pool and spawns its minimal number of workers.
+             * \param options The sizes of the pool.
+             * */
+            explicit ThreadPool(ThreadPoolOptions options = ThreadPoolOptions());
+
+            ThreadPool(const ThreadPool&) = delete;
+
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            /**
+             * \brief Runs the pending executables, then waits for the workers to exit.
+             * */
+            ~ThreadPool();
+
+            /**
+             * \brief Get the pool shared by the pooled threads created without an explicit pool.
+             * \return The pool (with the default options).
+             * */
+            static ThreadPool& get_default();
+
+            /**
+             * \brief Spawns workers in advance, so that the next executables do not wait for a spawn.
+             * \param count The number of workers the pool should have (bounded by the maximal size).
+             * */
+            void warm_up(std::size_t count);
+
+            /**
+             * \brief Runs an executable on a worker.
+             * \param executable The executable.
+             * */
+            void submit(LambdaExecutable&& executable);
+
+            /**
+             * \brief Get the number of workers.
+             * \return The number of workers.
+             * */
+            std::size_t get_size() const;
+
+            /**
+             * \brief Get the number of workers waiting for an executable.
+             * \return The number of idle workers.
+             * */
+            std::size_t get_idle_count() const;
+
+            /**
+             * \brief Get the number of executables waiting for a worker.
+             * \return The number of pending executables.
+             * */
+            std::size_t get_pending_count() const;
+
+        private:
+            /**
+             * \brief The sizes of the pool.
+             * */
+            const ThreadPoolOptions options;
+
+            /**
+             * \brief Protects the state of the pool.
+             * */
+            mutable std::mutex mutex;
+
+            /**
+             * \brief Notified when an executable is submitted (or the pool is destroyed).
+             * */
+            std::condition_variable work_condition;
+
+            /**
+             * \brief Notified when the last worker exits.
+             * */
+            std::condition_variable exit_condition;
+
+            /**
+             * \brief The executables waiting for a worker.
+             * */
+            std::deque<LambdaExecutable> pending;
+
+            /**
+             * \brief The number of workers.
+             * */
+            std::size_t size;
+
+            /**
+             * \brief The number of workers waiting for an executable.
+             * */
+            std::size_t idle;
+
+            /**
+             * \brief Set by the destructor.
+             * */
+            bool stopping;
+
+            /**
+             * \brief Spawns a worker (the mutex have to be locked).
+             * */
+            void spawn();
+
+            /**
+             * \brief The loop run by every worker.
+             * */
+            void work();
+        };
+    }
+}
+
+#endif
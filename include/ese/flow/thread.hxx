@@ -3,18 +3,77 @@
 #define ESE_FLOW_THREAD_HXX
 
 #include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace ese
 {
     namespace flow
     {
+        class ThreadPool;
+
+        /**
+         * \brief The scheduling policies of a thread.
+         *
+         * FIFO and ROUND_ROBIN are real-time policies (they usually require privileges), BATCH and IDLE are for
+         * throughput-oriented and background threads. \n
+         * */
+        enum class SchedulingPolicy
+        {
+            DEFAULT,
+            FIFO,
+            ROUND_ROBIN,
+            BATCH,
+            IDLE
+        };
+
+        /**
+         * \brief Tells where (and how) a Thread runs.
+         * \sa CpuTopology::layout()
+         * */
+        typedef struct _ThreadOptions_
+        {
+            /**
+             * \brief The CPUs on which the thread may run (if empty, the thread is not bound).
+             * */
+            std::vector<int> cpus;
+
+            /**
+             * \brief The NUMA node on which the thread runs and from which it allocates memory (-1 for none).
+             *
+             * The memory allocated by the thread (e.g. the buffers of the channels into which it sends) is taken
+             * from the node, when possible. If cpus is not empty, the thread is bound to those CPUs only. \n
+             * */
+            int numa_node = -1;
+
+            /**
+             * \brief The scheduling policy.
+             * */
+            SchedulingPolicy scheduling_policy = SchedulingPolicy::DEFAULT;
+
+            /**
+             * \brief The real-time priority (for FIFO and ROUND_ROBIN) or the nice value (for the other policies).
+             * */
+            int priority = 0;
+
+            /**
+             * \brief The name of the thread, as shown by debuggers and profilers (truncated to 15 characters on
+             *     Linux; if empty, the thread is not named).
+             * */
+            std::string name;
+        } ThreadOptions;
+
         /**
          * \brief A thread class.
          *
          * The created Thread object will execute the specified executable on a system thread. \n
+         * A pooled Thread (created with a ::ThreadPool) runs its executable on a pre-spawned worker of the pool
+         * instead, so that creating it costs a queue push rather than the creation of a system thread: its status,
+         * join() and the running count behave the same way. \n
          * Every thread should be joined, via Thread::join() method. \n
          * This class is something like a std::thread class wrapper (it adds some useful methods). \n
          * All operations on objects if this class are thread-safe. \n
@@ -41,7 +100,7 @@ namespace ese
             private:
 
                 /**
-                 * \brief The address of the native (C++) thread object.
+                 * \brief The address of the native (C++) thread object (nullptr for pooled threads).
                  * */
                 std::thread* native_thread;
 
@@ -55,13 +114,41 @@ namespace ese
                  * */
                 std::mutex joining_mutex;
 
+                /**
+                 * \brief Tells if all the options were applied.
+                 * */
+                std::atomic_bool placed;
+
+                /**
+                 * \brief Mutex used (with finished_condition) to wait for the end of a pooled thread.
+                 * */
+                std::mutex finished_mutex;
+
+                /**
+                 * \brief Notified when a pooled thread finishes.
+                 * */
+                std::condition_variable finished_condition;
+
             public:
                 /**
                  * \brief Creates a Thread object running the specified executable.
                  * \param executable The executable (have to implement operator()) to run on the thread.
+                 * \param options Where (and how) the thread runs: they are applied by the thread itself, before
+                 *     running the executable.
+                 * \sa is_placed()
+                 * */
+                template <typename TExecutable>
+                Thread(TExecutable&& executable, ThreadOptions options = ThreadOptions());
+
+                /**
+                 * \brief Creates a pooled Thread object, running the specified executable on a worker of a pool.
+                 * \param executable The executable (have to implement operator()) to run on the thread.
+                 * \param pool The pool (e.g. ThreadPool::get_default()), that have to outlive the thread.
+                 *
+                 * The executable is destroyed before the thread is FINISHED, as it would on a system thread. \n
                  * */
                 template <typename TExecutable>
-                Thread(TExecutable&& executable);
+                Thread(TExecutable&& executable, ThreadPool& pool);
 
                 /**
                  * \brief Destroys this object.
@@ -89,6 +176,13 @@ namespace ese
                  * */
                 bool is_joined() const noexcept;
 
+                /**
+                 * \brief Tells if all the options passed to the constructor were applied (meaningful once the thread
+                 *     is running).
+                 * \return True if they were applied, false if the operating system refused some of them.
+                 * */
+                bool is_placed() const noexcept;
+
                 /**
                  * \brief The function returns when the thread execution has completed.
                  *
@@ -100,10 +194,66 @@ namespace ese
                  * \brief Return the current number of running native (C++) threads, created by this class.
                  * \return The number of running native (C++) threads.
                  *
+                 * Pooled threads are counted while they run their executable (not the idle workers of the pools).
+                 *
                  * NOTE: The actual number of running threads may differ if some threads where created directly using
                  * the std::thread class (or any other method for thread creation).
                  * */
                 static int get_native_running_count() noexcept;
+
+                /**
+                 * \brief Return the number of threads (system or pooled) started by this class since the program
+                 *     started.
+                 * \return The number of started threads.
+                 * */
+                static std::uint64_t get_started_count() noexcept;
+
+                /**
+                 * \brief Binds the calling thread to a CPU.
+                 * \param cpu The index of the CPU.
+                 * \return True on success, false if the binding failed (or it is not supported on this platform).
+                 * */
+                static bool set_current_affinity(int cpu) noexcept;
+
+                /**
+                 * \brief Binds the calling thread to a set of CPUs.
+                 * \param cpus The indexes of the CPUs.
+                 * \return True on success, false if the binding failed (or it is not supported on this platform).
+                 * */
+                static bool set_current_affinity(const std::vector<int>& cpus) noexcept;
+
+                /**
+                 * \brief Binds the calling thread to the CPUs of a NUMA node, and makes it prefer the node's memory.
+                 * \param node The index of the node.
+                 * \return True on success, false if the binding failed (or it is not supported on this platform).
+                 *
+                 * Pages are placed when first touched: the memory the thread allocates and touches afterwards comes
+                 * from the node (when it has free memory). \n
+                 * */
+                static bool set_current_numa_node(int node) noexcept;
+
+                /**
+                 * \brief Sets the scheduling policy and priority of the calling thread.
+                 * \param policy The scheduling policy.
+                 * \param priority The real-time priority (for FIFO and ROUND_ROBIN) or the nice value (for the other
+                 *     policies).
+                 * \return True on success, false if it failed (or it is not supported on this platform).
+                 * */
+                static bool set_current_scheduling(SchedulingPolicy policy, int priority) noexcept;
+
+                /**
+                 * \brief Names the calling thread.
+                 * \param name The name (truncated to 15 characters on Linux).
+                 * \return True on success, false if it failed (or it is not supported on this platform).
+                 * */
+                static bool set_current_name(const std::string& name) noexcept;
+
+                /**
+                 * \brief Applies the options to the calling thread (the NUMA node first, then the CPUs).
+                 * \param options The options.
+                 * \return True if all of them were applied, false otherwise (the others are applied anyway).
+                 * */
+                static bool set_current_options(const ThreadOptions& options) noexcept;
         };
     }
 }
@@ -0,0 +1,213 @@
+
+#ifndef ESE_FLOW_TRACE_HXX
+#define ESE_FLOW_TRACE_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \brief The number of events kept by every thread (a power of two: once full, the oldest events are overwritten).
+ * */
+#ifndef ESE_FLOW_TRACE_BUFFER_SIZE
+#define ESE_FLOW_TRACE_BUFFER_SIZE (16384)
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief The kind of a TraceEvent.
+         * */
+        enum class TraceEventType
+        {
+            /**
+             * \brief A hop of an element (a send, a receive, a filter or a consume call), with its duration.
+             * */
+            SPAN,
+
+            /**
+             * \brief An element entered the queue of a channel.
+             * */
+            ENQUEUE,
+
+            /**
+             * \brief An element left the queue of a channel (it is paired with the ENQUEUE of the same sequence).
+             * */
+            DEQUEUE
+        };
+
+        /**
+         * \brief An event recorded by the Tracer.
+         * */
+        typedef struct _TraceEvent_
+        {
+            /**
+             * \brief The kind of the event.
+             * */
+            TraceEventType type;
+
+            /**
+             * \brief The name of the hop (a string literal: it is never copied).
+             * */
+            const char* name;
+
+            /**
+             * \brief The channel of an ENQUEUE or DEQUEUE event (nullptr for spans).
+             * */
+            const void* object;
+
+            /**
+             * \brief The position of the element in the channel (the n-th sent element is the n-th received one).
+             * */
+            std::uint64_t sequence;
+
+            /**
+             * \brief When the event happened, in ticks of Tracer::now().
+             * */
+            std::uint64_t time;
+
+            /**
+             * \brief The duration of a span, in ticks of Tracer::now().
+             * */
+            std::uint64_t duration;
+
+            /**
+             * \brief The index of the thread that recorded the event (set by Tracer::collect()).
+             * */
+            std::size_t thread;
+        } TraceEvent;
+
+        /**
+         * \brief Records where sampled elements spend their time, as they move through channels, filters and
+         *     consumers (those hops are instrumented only when ESE_FLOW_TRACING is defined).
+         * \sa TraceSpan
+         *
+         * Tracing is disabled until a sampling period is set: from then on, one call every period (on every
+         * thread) is traced with all the hops nested in it, and one element every period is traced through the
+         * queue of every Channel. Time is read from the TSC where available (a few nanoseconds), and converted to
+         * wall time only when the trace is dumped. \n
+         * Every thread records into a ring buffer of its own, without locks nor atomic read-modify-write
+         * operations: the buffers keep the last ESE_FLOW_TRACE_BUFFER_SIZE events of every thread. The buffer of
+         * an exited thread is reused by a new thread once its events were collected (or cleared), so the memory
+         * follows the number of live threads, not of the threads ever started. \n
+         * A call that is not sampled costs a thread-local increment and a branch. \n
+         * */
+        class Tracer
+        {
+        public:
+            Tracer() = delete;
+
+            /**
+             * \brief Sets how often elements are traced.
+             * \param period One element every period is traced (rounded up to a power of two), 0 disables tracing.
+             * */
+            static void set_sampling(std::uint64_t period) noexcept;
+
+            /**
+             * \brief Get how often elements are traced.
+             * \return The sampling period (0 if tracing is disabled).
+             * */
+            static std::uint64_t get_sampling() noexcept;
+
+            /**
+             * \brief Tells if the current call of the current thread is to be traced.
+             * \return True once every sampling period, false otherwise (or if tracing is disabled).
+             * */
+            static bool sample() noexcept;
+
+            /**
+             * \brief Tells if the element with a specified sequence number is to be traced.
+             * \param sequence The sequence number (e.g. the position of the element in a channel).
+             * \return True once every sampling period, false otherwise (or if tracing is disabled).
+             * */
+            static bool is_sampled(std::uint64_t sequence) noexcept;
+
+            /**
+             * \brief Get the current time, in ticks (of the TSC on x86, nanoseconds elsewhere).
+             * \return The time.
+             * */
+            static std::uint64_t now() noexcept;
+
+            /**
+             * \brief Records an event into the buffer of the current thread.
+             * \param event The event.
+             * */
+            static void record(const TraceEvent& event) noexcept;
+
+            /**
+             * \brief Reads the events recorded by all the threads (since the last clear()).
+             * \return The events, sorted by time.
+             *
+             * The events being recorded while the buffers are read may be lost. The events of exited threads are
+             * returned by the first call only, as their buffers can then be reused. \n
+             * */
+            static std::vector<TraceEvent> collect();
+
+            /**
+             * \brief Discards the recorded events.
+             * */
+            static void clear() noexcept;
+
+            /**
+             * \brief Get the number of ticks of now() in a nanosecond (measured once, in about 10 milliseconds).
+             * \return The number of ticks.
+             * */
+            static double get_ticks_per_nanosecond();
+
+            /**
+             * \brief Writes the recorded events in the Chrome trace format (also read by Perfetto).
+             * \param out Where the trace is written.
+             *
+             * Hops are written as complete events, on the track of their thread. The time an element waited in a
+             * channel is an async event (named "queue") from its ENQUEUE to its DEQUEUE, so that the queueing
+             * hotspots stand out. \n
+             * */
+            static void dump(std::ostream& out);
+        };
+
+        /**
+         * \brief Traces a hop as a span, from its construction to its destruction.
+         *
+         * The hop is traced if the call is sampled, or if it is nested in a traced hop of the same thread (so a
+         * traced send also traces the filters and the sends it calls). \n
+         * */
+        class TraceSpan
+        {
+        public:
+            /**
+             * \brief Starts the span (if the hop is to be traced).
+             * \param name The name of the hop (a string literal).
+             * */
+            explicit TraceSpan(const char* name) noexcept;
+
+            TraceSpan(const TraceSpan&) = delete;
+
+            TraceSpan& operator=(const TraceSpan&) = delete;
+
+            /**
+             * \brief Records the span (if the hop is traced).
+             * */
+            ~TraceSpan();
+
+        private:
+            /**
+             * \brief The name of the hop.
+             * */
+            const char* name;
+
+            /**
+             * \brief When the span started (0 if the hop is not traced).
+             * */
+            std::uint64_t start;
+        };
+    }
+}
+
+#include "template/trace.txx"
+
+#endif
@@ -0,0 +1,121 @@
+
+#ifndef ESE_FLOW_WAITPOLICY_HXX
+#define ESE_FLOW_WAITPOLICY_HXX
+
+#include <chrono>
+#include <cstddef>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief Tells the CPU that the calling thread is busy-waiting (a "pause" instruction, where available).
+         * */
+        inline void cpu_relax() noexcept;
+
+        /**
+         * \brief Wait policy for receivers that go to sleep as soon as there is nothing to receive.
+         * \sa SpinThenParkWaitPolicy
+         * \sa BusyPollWaitPolicy
+         *
+         * A wait policy tells a receiver how to wait for elements: first the receiver may spin() (without any lock)
+         * and then, if parks is true, it goes to sleep until it is notified. \n
+         * This is the best choice when receivers are often idle, as they do not burn any CPU time while waiting.
+         * */
+        class BlockingWaitPolicy
+        {
+        public:
+            /**
+             * \brief Tells if receivers spin before parking.
+             * */
+            static constexpr bool spins = false;
+
+            /**
+             * \brief Tells if receivers park (sleep) after spinning.
+             * */
+            static constexpr bool parks = true;
+
+            /**
+             * \brief Never spins.
+             * \param predicate Unused.
+             * \param time Unused.
+             * \return Always false.
+             * */
+            template<class TPredicate, class Clock, class Duration>
+            static bool spin(TPredicate&& predicate, const std::chrono::time_point<Clock, Duration>& time) noexcept;
+        };
+
+        /**
+         * \brief Wait policy for receivers that spin for a bounded amount of time, before going to sleep.
+         * \tparam SpinCount The number of times the predicate is checked, pausing the CPU between checks.
+         * \tparam YieldCount The number of times the predicate is checked, yielding the thread between checks (after
+         *     the pause phase).
+         * \sa BlockingWaitPolicy
+         * \sa BusyPollWaitPolicy
+         *
+         * When the elements arrive shortly after the receiver started waiting, the receiver gets them without paying
+         * a sleep and a wake-up (and the sender does not pay the notification). \n
+         * This is the best choice when receivers are almost always busy.
+         * */
+        template<std::size_t SpinCount = 256, std::size_t YieldCount = 16>
+        class SpinThenParkWaitPolicy
+        {
+        public:
+            /**
+             * \brief Tells if receivers spin before parking.
+             * */
+            static constexpr bool spins = true;
+
+            /**
+             * \brief Tells if receivers park (sleep) after spinning.
+             * */
+            static constexpr bool parks = true;
+
+            /**
+             * \brief Spins until the predicate becomes true, the spin budget ends or the time point is reached.
+             * \param predicate Tells when the wait is over.
+             * \param time The time point to wait until.
+             * \return True if the predicate became true, false otherwise.
+             * */
+            template<class TPredicate, class Clock, class Duration>
+            static bool spin(TPredicate&& predicate, const std::chrono::time_point<Clock, Duration>& time);
+        };
+
+        /**
+         * \brief Wait policy for receivers that never sleep: they poll until an element arrives or the time point is
+         *     reached.
+         * \sa BlockingWaitPolicy
+         * \sa SpinThenParkWaitPolicy
+         *
+         * It gives the lowest hand-off latency, at the price of a CPU core per waiting receiver. Blocking receives
+         * (with no time point) busy-poll forever, so wake_up() is the only way to stop them.
+         * */
+        class BusyPollWaitPolicy
+        {
+        public:
+            /**
+             * \brief Tells if receivers spin before parking.
+             * */
+            static constexpr bool spins = true;
+
+            /**
+             * \brief Tells if receivers park (sleep) after spinning.
+             * */
+            static constexpr bool parks = false;
+
+            /**
+             * \brief Spins until the predicate becomes true or the time point is reached.
+             * \param predicate Tells when the wait is over.
+             * \param time The time point to wait until.
+             * \return True if the predicate became true, false otherwise.
+             * */
+            template<class TPredicate, class Clock, class Duration>
+            static bool spin(TPredicate&& predicate, const std::chrono::time_point<Clock, Duration>& time);
+        };
+    }
+}
+
+#include "template/wait-policy.txx"
+
+#endif
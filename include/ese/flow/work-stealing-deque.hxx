@@ -0,0 +1,136 @@
+
+#ifndef ESE_FLOW_WORKSTEALINGDEQUE_HXX
+#define ESE_FLOW_WORKSTEALINGDEQUE_HXX
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <ese/flow/cache-line.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        /**
+         * \brief A growable Chase-Lev deque: one owner thread pushes and pops at the bottom, any other thread steals
+         *     from the top.
+         * \tparam TElement The type of the stored elements. Have to be trivially copyable (usually a pointer).
+         *
+         * The owner's push() and pop() are wait-free in the common case (pop() uses a CAS only to take the last
+         * element). steal() is lock-free. \n
+         * When the deque is full, the owner doubles its storage. Old storages are kept until the deque is destroyed,
+         * because a thief may still be reading them. \n
+         * */
+        template<typename TElement>
+        class WorkStealingDeque
+        {
+        public:
+            /**
+             * \brief The type of the stored elements.
+             * */
+            typedef TElement ElementType;
+
+            /**
+             * \brief Construct an empty deque.
+             * \param capacity The initial capacity (rounded up to the next power of two).
+             * */
+            explicit WorkStealingDeque(std::size_t capacity = 256);
+
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            /**
+             * \brief Pushes an element at the bottom of the deque (owner thread only).
+             * \param element The element to push.
+             * */
+            void push(TElement element);
+
+            /**
+             * \brief Pops the element at the bottom of the deque (owner thread only).
+             * \param address The pointer to the address where the popped element have to be stored.
+             * \return True if an element was popped, false if the deque is empty.
+             * */
+            bool pop(TElement* address) noexcept;
+
+            /**
+             * \brief Steals the element at the top of the deque (any thread).
+             * \param address The pointer to the address where the stolen element have to be stored.
+             * \return True if an element was stolen, false if the deque is empty or another thread took the element.
+             * */
+            bool steal(TElement* address) noexcept;
+
+            /**
+             * \brief Tells if the deque is (was, at the moment of the call) empty.
+             * \return True if it is empty, false otherwise.
+             * */
+            bool is_empty() const noexcept;
+
+        private:
+            /**
+             * \brief A circular storage of elements.
+             * */
+            typedef struct _Array_
+            {
+                /**
+                 * \brief capacity - 1, used to map positions to slots.
+                 * */
+                std::int64_t mask;
+
+                /**
+                 * \brief The slots (atomic, because thieves read them while the owner writes).
+                 * */
+                std::unique_ptr<std::atomic<TElement>[]> slots;
+
+                /**
+                 * \brief Construct an array of the specified capacity (a power of two).
+                 * */
+                explicit _Array_(std::int64_t capacity);
+
+                /**
+                 * \brief Stores an element at the specified position.
+                 * */
+                void put(std::int64_t position, TElement element) noexcept;
+
+                /**
+                 * \brief Loads the element at the specified position.
+                 * */
+                TElement get(std::int64_t position) const noexcept;
+            } Array;
+
+            /**
+             * \brief The position of the next element to steal.
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::int64_t> top;
+
+            /**
+             * \brief The position of the next element to push (written only by the owner).
+             * */
+            alignas(ESE_FLOW_CACHE_LINE_SIZE) std::atomic<std::int64_t> bottom;
+
+            /**
+             * \brief The current storage.
+             * */
+            std::atomic<Array*> array;
+
+            /**
+             * \brief All the storages ever used (the current one included), released on destruction.
+             * */
+            std::vector<std::unique_ptr<Array>> arrays;
+
+            /**
+             * \brief Replaces the current storage with a storage of double capacity (owner thread only).
+             * \param bottom The current bottom.
+             * \param top The current top.
+             * \return The new storage.
+             * */
+            Array* grow(std::int64_t bottom, std::int64_t top);
+        };
+    }
+}
+
+#include "template/work-stealing-deque.txx"
+
+#endif
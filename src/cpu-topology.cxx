@@ -0,0 +1,257 @@
+#include <ese/flow/cpu-topology.hxx>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        namespace
+        {
+            /**
+             * \brief Reads the first line of a file.
+             * \param path The path of the file.
+             * \param line Where the line is stored.
+             * \return True on success, false if the file can not be read.
+             * */
+            bool read_line(const std::string& path, std::string* line)
+            {
+                std::ifstream file(path);
+                return static_cast<bool>(std::getline(file, *line));
+            }
+
+            /**
+             * \brief Reads an integer from a file.
+             * \param path The path of the file.
+             * \param fallback The value returned if the file can not be read.
+             * \return The integer.
+             * */
+            int read_int(const std::string& path, int fallback)
+            {
+                std::string line;
+
+                if (!read_line(path, &line))
+                    return fallback;
+
+                try
+                {
+                    return std::stoi(line);
+                }
+                catch (const std::exception&)
+                {
+                    return fallback;
+                }
+            }
+
+            /**
+             * \brief Reads the CPUs on which the process may run.
+             * \return The ids of the CPUs in the affinity mask of the process (empty if the mask can not be read).
+             * */
+            std::set<int> read_allowed_cpus()
+            {
+                std::set<int> allowed;
+
+#ifdef __linux__
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+
+                if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+                    for (int id = 0; id < CPU_SETSIZE; ++id)
+                        if (CPU_ISSET(id, &mask))
+                            allowed.insert(id);
+#endif
+
+                return allowed;
+            }
+        }
+
+        CpuTopology::CpuTopology(std::vector<Cpu> cpus):
+            cpus(std::move(cpus))
+        {
+            std::sort(this->cpus.begin(), this->cpus.end(), [] (const Cpu& a, const Cpu& b)
+                {
+                    return std::make_tuple(a.node, a.package, a.core, a.id)
+                        < std::make_tuple(b.node, b.package, b.core, b.id);
+                });
+        }
+
+        CpuTopology CpuTopology::detect()
+        {
+            std::vector<Cpu> cpus;
+            std::string line;
+            const std::set<int> allowed = read_allowed_cpus();
+
+            if (read_line("/sys/devices/system/cpu/online", &line))
+            {
+                const std::string root = "/sys/devices/system/cpu/cpu";
+
+                // inside a cpuset (or a container) only some of the online CPUs can be used
+                for (int id: parse_cpu_list(line))
+                {
+                    if (!allowed.empty() && allowed.count(id) == 0)
+                        continue;
+
+                    const std::string topology = root + std::to_string(id) + "/topology/";
+                    cpus.push_back({id, read_int(topology + "core_id", id),
+                        read_int(topology + "physical_package_id", 0), -1});
+                }
+
+                // the nodes can be numbered sparsely
+                const std::vector<int> nodes = read_line("/sys/devices/system/node/online", &line)
+                    ? parse_cpu_list(line) : std::vector<int>();
+
+                for (int node: nodes)
+                {
+                    if (!read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", &line))
+                        continue;
+
+                    for (int id: parse_cpu_list(line))
+                        for (Cpu& cpu: cpus)
+                            if (cpu.id == id)
+                                cpu.node = node;
+                }
+            }
+
+            if (cpus.empty() && !allowed.empty())
+            {
+                for (int id: allowed)
+                    cpus.push_back({id, id, 0, -1});
+            }
+            else if (cpus.empty())
+            {
+                const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+                for (int id = 0; id < count; ++id)
+                    cpus.push_back({id, id, 0, -1});
+            }
+
+            return CpuTopology(std::move(cpus));
+        }
+
+        std::vector<int> CpuTopology::parse_cpu_list(const std::string& list)
+        {
+            std::vector<int> cpus;
+            std::size_t position = 0;
+
+            while (position < list.size())
+            {
+                std::size_t end = list.find(',', position);
+
+                if (end == std::string::npos)
+                    end = list.size();
+
+                const std::string range = list.substr(position, end - position);
+                const std::size_t dash = range.find('-');
+
+                position = end + 1;
+
+                // an empty list (e.g. a node without CPUs) is a blank line
+                if (range.find_first_not_of(" \t\r\n") == std::string::npos)
+                    continue;
+
+                int first;
+                int last;
+
+                try
+                {
+                    first = std::stoi(range.substr(0, dash));
+                    last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                }
+                catch (const std::logic_error&)
+                {
+                    throw std::invalid_argument("Invalid CPU list: " + list);
+                }
+
+                if (first < 0 || last < first)
+                    throw std::invalid_argument("Invalid CPU list: " + list);
+
+                for (int cpu = first; cpu <= last; ++cpu)
+                    cpus.push_back(cpu);
+            }
+
+            return cpus;
+        }
+
+        const std::vector<CpuTopology::Cpu>& CpuTopology::get_cpus() const noexcept
+        {
+            return cpus;
+        }
+
+        std::size_t CpuTopology::get_cores_count() const
+        {
+            std::set<std::pair<int, int>> cores;
+
+            for (const Cpu& cpu: cpus)
+                cores.emplace(cpu.package, cpu.core);
+
+            return cores.size();
+        }
+
+        std::size_t CpuTopology::get_nodes_count() const
+        {
+            std::set<int> nodes;
+
+            for (const Cpu& cpu: cpus)
+                if (cpu.node >= 0)
+                    nodes.insert(cpu.node);
+
+            return nodes.size();
+        }
+
+        std::vector<int> CpuTopology::get_node_cpus(int node) const
+        {
+            std::vector<int> ids;
+
+            for (const Cpu& cpu: cpus)
+                if (cpu.node == node)
+                    ids.push_back(cpu.id);
+
+            return ids;
+        }
+
+        std::vector<ThreadOptions> CpuTopology::layout(std::size_t threads_count, const std::string& name_prefix) const
+        {
+            // the first hardware thread of every core (in node order), then the second ones, and so on
+            std::vector<const Cpu*> order;
+            std::vector<std::vector<const Cpu*>> rounds;
+            std::map<std::tuple<int, int, int>, std::size_t> siblings;
+
+            for (const Cpu& cpu: cpus)
+            {
+                const std::size_t round = siblings[std::make_tuple(cpu.node, cpu.package, cpu.core)]++;
+
+                if (rounds.size() <= round)
+                    rounds.resize(round + 1);
+
+                rounds[round].push_back(&cpu);
+            }
+
+            for (const std::vector<const Cpu*>& round: rounds)
+                order.insert(order.end(), round.begin(), round.end());
+
+            std::vector<ThreadOptions> options(threads_count);
+
+            for (std::size_t i = 0; i < threads_count && !order.empty(); ++i)
+            {
+                const Cpu& cpu = *order[i % order.size()];
+                options[i].cpus.push_back(cpu.id);
+                options[i].numa_node = cpu.node;
+
+                if (!name_prefix.empty())
+                    options[i].name = name_prefix + std::to_string(i);
+            }
+
+            return options;
+        }
+    }
+}
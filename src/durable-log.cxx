@@ -0,0 +1,499 @@
+#include <ese/flow/durable-log.hxx>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ese
+{
+    namespace flow
+    {
+        namespace
+        {
+            /**
+             * \brief The size of a record's header: the size of the record plus one (0 marks the end of a
+             *     segment) and the checksum of the record.
+             * */
+            const std::size_t RECORD_HEADER_SIZE = 2 * sizeof(std::uint32_t);
+
+            /**
+             * \brief The suffix of the segment files.
+             * */
+            const char* const SEGMENT_SUFFIX = ".log";
+
+            [[noreturn]] void throw_errno(const char* what)
+            {
+                throw std::system_error(errno, std::system_category(), what);
+            }
+
+            std::size_t align_record(std::size_t size) noexcept
+            {
+                return (RECORD_HEADER_SIZE + size + 7) & ~std::size_t(7);
+            }
+
+            std::uint32_t checksum(const char* data, std::size_t size) noexcept
+            {
+                // FNV-1a
+                std::uint32_t hash = 2166136261u;
+
+                for (std::size_t i = 0; i < size; ++i)
+                    hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+
+                return hash;
+            }
+
+            std::string segment_name(DurableLog::Offset base)
+            {
+                char name[32];
+                std::snprintf(name, sizeof(name), "%020llu%s", static_cast<unsigned long long>(base), SEGMENT_SUFFIX);
+                return name;
+            }
+
+            void sync_directory(const std::string& directory)
+            {
+                const int fd = ::open(directory.c_str(), O_RDONLY);
+
+                if (fd == -1)
+                    throw_errno("open");
+
+                fsync(fd);
+                close(fd);
+            }
+        }
+
+        class DurableLog::Segment
+        {
+        public:
+            /**
+             * \brief The path of the segment file.
+             * */
+            const std::string path;
+
+            /**
+             * \brief The offset of the first record of the segment.
+             * */
+            const Offset base;
+
+            /**
+             * \brief The file descriptor of the segment file.
+             * */
+            int fd;
+
+            /**
+             * \brief The mapping of the segment file.
+             * */
+            char* address;
+
+            /**
+             * \brief The size of the segment file.
+             * */
+            std::size_t size;
+
+            /**
+             * \brief The number of used bytes.
+             * */
+            std::size_t end;
+
+            /**
+             * \brief The number of bytes flushed to disk.
+             * */
+            std::size_t synced;
+
+            /**
+             * \brief The number of records.
+             * */
+            Offset count;
+
+            Segment(const std::string& path, Offset base, std::size_t create_size):
+                path(path),
+                base(base),
+                fd(-1),
+                address(nullptr),
+                size(create_size),
+                end(0),
+                synced(0),
+                count(0)
+            {
+                fd = ::open(path.c_str(), O_RDWR | (create_size != 0 ? O_CREAT | O_EXCL : 0), 0644);
+
+                if (fd == -1)
+                    throw_errno("open");
+
+                struct stat status;
+
+                if (create_size != 0 ? ftruncate(fd, static_cast<off_t>(create_size)) == -1 : fstat(fd, &status) == -1)
+                {
+                    const int error = errno;
+                    close(fd);
+                    throw std::system_error(error, std::system_category(), "segment");
+                }
+
+                if (create_size == 0)
+                    size = static_cast<std::size_t>(status.st_size);
+
+                void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+                if (mapping == MAP_FAILED)
+                {
+                    const int error = errno;
+                    close(fd);
+                    throw std::system_error(error, std::system_category(), "mmap");
+                }
+
+                address = static_cast<char*>(mapping);
+            }
+
+            Segment(const Segment&) = delete;
+
+            Segment& operator=(const Segment&) = delete;
+
+            ~Segment()
+            {
+                munmap(address, size);
+                close(fd);
+            }
+
+            /**
+             * \brief Finds the used part of the segment, stopping at the first torn record (that is erased).
+             * */
+            void recover() noexcept
+            {
+                while (end + RECORD_HEADER_SIZE <= size)
+                {
+                    std::uint32_t header[2];
+                    std::memcpy(header, address + end, RECORD_HEADER_SIZE);
+
+                    if (header[0] == 0)
+                        break;
+
+                    const std::size_t length = header[0] - 1;
+
+                    if (end + align_record(length) > size
+                        || checksum(address + end + RECORD_HEADER_SIZE, length) != header[1])
+                    {
+                        std::memset(address + end, 0, size - end);
+                        break;
+                    }
+
+                    end += align_record(length);
+                    ++count;
+                }
+
+                synced = end;
+            }
+
+            /**
+             * \brief Tells if a record fits in the segment.
+             * \param length The size of the record.
+             * \return True if the record fits, false otherwise.
+             * */
+            bool fits(std::size_t length) const noexcept
+            {
+                return end + align_record(length) <= size;
+            }
+
+            /**
+             * \brief Copies a record at the end of the segment.
+             * \param data The address of the record's bytes.
+             * \param length The size of the record.
+             * */
+            void append(const void* data, std::size_t length) noexcept
+            {
+                const std::uint32_t header[2] = {
+                    static_cast<std::uint32_t>(length + 1),
+                    checksum(static_cast<const char*>(data), length)
+                };
+
+                std::memcpy(address + end + RECORD_HEADER_SIZE, data, length);
+                std::memcpy(address + end, header, RECORD_HEADER_SIZE);
+                end += align_record(length);
+                ++count;
+            }
+
+            /**
+             * \brief Reads the record at a position of the segment.
+             * \param byte The position of the record.
+             * \param data Where the address of the record's bytes is stored.
+             * \param length Where the size of the record is stored.
+             * \return The position of the next record.
+             * */
+            std::size_t read(std::size_t byte, const char** data, std::size_t* length) const noexcept
+            {
+                std::uint32_t header[2];
+                std::memcpy(header, address + byte, RECORD_HEADER_SIZE);
+
+                *data = address + byte + RECORD_HEADER_SIZE;
+                *length = header[0] - 1;
+                return byte + align_record(*length);
+            }
+
+            /**
+             * \brief Flushes the bytes written since the last flush.
+             * */
+            void sync()
+            {
+                if (synced == end)
+                    return;
+
+                static const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+                const std::size_t from = synced & ~(page_size - 1);
+
+                if (msync(address + from, end - from, MS_SYNC) == -1)
+                    throw_errno("msync");
+
+                synced = end;
+            }
+        };
+
+        DurableLog::DurableLog(const std::string& directory, const DurableLogOptions& options):
+            directory(directory),
+            options(options),
+            end_offset(0),
+            synced_offset(0),
+            committed_offset(0),
+            last_sync(std::chrono::steady_clock::now()),
+            committed_fd(-1)
+        {
+            if (mkdir(directory.c_str(), 0755) == -1 && errno != EEXIST)
+                throw_errno("mkdir");
+
+            std::vector<Offset> bases;
+
+            if (DIR* handle = opendir(directory.c_str()))
+            {
+                while (dirent* entry = readdir(handle))
+                {
+                    const std::string name = entry->d_name;
+                    const std::size_t suffix_length = std::strlen(SEGMENT_SUFFIX);
+
+                    if (name.size() > suffix_length
+                        && name.compare(name.size() - suffix_length, suffix_length, SEGMENT_SUFFIX) == 0)
+                        bases.push_back(std::strtoull(name.c_str(), nullptr, 10));
+                }
+
+                closedir(handle);
+            }
+            else
+            {
+                throw_errno("opendir");
+            }
+
+            std::sort(bases.begin(), bases.end());
+
+            for (Offset base: bases)
+            {
+                const std::string path = directory + "/" + segment_name(base);
+
+                // a gap (records lost before a crash) makes the following segments unreachable
+                if (!segments.empty() && base != end_offset)
+                {
+                    ::unlink(path.c_str());
+                    continue;
+                }
+
+                std::unique_ptr<Segment> segment(new Segment(path, base, 0));
+                segment->recover();
+                end_offset = base + segment->count;
+                segments.emplace(base, std::move(segment));
+            }
+
+            if (segments.empty())
+                add_segment();
+
+            synced_offset = end_offset;
+
+            const std::string committed_path = directory + "/committed";
+            committed_fd = ::open(committed_path.c_str(), O_RDWR | O_CREAT, 0644);
+
+            if (committed_fd == -1)
+                throw_errno("open");
+
+            if (pread(committed_fd, &committed_offset, sizeof(committed_offset), 0) != sizeof(committed_offset))
+                committed_offset = 0;
+
+            // records lost in a crash would otherwise stay committed, and the ones appended at their offsets skipped
+            if (committed_offset > end_offset)
+                commit(end_offset);
+        }
+
+        DurableLog::~DurableLog()
+        {
+            try
+            {
+                sync();
+            }
+            catch (...)
+            {
+
+            }
+
+            close(committed_fd);
+        }
+
+        DurableLog::Segment& DurableLog::add_segment()
+        {
+            const std::string path = directory + "/" + segment_name(end_offset);
+            std::unique_ptr<Segment> segment(new Segment(path, end_offset, options.segment_size));
+            Segment& added = *segment;
+
+            segments.emplace(end_offset, std::move(segment));
+            sync_directory(directory);
+            return added;
+        }
+
+        DurableLog::Segment& DurableLog::get_last_segment() noexcept
+        {
+            return *segments.rbegin()->second;
+        }
+
+        DurableLog::Offset DurableLog::append(const void* data, std::size_t size)
+        {
+            if (align_record(size) > options.segment_size)
+                throw std::length_error("the record is larger than a segment");
+
+            Segment* segment = &get_last_segment();
+
+            if (!segment->fits(size))
+            {
+                // a segment is complete on disk before the next one starts
+                segment->sync();
+                segment = &add_segment();
+            }
+
+            segment->append(data, size);
+            return end_offset++;
+        }
+
+        bool DurableLog::maybe_sync()
+        {
+            const Offset unsynced = end_offset - synced_offset;
+
+            if (unsynced == 0)
+                return false;
+
+            const bool count_reached = options.sync_every != 0 && unsynced >= options.sync_every;
+
+            if (!count_reached && (options.sync_interval.count() == 0
+                || std::chrono::steady_clock::now() - last_sync < options.sync_interval))
+                return false;
+
+            sync();
+            return true;
+        }
+
+        void DurableLog::sync()
+        {
+            get_last_segment().sync();
+            synced_offset = end_offset;
+            last_sync = std::chrono::steady_clock::now();
+        }
+
+        bool DurableLog::seek(Offset offset, Position* position) const
+        {
+            if (offset < get_begin_offset() || offset > end_offset)
+                return false;
+
+            auto found = segments.upper_bound(offset);
+            --found;
+
+            const Segment& segment = *found->second;
+            position->offset = segment.base;
+            position->segment = segment.base;
+            position->byte = 0;
+
+            const char* data;
+            std::size_t size;
+
+            while (position->offset < offset)
+            {
+                position->byte = segment.read(position->byte, &data, &size);
+                ++position->offset;
+            }
+
+            return true;
+        }
+
+        bool DurableLog::read(Position* position, const char** data, std::size_t* size) const
+        {
+            if (position->offset >= end_offset)
+                return false;
+
+            auto found = segments.find(position->segment);
+
+            // the segment was compacted away, or the position is at its end
+            if (found == segments.end() || position->offset >= found->second->base + found->second->count)
+            {
+                if (!seek(std::max(position->offset, get_begin_offset()), position))
+                    return false;
+
+                found = segments.find(position->segment);
+            }
+
+            position->byte = found->second->read(position->byte, data, size);
+            ++position->offset;
+            return true;
+        }
+
+        void DurableLog::commit(Offset offset)
+        {
+            if (offset > synced_offset)
+                sync();
+
+            if (pwrite(committed_fd, &offset, sizeof(offset), 0) != sizeof(offset))
+                throw_errno("pwrite");
+
+            if (fdatasync(committed_fd) == -1)
+                throw_errno("fdatasync");
+
+            committed_offset = offset;
+        }
+
+        std::size_t DurableLog::compact()
+        {
+            std::size_t removed = 0;
+
+            while (segments.size() > 1)
+            {
+                const Segment& first = *segments.begin()->second;
+
+                if (first.base + first.count > committed_offset)
+                    break;
+
+                ::unlink(first.path.c_str());
+                segments.erase(segments.begin());
+                ++removed;
+            }
+
+            return removed;
+        }
+
+        DurableLog::Offset DurableLog::get_begin_offset() const noexcept
+        {
+            return segments.begin()->first;
+        }
+
+        DurableLog::Offset DurableLog::get_end_offset() const noexcept
+        {
+            return end_offset;
+        }
+
+        DurableLog::Offset DurableLog::get_synced_offset() const noexcept
+        {
+            return synced_offset;
+        }
+
+        DurableLog::Offset DurableLog::get_committed_offset() const noexcept
+        {
+            return committed_offset;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include <ese/flow/event-count.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        EventCount::EventCount() noexcept:
+            epoch(0),
+            waiting(0)
+        {
+
+        }
+
+        EventCount::Key EventCount::prepare_wait() noexcept
+        {
+            waiting.fetch_add(1, std::memory_order_seq_cst);
+            return epoch.load(std::memory_order_seq_cst);
+        }
+
+        void EventCount::cancel_wait() noexcept
+        {
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void EventCount::wait(Key key)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (epoch.load(std::memory_order_relaxed) == key)
+                condition_variable.wait(lock);
+
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        bool EventCount::advance() noexcept
+        {
+            // pairs with the seq_cst operations of prepare_wait(): either the waiter sees the new state, or we see
+            // the waiter
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (waiting.load(std::memory_order_relaxed) == 0)
+                return false;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            epoch.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        void EventCount::notify_one() noexcept
+        {
+            if (advance())
+                condition_variable.notify_one();
+        }
+
+        void EventCount::notify_all() noexcept
+        {
+            if (advance())
+                condition_variable.notify_all();
+        }
+
+        int EventCount::get_waiting_count() const noexcept
+        {
+            return waiting;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include <ese/flow/metrics.hxx>
+#include <ese/flow/thread.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        constexpr std::size_t LatencyHistogram::BUCKETS_COUNT;
+
+        std::vector<std::pair<std::string, double>> MetricsSnapshot::get_samples() const
+        {
+            std::vector<std::pair<std::string, double>> samples;
+
+            auto add = [&samples] (const std::string& name, double value)
+                {
+                    samples.emplace_back(name, value);
+                };
+
+            for (const auto& entry: channels)
+            {
+                const std::string prefix = "channel." + entry.first + ".";
+                const ChannelMetrics& metrics = entry.second;
+
+                add(prefix + "enqueued", static_cast<double>(metrics.enqueued));
+                add(prefix + "dequeued", static_cast<double>(metrics.dequeued));
+                add(prefix + "depth", static_cast<double>(metrics.depth));
+                add(prefix + "high_water_mark", static_cast<double>(metrics.high_water_mark));
+                add(prefix + "dropped", static_cast<double>(metrics.dropped));
+                add(prefix + "blocked", static_cast<double>(metrics.blocked));
+                add(prefix + "lock_contentions", static_cast<double>(metrics.lock_contentions));
+                add(prefix + "lock_wait_ns", static_cast<double>(metrics.lock_wait_ns));
+                add(prefix + "spun_waits", static_cast<double>(metrics.spun_waits));
+                add(prefix + "slept_waits", static_cast<double>(metrics.slept_waits));
+                add(prefix + "timed_out_waits", static_cast<double>(metrics.timed_out_waits));
+            }
+
+            for (const auto& entry: consumers)
+            {
+                const std::string prefix = "consumer." + entry.first + ".";
+                const ConsumerMetrics& metrics = entry.second;
+
+                add(prefix + "consumed", static_cast<double>(metrics.consumed));
+                add(prefix + "latency.count", static_cast<double>(metrics.latency.count));
+                add(prefix + "latency.mean", metrics.latency.mean);
+                add(prefix + "latency.p50", static_cast<double>(metrics.latency.p50));
+                add(prefix + "latency.p90", static_cast<double>(metrics.latency.p90));
+                add(prefix + "latency.p99", static_cast<double>(metrics.latency.p99));
+                add(prefix + "latency.p999", static_cast<double>(metrics.latency.p999));
+                add(prefix + "latency.max", static_cast<double>(metrics.latency.max));
+            }
+
+            add("threads.running", static_cast<double>(threads.running));
+            add("threads.started", static_cast<double>(threads.started));
+            return samples;
+        }
+
+        MetricsRegistry& MetricsRegistry::get_default()
+        {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+        void MetricsRegistry::add_channel(const std::string& name, std::function<ChannelMetrics()> source)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            channels[name] = std::move(source);
+        }
+
+        void MetricsRegistry::add_consumer(const std::string& name, std::function<ConsumerMetrics()> source)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            consumers[name] = std::move(source);
+        }
+
+        void MetricsRegistry::remove(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            channels.erase(name);
+            consumers.erase(name);
+        }
+
+        MetricsSnapshot MetricsRegistry::snapshot() const
+        {
+            MetricsSnapshot snapshot;
+            std::lock_guard<std::mutex> lock(mutex);
+
+            snapshot.time = std::chrono::steady_clock::now();
+
+            for (const auto& entry: channels)
+                snapshot.channels[entry.first] = entry.second();
+
+            for (const auto& entry: consumers)
+                snapshot.consumers[entry.first] = entry.second();
+
+            snapshot.threads.running = static_cast<std::uint64_t>(Thread::get_native_running_count());
+            snapshot.threads.started = Thread::get_started_count();
+            return snapshot;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include <ese/flow/pipeline.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        PipelineState::_Stage_::_Stage_(const _Stage_* upstream, std::size_t parallelism) noexcept:
+            running(0),
+            upstream(upstream),
+            parallelism(parallelism),
+            listening(false)
+        {
+
+        }
+
+        PipelineState::_Stage_::~_Stage_() noexcept
+        {
+            if (detach)
+                detach();
+        }
+
+        void PipelineState::_Stage_::on_send() noexcept
+        {
+            input_event.notify_all();
+        }
+
+        PipelineState::PipelineState(std::size_t channel_capacity, std::chrono::milliseconds poll_interval):
+            channel_capacity(channel_capacity),
+            poll_interval(poll_interval),
+            stop_requested(false)
+        {
+
+        }
+
+        PipelineState::Stage* PipelineState::add_stage(const Stage* upstream, std::size_t parallelism)
+        {
+            stages.emplace_back(new Stage(upstream, parallelism));
+            return stages.back().get();
+        }
+
+        bool PipelineState::is_input_finished(const Stage& stage) const noexcept
+        {
+            if (stage.upstream == nullptr)
+                return stop_requested.load(std::memory_order_acquire);
+
+            return stage.upstream->running.load(std::memory_order_acquire) == 0;
+        }
+
+        void PipelineState::finish_thread(Stage& stage)
+        {
+            if (stage.running.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            for (std::unique_ptr<Stage>& downstream: stages)
+                if (downstream->upstream == &stage)
+                    downstream->input_event.notify_all();
+        }
+
+        RunningPipeline::RunningPipeline(std::unique_ptr<PipelineState>&& state, std::vector<ThreadOptions> options):
+            state(std::move(state))
+        {
+            std::vector<LambdaExecutable>& bodies = this->state->bodies;
+
+            for (std::size_t i = 0; i < bodies.size(); ++i)
+                threads.emplace_back(new Thread(std::move(bodies[i]),
+                    i < options.size() ? std::move(options[i]) : ThreadOptions()));
+
+            this->state->bodies.clear();
+        }
+
+        RunningPipeline::~RunningPipeline()
+        {
+            if (state == nullptr)
+                return;
+
+            stop();
+            join();
+        }
+
+        void RunningPipeline::stop() noexcept
+        {
+            state->stop_requested.store(true, std::memory_order_release);
+            state->stages.front()->input_event.notify_all();
+        }
+
+        void RunningPipeline::join()
+        {
+            for (std::unique_ptr<Thread>& thread: threads)
+                thread->join();
+        }
+
+        std::size_t RunningPipeline::get_stages_count() const noexcept
+        {
+            return state->stages.size();
+        }
+
+        std::size_t RunningPipeline::get_threads_count() const noexcept
+        {
+            return threads.size();
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <ese/flow/poller.hxx>
+
+namespace ese
+{
+    namespace flow
+    {
+        const std::size_t Poller::NONE;
+
+        Poller::Poller():
+            current(NONE),
+            credits(0),
+            wake_ups(0)
+        {
+
+        }
+
+        Poller::~Poller()
+        {
+            for (Source& source: sources)
+                source.detach();
+        }
+
+        std::size_t Poller::poll()
+        {
+            return find_ready();
+        }
+
+        std::size_t Poller::wait()
+        {
+            return wait_until_0(Deadline::max());
+        }
+
+        std::size_t Poller::wait_until_0(const Deadline& time)
+        {
+            const unsigned wake_ups = this->wake_ups.load(std::memory_order_acquire);
+            std::size_t index = find_ready();
+
+            if (index != NONE || time == Deadline::min())
+                return index;
+
+            while (true)
+            {
+                EventCount::Key key = event.prepare_wait();
+                index = find_ready();
+
+                if (index != NONE || this->wake_ups.load(std::memory_order_acquire) != wake_ups)
+                {
+                    event.cancel_wait();
+                    return index;
+                }
+
+                if (!event.wait_until(key, time))
+                    return find_ready();
+
+                index = find_ready();
+
+                // the notification may come from a channel whose element was already taken by another receiver
+                if (index != NONE || this->wake_ups.load(std::memory_order_acquire) != wake_ups)
+                    return index;
+            }
+        }
+
+        void Poller::wake_up() noexcept
+        {
+            wake_ups.fetch_add(1, std::memory_order_release);
+            event.notify_all();
+        }
+
+        std::size_t Poller::get_channels_count() const noexcept
+        {
+            return sources.size();
+        }
+
+        void Poller::on_send() noexcept
+        {
+            event.notify_one();
+        }
+
+        std::size_t Poller::find_ready()
+        {
+            const std::size_t count = sources.size();
+
+            if (count == 0)
+                return NONE;
+
+            if (credits != 0 && sources[current].is_ready())
+            {
+                --credits;
+                return current;
+            }
+
+            for (std::size_t i = 1; i <= count; ++i)
+            {
+                const std::size_t index = (current + i) % count;
+
+                if (sources[index].is_ready())
+                {
+                    current = index;
+                    credits = sources[index].weight - 1;
+                    return index;
+                }
+            }
+
+            return NONE;
+        }
+    }
+}
@@ -0,0 +1,229 @@
+#include <ese/flow/profiled-mutex.hxx>
+#include <algorithm>
+#include <cstdio>
+
+namespace ese
+{
+    namespace flow
+    {
+        namespace
+        {
+            /**
+             * \brief The role of the current thread.
+             * */
+            thread_local LockRole current_role = LockRole::OTHER;
+
+            /**
+             * \brief Increments a counter written only under a mutex (no read-modify-write is needed).
+             * \param counter The counter.
+             * \param value The increment.
+             * */
+            void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            /**
+             * \brief Get the nanoseconds of a duration.
+             * \param duration The duration.
+             * \return The nanoseconds.
+             * */
+            std::uint64_t to_nanoseconds(std::chrono::steady_clock::duration duration) noexcept
+            {
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                    .count());
+            }
+
+            /**
+             * \brief Get the name of a role.
+             * \param role The index of the role.
+             * \return The name.
+             * */
+            const char* get_role_name(std::size_t role) noexcept
+            {
+                switch (static_cast<LockRole>(role))
+                {
+                    case LockRole::SENDER:
+                        return "sender";
+
+                    case LockRole::RECEIVER:
+                        return "receiver";
+
+                    default:
+                        return "other";
+                }
+            }
+        }
+
+        ProfiledMutex::ProfiledMutex() noexcept:
+            holder(LockRole::OTHER),
+            acquisitions(0),
+            contentions(0),
+            sleep_ns(0)
+        {
+            for (auto& waiter: blocked_ns)
+                for (std::atomic<std::uint64_t>& time: waiter)
+                    time.store(0, std::memory_order_relaxed);
+        }
+
+        void ProfiledMutex::lock()
+        {
+            if (!mutex.try_lock())
+            {
+                // the holder may change before the mutex is acquired: the first one is blamed for the wait
+                const LockRole blocker = holder.load(std::memory_order_relaxed);
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                mutex.lock();
+
+                const std::uint64_t waited = to_nanoseconds(std::chrono::steady_clock::now() - start);
+
+                add(contentions, 1);
+                add(blocked_ns[static_cast<std::size_t>(current_role)][static_cast<std::size_t>(blocker)], waited);
+                wait_histogram.record(waited);
+            }
+
+            acquired();
+        }
+
+        bool ProfiledMutex::try_lock()
+        {
+            if (!mutex.try_lock())
+                return false;
+
+            acquired();
+            return true;
+        }
+
+        void ProfiledMutex::unlock()
+        {
+            hold_histogram.record(to_nanoseconds(std::chrono::steady_clock::now() - locked_at));
+            mutex.unlock();
+        }
+
+        void ProfiledMutex::record_sleep(std::chrono::steady_clock::duration duration) noexcept
+        {
+            const std::uint64_t slept = to_nanoseconds(duration);
+
+            add(sleep_ns, slept);
+            sleep_histogram.record(slept);
+        }
+
+        LockProfile ProfiledMutex::get_profile() const noexcept
+        {
+            LockProfile profile;
+            profile.acquisitions = acquisitions.load(std::memory_order_relaxed);
+            profile.contentions = contentions.load(std::memory_order_relaxed);
+            profile.sleep_ns = sleep_ns.load(std::memory_order_relaxed);
+
+            for (std::size_t waiter = 0; waiter < LOCK_ROLES_COUNT; ++waiter)
+            {
+                for (std::size_t blocker = 0; blocker < LOCK_ROLES_COUNT; ++blocker)
+                {
+                    profile.blocked_ns[waiter][blocker] = blocked_ns[waiter][blocker].load(std::memory_order_relaxed);
+                    profile.wait_ns += profile.blocked_ns[waiter][blocker];
+                }
+            }
+
+            profile.wait = wait_histogram.get_summary();
+            profile.hold = hold_histogram.get_summary();
+            profile.sleep = sleep_histogram.get_summary();
+            return profile;
+        }
+
+        void ProfiledMutex::set_current_role(LockRole role) noexcept
+        {
+            current_role = role;
+        }
+
+        LockRole ProfiledMutex::get_current_role() noexcept
+        {
+            return current_role;
+        }
+
+        void ProfiledMutex::acquired() noexcept
+        {
+            add(acquisitions, 1);
+            holder.store(current_role, std::memory_order_relaxed);
+            locked_at = std::chrono::steady_clock::now();
+        }
+
+        LockProfiler& LockProfiler::get_default()
+        {
+            static LockProfiler profiler;
+            return profiler;
+        }
+
+        void LockProfiler::add(const std::string& name, std::function<LockProfile()> source)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sources[name] = std::move(source);
+        }
+
+        void LockProfiler::remove(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sources.erase(name);
+        }
+
+        std::vector<std::pair<std::string, LockProfile>> LockProfiler::rank() const
+        {
+            std::vector<std::pair<std::string, LockProfile>> profiles;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                for (const auto& entry: sources)
+                    profiles.emplace_back(entry.first, entry.second());
+            }
+
+            std::stable_sort(profiles.begin(), profiles.end(), [] (const std::pair<std::string, LockProfile>& a,
+                    const std::pair<std::string, LockProfile>& b)
+                {
+                    return a.second.wait_ns > b.second.wait_ns;
+                });
+
+            return profiles;
+        }
+
+        void LockProfiler::report(std::ostream& out) const
+        {
+            char line[256];
+
+            std::snprintf(line, sizeof(line), "%-24s %12s %12s %10s %10s %10s %10s %10s  %s\n", "channel",
+                "wait (us)", "sleep (us)", "contended", "wait p50", "wait p99", "hold p50", "hold p99",
+                "most blocked");
+            out << line;
+
+            for (const std::pair<std::string, LockProfile>& entry: rank())
+            {
+                const LockProfile& profile = entry.second;
+                std::size_t waiter = 0;
+                std::size_t blocker = 0;
+
+                for (std::size_t w = 0; w < LOCK_ROLES_COUNT; ++w)
+                    for (std::size_t b = 0; b < LOCK_ROLES_COUNT; ++b)
+                        if (profile.blocked_ns[w][b] > profile.blocked_ns[waiter][blocker])
+                        {
+                            waiter = w;
+                            blocker = b;
+                        }
+
+                const std::string blocked = profile.blocked_ns[waiter][blocker] == 0
+                    ? "-"
+                    : std::string(get_role_name(waiter)) + "<-" + get_role_name(blocker);
+
+                std::snprintf(line, sizeof(line), "%-24s %12.1f %12.1f %9.2f%% %10llu %10llu %10llu %10llu  %s\n",
+                    entry.first.c_str(), static_cast<double>(profile.wait_ns) / 1000,
+                    static_cast<double>(profile.sleep_ns) / 1000,
+                    profile.acquisitions == 0 ? 0.0 : 100.0 * static_cast<double>(profile.contentions)
+                        / static_cast<double>(profile.acquisitions),
+                    static_cast<unsigned long long>(profile.wait.p50),
+                    static_cast<unsigned long long>(profile.wait.p99),
+                    static_cast<unsigned long long>(profile.hold.p50),
+                    static_cast<unsigned long long>(profile.hold.p99), blocked.c_str());
+                out << line;
+            }
+        }
+    }
+}
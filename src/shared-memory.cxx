@@ -0,0 +1,259 @@
+#include <ese/flow/shared-memory.hxx>
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        namespace
+        {
+            [[noreturn]] void throw_errno(const char* what)
+            {
+                throw std::system_error(errno, std::system_category(), what);
+            }
+
+            int open_anonymous()
+            {
+#if defined(__linux__) && defined(SYS_memfd_create)
+                return static_cast<int>(syscall(SYS_memfd_create, "ese-flow", 0));
+#else
+                // no memfd: a named object, removed as soon as it is open
+                const std::string name = "/ese-flow-" + std::to_string(getpid()) + "-"
+                    + std::to_string(reinterpret_cast<std::uintptr_t>(&name));
+                const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+                if (fd != -1)
+                    shm_unlink(name.c_str());
+
+                return fd;
+#endif
+            }
+        }
+
+        SharedMemory SharedMemory::create(const std::string& name, std::size_t size)
+        {
+            const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+            if (fd == -1)
+                throw_errno("shm_open");
+
+            if (ftruncate(fd, static_cast<off_t>(size)) == -1)
+            {
+                const int error = errno;
+                close(fd);
+                shm_unlink(name.c_str());
+                throw std::system_error(error, std::system_category(), "ftruncate");
+            }
+
+            return map(fd, size);
+        }
+
+        SharedMemory SharedMemory::open(const std::string& name)
+        {
+            const int fd = shm_open(name.c_str(), O_RDWR, 0);
+
+            if (fd == -1)
+                throw_errno("shm_open");
+
+            return from_fd(fd);
+        }
+
+        SharedMemory SharedMemory::create_anonymous(std::size_t size)
+        {
+            const int fd = open_anonymous();
+
+            if (fd == -1)
+                throw_errno("memfd_create");
+
+            if (ftruncate(fd, static_cast<off_t>(size)) == -1)
+            {
+                const int error = errno;
+                close(fd);
+                throw std::system_error(error, std::system_category(), "ftruncate");
+            }
+
+            return map(fd, size);
+        }
+
+        SharedMemory SharedMemory::from_fd(int fd)
+        {
+            struct stat status;
+
+            if (fstat(fd, &status) == -1)
+            {
+                const int error = errno;
+                close(fd);
+                throw std::system_error(error, std::system_category(), "fstat");
+            }
+
+            return map(fd, static_cast<std::size_t>(status.st_size));
+        }
+
+        bool SharedMemory::unlink(const std::string& name) noexcept
+        {
+            return shm_unlink(name.c_str()) == 0;
+        }
+
+        SharedMemory SharedMemory::map(int fd, std::size_t size)
+        {
+            void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+            if (address == MAP_FAILED)
+            {
+                const int error = errno;
+                close(fd);
+                throw std::system_error(error, std::system_category(), "mmap");
+            }
+
+            return SharedMemory(fd, address, size);
+        }
+
+        SharedMemory::SharedMemory(int fd, void* address, std::size_t size) noexcept:
+            fd(fd),
+            address(address),
+            size(size)
+        {
+
+        }
+
+        SharedMemory::SharedMemory(SharedMemory&& other) noexcept:
+            fd(other.fd),
+            address(other.address),
+            size(other.size)
+        {
+            other.fd = -1;
+            other.address = nullptr;
+            other.size = 0;
+        }
+
+        SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept
+        {
+            std::swap(fd, other.fd);
+            std::swap(address, other.address);
+            std::swap(size, other.size);
+            return *this;
+        }
+
+        SharedMemory::~SharedMemory()
+        {
+            if (address != nullptr)
+                munmap(address, size);
+
+            if (fd != -1)
+                close(fd);
+        }
+
+        void* SharedMemory::get_address() const noexcept
+        {
+            return address;
+        }
+
+        std::size_t SharedMemory::get_size() const noexcept
+        {
+            return size;
+        }
+
+        int SharedMemory::get_fd() const noexcept
+        {
+            return fd;
+        }
+
+        SharedEventCount::SharedEventCount() noexcept:
+            epoch(0),
+            waiting(0)
+        {
+
+        }
+
+        SharedEventCount::Key SharedEventCount::prepare_wait() noexcept
+        {
+            waiting.fetch_add(1, std::memory_order_seq_cst);
+            return epoch.load(std::memory_order_seq_cst);
+        }
+
+        void SharedEventCount::cancel_wait() noexcept
+        {
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        bool SharedEventCount::wait_until(Key key, const Deadline& time) noexcept
+        {
+            while (epoch.load(std::memory_order_acquire) == key)
+            {
+                std::chrono::nanoseconds remaining = std::chrono::nanoseconds::max();
+
+                if (time != Deadline::max())
+                {
+                    remaining = time - std::chrono::steady_clock::now();
+
+                    if (remaining <= std::chrono::nanoseconds::zero())
+                    {
+                        waiting.fetch_sub(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                }
+
+#ifdef __linux__
+                // the kernel sleeps only if the epoch still equals the key: no notification can be lost
+                struct timespec timeout;
+                timeout.tv_sec = static_cast<time_t>(std::chrono::duration_cast<std::chrono::seconds>(remaining).count());
+                timeout.tv_nsec = static_cast<long>((remaining % std::chrono::seconds(1)).count());
+
+                syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAIT, key,
+                    time == Deadline::max() ? nullptr : &timeout, nullptr, 0);
+#else
+                std::this_thread::sleep_for(std::min(remaining, std::chrono::nanoseconds(50000)));
+#endif
+            }
+
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool SharedEventCount::advance() noexcept
+        {
+            // pairs with the seq_cst operations of prepare_wait(), as in EventCount
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (waiting.load(std::memory_order_relaxed) == 0)
+                return false;
+
+            epoch.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+
+        void SharedEventCount::notify_one() noexcept
+        {
+            if (!advance())
+                return;
+
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+        }
+
+        void SharedEventCount::notify_all() noexcept
+        {
+            if (!advance())
+                return;
+
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+        }
+    }
+}
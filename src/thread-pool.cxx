@@ -0,0 +1,126 @@
+#include <ese/flow/thread-pool.hxx>
+#include <thread>
+#include <utility>
+
+namespace ese
+{
+    namespace flow
+    {
+        ThreadPool::ThreadPool(ThreadPoolOptions options):
+            options(options),
+            size(0),
+            idle(0),
+            stopping(false)
+        {
+            warm_up(options.min_size);
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+            work_condition.notify_all();
+            exit_condition.wait(lock, [this] ()
+                {
+                    return size == 0;
+                });
+        }
+
+        ThreadPool& ThreadPool::get_default()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        void ThreadPool::warm_up(std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            while (size < count && size < options.max_size)
+                spawn();
+        }
+
+        void ThreadPool::submit(LambdaExecutable&& executable)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(std::move(executable));
+
+            // every pending executable needs an idle worker of its own: spawn one for those that lack it
+            if (pending.size() <= idle)
+                work_condition.notify_one();
+            else if (size < options.max_size)
+                spawn();
+        }
+
+        std::size_t ThreadPool::get_size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return size;
+        }
+
+        std::size_t ThreadPool::get_idle_count() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return idle;
+        }
+
+        std::size_t ThreadPool::get_pending_count() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return pending.size();
+        }
+
+        void ThreadPool::spawn()
+        {
+            std::thread([this] ()
+                {
+                    work();
+                }).detach();
+
+            // the worker is idle from now on, even before it starts waiting
+            ++size;
+            ++idle;
+        }
+
+        void ThreadPool::work()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (true)
+            {
+                if (!pending.empty())
+                {
+                    --idle;
+
+                    {
+                        LambdaExecutable executable = std::move(pending.front());
+                        pending.pop_front();
+                        lock.unlock();
+                        executable();
+                    }
+
+                    lock.lock();
+                    ++idle;
+                    continue;
+                }
+
+                if (stopping)
+                    break;
+
+                const bool notified = work_condition.wait_for(lock, options.idle_timeout, [this] ()
+                    {
+                        return !pending.empty() || stopping;
+                    });
+
+                if (!notified && size > options.min_size)
+                    break;
+            }
+
+            --idle;
+
+            // the destructor may return (and free the pool) as soon as the mutex is released
+            if (--size == 0)
+                exit_condition.notify_all();
+        }
+    }
+}
@@ -1,4 +1,14 @@
 #include <ese/flow/thread.hxx>
+#include <fstream>
+#include <ese/flow/cpu-topology.hxx>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace ese
 {
@@ -6,6 +16,8 @@ namespace ese
     {
         std::atomic_int running_native_threads(0);
 
+        std::atomic<std::uint64_t> started_native_threads(0);
+
         Thread::~Thread()
         {
             join();
@@ -26,6 +38,11 @@ namespace ese
             return status == Status::JOINED;
         }
 
+        bool Thread::is_placed() const noexcept
+        {
+            return placed;
+        }
+
         void Thread::join()
         {
             std::lock_guard<std::mutex> lock(joining_mutex);
@@ -33,6 +50,18 @@ namespace ese
             if (status == Status::JOINED)
                 return;
 
+            if (native_thread == nullptr)
+            {
+                std::unique_lock<std::mutex> finished_lock(finished_mutex);
+                finished_condition.wait(finished_lock, [this] ()
+                    {
+                        return status == Status::FINISHED;
+                    });
+
+                status = Status::JOINED;
+                return;
+            }
+
             native_thread->join();
             status = Status::JOINED;
             delete native_thread;
@@ -42,5 +71,158 @@ namespace ese
         {
             return running_native_threads;
         }
+
+        std::uint64_t Thread::get_started_count() noexcept
+        {
+            return started_native_threads.load(std::memory_order_relaxed);
+        }
+
+        bool Thread::set_current_affinity(int cpu) noexcept
+        {
+#ifdef __linux__
+            if (cpu < 0 || cpu >= CPU_SETSIZE)
+                return false;
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+            (void) cpu;
+            return false;
+#endif
+        }
+
+        bool Thread::set_current_affinity(const std::vector<int>& cpus) noexcept
+        {
+#ifdef __linux__
+            if (cpus.empty())
+                return false;
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            for (int cpu: cpus)
+            {
+                if (cpu < 0 || cpu >= CPU_SETSIZE)
+                    return false;
+
+                CPU_SET(cpu, &set);
+            }
+
+            return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+            (void) cpus;
+            return false;
+#endif
+        }
+
+        bool Thread::set_current_numa_node(int node) noexcept
+        {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+            // MPOL_PREFERRED, from <numaif.h> (not included, so that libnuma is not needed)
+            static const int preferred_policy = 1;
+            unsigned long mask[16] = {};
+            const int mask_bits = static_cast<int>(sizeof(mask) * 8);
+
+            if (node < 0 || node >= mask_bits)
+                return false;
+
+            try
+            {
+                std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string list;
+
+                if (!std::getline(file, list))
+                    return false;
+
+                std::vector<int> cpus = CpuTopology::parse_cpu_list(list);
+
+                if (!set_current_affinity(cpus))
+                    return false;
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+
+            // the kernel reads maxnode - 1 bits
+            return syscall(SYS_set_mempolicy, preferred_policy, mask, mask_bits + 1) == 0;
+#else
+            (void) node;
+            return false;
+#endif
+        }
+
+        bool Thread::set_current_scheduling(SchedulingPolicy policy, int priority) noexcept
+        {
+#ifdef __linux__
+            int native_policy = SCHED_OTHER;
+
+            switch (policy)
+            {
+                case SchedulingPolicy::DEFAULT:
+                    native_policy = SCHED_OTHER;
+                    break;
+                case SchedulingPolicy::FIFO:
+                    native_policy = SCHED_FIFO;
+                    break;
+                case SchedulingPolicy::ROUND_ROBIN:
+                    native_policy = SCHED_RR;
+                    break;
+                case SchedulingPolicy::BATCH:
+                    native_policy = SCHED_BATCH;
+                    break;
+                case SchedulingPolicy::IDLE:
+                    native_policy = SCHED_IDLE;
+                    break;
+            }
+
+            const bool real_time = native_policy == SCHED_FIFO || native_policy == SCHED_RR;
+            sched_param parameters = {};
+            parameters.sched_priority = real_time ? priority : 0;
+
+            if (pthread_setschedparam(pthread_self(), native_policy, &parameters) != 0)
+                return false;
+
+            // on Linux the nice value is per thread
+            return real_time || setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), priority) == 0;
+#else
+            return policy == SchedulingPolicy::DEFAULT && priority == 0;
+#endif
+        }
+
+        bool Thread::set_current_name(const std::string& name) noexcept
+        {
+#ifdef __linux__
+            char truncated[16] = {};
+            name.copy(truncated, sizeof(truncated) - 1);
+            return pthread_setname_np(pthread_self(), truncated) == 0;
+#else
+            (void) name;
+            return false;
+#endif
+        }
+
+        bool Thread::set_current_options(const ThreadOptions& options) noexcept
+        {
+            bool placed = true;
+
+            if (options.numa_node >= 0)
+                placed = set_current_numa_node(options.numa_node) && placed;
+
+            if (!options.cpus.empty())
+                placed = set_current_affinity(options.cpus) && placed;
+
+            if (options.scheduling_policy != SchedulingPolicy::DEFAULT || options.priority != 0)
+                placed = set_current_scheduling(options.scheduling_policy, options.priority) && placed;
+
+            if (!options.name.empty())
+                placed = set_current_name(options.name) && placed;
+
+            return placed;
+        }
     }
 }
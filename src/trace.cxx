@@ -0,0 +1,334 @@
+#include <ese/flow/trace.hxx>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace ese
+{
+    namespace flow
+    {
+        namespace
+        {
+            static_assert((ESE_FLOW_TRACE_BUFFER_SIZE & (ESE_FLOW_TRACE_BUFFER_SIZE - 1)) == 0,
+                "ESE_FLOW_TRACE_BUFFER_SIZE has to be a power of two");
+
+            /**
+             * \brief The events of a thread, written only by that thread.
+             * */
+            typedef struct _TraceBuffer_
+            {
+                /**
+                 * \brief The name of the thread (when it first recorded an event).
+                 * */
+                std::string name;
+
+                /**
+                 * \brief The number of recorded events (the next one is written at head % size).
+                 * */
+                std::atomic<std::uint64_t> head{0};
+
+                /**
+                 * \brief The number of events discarded by clear().
+                 * */
+                std::atomic<std::uint64_t> tail{0};
+
+                /**
+                 * \brief Set when the thread exited (protected by the buffers mutex).
+                 * */
+                bool exited = false;
+
+                /**
+                 * \brief Set when the events were collected after the thread exited (protected by the buffers mutex).
+                 * */
+                bool collected = false;
+
+                /**
+                 * \brief The last recorded events.
+                 * */
+                TraceEvent events[ESE_FLOW_TRACE_BUFFER_SIZE];
+            } TraceBuffer;
+
+            /**
+             * \brief Protects the list of buffers.
+             * */
+            std::mutex buffers_mutex;
+
+            /**
+             * \brief The buffers of all the threads that recorded an event (those of exited threads are kept until
+             *     their events are collected, and then reused).
+             * */
+            std::vector<std::shared_ptr<TraceBuffer>> buffers;
+
+            /**
+             * \brief Holds the buffer of a thread, and marks it as exited with the thread.
+             * */
+            class TraceBufferHolder
+            {
+            public:
+                ~TraceBufferHolder()
+                {
+                    if (!buffer)
+                        return;
+
+                    std::lock_guard<std::mutex> lock(buffers_mutex);
+                    buffer->exited = true;
+                }
+
+                /**
+                 * \brief The buffer (empty until the thread records its first event).
+                 * */
+                std::shared_ptr<TraceBuffer> buffer;
+            };
+
+            /**
+             * \brief Takes a buffer for the current thread: one that an exited thread left with no pending events, or
+             *     a new one.
+             * \return The buffer.
+             * */
+            std::shared_ptr<TraceBuffer> acquire_buffer()
+            {
+                std::string name;
+
+#ifdef __linux__
+                char thread_name[16] = {};
+
+                if (pthread_getname_np(pthread_self(), thread_name, sizeof(thread_name)) == 0)
+                    name = thread_name;
+#endif
+
+                std::lock_guard<std::mutex> lock(buffers_mutex);
+
+                for (const std::shared_ptr<TraceBuffer>& buffer: buffers)
+                {
+                    const bool pending = buffer->head.load(std::memory_order_relaxed)
+                        != buffer->tail.load(std::memory_order_relaxed);
+
+                    if (buffer->exited && (buffer->collected || !pending))
+                    {
+                        buffer->name = name;
+                        buffer->head.store(0, std::memory_order_relaxed);
+                        buffer->tail.store(0, std::memory_order_relaxed);
+                        buffer->exited = false;
+                        buffer->collected = false;
+                        return buffer;
+                    }
+                }
+
+                buffers.push_back(std::make_shared<TraceBuffer>());
+                buffers.back()->name = name;
+                return buffers.back();
+            }
+
+            /**
+             * \brief Get the buffer of the current thread, taking one on the first call.
+             * \return The buffer.
+             * */
+            TraceBuffer& get_buffer()
+            {
+                static thread_local TraceBufferHolder holder;
+
+                if (!holder.buffer)
+                    holder.buffer = acquire_buffer();
+
+                return *holder.buffer;
+            }
+
+            /**
+             * \brief Escapes a string for JSON.
+             * \param text The string.
+             * \return The escaped string (without quotes).
+             * */
+            std::string escape(const std::string& text)
+            {
+                std::string escaped;
+
+                for (char c: text)
+                {
+                    if (c == '"' || c == '\\')
+                        escaped += '\\';
+
+                    if (static_cast<unsigned char>(c) >= 0x20)
+                        escaped += c;
+                }
+
+                return escaped;
+            }
+        }
+
+        void Tracer::set_sampling(std::uint64_t period) noexcept
+        {
+            std::uint64_t rounded = period == 0 ? 0 : 1;
+
+            while (rounded != 0 && rounded < period)
+                rounded <<= 1;
+
+            trace_period().store(rounded, std::memory_order_relaxed);
+        }
+
+        void Tracer::record(const TraceEvent& event) noexcept
+        {
+            TraceBuffer& buffer = get_buffer();
+            const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+            buffer.events[head & (ESE_FLOW_TRACE_BUFFER_SIZE - 1)] = event;
+            buffer.head.store(head + 1, std::memory_order_release);
+        }
+
+        std::vector<TraceEvent> Tracer::collect()
+        {
+            std::vector<TraceEvent> events;
+            std::lock_guard<std::mutex> lock(buffers_mutex);
+
+            for (std::size_t thread = 0; thread < buffers.size(); ++thread)
+            {
+                const TraceBuffer& buffer = *buffers[thread];
+                const std::uint64_t head = buffer.head.load(std::memory_order_acquire);
+                const std::size_t first = events.size();
+                std::uint64_t begin = buffer.tail.load(std::memory_order_relaxed);
+
+                if (head - begin > ESE_FLOW_TRACE_BUFFER_SIZE)
+                    begin = head - ESE_FLOW_TRACE_BUFFER_SIZE;
+
+                for (std::uint64_t i = begin; i < head; ++i)
+                {
+                    events.push_back(buffer.events[i & (ESE_FLOW_TRACE_BUFFER_SIZE - 1)]);
+                    events.back().thread = thread;
+                }
+
+                // the events overwritten while they were copied are dropped
+                const std::uint64_t written = buffer.head.load(std::memory_order_acquire);
+
+                if (written - begin > ESE_FLOW_TRACE_BUFFER_SIZE)
+                {
+                    const std::uint64_t lost = std::min<std::uint64_t>(written - begin - ESE_FLOW_TRACE_BUFFER_SIZE,
+                        head - begin);
+                    events.erase(events.begin() + static_cast<std::ptrdiff_t>(first),
+                        events.begin() + static_cast<std::ptrdiff_t>(first + lost));
+                }
+
+                // the buffer of an exited thread can be reused, now that its events were read
+                if (buffer.exited)
+                    buffers[thread]->collected = true;
+            }
+
+            std::stable_sort(events.begin(), events.end(), [] (const TraceEvent& a, const TraceEvent& b)
+                {
+                    return a.time < b.time;
+                });
+
+            return events;
+        }
+
+        void Tracer::clear() noexcept
+        {
+            std::lock_guard<std::mutex> lock(buffers_mutex);
+
+            for (const std::shared_ptr<TraceBuffer>& buffer: buffers)
+                buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+
+        double Tracer::get_ticks_per_nanosecond()
+        {
+            static const double ticks = [] ()
+                {
+                    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    const std::uint64_t start_ticks = now();
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+                    const std::uint64_t end_ticks = now();
+                    const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+
+                    return static_cast<double>(end_ticks - start_ticks) / static_cast<double>(elapsed.count());
+                }();
+
+            return ticks;
+        }
+
+        void Tracer::dump(std::ostream& out)
+        {
+            const std::vector<TraceEvent> events = collect();
+            const double ticks_per_microsecond = get_ticks_per_nanosecond() * 1000;
+            const std::uint64_t origin = events.empty() ? 0 : events.front().time;
+            const char* separator = "\n";
+            char line[512];
+
+            auto timestamp = [origin, ticks_per_microsecond] (std::uint64_t time)
+                {
+                    return static_cast<double>(time - origin) / ticks_per_microsecond;
+                };
+
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            {
+                std::lock_guard<std::mutex> lock(buffers_mutex);
+
+                for (std::size_t thread = 0; thread < buffers.size(); ++thread)
+                {
+                    const std::string name = buffers[thread]->name.empty()
+                        ? "thread-" + std::to_string(thread)
+                        : buffers[thread]->name;
+
+                    out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+                        << ",\"args\":{\"name\":\"" << escape(name) << "\"}}";
+                    separator = ",\n";
+                }
+            }
+
+            // an element is written to the queue track only if both ends of its wait were recorded
+            std::map<std::tuple<const void*, std::uint64_t>, const TraceEvent*> enqueued;
+
+            for (const TraceEvent& event: events)
+                if (event.type == TraceEventType::ENQUEUE)
+                    enqueued[std::make_tuple(event.object, event.sequence)] = &event;
+
+            for (const TraceEvent& event: events)
+            {
+                if (event.type == TraceEventType::SPAN)
+                {
+                    std::snprintf(line, sizeof(line), "{\"name\":\"%s\",\"cat\":\"ese-flow\",\"ph\":\"X\",\"pid\":1,"
+                        "\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}", escape(event.name).c_str(), event.thread,
+                        timestamp(event.time), static_cast<double>(event.duration) / ticks_per_microsecond);
+                }
+                else if (event.type == TraceEventType::DEQUEUE)
+                {
+                    const auto match = enqueued.find(std::make_tuple(event.object, event.sequence));
+
+                    if (match == enqueued.end())
+                        continue;
+
+                    const TraceEvent& begin = *match->second;
+                    const char* format = "{\"name\":\"queue\",\"cat\":\"ese-flow\",\"ph\":\"%s\",\"pid\":1,"
+                        "\"tid\":%zu,\"id\":\"%p.%llu\",\"ts\":%.3f,\"args\":{\"channel\":\"%p\",\"sequence\":%llu}}";
+
+                    std::snprintf(line, sizeof(line), format, "b", begin.thread, begin.object,
+                        static_cast<unsigned long long>(begin.sequence), timestamp(begin.time), begin.object,
+                        static_cast<unsigned long long>(begin.sequence));
+                    out << separator << line;
+                    separator = ",\n";
+                    std::snprintf(line, sizeof(line), format, "e", event.thread, event.object,
+                        static_cast<unsigned long long>(event.sequence), timestamp(event.time), event.object,
+                        static_cast<unsigned long long>(event.sequence));
+                }
+                else
+                {
+                    continue;
+                }
+
+                out << separator << line;
+                separator = ",\n";
+            }
+
+            out << "\n]}\n";
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <ese/flow/async-channel.hxx>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/lock-free-channel.hxx>
+#include <ese/flow/thread-pool-executor.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class AsyncChannelTest: public testing::Test
+{
+    public:
+        AsyncChannelTest()
+        {
+
+        }
+};
+
+template<typename TAsyncChannel>
+AsyncTask receive_all(Executor<LambdaExecutable>& executor, TAsyncChannel& channel, int count,
+    std::atomic_int& sum, std::atomic_int& done)
+{
+    co_await resume_on(executor);
+
+    for (int i = 0; i < count; ++i)
+        sum += co_await channel.get_receiver().async_receive();
+
+    ++done;
+}
+
+template<typename TAsyncChannel>
+AsyncTask send_all(Executor<LambdaExecutable>& executor, TAsyncChannel& channel, int first, int count,
+    std::atomic_int& done)
+{
+    co_await resume_on(executor);
+
+    for (int i = first; i < first + count; ++i)
+        co_await channel.get_sender().async_send(i);
+
+    ++done;
+}
+
+/*
+ * Checks that coroutines suspended on an empty channel are resumed by the elements sent by a thread.
+ */
+TEST_F(AsyncChannelTest, asyncReceive)
+{
+    ThreadPoolExecutor<> pool(2);
+    Channel<int> channel;
+    AsyncChannel<Channel<int>> async_channel(channel, pool);
+    std::atomic_int sum(0);
+    std::atomic_int done(0);
+
+    for (int i = 0; i < 4; ++i)
+        receive_all(pool, async_channel, 25, sum, done);
+
+    std::this_thread::sleep_for(50ms);
+    ASSERT_EQ(done, 0);
+
+    for (int i = 1; i <= 100; ++i)
+        channel.get_sender().send(i);
+
+    while (done != 4)
+        std::this_thread::sleep_for(1ms);
+
+    pool.drain();
+
+    ASSERT_EQ(sum, 5050);
+}
+
+/*
+ * Checks that coroutines suspended on a full bounded channel are resumed when a thread receives elements.
+ */
+TEST_F(AsyncChannelTest, asyncSend)
+{
+    ThreadPoolExecutor<> pool(2);
+    Channel<int> channel(2);
+    AsyncChannel<Channel<int>> async_channel(channel, pool);
+    std::atomic_int done(0);
+    int sum = 0;
+
+    send_all(pool, async_channel, 1, 50, done);
+    send_all(pool, async_channel, 51, 50, done);
+
+    std::this_thread::sleep_for(50ms);
+    ASSERT_EQ(done, 0);
+
+    for (int i = 0; i < 100; ++i)
+        sum += channel.get_receiver().receive();
+
+    while (done != 2)
+        std::this_thread::sleep_for(1ms);
+
+    pool.drain();
+
+    ASSERT_EQ(sum, 5050);
+}
+
+/*
+ * Checks that thousands of flows, both sending and receiving, share a handful of threads.
+ */
+TEST_F(AsyncChannelTest, manyFlows)
+{
+    ThreadPoolExecutor<> pool(4);
+    MpmcChannel<int> channel(64);
+    AsyncChannel<MpmcChannel<int>> async_channel(channel, pool);
+    std::atomic_int sum(0);
+    std::atomic_int received(0);
+    std::atomic_int sent(0);
+
+    for (int i = 0; i < 10000; ++i)
+        receive_all(pool, async_channel, 1, sum, received);
+
+    for (int i = 0; i < 10000; ++i)
+        send_all(pool, async_channel, i, 1, sent);
+
+    auto start = std::chrono::steady_clock::now();
+
+    while ((received != 10000 || sent != 10000) && std::chrono::steady_clock::now() - start < 30s)
+        std::this_thread::sleep_for(1ms);
+
+    pool.drain();
+
+    ASSERT_EQ(sent, 10000);
+    ASSERT_EQ(received, 10000);
+    ASSERT_EQ(sum, 49995000);
+}
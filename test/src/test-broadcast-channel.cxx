@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <ese/flow/broadcast-channel.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+/*
+ * Every subscriber receives every element sent after its subscription.
+ */
+TEST(BroadcastChannelTest, allSubscribersReceive)
+{
+    BroadcastChannel<int> channel(8);
+    BroadcastChannel<int>::ReceiverType& first = channel.subscribe();
+
+    channel.get_sender().send(1);
+
+    BroadcastChannel<int>::ReceiverType& second = channel.subscribe();
+    ASSERT_EQ(channel.get_subscribers_count(), 2);
+    ASSERT_EQ(channel.get_capacity(), 8);
+
+    channel.get_sender().send(2);
+    channel.get_sender() << 3;
+
+    ASSERT_EQ(first.receive(), 1);
+    ASSERT_EQ(first.receive(), 2);
+    ASSERT_EQ(first.receive(), 3);
+    ASSERT_TRUE(first.is_empty());
+
+    ASSERT_EQ(second.receive(), 2);
+    ASSERT_EQ(second.receive(), 3);
+
+    int element;
+    ASSERT_FALSE(second.try_receive(&element));
+    ASSERT_FALSE(second.try_receive_for(&element, 5ms));
+
+    channel.unsubscribe(second);
+    ASSERT_EQ(channel.get_subscribers_count(), 1);
+}
+
+/*
+ * The visiting methods give a reference to the element in the ring: the same object to all the subscribers.
+ */
+TEST(BroadcastChannelTest, zeroCopyRead)
+{
+    BroadcastChannel<std::vector<int>> channel(4);
+    BroadcastChannel<std::vector<int>>::ReceiverType& first = channel.subscribe();
+    BroadcastChannel<std::vector<int>>::ReceiverType& second = channel.subscribe();
+
+    channel.get_sender().send(std::vector<int>{1, 2, 3});
+
+    const std::vector<int>* first_address = nullptr;
+    const std::vector<int>* second_address = nullptr;
+
+    ASSERT_TRUE(first.try_read([&first_address] (const std::vector<int>& element)
+        {
+            first_address = &element;
+        }));
+
+    ASSERT_TRUE(second.try_read_for([&second_address] (const std::vector<int>& element)
+        {
+            second_address = &element;
+        }, 5ms));
+
+    ASSERT_NE(first_address, nullptr);
+    ASSERT_EQ(first_address, second_address);
+    ASSERT_EQ(first_address->size(), 3);
+    ASSERT_FALSE(first.try_read([] (const std::vector<int>&) {}));
+}
+
+/*
+ * With BLOCK, the sender waits for the slowest subscriber.
+ */
+TEST(BroadcastChannelTest, blockWaitsForSlowest)
+{
+    BroadcastChannel<int> channel(2, SlowSubscriberPolicy::BLOCK);
+    BroadcastChannel<int>::ReceiverType& fast = channel.subscribe();
+    BroadcastChannel<int>::ReceiverType& slow = channel.subscribe();
+    Sender<int>& sender = channel.get_sender();
+
+    sender.send(1);
+    sender.send(2);
+
+    ASSERT_EQ(fast.receive(), 1);
+    ASSERT_EQ(fast.receive(), 2);
+    ASSERT_FALSE(sender.try_send(3));
+    ASSERT_FALSE(sender.try_send_for(3, 5ms));
+
+    std::thread consumer([&slow] ()
+        {
+            std::this_thread::sleep_for(10ms);
+            slow.receive();
+        });
+
+    sender.send(3);
+    consumer.join();
+
+    ASSERT_EQ(slow.receive(), 2);
+    ASSERT_EQ(slow.receive(), 3);
+    ASSERT_EQ(fast.receive(), 3);
+    ASSERT_EQ(slow.get_skipped_count(), 0);
+}
+
+/*
+ * With SKIP, the slow subscriber jumps to the oldest element still in the ring.
+ */
+TEST(BroadcastChannelTest, skipOverwrites)
+{
+    BroadcastChannel<int> channel(4, SlowSubscriberPolicy::SKIP);
+    BroadcastChannel<int>::ReceiverType& slow = channel.subscribe();
+    Sender<int>& sender = channel.get_sender();
+
+    for (int i = 0; i < 10; ++i)
+        ASSERT_TRUE(sender.try_send(i));
+
+    ASSERT_EQ(slow.get_skipped_count(), 6);
+    ASSERT_FALSE(slow.is_lagged());
+
+    for (int i = 6; i < 10; ++i)
+        ASSERT_EQ(slow.receive(), i);
+
+    ASSERT_TRUE(slow.is_empty());
+}
+
+/*
+ * With LAG_DETECT, the slow subscriber cannot read until it resyncs.
+ */
+TEST(BroadcastChannelTest, lagDetect)
+{
+    BroadcastChannel<int> channel(4, SlowSubscriberPolicy::LAG_DETECT);
+    BroadcastChannel<int>::ReceiverType& slow = channel.subscribe();
+    int numbers[6] = {0, 1, 2, 3, 4, 5};
+
+    channel.get_sender().send_batch(numbers, numbers + 6);
+
+    int element;
+    ASSERT_TRUE(slow.is_lagged());
+    ASSERT_TRUE(slow.is_empty());
+    ASSERT_FALSE(slow.try_receive(&element));
+    ASSERT_EQ(slow.get_skipped_count(), 2);
+
+    slow.resync();
+
+    for (int i = 2; i < 6; ++i)
+        ASSERT_EQ(slow.receive(), i);
+}
+
+/*
+ * Many subscribers, each on its own thread, receive the same sequence.
+ */
+TEST(BroadcastChannelTest, fanOut)
+{
+    static const int subscribers_count = 4;
+    static const int elements_count = 10000;
+
+    BroadcastChannel<int, SpinThenParkWaitPolicy<>> channel(64);
+    std::vector<BroadcastChannel<int, SpinThenParkWaitPolicy<>>::ReceiverType*> subscribers;
+    std::vector<std::thread> consumers;
+    std::unique_ptr<bool[]> in_order(new bool[subscribers_count]);
+
+    for (int i = 0; i < subscribers_count; ++i)
+        subscribers.push_back(&channel.subscribe());
+
+    for (int i = 0; i < subscribers_count; ++i)
+        consumers.emplace_back([&subscribers, &in_order, i] ()
+            {
+                bool ok = true;
+
+                for (int j = 0; j < elements_count; ++j)
+                    subscribers[i]->try_read([&ok, j] (const int& element)
+                        {
+                            ok = ok && element == j;
+                        }, true);
+
+                in_order[i] = ok;
+            });
+
+    for (int i = 0; i < elements_count; ++i)
+        channel.get_sender().send(i);
+
+    for (std::thread& consumer: consumers)
+        consumer.join();
+
+    for (int i = 0; i < subscribers_count; ++i)
+        ASSERT_TRUE(in_order[i]);
+}
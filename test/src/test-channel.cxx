@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <chrono>
+#include <iterator>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 #include <ese/flow/channel.hxx>
 
 #define THE_NUMBER  (42)
@@ -206,6 +209,240 @@ TEST_F(ChannelTest, priorityQueueAsTemplateArgument)
     ASSERT_EQ(channel.get_receiver().receive(), 1);
 }
 
+/*
+ * Checks that a receiver that spins before parking receives elements sent both while it spins and while it sleeps.
+ */
+TEST_F(ChannelTest, spinThenParkWaitPolicy)
+{
+    Channel<int, std::queue<int>, SpinThenParkWaitPolicy<>> channel;
+
+    std::thread thread([&sender = channel.get_sender()] ()
+        {
+            sender << 1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            sender << 2;
+        });
+
+    int n = 0;
+    bool received0 = channel.get_receiver().try_receive(&n, true);
+    int n0 = n;
+    bool received1 = channel.get_receiver().try_receive(&n, true);
+    int n1 = n;
+    thread.join();
+
+    ASSERT_TRUE(received0);
+    ASSERT_TRUE(received1);
+    ASSERT_EQ(n0, 1);
+    ASSERT_EQ(n1, 2);
+}
+
+/*
+ * Checks that a busy-polling receiver receives an element and that it respects the time point when there is no data.
+ */
+TEST_F(ChannelTest, busyPollWaitPolicy)
+{
+    Channel<int, std::queue<int>, BusyPollWaitPolicy> channel;
+
+    std::thread thread([&sender = channel.get_sender()] ()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            sender << THE_NUMBER;
+        });
+
+    int n = 0;
+    bool received = channel.get_receiver().try_receive(&n, true);
+    thread.join();
+
+    auto start = std::chrono::steady_clock::now();
+    bool timed_out = !channel.get_receiver().try_receive_for(&n, std::chrono::milliseconds(50));
+    auto end = std::chrono::steady_clock::now();
+
+    ASSERT_TRUE(received);
+    ASSERT_EQ(n, THE_NUMBER);
+    ASSERT_TRUE(timed_out);
+    ASSERT_GT(end - start, std::chrono::milliseconds(45));
+}
+
+/*
+ * Checks that ::wake_up() stops a busy-polling receiver.
+ */
+TEST_F(ChannelTest, busyPollWakeUp)
+{
+    Channel<int, std::queue<int>, BusyPollWaitPolicy> channel;
+
+    std::thread thread([&channel] ()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            channel.wake_up();
+        });
+
+    bool received = channel.get_receiver().try_receive(nullptr, true);
+    thread.join();
+
+    ASSERT_FALSE(received);
+}
+
+/*
+ * Checks that elements sent in batch are received in batch, in the correct order.
+ */
+TEST_F(ChannelTest, batchSendAndReceive)
+{
+    std::vector<int> sent(200);
+
+    for (int i = 0; i < 200; ++i)
+        sent[i] = i;
+
+    sender.send_batch(sent.begin(), sent.end());
+
+    std::vector<int> received;
+    std::size_t count0 = receiver.receive_batch(std::back_inserter(received), 150);
+    std::size_t count1 = receiver.receive_batch(std::back_inserter(received), 150);
+    std::size_t count2 = receiver.receive_batch(std::back_inserter(received), 150);
+
+    ASSERT_EQ(count0, 150);
+    ASSERT_EQ(count1, 50);
+    ASSERT_EQ(count2, 0);
+    ASSERT_EQ(received, sent);
+}
+
+/*
+ * Checks that a blocking batch receive waits for the first element and then takes all the available ones.
+ */
+TEST_F(ChannelTest, batchReceiveBlocksUntilFirstElement)
+{
+    std::thread thread([&sender = channel.get_sender()] ()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            int numbers[] = {1, 2, 3};
+            sender.send_batch(numbers, numbers + 3);
+        });
+
+    int numbers[10];
+    std::size_t count = receiver.receive_batch(numbers, 10, true);
+    thread.join();
+
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(numbers[0], 1);
+    ASSERT_EQ(numbers[2], 3);
+}
+
+/*
+ * Checks that a sender blocks on a full bounded channel until an element is received, and that try_send() gives up.
+ */
+TEST_F(ChannelTest, boundedBlock)
+{
+    Channel<int> channel(2);
+    Sender<int>& sender = channel.get_sender();
+    Receiver<int>& receiver = channel.get_receiver();
+
+    sender << 1 << 2;
+    ASSERT_FALSE(sender.try_send(3));
+    ASSERT_FALSE(sender.try_send_for(3, std::chrono::milliseconds(20)));
+
+    std::thread thread([&receiver] ()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            receiver.receive();
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    sender << 3;
+    auto end = std::chrono::steady_clock::now();
+    thread.join();
+
+    ASSERT_GT(end - start, std::chrono::milliseconds(40));
+    ASSERT_EQ(receiver.receive(), 2);
+    ASSERT_EQ(receiver.receive(), 3);
+    ASSERT_EQ(channel.get_blocked_count(), 3);
+    ASSERT_EQ(channel.get_dropped_count(), 0);
+}
+
+/*
+ * Checks that a batch bigger than the capacity of a bounded channel passes through it.
+ */
+TEST_F(ChannelTest, boundedBatch)
+{
+    Channel<int> channel(4);
+    std::vector<int> sent(100);
+
+    for (int i = 0; i < 100; ++i)
+        sent[i] = i;
+
+    std::thread thread([&channel, &sent] ()
+        {
+            channel.get_sender().send_batch(sent.begin(), sent.end());
+        });
+
+    std::vector<int> received;
+
+    while (received.size() < sent.size())
+        channel.get_receiver().receive_batch(std::back_inserter(received), 100, true);
+
+    thread.join();
+    ASSERT_EQ(received, sent);
+}
+
+/*
+ * Checks that the newest elements are dropped by a full DROP_NEWEST channel.
+ */
+TEST_F(ChannelTest, boundedDropNewest)
+{
+    Channel<int> channel(2, OverflowPolicy::DROP_NEWEST);
+
+    for (int i = 0; i < 5; ++i)
+        channel.get_sender() << i;
+
+    ASSERT_FALSE(channel.get_sender().try_send(5, true));
+    ASSERT_EQ(channel.get_receiver().receive(), 0);
+    ASSERT_EQ(channel.get_receiver().receive(), 1);
+    ASSERT_FALSE(channel.get_receiver().try_receive(nullptr));
+    ASSERT_EQ(channel.get_dropped_count(), 4);
+    ASSERT_EQ(channel.get_blocked_count(), 0);
+}
+
+/*
+ * Checks that the oldest elements are dropped by a full DROP_OLDEST channel.
+ */
+TEST_F(ChannelTest, boundedDropOldest)
+{
+    Channel<int> channel(2, OverflowPolicy::DROP_OLDEST);
+
+    for (int i = 0; i < 5; ++i)
+        channel.get_sender() << i;
+
+    ASSERT_TRUE(channel.get_sender().try_send(5));
+    ASSERT_EQ(channel.get_receiver().receive(), 4);
+    ASSERT_EQ(channel.get_receiver().receive(), 5);
+    ASSERT_EQ(channel.get_dropped_count(), 4);
+}
+
+/*
+ * Checks that a full SAMPLE channel keeps one of every "sample period" overflowing elements.
+ */
+TEST_F(ChannelTest, boundedSample)
+{
+    Channel<int> channel(1, OverflowPolicy::SAMPLE, 4);
+
+    for (int i = 0; i < 10; ++i)
+        channel.get_sender() << i;
+
+    ASSERT_EQ(channel.get_receiver().receive(), 8);
+    ASSERT_FALSE(channel.get_receiver().try_receive(nullptr));
+    ASSERT_EQ(channel.get_dropped_count(), 9);
+}
+
+/*
+ * Checks that the policies that drop the oldest element are rejected by channels that reorder their elements.
+ */
+TEST_F(ChannelTest, dropOldestRequiresFifoQueue)
+{
+    typedef Channel<int, std::priority_queue<int>> PriorityChannel;
+
+    ASSERT_THROW(PriorityChannel(2, OverflowPolicy::DROP_OLDEST), std::invalid_argument);
+    ASSERT_THROW(PriorityChannel(2, OverflowPolicy::SAMPLE), std::invalid_argument);
+    ASSERT_NO_THROW(PriorityChannel(2, OverflowPolicy::DROP_NEWEST));
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
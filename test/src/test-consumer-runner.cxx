@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/consumer-runner.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class SummingConsumerFactory: public ConsumerFactory<int>
+{
+public:
+    SummingConsumerFactory(Receiver<int>* receiver):
+        ConsumerFactory(receiver),
+        sum(0),
+        batches(0)
+    {
+
+    }
+
+    void consume_0(int&& number) override
+    {
+        sum += number;
+    }
+
+    void consume_batch_0(int* numbers, std::size_t count) override
+    {
+        ++batches;
+        ConsumerFactory<int>::consume_batch_0(numbers, count);
+    }
+
+    std::atomic_int sum;
+    std::atomic_int batches;
+};
+
+class ConsumerRunnerTest: public testing::Test
+{
+public:
+    ConsumerRunnerTest():
+        factory(&channel.get_receiver())
+    {
+
+    }
+
+protected:
+    Channel<int> channel;
+    SummingConsumerFactory factory;
+};
+
+/*
+ * Checks that the runner drives non-blocking consumers until every element is consumed, then stops them.
+ */
+TEST_F(ConsumerRunnerTest, nonBlockingConsumers)
+{
+    ConsumerRunner<int> runner;
+
+    runner.add(factory.create_one());
+    runner.add(factory.create_one());
+
+    for (int i = 1; i <= 1000; ++i)
+        channel.get_sender().send(i);
+
+    while (factory.sum != 500500)
+        std::this_thread::sleep_for(1ms);
+
+    runner.stop();
+
+    ASSERT_EQ(runner.get_consumers_count(), 2);
+    ASSERT_EQ(runner.get_consumed_count(), 1000);
+}
+
+/*
+ * Checks that stop() wakes up the parked consumers at once.
+ */
+TEST_F(ConsumerRunnerTest, stopParkedConsumers)
+{
+    ConsumerRunner<int> runner(channel);
+
+    for (int i = 0; i < 4; ++i)
+        runner.add(factory.create_one());
+
+    channel.get_sender().send(42);
+    std::this_thread::sleep_for(50ms);
+
+    auto start = std::chrono::steady_clock::now();
+    runner.stop();
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+    ASSERT_EQ(factory.sum, 42);
+    ASSERT_EQ(runner.get_consumed_count(), 1);
+}
+
+/*
+ * Checks that a send wakes up the consumers parked by a runner listening to the channel.
+ */
+TEST_F(ConsumerRunnerTest, sendWakesParkedConsumers)
+{
+    ConsumerRunnerOptions options;
+    options.spins = 0;
+    options.yields = 0;
+    ConsumerRunner<int> runner(channel, options);
+
+    runner.add(factory.create_one());
+    std::this_thread::sleep_for(50ms);
+
+    auto start = std::chrono::steady_clock::now();
+    channel.get_sender().send(42);
+
+    while (factory.sum != 42)
+        std::this_thread::sleep_for(1ms);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+/*
+ * Checks that a stop required while the consumers are parking is not lost.
+ */
+TEST_F(ConsumerRunnerTest, stopWhileParking)
+{
+    ConsumerRunnerOptions options;
+    options.spins = 0;
+    options.yields = 0;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        ConsumerRunner<int> runner(channel, options);
+
+        runner.add(factory.create_one());
+        runner.add(factory.create_one());
+        runner.stop();
+    }
+
+    ASSERT_EQ(Thread::get_native_running_count(), 0);
+}
+
+/*
+ * Checks that a runner can not listen to a channel that already has a listener.
+ */
+TEST_F(ConsumerRunnerTest, channelAlreadyListened)
+{
+    ConsumerRunner<int> runner(channel);
+
+    ASSERT_THROW(ConsumerRunner<int> other(channel), std::logic_error);
+}
+
+/*
+ * Checks that an adaptive consumer grows its batches while the queue is deep.
+ */
+TEST_F(ConsumerRunnerTest, adaptiveBatching)
+{
+    int numbers[1000];
+
+    for (int i = 0; i < 1000; ++i)
+        numbers[i] = i + 1;
+
+    channel.get_sender().send_batch(numbers, numbers + 1000);
+
+    Consumer<int> consumer = factory.create_adaptive(64);
+    int consumed[8];
+
+    for (int i = 0; i < 8; ++i)
+        consumed[i] = consumer.consume();
+
+    ASSERT_EQ(consumed[0], 1);
+    ASSERT_EQ(consumed[1], 2);
+    ASSERT_EQ(consumed[2], 4);
+    ASSERT_EQ(consumed[6], 64);
+    ASSERT_EQ(consumed[7], 64);
+
+    ConsumerRunner<int> runner(channel);
+
+    runner.add(std::move(consumer));
+
+    while (factory.sum != 500500)
+        std::this_thread::sleep_for(1ms);
+
+    runner.stop();
+
+    ASSERT_EQ(runner.get_consumed_count(), 1000);
+    ASSERT_LT(factory.batches, 100);
+}
+
+/*
+ * Checks that the destructor stops the consumers.
+ */
+TEST_F(ConsumerRunnerTest, destructorStops)
+{
+    {
+        ConsumerRunner<int> runner(channel);
+
+        runner.add(factory.create_adaptive(16));
+        channel.get_sender().send(7);
+
+        while (factory.sum != 7)
+            std::this_thread::sleep_for(1ms);
+    }
+
+    ASSERT_EQ(Thread::get_native_running_count(), 0);
+}
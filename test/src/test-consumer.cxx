@@ -224,6 +224,27 @@ TEST_F(ConsumerTest, nonBlockingCreateOneFor)
     ASSERT_EQ(consumed_sum[5], 3);
 }
 
+/*
+ * Check consuming some ints with the create_batch() behaviour.
+ */
+TEST_F(ConsumerTest, createBatch)
+{
+    for (int i = 1; i <= 5; ++i)
+        sender << i;
+
+    Consumer<int> consumer = consumer_factory.create_batch(3);
+
+    int consumed0 = consumer();
+    int consumed1 = consumer();
+    int consumed2 = consumer();
+
+    ASSERT_EQ(consumed0, 3);
+    ASSERT_EQ(consumed1, 2);
+    ASSERT_EQ(consumed2, 0);
+    ASSERT_EQ(consumer.get_consumed_count(), 5);
+    ASSERT_EQ(consumer_factory.get_sum(), 15);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include <ese/flow/cpu-topology.hxx>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace ese::flow;
+
+class CpuTopologyTest: public testing::Test
+{
+public:
+    CpuTopologyTest()
+    {
+
+    }
+};
+
+/*
+ * Checks the parsing of Linux CPU lists.
+ */
+TEST_F(CpuTopologyTest, parseCpuList)
+{
+    ASSERT_EQ(CpuTopology::parse_cpu_list("0-3,8,10-11\n"), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    ASSERT_EQ(CpuTopology::parse_cpu_list("5"), std::vector<int>({5}));
+    ASSERT_TRUE(CpuTopology::parse_cpu_list("\n").empty());
+    ASSERT_THROW(CpuTopology::parse_cpu_list("3-1"), std::invalid_argument);
+    ASSERT_THROW(CpuTopology::parse_cpu_list("a"), std::invalid_argument);
+}
+
+/*
+ * Checks that the detected topology has at least a CPU, in a core.
+ */
+TEST_F(CpuTopologyTest, detect)
+{
+    CpuTopology topology = CpuTopology::detect();
+
+    ASSERT_FALSE(topology.get_cpus().empty());
+    ASSERT_GE(topology.get_cores_count(), 1);
+    ASSERT_LE(topology.get_cores_count(), topology.get_cpus().size());
+}
+
+/*
+ * Checks that the detected CPUs are the ones the process may run on.
+ */
+TEST_F(CpuTopologyTest, detectAllowed)
+{
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+
+    const CpuTopology topology = CpuTopology::detect();
+    const std::vector<CpuTopology::Cpu>& cpus = topology.get_cpus();
+    ASSERT_EQ(static_cast<int>(cpus.size()), CPU_COUNT(&allowed));
+
+    for (const CpuTopology::Cpu& cpu: cpus)
+        ASSERT_TRUE(CPU_ISSET(cpu.id, &allowed));
+#endif
+}
+
+/*
+ * Checks that threads get a core each (filling a node first), before sharing cores.
+ */
+TEST_F(CpuTopologyTest, layout)
+{
+    // 2 nodes, 2 cores per node, 2 hardware threads per core (CPUs n and n + 4 are siblings)
+    CpuTopology topology({
+        {0, 0, 0, 0}, {1, 1, 0, 0}, {2, 0, 1, 1}, {3, 1, 1, 1},
+        {4, 0, 0, 0}, {5, 1, 0, 0}, {6, 0, 1, 1}, {7, 1, 1, 1}
+    });
+
+    ASSERT_EQ(topology.get_cores_count(), 4);
+    ASSERT_EQ(topology.get_nodes_count(), 2);
+    ASSERT_EQ(topology.get_node_cpus(1), std::vector<int>({2, 6, 3, 7}));
+
+    std::vector<ThreadOptions> options = topology.layout(10, "stage-");
+    std::vector<int> cpus;
+
+    for (const ThreadOptions& thread: options)
+    {
+        ASSERT_EQ(thread.cpus.size(), 1);
+        cpus.push_back(thread.cpus[0]);
+    }
+
+    ASSERT_EQ(cpus, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 0, 1}));
+    ASSERT_EQ(options[0].numa_node, 0);
+    ASSERT_EQ(options[2].numa_node, 1);
+    ASSERT_EQ(options[9].name, "stage-9");
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <ese/flow/deadline-channel.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+typedef struct _Task_
+{
+    Deadline deadline;
+    std::string name;
+
+    Deadline get_deadline() const noexcept
+    {
+        return deadline;
+    }
+} Task;
+
+class DeadlineChannelTest: public testing::Test
+{
+    protected:
+        DeadlineChannel<Task> channel;
+        Receiver<Task>& receiver;
+        Sender<Task>& sender;
+        const Deadline now;
+
+    public:
+        DeadlineChannelTest():
+            receiver(channel.get_receiver()),
+            sender(channel.get_sender()),
+            now(std::chrono::steady_clock::now())
+        {
+
+        }
+
+        std::vector<std::string> receive_all()
+        {
+            std::vector<std::string> names;
+            Task task;
+
+            while (receiver.try_receive(&task))
+                names.push_back(task.name);
+
+            return names;
+        }
+};
+
+/*
+ * Checks that the earliest deadline is received first, even within the same bucket.
+ */
+TEST_F(DeadlineChannelTest, earliestFirst)
+{
+    sender.send({now + 30ms, "c"});
+    sender.send({now + 10ms, "a"});
+    sender.send({now + 20ms, "b"});
+    sender.send({now + 10ms + 300us, "a2"});
+    sender.send({now + 10ms + 100us, "a1"});
+
+    ASSERT_EQ(receive_all(), std::vector<std::string>({"a", "a1", "a2", "b", "c"}));
+}
+
+/*
+ * Checks the deadlines beyond the horizon of the buckets, and the late ones.
+ */
+TEST_F(DeadlineChannelTest, overflowAndLate)
+{
+    sender.send({now + 10ms, "soon"});
+    sender.send({now + 1h, "hour"});
+    sender.send({Deadline::max(), "never"});
+    sender.send({now + 1s, "second"});
+    sender.send({now + 1min, "minute"});
+    sender.send({Deadline::min(), "late"});
+    sender.send({now - 1s, "late1"});
+
+    ASSERT_EQ(receive_all(), std::vector<std::string>({"late", "late1", "soon", "second", "minute", "hour", "never"}));
+}
+
+/*
+ * Checks that the calendar moves forward while elements are sent and received.
+ */
+TEST_F(DeadlineChannelTest, movingCalendar)
+{
+    sender.send({now + 5ms, "a"});
+    sender.send({now + 500ms, "d"});
+    ASSERT_EQ(receiver.receive().name, "a");
+
+    sender.send({now + 300ms, "c"});
+    sender.send({now + 100ms, "b"});
+    sender.send({now + 2s, "e"});
+
+    ASSERT_EQ(receive_all(), std::vector<std::string>({"b", "c", "d", "e"}));
+}
+
+/*
+ * Compares the queue with a sort, on random deadlines spread over many laps of the calendar.
+ */
+TEST(DeadlineQueueTest, randomDeadlines)
+{
+    struct Identity
+    {
+        Deadline operator()(const Deadline& deadline) const noexcept
+        {
+            return deadline;
+        }
+    };
+
+    DeadlineQueue<Deadline, Identity, 64> queue(1ms);
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> distribution(0, 1000);
+    std::vector<Deadline> expected;
+    std::vector<Deadline> popped;
+    const Deadline now = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < 50; ++round)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            const Deadline deadline = now + std::chrono::milliseconds(round * 10 + distribution(random));
+            queue.push(deadline);
+            expected.push_back(deadline);
+        }
+
+        for (int i = 0; i < 10; ++i)
+        {
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(queue.front(), expected.front());
+            expected.erase(expected.begin());
+            queue.pop();
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+
+    while (!queue.empty())
+    {
+        popped.push_back(queue.front());
+        queue.pop();
+    }
+
+    ASSERT_EQ(popped, expected);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
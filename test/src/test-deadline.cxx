@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <ese/flow/deadline.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class DeadlineTest: public testing::Test
+{
+
+};
+
+/*
+ * Checks that the extreme time points of every clock map to the extreme deadlines.
+ */
+TEST_F(DeadlineTest, extremesSaturate)
+{
+    using system_time_point = std::chrono::system_clock::time_point;
+
+    ASSERT_EQ(to_deadline(system_time_point::max()), Deadline::max());
+    ASSERT_EQ(to_deadline(system_time_point::min()), Deadline::min());
+    ASSERT_EQ(to_deadline(Deadline::max()), Deadline::max());
+    ASSERT_EQ(to_deadline(Deadline::min()), Deadline::min());
+}
+
+/*
+ * Checks that a time point of another clock is converted to a deadline at the same distance from now.
+ */
+TEST_F(DeadlineTest, otherClockConversion)
+{
+    const Deadline before = Deadline::clock::now();
+    const Deadline deadline = to_deadline(std::chrono::system_clock::now() + 1s);
+    const Deadline after = Deadline::clock::now();
+
+    ASSERT_GE(deadline, before + 900ms);
+    ASSERT_LE(deadline, after + 1100ms);
+}
+
+/*
+ * Checks that durations are converted without overflowing.
+ */
+TEST_F(DeadlineTest, deadlineAfter)
+{
+    ASSERT_EQ(deadline_after(0ms), Deadline::min());
+    ASSERT_EQ(deadline_after(-1s), Deadline::min());
+    ASSERT_EQ(deadline_after(std::chrono::hours::max()), Deadline::max());
+    ASSERT_GT(deadline_after(1s), Deadline::clock::now());
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
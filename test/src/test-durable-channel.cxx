@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <dirent.h>
+#include <unistd.h>
+#include <ese/flow/durable-channel.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+/*
+ * Serializes strings as their characters.
+ */
+class StringSerializer
+{
+public:
+    void serialize(const std::string& element, std::string& buffer) const
+    {
+        buffer.append(element);
+    }
+
+    bool deserialize(const char* data, std::size_t size, std::string* element) const
+    {
+        element->assign(data, size);
+        return true;
+    }
+};
+
+class DurableChannelTest: public testing::Test
+{
+    protected:
+        std::string directory;
+
+    public:
+        DurableChannelTest()
+        {
+            char path[] = "/tmp/ese-flow-durable-XXXXXX";
+            directory = mkdtemp(path);
+        }
+
+        ~DurableChannelTest()
+        {
+            if (DIR* handle = opendir(directory.c_str()))
+            {
+                while (dirent* entry = readdir(handle))
+                    std::remove((directory + "/" + entry->d_name).c_str());
+
+                closedir(handle);
+            }
+
+            rmdir(directory.c_str());
+        }
+
+        std::size_t count_segments() const
+        {
+            std::size_t count = 0;
+
+            if (DIR* handle = opendir(directory.c_str()))
+            {
+                while (dirent* entry = readdir(handle))
+                    count += std::string(entry->d_name).find(".log") != std::string::npos;
+
+                closedir(handle);
+            }
+
+            return count;
+        }
+};
+
+/*
+ * Passes some values through the channel.
+ */
+TEST_F(DurableChannelTest, simpleValuePassing)
+{
+    DurableChannel<int> channel(directory);
+    ASSERT_TRUE(channel.is_empty());
+
+    channel.get_sender().send(1);
+    channel.get_sender() << 2;
+
+    ASSERT_FALSE(channel.is_empty());
+    ASSERT_EQ(channel.get_end_offset(), 2);
+    ASSERT_EQ(channel.get_receiver().receive(), 1);
+    ASSERT_EQ(channel.get_receiver().receive(), 2);
+
+    int element;
+    ASSERT_FALSE(channel.get_receiver().try_receive(&element));
+    ASSERT_FALSE(channel.get_receiver().try_receive_for(&element, 5ms));
+}
+
+/*
+ * After a restart, the receiver resumes from the committed offset and can replay the older elements.
+ */
+TEST_F(DurableChannelTest, resumeAndReplay)
+{
+    {
+        DurableChannel<int> channel(directory);
+        int numbers[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        channel.get_sender().send_batch(numbers, numbers + 10);
+
+        for (int i = 0; i < 4; ++i)
+            ASSERT_EQ(channel.get_receiver().receive(), i);
+
+        channel.get_receiver().commit();
+    }
+
+    DurableChannel<int> channel(directory);
+    ASSERT_EQ(channel.get_end_offset(), 10);
+    ASSERT_EQ(channel.get_receiver().get_committed_offset(), 4);
+    ASSERT_EQ(channel.get_receiver().get_offset(), 4);
+
+    for (int i = 4; i < 10; ++i)
+        ASSERT_EQ(channel.get_receiver().receive(), i);
+
+    ASSERT_TRUE(channel.get_receiver().seek(2));
+    ASSERT_EQ(channel.get_receiver().receive(), 2);
+    ASSERT_FALSE(channel.get_receiver().seek(11));
+
+    channel.get_sender().send(10);
+    ASSERT_EQ(channel.get_receiver().receive(), 3);
+}
+
+/*
+ * Elements span many segments, that are recovered on restart and removed once committed.
+ */
+TEST_F(DurableChannelTest, segments)
+{
+    DurableLogOptions options;
+    options.segment_size = 256;
+
+    {
+        DurableChannel<std::string, StringSerializer> channel(directory, options);
+
+        for (int i = 0; i < 100; ++i)
+            channel.get_sender().send("element " + std::to_string(i));
+    }
+
+    ASSERT_GT(count_segments(), 5);
+
+    DurableChannel<std::string, StringSerializer> channel(directory, options);
+    ASSERT_EQ(channel.get_end_offset(), 100);
+
+    std::string elements[100];
+    ASSERT_EQ(channel.get_receiver().receive_batch(elements, 100), 100);
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(elements[i], "element " + std::to_string(i));
+
+    ASSERT_TRUE(channel.get_receiver().seek(60));
+    channel.get_receiver().commit();
+
+    const std::size_t segments = count_segments();
+    ASSERT_GT(channel.compact(), 0);
+    ASSERT_LT(count_segments(), segments);
+    ASSERT_FALSE(channel.get_receiver().seek(0));
+    ASSERT_EQ(channel.get_receiver().receive(), "element 60");
+
+    ASSERT_THROW(channel.get_sender().send(std::string(1024, 'x')), std::length_error);
+}
+
+/*
+ * A torn record (e.g. a crash during a write) ends the log, when it is opened again.
+ */
+TEST_F(DurableChannelTest, tornRecord)
+{
+    {
+        DurableChannel<int> channel(directory);
+
+        for (int i = 0; i < 5; ++i)
+            channel.get_sender().send(i);
+
+        channel.sync();
+    }
+
+    // every record takes 16 bytes: its header, the int and the padding
+    FILE* file = std::fopen((directory + "/00000000000000000000.log").c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 4 * 16 + 8, SEEK_SET);
+    std::fputc(0x7f, file);
+    std::fclose(file);
+
+    DurableChannel<int> channel(directory);
+    ASSERT_EQ(channel.get_end_offset(), 4);
+
+    channel.get_sender().send(40);
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_EQ(channel.get_receiver().receive(), i);
+
+    ASSERT_EQ(channel.get_receiver().receive(), 40);
+}
+
+/*
+ * A committed offset beyond the records recovered after a crash is clamped, so that the records appended at its
+ * place are not skipped on the next restart.
+ */
+TEST_F(DurableChannelTest, commitBeyondTornRecord)
+{
+    {
+        DurableChannel<int> channel(directory);
+
+        for (int i = 0; i < 5; ++i)
+            channel.get_sender().send(i);
+
+        for (int i = 0; i < 5; ++i)
+            ASSERT_EQ(channel.get_receiver().receive(), i);
+
+        channel.get_receiver().commit();
+    }
+
+    FILE* file = std::fopen((directory + "/00000000000000000000.log").c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 3 * 16 + 8, SEEK_SET);
+    std::fputc(0x7f, file);
+    std::fclose(file);
+
+    {
+        DurableChannel<int> channel(directory);
+        ASSERT_EQ(channel.get_end_offset(), 3);
+        ASSERT_EQ(channel.get_receiver().get_committed_offset(), 3);
+
+        channel.get_sender().send(30);
+        channel.get_sender().send(40);
+    }
+
+    DurableChannel<int> channel(directory);
+    ASSERT_EQ(channel.get_receiver().receive(), 30);
+    ASSERT_EQ(channel.get_receiver().receive(), 40);
+}
+
+/*
+ * A consumer thread receives all the elements sent by a producer thread.
+ */
+TEST_F(DurableChannelTest, producerConsumer)
+{
+    static const int elements_count = 10000;
+
+    DurableChannel<int> channel(directory);
+    bool in_order = true;
+
+    std::thread consumer([&channel, &in_order] ()
+        {
+            for (int i = 0; i < elements_count; ++i)
+                in_order = in_order && channel.get_receiver().receive() == i;
+        });
+
+    for (int i = 0; i < elements_count; ++i)
+        channel.get_sender().send(i);
+
+    consumer.join();
+    ASSERT_TRUE(in_order);
+}
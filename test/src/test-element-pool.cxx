@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/element-pool.hxx>
+
+using namespace ese::flow;
+
+/*
+ * A released element comes back from acquire(), with its buffer.
+ */
+TEST(ElementPoolTest, recycle)
+{
+    ElementPool<std::vector<int>> pool(2);
+    ASSERT_EQ(pool.get_capacity(), 2);
+
+    std::vector<int> element = pool.acquire();
+    ASSERT_EQ(pool.get_created_count(), 1);
+
+    element.resize(100);
+    const int* buffer = element.data();
+    ASSERT_TRUE(pool.release(std::move(element)));
+
+    std::vector<int> recycled = pool.acquire();
+    ASSERT_EQ(pool.get_recycled_count(), 1);
+    ASSERT_EQ(recycled.data(), buffer);
+    ASSERT_EQ(recycled.size(), 100);
+}
+
+/*
+ * The pool keeps at most capacity elements.
+ */
+TEST(ElementPoolTest, full)
+{
+    ElementPool<std::vector<int>> pool(2);
+    std::vector<int> element(3);
+
+    ASSERT_TRUE(pool.release(std::vector<int>(1)));
+    ASSERT_TRUE(pool.release(std::vector<int>(2)));
+    ASSERT_FALSE(pool.release(std::move(element)));
+    ASSERT_EQ(element.size(), 3);
+
+    pool.acquire();
+    pool.acquire();
+    pool.acquire();
+    ASSERT_EQ(pool.get_recycled_count(), 2);
+    ASSERT_EQ(pool.get_created_count(), 1);
+}
+
+/*
+ * The consumer gives the spent elements back to the producer: after the warm-up, no element is created.
+ */
+TEST(ElementPoolTest, producerConsumer)
+{
+    static const int elements_count = 10000;
+
+    ElementPool<std::vector<int>> pool(64);
+    RingQueueChannel<std::vector<int>> channel(32);
+
+    std::thread consumer([&channel, &pool] ()
+        {
+            for (int i = 0; i < elements_count; ++i)
+                pool.release(channel.get_receiver().receive());
+        });
+
+    for (int i = 0; i < elements_count; ++i)
+    {
+        std::vector<int> element = pool.acquire();
+        element.assign(16, i);
+        channel.get_sender().send(std::move(element));
+    }
+
+    consumer.join();
+
+    // the elements in the channel, in the hands of the threads and those that lost a race with a release
+    ASSERT_LE(pool.get_created_count(), 64);
+    ASSERT_EQ(pool.get_created_count() + pool.get_recycled_count(), elements_count);
+}
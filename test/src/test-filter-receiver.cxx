@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include <iterator>
 #include <string>
+#include <vector>
 #include <ese/flow/channel.hxx>
 #include <ese/flow/filter-receiver.hxx>
 
@@ -54,6 +56,21 @@ TEST_F(FilterReceiverTest, simple)
     ASSERT_EQ(r1, 50);
 }
 
+/*
+ * Test if batches are received and filtered.
+ */
+TEST_F(FilterReceiverTest, batch)
+{
+    std::vector<std::string> numbers = {"1", "2", "3"};
+    sender.send_batch(numbers.begin(), numbers.end());
+
+    std::vector<int> received;
+    std::size_t count = receiver.receive_batch(std::back_inserter(received), 10);
+
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(received, std::vector<int>({1, 2, 3}));
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 #include <ese/flow/channel.hxx>
 #include <ese/flow/filter-sender.hxx>
 
@@ -54,6 +55,37 @@ TEST_F(FilterSenderTest, simple)
     ASSERT_EQ(r1, 50);
 }
 
+/*
+ * Test if batches are filtered and forwarded.
+ */
+TEST_F(FilterSenderTest, batch)
+{
+    std::vector<std::string> numbers = {"1", "2", "3"};
+    sender.send_batch(numbers.begin(), numbers.end());
+
+    int received[3];
+    std::size_t count = receiver.receive_batch(received, 3);
+
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(received[0], 1);
+    ASSERT_EQ(received[2], 3);
+}
+
+/*
+ * Test if try_send() is forwarded to a bounded sender, leaving the element untouched when it is refused.
+ */
+TEST_F(FilterSenderTest, trySend)
+{
+    Channel<int> channel(1);
+    FilterSender<std::string, int> sender(&filter, &channel.get_sender());
+    std::string number = "7";
+
+    ASSERT_TRUE(sender.try_send(std::move(number)));
+    ASSERT_FALSE(sender.try_send(std::move(number)));
+    ASSERT_EQ(number, "7");
+    ASSERT_EQ(channel.get_receiver().receive(), 7);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
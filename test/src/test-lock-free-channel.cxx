@@ -0,0 +1,371 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/consumer.hxx>
+#include <ese/flow/filter-receiver.hxx>
+#include <ese/flow/lock-free-channel.hxx>
+
+#define THE_NUMBER  (42)
+#define ONE         (1)
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class LockFreeChannelTest: public testing::Test
+{
+    protected:
+        SpscChannel<int> channel;
+        Receiver<int>& receiver;
+        Sender<int>& sender;
+
+    public:
+        LockFreeChannelTest():
+            channel(16),
+            receiver(channel.get_receiver()),
+            sender(channel.get_sender())
+        {
+
+        }
+};
+
+/*
+ * Tries to pass some values through the channel and checks if those are received in the correct order.
+ */
+TEST_F(LockFreeChannelTest, simpleValuePassing)
+{
+    sender.send(THE_NUMBER);
+    sender << ONE;
+
+    ASSERT_EQ(receiver.receive(), THE_NUMBER);
+    ASSERT_EQ(receiver.receive(), ONE);
+}
+
+/*
+ * Checks that the receiver does not block on empty channel using method ::try_receive().
+ */
+TEST_F(LockFreeChannelTest, noBlockOnEmptyChannel)
+{
+    bool received = receiver.try_receive(nullptr);
+    ASSERT_FALSE(received);
+}
+
+/*
+ * Checks that the receiver blocks until there is a value on the channel using ::try_receive() method.
+ */
+TEST_F(LockFreeChannelTest, blockUntilValueOnChannel)
+{
+    std::thread thread([&sender = channel.get_sender()] ()
+        {
+            std::this_thread::sleep_for(100ms);
+            sender.send(THE_NUMBER);
+        });
+
+    int n = 0;
+    bool received = receiver.try_receive(&n, true);
+    thread.join();
+
+    ASSERT_EQ(n, THE_NUMBER);
+    ASSERT_TRUE(received);
+}
+
+/*
+ * Checks that the receiver blocks until the channel calls ::wake_up() method.
+ */
+TEST_F(LockFreeChannelTest, blockUntilChannelWakesUp)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread thread([this] ()
+        {
+            std::this_thread::sleep_for(100ms);
+            this->channel.wake_up();
+        });
+
+    bool received = receiver.try_receive(nullptr, true);
+    auto end = std::chrono::steady_clock::now();
+    thread.join();
+
+    ASSERT_GT(end - start, 90ms);
+    ASSERT_FALSE(received);
+}
+
+/*
+ * Checks that the receiver blocks for 100ms (at least) using the method ::try_receive_for() where there is no data to
+ * receive.
+ */
+TEST_F(LockFreeChannelTest, tryReceiveForNoData)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool received = receiver.try_receive_for(nullptr, 100ms);
+    auto end = std::chrono::steady_clock::now();
+
+    ASSERT_GT(end - start, 90ms);
+    ASSERT_FALSE(received);
+}
+
+/*
+ * Checks that a sender blocks on a full channel until an element is received.
+ */
+TEST_F(LockFreeChannelTest, senderBlocksWhenFull)
+{
+    for (int i = 0; i < 16; ++i)
+        sender << i;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread thread([this] ()
+        {
+            std::this_thread::sleep_for(100ms);
+            this->receiver.receive();
+        });
+
+    sender << THE_NUMBER;
+    auto end = std::chrono::steady_clock::now();
+    thread.join();
+
+    ASSERT_GT(end - start, 90ms);
+
+    for (int i = 1; i < 16; ++i)
+        ASSERT_EQ(receiver.receive(), i);
+
+    ASSERT_EQ(receiver.receive(), THE_NUMBER);
+}
+
+/*
+ * Passes many elements from one thread to another through a small SPSC channel, checking the order.
+ */
+TEST_F(LockFreeChannelTest, spscOrdering)
+{
+    static const int count = 100000;
+
+    std::thread thread([this] ()
+        {
+            for (int i = 0; i < count; ++i)
+                this->sender << i;
+        });
+
+    bool ordered = true;
+
+    for (int i = 0; i < count; ++i)
+        ordered = ordered && receiver.receive() == i;
+
+    thread.join();
+    ASSERT_TRUE(ordered);
+}
+
+/*
+ * Passes many elements from several producers to several consumers through an MPMC channel.
+ */
+TEST_F(LockFreeChannelTest, mpmcManyThreads)
+{
+    static const int threads_count = 4;
+    static const int per_thread = 20000;
+
+    MpmcChannel<int> channel(32);
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(threads_count, 0);
+
+    for (int p = 0; p < threads_count; ++p)
+        threads.emplace_back([&channel] ()
+            {
+                for (int i = 1; i <= per_thread; ++i)
+                    channel.get_sender() << i;
+            });
+
+    for (int c = 0; c < threads_count; ++c)
+        threads.emplace_back([&channel, &sums, c] ()
+            {
+                for (int i = 0; i < per_thread; ++i)
+                    sums[c] += channel.get_receiver().receive();
+            });
+
+    for (std::thread& thread: threads)
+        thread.join();
+
+    long long sum = 0;
+
+    for (long long partial: sums)
+        sum += partial;
+
+    ASSERT_EQ(sum, threads_count * (static_cast<long long>(per_thread) * (per_thread + 1) / 2));
+}
+
+/*
+ * Checks that a blocking receive never returns empty-handed, even when woken for an element another receiver took.
+ */
+TEST_F(LockFreeChannelTest, blockingReceiveAfterStolenElement)
+{
+    static const int threads_count = 4;
+    static const int per_thread = 5000;
+
+    // the channel never fills up, so that the sender does not wait for failed receivers
+    MpmcChannel<int> channel(threads_count * per_thread);
+    std::vector<std::thread> threads;
+    std::vector<int> failures(threads_count, 0);
+
+    for (int c = 0; c < threads_count; ++c)
+        threads.emplace_back([&channel, &failures, c] ()
+            {
+                int element;
+
+                for (int i = 0; i < per_thread; ++i)
+                    if (!channel.get_receiver().try_receive(&element, true))
+                        ++failures[c];
+            });
+
+    // sends in bursts, so that the parked receivers are woken together and race for the elements
+    for (int i = 0; i < threads_count * per_thread; ++i)
+    {
+        channel.get_sender() << i;
+
+        if (i % threads_count == 0)
+            std::this_thread::sleep_for(10us);
+    }
+
+    for (std::thread& thread: threads)
+        thread.join();
+
+    for (int failed: failures)
+        ASSERT_EQ(failed, 0);
+}
+
+/*
+ * Checks that a receiver that spins before parking works with a lock-free channel.
+ */
+TEST_F(LockFreeChannelTest, spinThenParkWaitPolicy)
+{
+    static const int count = 10000;
+
+    SpscChannel<int, SpinThenParkWaitPolicy<>> channel(8);
+
+    std::thread thread([&channel] ()
+        {
+            for (int i = 0; i < count; ++i)
+                channel.get_sender() << i;
+        });
+
+    bool ordered = true;
+
+    for (int i = 0; i < count; ++i)
+        ordered = ordered && channel.get_receiver().receive() == i;
+
+    thread.join();
+    ASSERT_TRUE(ordered);
+}
+
+class StringToIntFilter: public Filter<std::string, int>
+{
+public:
+    int filter(std::string&& s) override
+    {
+        return filter(s);
+    }
+
+    int filter(const std::string& s) override
+    {
+        return std::stoi(s);
+    }
+};
+
+/*
+ * Checks that a FilterReceiver works on top of a lock-free channel.
+ */
+TEST_F(LockFreeChannelTest, filterReceiverOnTop)
+{
+    MpmcChannel<std::string> channel(4);
+    StringToIntFilter filter;
+    FilterReceiver<std::string, int> receiver(&filter, &channel.get_receiver());
+
+    channel.get_sender() << "44";
+
+    ASSERT_EQ(receiver.receive(), 44);
+}
+
+class SumConsumerFactory: public ConsumerFactory<int>
+{
+public:
+    SumConsumerFactory(Receiver<int>* receiver):
+        ConsumerFactory(receiver),
+        sum(0)
+    {
+
+    }
+
+    void consume_0(int&& number) override
+    {
+        sum += number;
+    }
+
+    int sum;
+};
+
+/*
+ * Checks that consumers work on top of a lock-free channel.
+ */
+TEST_F(LockFreeChannelTest, consumerOnTop)
+{
+    SumConsumerFactory factory(&receiver);
+    Consumer<int> consumer = factory.create_one();
+
+    sender << 1;
+    sender << 2;
+
+    ASSERT_EQ(consumer(), 1);
+    ASSERT_EQ(consumer(), 1);
+    ASSERT_EQ(consumer(), 0);
+    ASSERT_EQ(factory.sum, 3);
+}
+
+/*
+ * Checks that a batch bigger than the channel's capacity passes through the channel.
+ */
+TEST_F(LockFreeChannelTest, batchBiggerThanCapacity)
+{
+    std::vector<int> sent(100);
+
+    for (int i = 0; i < 100; ++i)
+        sent[i] = i;
+
+    std::thread thread([this, &sent] ()
+        {
+            this->sender.send_batch(sent.begin(), sent.end());
+        });
+
+    std::vector<int> received;
+
+    while (received.size() < sent.size())
+        receiver.receive_batch(std::back_inserter(received), 100, true);
+
+    thread.join();
+    ASSERT_EQ(received, sent);
+}
+
+/*
+ * Checks that try_send() gives up on a full channel (leaving the element untouched) and counts the blocked sends.
+ */
+TEST_F(LockFreeChannelTest, trySend)
+{
+    MpmcChannel<std::string> channel(2);
+    std::string name = "janez";
+
+    channel.get_sender() << "1" << "2";
+
+    ASSERT_FALSE(channel.get_sender().try_send(std::move(name)));
+    ASSERT_FALSE(channel.get_sender().try_send_for(std::move(name), 20ms));
+    ASSERT_EQ(name, "janez");
+    ASSERT_EQ(channel.get_blocked_count(), 2);
+
+    ASSERT_EQ(channel.get_receiver().receive(), "1");
+    ASSERT_TRUE(channel.get_sender().try_send(std::move(name)));
+    ASSERT_EQ(channel.get_receiver().receive(), "2");
+    ASSERT_EQ(channel.get_receiver().receive(), "janez");
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/profiled-mutex.hxx>
+
+using namespace ese::flow;
+
+namespace
+{
+    const std::size_t SENDER = static_cast<std::size_t>(LockRole::SENDER);
+    const std::size_t RECEIVER = static_cast<std::size_t>(LockRole::RECEIVER);
+}
+
+/*
+ * Checks that uncontended locks are counted and their hold times recorded.
+ */
+TEST(ProfiledMutexTest, uncontended)
+{
+    ProfiledMutex mutex;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex);
+    }
+
+    ASSERT_TRUE(mutex.try_lock());
+    std::thread([&mutex] () { ASSERT_FALSE(mutex.try_lock()); }).join();
+    mutex.unlock();
+
+    const LockProfile profile = mutex.get_profile();
+
+    ASSERT_EQ(profile.acquisitions, 11);
+    ASSERT_EQ(profile.contentions, 0);
+    ASSERT_EQ(profile.wait_ns, 0);
+    ASSERT_EQ(profile.wait.count, 0);
+    ASSERT_EQ(profile.hold.count, 11);
+}
+
+/*
+ * Checks that a contended lock blames the role of the holder for the wait.
+ */
+TEST(ProfiledMutexTest, contention)
+{
+    ProfiledMutex mutex;
+
+    ProfiledMutex::set_current_role(LockRole::RECEIVER);
+    mutex.lock();
+
+    std::thread sender([&mutex] ()
+        {
+            ProfiledMutex::set_current_role(LockRole::SENDER);
+            mutex.lock();
+            mutex.unlock();
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    mutex.unlock();
+    sender.join();
+    ProfiledMutex::set_current_role(LockRole::OTHER);
+
+    const LockProfile profile = mutex.get_profile();
+
+    ASSERT_EQ(profile.acquisitions, 2);
+    ASSERT_EQ(profile.contentions, 1);
+    ASSERT_GE(profile.blocked_ns[SENDER][RECEIVER], 10000000);
+    ASSERT_EQ(profile.wait_ns, profile.blocked_ns[SENDER][RECEIVER]);
+    ASSERT_EQ(profile.wait.count, 1);
+    ASSERT_GE(profile.hold.max, 10000000);
+}
+
+/*
+ * Checks that a channel profiles its mutex, with the roles of its senders and receivers and the sleeps of the
+ * blocked receivers.
+ */
+TEST(ProfiledMutexTest, channel)
+{
+    Channel<int> channel;
+    int element = 0;
+
+    std::thread receiver([&channel, &element] ()
+        {
+            channel.get_receiver().try_receive(&element, true);
+            ASSERT_EQ(ProfiledMutex::get_current_role(), LockRole::RECEIVER);
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    channel.get_sender().send(42);
+    receiver.join();
+
+    ASSERT_EQ(ProfiledMutex::get_current_role(), LockRole::SENDER);
+    ProfiledMutex::set_current_role(LockRole::OTHER);
+
+    const LockProfile profile = channel.get_lock_profile();
+
+    ASSERT_EQ(element, 42);
+    ASSERT_GE(profile.acquisitions, 2);
+    ASSERT_EQ(profile.sleep.count, 1);
+    ASSERT_GE(profile.sleep_ns, 10000000);
+}
+
+/*
+ * Checks that the profiler ranks the channels by wait time, and reports them.
+ */
+TEST(LockProfilerTest, rank)
+{
+    LockProfiler profiler;
+    Channel<int> channel;
+
+    LockProfile contended;
+    contended.acquisitions = 4;
+    contended.contentions = 2;
+    contended.wait_ns = 5000;
+    contended.blocked_ns[RECEIVER][SENDER] = 4000;
+    contended.blocked_ns[SENDER][RECEIVER] = 1000;
+
+    channel.get_sender().send(1);
+
+    profiler.add("channel", channel);
+    profiler.add("contended", std::function<LockProfile()>([contended] () { return contended; }));
+    profiler.add("removed", std::function<LockProfile()>([] () { return LockProfile(); }));
+    profiler.remove("removed");
+
+    const std::vector<std::pair<std::string, LockProfile>> ranked = profiler.rank();
+
+    ASSERT_EQ(ranked.size(), 2);
+    ASSERT_EQ(ranked[0].first, "contended");
+    ASSERT_EQ(ranked[1].first, "channel");
+    ASSERT_EQ(ranked[1].second.acquisitions, 1);
+
+    std::ostringstream out;
+    profiler.report(out);
+    const std::string report = out.str();
+
+    ASSERT_EQ(report.find("channel"), 0);
+    ASSERT_LT(report.find("contended"), report.find("\nchannel"));
+    ASSERT_NE(report.find("50.00%"), std::string::npos);
+    ASSERT_NE(report.find("receiver<-sender"), std::string::npos);
+    ASSERT_EQ(report.find("removed"), std::string::npos);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/consumer.hxx>
+#include <ese/flow/metrics.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class SlowConsumerFactory: public ConsumerFactory<int>
+{
+public:
+    SlowConsumerFactory(Receiver<int>* receiver):
+        ConsumerFactory(receiver)
+    {
+
+    }
+
+    void consume_0(int&& number) override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(number));
+    }
+};
+
+class MetricsTest: public testing::Test
+{
+public:
+    MetricsTest()
+    {
+
+    }
+};
+
+/*
+ * Checks that the stripes of a counter are summed, whatever thread incremented them.
+ */
+TEST_F(MetricsTest, counter)
+{
+    MetricCounter counter;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&counter] ()
+            {
+                for (int i = 0; i < 1000; ++i)
+                    counter.add();
+            });
+
+    for (std::thread& thread: threads)
+        thread.join();
+
+    ASSERT_EQ(counter.get(), 8000);
+}
+
+/*
+ * Checks the log-linear buckets, and the percentiles computed from them.
+ */
+TEST_F(MetricsTest, histogram)
+{
+    for (std::uint64_t value: {0ull, 1ull, 15ull, 16ull, 31ull, 1000ull, 123456789ull, ~0ull})
+    {
+        const std::size_t bucket = LatencyHistogram::get_bucket(value);
+
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS_COUNT);
+        ASSERT_GE(LatencyHistogram::get_bucket_max(bucket), value);
+        ASSERT_LE(LatencyHistogram::get_bucket_max(bucket) - value, value / 16);
+    }
+
+    LatencyHistogram histogram;
+
+    for (std::uint64_t i = 1; i <= 1000; ++i)
+        histogram.record(i * 1000);
+
+    LatencySummary summary = histogram.get_summary();
+
+    ASSERT_EQ(summary.count, 1000);
+    ASSERT_NEAR(summary.mean, 500500, 1);
+    ASSERT_NEAR(summary.p50, 500000, 500000 / 16);
+    ASSERT_NEAR(summary.p99, 990000, 990000 / 16);
+    ASSERT_EQ(summary.max, 1000000);
+}
+
+/*
+ * Checks the counters of a channel: rates, depth and high-water mark, receiver waits.
+ */
+TEST_F(MetricsTest, channel)
+{
+    Channel<int> channel;
+    int number;
+
+    for (int i = 0; i < 10; ++i)
+        channel.get_sender().send(i);
+
+    for (int i = 0; i < 5; ++i)
+        channel.get_receiver().receive();
+
+    ChannelMetrics metrics = channel.get_metrics();
+
+    ASSERT_EQ(metrics.enqueued, 10);
+    ASSERT_EQ(metrics.dequeued, 5);
+    ASSERT_EQ(metrics.depth, 5);
+    ASSERT_EQ(metrics.high_water_mark, 10);
+
+    while (channel.get_receiver().try_receive(&number))
+        ;
+
+    ASSERT_FALSE(channel.get_receiver().try_receive_for(&number, 1ms));
+
+    std::thread sender([&channel] ()
+        {
+            std::this_thread::sleep_for(20ms);
+            channel.get_sender().send(42);
+        });
+
+    ASSERT_EQ(channel.get_receiver().receive(), 42);
+    sender.join();
+
+    metrics = channel.get_metrics();
+
+    ASSERT_EQ(metrics.timed_out_waits, 1);
+    ASSERT_EQ(metrics.slept_waits, 1);
+    ASSERT_EQ(metrics.depth, 0);
+}
+
+/*
+ * Checks the throughput and latency of a consumer, and the snapshot of the registry.
+ */
+TEST_F(MetricsTest, consumerAndRegistry)
+{
+    Channel<int> channel;
+    SlowConsumerFactory factory(&channel.get_receiver());
+    Consumer<int> consumer = factory.create_one();
+    MetricsRegistry registry;
+
+    registry.add_channel("input", channel);
+    registry.add_consumer("slow", consumer);
+
+    for (int i = 0; i < 20; ++i)
+        channel.get_sender().send(1000);
+
+    while (consumer.consume() != 0)
+        ;
+
+    MetricsSnapshot snapshot = registry.snapshot();
+
+    ASSERT_EQ(snapshot.channels.at("input").dequeued, 20);
+    ASSERT_EQ(snapshot.consumers.at("slow").consumed, 20);
+    ASSERT_GE(snapshot.consumers.at("slow").latency.p50, 1000000);
+
+    bool found = false;
+
+    for (const auto& sample: snapshot.get_samples())
+        if (sample.first == "consumer.slow.consumed")
+            found = sample.second == 20;
+
+    ASSERT_TRUE(found);
+
+    registry.remove("slow");
+    ASSERT_EQ(registry.snapshot().consumers.size(), 0);
+}
+
+/*
+ * Checks that the default batch consumption times every element on its own, instead of averaging the batch.
+ */
+TEST_F(MetricsTest, batchLatencyPerElement)
+{
+    Channel<int> channel;
+    SlowConsumerFactory factory(&channel.get_receiver());
+    Consumer<int> consumer = factory.create_batch(10);
+    int numbers[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 20000};
+
+    channel.get_sender().send_batch(numbers, numbers + 10);
+
+    ASSERT_EQ(consumer.consume(), 10);
+
+    ConsumerMetrics metrics = consumer.get_metrics();
+
+    ASSERT_EQ(metrics.consumed, 10);
+    ASSERT_EQ(metrics.latency.count, 10);
+    ASSERT_LT(metrics.latency.p50, 1000000);
+    ASSERT_GE(metrics.latency.max, 20000000);
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/parallel-filter.hxx>
+#include <ese/flow/thread-pool-executor.hxx>
+
+using namespace ese::flow;
+
+class StringToIntFilter: public Filter<std::string, int>
+{
+public:
+    int filter(std::string&& s) override
+    {
+        return filter(s);
+    }
+
+    int filter(const std::string& s) override
+    {
+        return std::stoi(s);
+    }
+};
+
+/*
+ * Not thread-safe: it remembers the threads that used it.
+ */
+class RecordingFilter: public Filter<int, int>
+{
+public:
+    explicit RecordingFilter(std::atomic_int* instances)
+    {
+        ++*instances;
+    }
+
+    int filter(int&& i) override
+    {
+        return filter(i);
+    }
+
+    int filter(const int& i) override
+    {
+        threads.insert(std::this_thread::get_id());
+        return i * 2;
+    }
+
+    std::set<std::thread::id> threads;
+};
+
+class ParallelFilterTest: public testing::Test
+{
+public:
+    ParallelFilterTest():
+        pool(4),
+        receiver(channel.get_receiver())
+    {
+
+    }
+
+protected:
+    ThreadPoolExecutor<> pool;
+    Channel<int> channel;
+    Receiver<int>& receiver;
+
+    std::vector<int> receive_all()
+    {
+        std::vector<int> elements;
+        int element;
+
+        while (receiver.try_receive(&element))
+            elements.push_back(element);
+
+        return elements;
+    }
+};
+
+/*
+ * Test if single elements and batches are filtered and forwarded in order.
+ */
+TEST_F(ParallelFilterTest, ordered)
+{
+    StringToIntFilter filter;
+    ParallelFilter<std::string, int> sender(&pool, 4, &filter, &channel.get_sender());
+    std::vector<std::string> batch;
+
+    for (int i = 0; i < 1000; ++i)
+        batch.push_back(std::to_string(i));
+
+    sender.send("-1");
+    sender.send_batch(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+
+    std::vector<int> elements = receive_all();
+
+    ASSERT_EQ(elements.size(), 1001);
+
+    for (int i = 0; i < 1001; ++i)
+        ASSERT_EQ(elements[i], i - 1);
+}
+
+/*
+ * Test if every element is forwarded (in any order) in UNORDERED mode.
+ */
+TEST_F(ParallelFilterTest, unordered)
+{
+    StringToIntFilter filter;
+    ParallelFilter<std::string, int> sender(&pool, 4, &filter, &channel.get_sender(), ParallelOrder::UNORDERED);
+    std::vector<std::string> batch;
+
+    for (int i = 0; i < 1000; ++i)
+        batch.push_back(std::to_string(i));
+
+    sender.send_batch(batch.begin(), batch.end());
+
+    std::vector<int> elements = receive_all();
+    std::sort(elements.begin(), elements.end());
+
+    ASSERT_EQ(elements.size(), 1000);
+
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(elements[i], i);
+}
+
+/*
+ * Test that every slice uses its own filter instance, on one thread at a time.
+ */
+TEST_F(ParallelFilterTest, factory)
+{
+    std::atomic_int instances(0);
+    std::vector<RecordingFilter*> filters;
+    std::mutex mutex;
+
+    ParallelFilter<int, int> sender(&pool, 4, [&] ()
+        {
+            std::unique_ptr<RecordingFilter> filter(new RecordingFilter(&instances));
+            std::lock_guard<std::mutex> lock(mutex);
+            filters.push_back(filter.get());
+            return std::unique_ptr<Filter<int, int>>(std::move(filter));
+        }, &channel.get_sender());
+
+    std::vector<int> batch(100);
+
+    for (int i = 0; i < 100; ++i)
+        batch[i] = i;
+
+    for (int j = 0; j < 10; ++j)
+        sender.send_batch(batch.begin(), batch.end());
+
+    std::vector<int> elements = receive_all();
+
+    ASSERT_EQ(instances, 4);
+    ASSERT_EQ(sender.get_parallelism(), 4);
+    ASSERT_EQ(elements.size(), 1000);
+
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(elements[i], (i % 100) * 2);
+
+    // the first slice is always filtered by the sending thread
+    ASSERT_EQ(filters[0]->threads, std::set<std::thread::id>({std::this_thread::get_id()}));
+}
+
+/*
+ * Test that small batches are not split below the minimal slice size (and that the inline Executor works).
+ */
+TEST_F(ParallelFilterTest, minSliceSize)
+{
+    Executor<LambdaExecutable> executor;
+    std::atomic_int instances(0);
+    ParallelFilter<int, int> sender(&executor, 8, [&instances] ()
+        {
+            return std::unique_ptr<Filter<int, int>>(new RecordingFilter(&instances));
+        }, &channel.get_sender(), ParallelOrder::ORDERED, 16);
+
+    std::vector<int> batch = {1, 2, 3, 4, 5};
+    sender.send_batch(batch.begin(), batch.end());
+
+    ASSERT_EQ(receive_all(), std::vector<int>({2, 4, 6, 8, 10}));
+}
+
+/*
+ * Test that an exception thrown by a slice is re-thrown by the sender, and nothing of the batch is forwarded.
+ */
+TEST_F(ParallelFilterTest, exception)
+{
+    StringToIntFilter filter;
+    ParallelFilter<std::string, int> sender(&pool, 4, &filter, &channel.get_sender());
+    std::vector<std::string> batch(100, "1");
+    batch[90] = "not a number";
+
+    ASSERT_THROW(sender.send_batch_0(batch.data(), batch.size()), std::invalid_argument);
+    ASSERT_TRUE(receive_all().empty());
+
+    batch.assign(100, "2");
+    sender.send_batch_0(batch.data(), batch.size());
+
+    ASSERT_EQ(receive_all().size(), 100);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/pipeline.hxx>
+
+using namespace ese::flow;
+
+class StringToIntFilter: public Filter<std::string, int>
+{
+public:
+    int filter(std::string&& s) override
+    {
+        return filter(s);
+    }
+
+    int filter(const std::string& s) override
+    {
+        return std::stoi(s);
+    }
+};
+
+class InvertIntFilter: public Filter<int, int>
+{
+public:
+    int filter(int&& i) override
+    {
+        return filter(i);
+    }
+
+    int filter(const int& i) override
+    {
+        return -i;
+    }
+};
+
+class CountingFilter: public Filter<int, int>
+{
+public:
+    explicit CountingFilter(std::atomic_int& instances):
+        count(0)
+    {
+        ++instances;
+    }
+
+    int filter(int&& i) override
+    {
+        return filter(i);
+    }
+
+    int filter(const int& i) override
+    {
+        // not thread-safe: every thread needs its own instance
+        ++count;
+        return count > 0 ? i : 0;
+    }
+
+private:
+    int count;
+};
+
+class PipelineTest: public testing::Test
+{
+public:
+    PipelineTest():
+        source(channel.get_sender()),
+        sink(result.get_receiver())
+    {
+
+    }
+
+protected:
+    Channel<std::string> channel;
+    Channel<int> result;
+    Sender<std::string>& source;
+    Receiver<int>& sink;
+    StringToIntFilter to_int;
+    InvertIntFilter invert;
+};
+
+/*
+ * Test if adjacent filters are fused into a single stage.
+ */
+TEST_F(PipelineTest, fused)
+{
+    RunningPipeline running = pipeline(channel.get_receiver()) | to_int | invert | result.get_sender();
+
+    ASSERT_EQ(running.get_stages_count(), 1);
+    ASSERT_EQ(running.get_threads_count(), 1);
+
+    source.send("1");
+    source.send("20");
+
+    ASSERT_EQ(sink.receive(), -1);
+    ASSERT_EQ(sink.receive(), -20);
+}
+
+/*
+ * Test if a pipeline can start directly from a receiver.
+ */
+TEST_F(PipelineTest, fromReceiver)
+{
+    RunningPipeline running = channel.get_receiver() | to_int | result.get_sender();
+
+    source.send("5");
+
+    ASSERT_EQ(sink.receive(), 5);
+}
+
+/*
+ * Test if parallel stages get their own threads, and that every element goes through them.
+ */
+TEST_F(PipelineTest, parallel)
+{
+    RunningPipeline running = pipeline(channel.get_receiver(), 8) | to_int | parallel(3, invert)
+        | stateless(invert) | stage(invert) | result.get_sender();
+
+    ASSERT_EQ(running.get_stages_count(), 3);
+    ASSERT_EQ(running.get_threads_count(), 5);
+
+    for (int i = 1; i <= 100; ++i)
+        source.send(std::to_string(i));
+
+    int sum = 0;
+
+    for (int i = 1; i <= 100; ++i)
+        sum += sink.receive();
+
+    ASSERT_EQ(sum, -5050);
+}
+
+/*
+ * Test if a filter that is not stateless gets its own thread, instead of being fused into a parallel stage.
+ */
+TEST_F(PipelineTest, statefulAfterParallel)
+{
+    RunningPipeline running = pipeline(channel.get_receiver(), 8) | to_int | parallel(3, invert) | invert
+        | invert | result.get_sender();
+
+    ASSERT_EQ(running.get_stages_count(), 3);
+    ASSERT_EQ(running.get_threads_count(), 5);
+
+    for (int i = 1; i <= 100; ++i)
+        source.send(std::to_string(i));
+
+    int sum = 0;
+
+    for (int i = 1; i <= 100; ++i)
+        sum += sink.receive();
+
+    ASSERT_EQ(sum, -5050);
+}
+
+/*
+ * Test if every thread of a parallel stage gets its own filter, when created by a factory.
+ */
+TEST_F(PipelineTest, parallelFactory)
+{
+    std::atomic_int instances(0);
+
+    RunningPipeline running = pipeline(channel.get_receiver(), 8) | to_int
+        | parallel(4, [&instances] () { return std::unique_ptr<CountingFilter>(new CountingFilter(instances)); })
+        | result.get_sender();
+
+    ASSERT_EQ(running.get_threads_count(), 5);
+    ASSERT_EQ(instances.load(), 4);
+
+    for (int i = 1; i <= 100; ++i)
+        source.send(std::to_string(i));
+
+    int sum = 0;
+
+    for (int i = 1; i <= 100; ++i)
+        sum += sink.receive();
+
+    ASSERT_EQ(sum, 5050);
+}
+
+/*
+ * Test if stopping wakes up the stages parked on their input channels (a pipeline built from a channel does not poll).
+ */
+TEST_F(PipelineTest, wakeUpOnStop)
+{
+    {
+        RunningPipeline running = pipeline(channel, 8) | to_int | parallel(2, invert) | stage(invert)
+            | result.get_sender();
+
+        source.send("7");
+        ASSERT_EQ(sink.receive(), 7);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        running.stop();
+        running.join();
+
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    }
+
+    // the destroyed pipeline is not the listener of the channel anymore
+    RunningPipeline running = pipeline(channel) | to_int | result.get_sender();
+
+    source.send("8");
+    ASSERT_EQ(sink.receive(), 8);
+}
+
+/*
+ * Test if a pipeline laid out on the CPUs processes every element.
+ */
+TEST_F(PipelineTest, placed)
+{
+    RunningPipeline running = (pipeline(channel.get_receiver(), 8) | to_int | parallel(2, invert))
+        .into(result.get_sender(), CpuTopology::detect());
+
+    ASSERT_EQ(running.get_threads_count(), 3);
+
+    for (int i = 1; i <= 100; ++i)
+        source.send(std::to_string(i));
+
+    int sum = 0;
+
+    for (int i = 1; i <= 100; ++i)
+        sum += sink.receive();
+
+    ASSERT_EQ(sum, -5050);
+}
+
+/*
+ * Test if stopping the pipeline processes the elements already sent, before joining the threads.
+ */
+TEST_F(PipelineTest, stop)
+{
+    for (int i = 1; i <= 10; ++i)
+        source.send(std::to_string(i));
+
+    {
+        RunningPipeline running = pipeline(channel.get_receiver()) | parallel(2, to_int) | result.get_sender();
+        running.stop();
+        running.join();
+    }
+
+    int sum = 0;
+
+    for (int i = 1; i <= 10; ++i)
+        sum += sink.receive();
+
+    int element;
+    ASSERT_EQ(sum, 55);
+    ASSERT_FALSE(sink.try_receive(&element));
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
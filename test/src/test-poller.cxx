@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/lock-free-channel.hxx>
+#include <ese/flow/poller.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class PollerTest: public testing::Test
+{
+    protected:
+        Channel<int> numbers;
+        MpmcChannel<std::string> texts;
+        Poller poller;
+        std::size_t numbers_index;
+        std::size_t texts_index;
+
+    public:
+        PollerTest():
+            texts(16)
+        {
+            numbers_index = poller.add(numbers);
+            texts_index = poller.add(texts);
+        }
+};
+
+/*
+ * Checks that nothing is ready while the channels are empty.
+ */
+TEST_F(PollerTest, empty)
+{
+    ASSERT_EQ(poller.get_channels_count(), 2);
+    ASSERT_EQ(poller.poll(), Poller::NONE);
+    ASSERT_EQ(poller.wait_for(10ms), Poller::NONE);
+}
+
+/*
+ * Checks that the ready channel is returned.
+ */
+TEST_F(PollerTest, ready)
+{
+    texts.get_sender().send("hello");
+    ASSERT_EQ(poller.poll(), texts_index);
+    ASSERT_EQ(texts.get_receiver().receive(), "hello");
+    ASSERT_EQ(poller.poll(), Poller::NONE);
+
+    numbers.get_sender().send(42);
+    ASSERT_EQ(poller.wait(), numbers_index);
+}
+
+/*
+ * Checks that a waiting thread is woken up by senders of any channel.
+ */
+TEST_F(PollerTest, wakeUpOnSend)
+{
+    std::thread sender([this] ()
+        {
+            std::this_thread::sleep_for(20ms);
+            texts.get_sender().send("late");
+            std::this_thread::sleep_for(20ms);
+            numbers.get_sender().send(1);
+        });
+
+    std::vector<std::size_t> order;
+
+    while (order.size() < 2)
+    {
+        const std::size_t index = poller.wait_for(5s);
+        ASSERT_NE(index, Poller::NONE);
+        order.push_back(index);
+
+        if (index == texts_index)
+            texts.get_receiver().receive();
+        else
+            numbers.get_receiver().receive();
+    }
+
+    sender.join();
+    ASSERT_EQ(order, std::vector<std::size_t>({texts_index, numbers_index}));
+}
+
+/*
+ * Checks that wake_up() interrupts the wait.
+ */
+TEST_F(PollerTest, wakeUp)
+{
+    std::thread waker([this] ()
+        {
+            std::this_thread::sleep_for(20ms);
+            poller.wake_up();
+        });
+
+    ASSERT_EQ(poller.wait(), Poller::NONE);
+    waker.join();
+}
+
+/*
+ * Checks the round-robin order among ready channels, and the weights.
+ */
+TEST(PollerWeightTest, weightedRoundRobin)
+{
+    Channel<int> a;
+    Channel<int> b;
+    Poller poller;
+    const std::size_t ia = poller.add(a, 2);
+    const std::size_t ib = poller.add(b);
+    std::vector<std::size_t> order;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        a.get_sender().send(i);
+        b.get_sender().send(i);
+    }
+
+    for (int i = 0; i < 6; ++i)
+    {
+        const std::size_t index = poller.poll();
+        order.push_back(index);
+        (index == ia ? a : b).get_receiver().receive();
+    }
+
+    ASSERT_EQ(order, std::vector<std::size_t>({ia, ia, ib, ia, ia, ib}));
+}
+
+/*
+ * Checks that the poller detaches from its channels when destroyed.
+ */
+TEST(PollerWeightTest, detach)
+{
+    Channel<int> channel;
+
+    {
+        Poller poller;
+        poller.add(channel);
+    }
+
+    channel.get_sender().send(1);
+    ASSERT_EQ(channel.get_receiver().receive(), 1);
+}
+
+/*
+ * Checks that a second poller cannot take over the channel of the first one, until the first one is destroyed.
+ */
+TEST(PollerWeightTest, singleListener)
+{
+    Channel<int> channel;
+    Poller second;
+
+    {
+        Poller first;
+        first.add(channel);
+
+        ASSERT_THROW(second.add(channel), std::logic_error);
+
+        channel.get_sender().send(1);
+        ASSERT_EQ(first.poll(), 0);
+        ASSERT_EQ(second.poll(), Poller::NONE);
+    }
+
+    ASSERT_EQ(second.add(channel), 0);
+    ASSERT_EQ(second.poll(), 0);
+}
+
+namespace
+{
+    /*
+     * Sends a batch bigger than the channel, while the current thread receives only when the poller returns:
+     * returns how long it took (in milliseconds) to receive the whole batch.
+     */
+    template<typename TChannel>
+    long receive_filling_batch(TChannel& channel)
+    {
+        Poller poller;
+        poller.add(channel);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        std::thread sender([&channel] ()
+            {
+                // the receiver is waiting on the poller when the batch starts
+                std::this_thread::sleep_for(20ms);
+                std::vector<int> elements = {1, 2, 3, 4, 5};
+                channel.get_sender().send_batch(elements.begin(), elements.end());
+            });
+
+        int received = 0;
+        int element;
+
+        while (received < 5)
+        {
+            poller.wait_for(5s);
+
+            while (channel.get_receiver().try_receive(&element))
+                ++received;
+        }
+
+        sender.join();
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+/*
+ * Checks that a sender that waits for space in the middle of a batch wakes up the poller first (otherwise the
+ * receiver sleeps until the poller times out).
+ */
+TEST(PollerWeightTest, fullDuringBatch)
+{
+    Channel<int> channel(2);
+    MpmcChannel<int> lock_free(2);
+
+    ASSERT_LT(receive_filling_batch(channel), 4000);
+    ASSERT_LT(receive_filling_batch(lock_free), 4000);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
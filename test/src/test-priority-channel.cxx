@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/priority-channel.hxx>
+
+using namespace ese::flow;
+
+typedef struct _Message_
+{
+    int priority;
+    std::string text;
+
+    int get_priority() const noexcept
+    {
+        return priority;
+    }
+} Message;
+
+class PriorityChannelTest: public testing::Test
+{
+    protected:
+        PriorityChannel<Message, 3> channel;
+        Receiver<Message>& receiver;
+        Sender<Message>& sender;
+
+    public:
+        PriorityChannelTest():
+            channel(16),
+            receiver(channel.get_receiver()),
+            sender(channel.get_sender())
+        {
+
+        }
+};
+
+/*
+ * Checks that the most urgent levels are received first, and every level in FIFO order.
+ */
+TEST_F(PriorityChannelTest, urgentFirst)
+{
+    sender.send({2, "bulk-0"});
+    sender.send({1, "normal-0"});
+    sender.send({2, "bulk-1"});
+    sender.send({0, "control-0"});
+    sender.send({1, "normal-1"});
+    sender.send({0, "control-1"});
+
+    std::vector<std::string> texts;
+    Message message;
+
+    while (receiver.try_receive(&message))
+        texts.push_back(message.text);
+
+    ASSERT_EQ(texts, std::vector<std::string>({"control-0", "control-1", "normal-0", "normal-1", "bulk-0",
+        "bulk-1"}));
+}
+
+/*
+ * Checks that levels beyond the last one are clamped to it.
+ */
+TEST_F(PriorityChannelTest, clampedLevel)
+{
+    sender.send({42, "far"});
+    sender.send({2, "bulk"});
+    sender.send({1, "normal"});
+
+    ASSERT_EQ(receiver.receive().text, "normal");
+    ASSERT_EQ(receiver.receive().text, "far");
+    ASSERT_EQ(receiver.receive().text, "bulk");
+}
+
+/*
+ * Checks that a full level does not block the others.
+ */
+TEST_F(PriorityChannelTest, fullLevel)
+{
+    for (int i = 0; i < 16; ++i)
+        ASSERT_TRUE(sender.try_send(Message{2, "bulk"}));
+
+    ASSERT_FALSE(sender.try_send(Message{2, "bulk"}));
+    ASSERT_TRUE(sender.try_send(Message{0, "control"}));
+    ASSERT_EQ(receiver.receive().text, "control");
+}
+
+/*
+ * Checks that a custom functor can extract the level.
+ */
+TEST(PriorityChannelFunctorTest, customFunctor)
+{
+    struct Parity
+    {
+        std::size_t operator()(int i) const noexcept
+        {
+            return i % 2 == 0 ? 0 : 1;
+        }
+    };
+
+    PriorityChannel<int, 2, Parity> channel(8);
+    std::vector<int> elements = {1, 2, 3, 4, 5, 6};
+    channel.get_sender().send_batch(elements.begin(), elements.end());
+
+    int received[6];
+    ASSERT_EQ(channel.get_receiver().receive_batch(received, 6), 6);
+    ASSERT_EQ(std::vector<int>(received, received + 6), std::vector<int>({2, 4, 6, 1, 3, 5}));
+}
+
+namespace
+{
+    /*
+     * An element whose default constructor throws after a number of constructions.
+     */
+    typedef struct _Fragile_
+    {
+        static int constructions_left;
+        static int alive;
+
+        _Fragile_()
+        {
+            if (constructions_left-- == 0)
+                throw std::runtime_error("construction failed");
+
+            ++alive;
+        }
+
+        ~_Fragile_()
+        {
+            --alive;
+        }
+
+        int get_priority() const noexcept
+        {
+            return 0;
+        }
+    } Fragile;
+
+    int Fragile::constructions_left = 0;
+    int Fragile::alive = 0;
+}
+
+/*
+ * Checks that the levels already constructed are destroyed when a later level fails.
+ */
+TEST(PriorityChannelFunctorTest, failedLevel)
+{
+    // the first two levels (of 8 slots each) are constructed, the third one fails
+    Fragile::constructions_left = 20;
+
+    ASSERT_THROW((PriorityRingBuffer<Fragile, 3>(8)), std::runtime_error);
+    ASSERT_EQ(Fragile::alive, 0);
+}
+
+/*
+ * Many producers send on every level while a consumer receives: nothing is lost.
+ */
+TEST(PriorityChannelFunctorTest, concurrentProducers)
+{
+    PriorityChannel<Message, 4> channel(64);
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < 4; ++p)
+        producers.emplace_back([&channel, p] ()
+            {
+                for (int i = 0; i < 1000; ++i)
+                    channel.get_sender().send({(p + i) % 4, ""});
+            });
+
+    int received = 0;
+
+    while (received < 4000)
+    {
+        channel.get_receiver().receive();
+        ++received;
+    }
+
+    for (std::thread& producer: producers)
+        producer.join();
+
+    Message message;
+    ASSERT_FALSE(channel.get_receiver().try_receive(&message));
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
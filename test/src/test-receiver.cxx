@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include <condition_variable>
+#include <iterator>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 #include <ese/flow/receiver.hxx>
 
 using namespace ese::flow;
@@ -18,37 +20,16 @@ public:
         condition_variable.notify_all();
     }
 
-    bool try_receive_until_0(int* address, const boost::any& time) override
-    {
-        using time_point_high = std::chrono::time_point<std::chrono::high_resolution_clock>;
-        using time_point_steady = std::chrono::time_point<std::chrono::steady_clock>;
-        using time_point_system = std::chrono::time_point<std::chrono::system_clock>;
-
-        if (time.type() == typeid(time_point_high))
-            return try_receive_until_1(address, boost::any_cast<time_point_high>(time));
-
-        if (time.type() == typeid(time_point_steady))
-            return try_receive_until_1(address, boost::any_cast<time_point_steady>(time));
-
-        if (time.type() == typeid(time_point_system))
-            return try_receive_until_1(address, boost::any_cast<time_point_system>(time));
-
-        throw std::exception();
-    }
-
-private:
-    std::queue<int> queue;
-    std::mutex mutex;
-    std::condition_variable condition_variable;
-
-    template<class Clock, class Duration>
-    bool try_receive_until_1(int* address, const std::chrono::time_point<Clock, Duration>& time)
+    bool try_receive_until_0(int* address, const Deadline& time) override
     {
         std::unique_lock<std::mutex> lock(mutex);
 
         if (queue.empty())
         {
-            condition_variable.wait_until(lock, time);
+            if (time == Deadline::max())
+                condition_variable.wait(lock);
+            else
+                condition_variable.wait_until(lock, time);
 
             if (queue.empty())
                 return false;
@@ -58,6 +39,11 @@ private:
         queue.pop();
         return true;
     }
+
+private:
+    std::queue<int> queue;
+    std::mutex mutex;
+    std::condition_variable condition_variable;
 };
 
 class ReceiverTest: public testing::Test
@@ -174,6 +160,29 @@ TEST_F(ReceiverTest, tryReceive)
     ASSERT_LT(used_time1, 50ms);
 }
 
+/*
+ * Testing if the default receive_batch() implementation receives the available elements (up to max).
+ */
+TEST_F(ReceiverTest, receiveBatch)
+{
+    for (int i = 1; i <= 5; ++i)
+        receiver.send(i);
+
+    std::vector<int> numbers;
+    int array[8];
+
+    std::size_t received0 = receiver.receive_batch(std::back_inserter(numbers), 3);
+    std::size_t received1 = receiver.receive_batch(array, 8, true);
+    std::size_t received2 = receiver.receive_batch(array, 8, std::chrono::steady_clock::now() + 10ms);
+
+    ASSERT_EQ(received0, 3);
+    ASSERT_EQ(received1, 2);
+    ASSERT_EQ(received2, 0);
+    ASSERT_EQ(numbers, std::vector<int>({1, 2, 3}));
+    ASSERT_EQ(array[0], 4);
+    ASSERT_EQ(array[1], 5);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
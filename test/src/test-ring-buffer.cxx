@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/ring-buffer.hxx>
+
+using namespace ese::flow;
+
+class RingBufferTest: public testing::Test
+{
+public:
+    RingBufferTest()
+    {
+
+    }
+};
+
+/*
+ * Checks that the capacity is rounded up to the next power of two.
+ */
+TEST_F(RingBufferTest, capacityRounding)
+{
+    SpscRingBuffer<int> spsc(5);
+    MpmcRingBuffer<int> mpmc(16);
+
+    ASSERT_EQ(spsc.get_capacity(), 8);
+    ASSERT_EQ(mpmc.get_capacity(), 16);
+}
+
+/*
+ * Fills the SPSC buffer, checks that it refuses more elements and that they are popped in the correct order.
+ */
+TEST_F(RingBufferTest, spscFullAndEmpty)
+{
+    SpscRingBuffer<std::string> buffer(4);
+    std::string rejected = "rejected";
+    std::string s;
+
+    ASSERT_TRUE(buffer.is_empty());
+    ASSERT_FALSE(buffer.try_pop(&s));
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(buffer.try_push(std::to_string(i)));
+
+    ASSERT_FALSE(buffer.try_push(std::move(rejected)));
+    ASSERT_EQ(rejected, "rejected");
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(buffer.try_pop(&s));
+        ASSERT_EQ(s, std::to_string(i));
+    }
+
+    ASSERT_TRUE(buffer.is_empty());
+}
+
+/*
+ * Fills the MPMC buffer, checks that it refuses more elements and that they are popped in the correct order.
+ */
+TEST_F(RingBufferTest, mpmcFullAndEmpty)
+{
+    MpmcRingBuffer<std::string> buffer(4);
+    std::string rejected = "rejected";
+    std::string s;
+
+    ASSERT_TRUE(buffer.is_empty());
+    ASSERT_FALSE(buffer.try_pop(&s));
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(buffer.try_push(std::to_string(i)));
+
+    ASSERT_FALSE(buffer.try_push(std::move(rejected)));
+    ASSERT_EQ(rejected, "rejected");
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(buffer.try_pop(&s));
+        ASSERT_EQ(s, std::to_string(i));
+    }
+
+    ASSERT_TRUE(buffer.is_empty());
+}
+
+/*
+ * Passes many elements through a small MPMC buffer with several producers and consumers and checks that every element
+ * is popped exactly once.
+ */
+TEST_F(RingBufferTest, mpmcConcurrent)
+{
+    static const int producers = 4;
+    static const int per_producer = 20000;
+
+    MpmcRingBuffer<int> buffer(64);
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(producers, 0);
+
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&buffer] ()
+            {
+                for (int i = 1; i <= per_producer; ++i)
+                    while (!buffer.try_push(i))
+                        std::this_thread::yield();
+            });
+
+    for (int c = 0; c < producers; ++c)
+        threads.emplace_back([&buffer, &sums, c] ()
+            {
+                int n;
+
+                for (int i = 0; i < per_producer; ++i)
+                {
+                    while (!buffer.try_pop(&n))
+                        std::this_thread::yield();
+
+                    sums[c] += n;
+                }
+            });
+
+    for (std::thread& thread: threads)
+        thread.join();
+
+    long long sum = 0;
+
+    for (long long partial: sums)
+        sum += partial;
+
+    ASSERT_EQ(sum, producers * (static_cast<long long>(per_producer) * (per_producer + 1) / 2));
+    ASSERT_TRUE(buffer.is_empty());
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
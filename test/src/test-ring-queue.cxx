@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/ring-queue.hxx>
+
+using namespace ese::flow;
+
+static int allocations = 0;
+
+/*
+ * An allocator that counts its allocations.
+ */
+template<typename T>
+class CountingAllocator: public std::allocator<T>
+{
+public:
+    template<typename U>
+    struct rebind
+    {
+        typedef CountingAllocator<U> other;
+    };
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept
+    {
+
+    }
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+/*
+ * Elements are popped in the same order they were pushed, also while the ring wraps and grows.
+ */
+TEST(RingQueueTest, fifo)
+{
+    RingQueue<std::string> queue;
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.capacity(), 0);
+
+    int pushed = 0;
+    int popped = 0;
+
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 7 * round; ++i)
+            queue.push(std::to_string(pushed++));
+
+        for (int i = 0; i < 5 * round; ++i)
+        {
+            ASSERT_EQ(queue.front(), std::to_string(popped++));
+            queue.pop();
+        }
+    }
+
+    ASSERT_EQ(queue.size(), static_cast<std::size_t>(pushed - popped));
+
+    while (!queue.empty())
+    {
+        ASSERT_EQ(queue.front(), std::to_string(popped++));
+        queue.pop();
+    }
+
+    ASSERT_EQ(popped, pushed);
+}
+
+/*
+ * Once grown, the ring does not allocate anymore.
+ */
+TEST(RingQueueTest, steadyStateDoesNotAllocate)
+{
+    allocations = 0;
+    RingQueue<int, CountingAllocator<int>> queue;
+    queue.reserve(100);
+
+    ASSERT_EQ(allocations, 1);
+    ASSERT_EQ(queue.capacity(), 128);
+
+    for (int round = 0; round < 1000; ++round)
+    {
+        for (int i = 0; i < 100; ++i)
+            queue.push(i);
+
+        while (!queue.empty())
+            queue.pop();
+    }
+
+    ASSERT_EQ(allocations, 1);
+}
+
+/*
+ * A RingQueueChannel passes values like any Channel.
+ */
+TEST(RingQueueTest, channel)
+{
+    RingQueueChannel<int> channel;
+    channel.get_sender().send(1);
+    channel.get_sender() << 2;
+
+    ASSERT_EQ(channel.get_receiver().receive(), 1);
+    ASSERT_EQ(channel.get_receiver().receive(), 2);
+    ASSERT_TRUE(channel.is_empty());
+}
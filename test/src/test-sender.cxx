@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <chrono>
 #include <queue>
+#include <string>
+#include <vector>
 #include <ese/flow/sender.hxx>
 
 using namespace ese::flow;
@@ -87,6 +90,37 @@ TEST_F(SenderTest, copySendOp)
     ASSERT_EQ(sender.copied.size(), 2);
 }
 
+/*
+ * Tests if the default send_batch() implementation forwards every element to the "move" send() method.
+ */
+TEST_F(SenderTest, sendBatch)
+{
+    std::vector<std::string> names = {"janez", "pintar", "ese"};
+
+    sender.send_batch(names.begin(), names.end());
+
+    ASSERT_EQ(sender.moved.size(), 3);
+    ASSERT_EQ(sender.copied.size(), 0);
+    ASSERT_EQ(sender.moved.front(), "janez");
+    ASSERT_EQ(names[0], "janez");
+}
+
+/*
+ * Tests if the default try_send() implementation always sends the element (via the "move" send() method).
+ */
+TEST_F(SenderTest, trySend)
+{
+    std::string name = "janez";
+
+    ASSERT_TRUE(sender.try_send(std::string("ese")));
+    ASSERT_TRUE(sender.try_send(name));
+    ASSERT_TRUE(sender.try_send_for(std::string("pintar"), std::chrono::milliseconds(1)));
+
+    ASSERT_EQ(sender.moved.size(), 3);
+    ASSERT_EQ(sender.copied.size(), 0);
+    ASSERT_EQ(name, "janez");
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
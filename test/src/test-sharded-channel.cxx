@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <ese/flow/poller.hxx>
+#include <ese/flow/sharded-channel.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class ShardedChannelTest: public testing::TestWithParam<ShardOrdering>
+{
+    protected:
+        ShardedChannel<std::pair<int, int>> channel;
+        Receiver<std::pair<int, int>>& receiver;
+        Sender<std::pair<int, int>>& sender;
+
+    public:
+        ShardedChannelTest():
+            channel(4, GetParam()),
+            receiver(channel.get_receiver()),
+            sender(channel.get_sender())
+        {
+
+        }
+};
+
+/*
+ * Passes some values through the channel, from a single thread (they share the same shard).
+ */
+TEST_P(ShardedChannelTest, simpleValuePassing)
+{
+    ASSERT_TRUE(channel.is_empty());
+    ASSERT_EQ(channel.get_shards_count(), 4);
+
+    sender.send({0, 1});
+    sender << std::make_pair(0, 2);
+
+    ASSERT_FALSE(channel.is_empty());
+    ASSERT_EQ(receiver.receive().second, 1);
+    ASSERT_EQ(receiver.receive().second, 2);
+
+    std::pair<int, int> element;
+    ASSERT_FALSE(receiver.try_receive(&element));
+    ASSERT_FALSE(receiver.try_receive_for(&element, 5ms));
+}
+
+/*
+ * Many producers send at the same time, a consumer receives in batches: nothing is lost and (with
+ * PER_PRODUCER_FIFO) the elements of every producer arrive in order.
+ */
+TEST_P(ShardedChannelTest, manyProducers)
+{
+    static const int producers_count = 8;
+    static const int elements_count = 10000;
+
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < producers_count; ++p)
+        producers.emplace_back([this, p] ()
+            {
+                for (int i = 0; i < elements_count; ++i)
+                    sender.send({p, i});
+            });
+
+    std::vector<int> last(producers_count, -1);
+    std::vector<int> received(producers_count, 0);
+    std::pair<int, int> batch[32];
+    int total = 0;
+
+    while (total < producers_count * elements_count)
+    {
+        const std::size_t count = receiver.receive_batch(batch, 32, std::chrono::steady_clock::now() + 5s);
+        ASSERT_NE(count, 0);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const int p = batch[i].first;
+
+            if (GetParam() == ShardOrdering::PER_PRODUCER_FIFO)
+            {
+                ASSERT_GT(batch[i].second, last[p]);
+            }
+
+            last[p] = batch[i].second;
+            ++received[p];
+        }
+
+        total += static_cast<int>(count);
+    }
+
+    for (std::thread& producer: producers)
+        producer.join();
+
+    for (int p = 0; p < producers_count; ++p)
+        ASSERT_EQ(received[p], elements_count);
+
+    ASSERT_TRUE(channel.is_empty());
+}
+
+/*
+ * Checks that a sleeping receiver is woken up by a send, and by wake_up().
+ */
+TEST_P(ShardedChannelTest, sleepingReceiver)
+{
+    std::thread thread([this] ()
+        {
+            std::this_thread::sleep_for(20ms);
+            sender.send({1, 42});
+            std::this_thread::sleep_for(20ms);
+            channel.wake_up();
+        });
+
+    std::pair<int, int> element;
+
+    ASSERT_TRUE(receiver.try_receive_for(&element, 5s));
+    ASSERT_EQ(element.second, 42);
+    ASSERT_FALSE(receiver.try_receive_for(&element, 5s));
+    thread.join();
+}
+
+/*
+ * Checks that a Poller is notified by the channel.
+ */
+TEST_P(ShardedChannelTest, poller)
+{
+    Poller poller;
+    const std::size_t index = poller.add(channel);
+
+    ASSERT_EQ(poller.poll(), Poller::NONE);
+    std::vector<std::pair<int, int>> elements = {{0, 1}, {0, 2}};
+    sender.send_batch(elements.begin(), elements.end());
+    ASSERT_EQ(poller.wait_for(1s), index);
+}
+
+INSTANTIATE_TEST_SUITE_P(Orderings, ShardedChannelTest,
+    testing::Values(ShardOrdering::PER_PRODUCER_FIFO, ShardOrdering::RELAXED));
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <ese/flow/shared-memory-channel.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+typedef struct _Sample_
+{
+    int producer;
+    int index;
+    double value;
+} Sample;
+
+/*
+ * A channel attached to the same memory sees the elements sent by the creator.
+ */
+TEST(SharedMemoryChannelTest, simpleValuePassing)
+{
+    SharedMemory memory = SharedMemory::create_anonymous(SharedMemoryChannel<Sample>::get_required_size(4));
+    const int fd = dup(memory.get_fd());
+
+    SharedMemoryChannel<Sample> creator(std::move(memory), 4);
+    SharedMemoryChannel<Sample> attached(SharedMemory::from_fd(fd));
+
+    ASSERT_EQ(attached.get_capacity(), 4);
+    ASSERT_TRUE(attached.is_empty());
+
+    creator.get_sender().send({0, 1, 0.5});
+    creator.get_sender() << Sample{0, 2, 1.5};
+
+    ASSERT_FALSE(attached.is_empty());
+
+    Sample sample = attached.get_receiver().receive();
+    ASSERT_EQ(sample.index, 1);
+    ASSERT_EQ(sample.value, 0.5);
+    ASSERT_EQ(attached.get_receiver().receive().index, 2);
+    ASSERT_FALSE(attached.get_receiver().try_receive_for(&sample, 5ms));
+}
+
+/*
+ * A full channel makes try_send() fail (after its deadline).
+ */
+TEST(SharedMemoryChannelTest, fullChannel)
+{
+    SharedMemoryChannel<int> channel(SharedMemory::create_anonymous(SharedMemoryChannel<int>::get_required_size(2)), 2);
+    Sender<int>& sender = channel.get_sender();
+
+    ASSERT_TRUE(sender.try_send(1));
+    ASSERT_TRUE(sender.try_send(2));
+    ASSERT_FALSE(sender.try_send(3));
+    ASSERT_FALSE(sender.try_send_for(3, 5ms));
+
+    int numbers[2];
+    ASSERT_EQ(channel.get_receiver().receive_batch(numbers, 2), 2);
+    ASSERT_EQ(numbers[0], 1);
+    ASSERT_EQ(numbers[1], 2);
+    ASSERT_TRUE(sender.try_send(3));
+}
+
+/*
+ * Attaching to a region that does not contain a channel (of the right type) fails.
+ */
+TEST(SharedMemoryChannelTest, invalidAttach)
+{
+    ASSERT_THROW(SharedMemoryChannel<int>(SharedMemory::create_anonymous(4096)), std::invalid_argument);
+    ASSERT_THROW(SharedMemoryChannel<int>(SharedMemory::create_anonymous(16), 1024), std::invalid_argument);
+
+    SharedMemory memory = SharedMemory::create_anonymous(SharedMemoryChannel<int>::get_required_size(8));
+    const int fd = dup(memory.get_fd());
+    SharedMemoryChannel<int> channel(std::move(memory), 8);
+
+    ASSERT_THROW(SharedMemoryChannel<Sample>(SharedMemory::from_fd(fd)), std::invalid_argument);
+}
+
+/*
+ * Elements pass from a child process to its parent through a named shared memory object.
+ */
+TEST(SharedMemoryChannelTest, betweenProcesses)
+{
+    static const int elements_count = 100000;
+
+    const std::string name = "/ese-flow-test-" + std::to_string(getpid());
+    SharedMemoryChannel<Sample> channel(
+        SharedMemory::create(name, SharedMemoryChannel<Sample>::get_required_size(64)), 64);
+
+    const pid_t child = fork();
+    ASSERT_NE(child, -1);
+
+    if (child == 0)
+    {
+        SharedMemoryChannel<Sample> attached(SharedMemory::open(name));
+
+        for (int i = 0; i < elements_count; ++i)
+            attached.get_sender().send({1, i, i * 0.5});
+
+        _exit(0);
+    }
+
+    bool in_order = true;
+
+    for (int i = 0; i < elements_count; ++i)
+    {
+        const Sample sample = channel.get_receiver().receive();
+        in_order = in_order && sample.producer == 1 && sample.index == i && sample.value == i * 0.5;
+    }
+
+    int status;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(SharedMemory::unlink(name));
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    ASSERT_TRUE(in_order);
+    ASSERT_TRUE(channel.is_empty());
+}
+
+/*
+ * Checks that a blocking receive never returns empty-handed, even when woken for an element another receiver took.
+ */
+TEST(SharedMemoryChannelTest, blockingReceiveAfterStolenElement)
+{
+    static const int threads_count = 4;
+    static const int per_thread = 2000;
+
+    // the channel never fills up, so that the sender does not wait for failed receivers
+    SharedMemoryChannel<int> channel(SharedMemory::create_anonymous(
+        SharedMemoryChannel<int>::get_required_size(threads_count * per_thread)), threads_count * per_thread);
+    std::vector<std::thread> threads;
+    std::vector<int> failures(threads_count, 0);
+
+    for (int c = 0; c < threads_count; ++c)
+        threads.emplace_back([&channel, &failures, c] ()
+            {
+                int element;
+
+                for (int i = 0; i < per_thread; ++i)
+                    if (!channel.get_receiver().try_receive(&element, true))
+                        ++failures[c];
+            });
+
+    // sends in bursts, so that the parked receivers are woken together and race for the elements
+    for (int i = 0; i < threads_count * per_thread; ++i)
+    {
+        channel.get_sender().send(i);
+
+        if (i % threads_count == 0)
+            std::this_thread::sleep_for(10us);
+    }
+
+    for (std::thread& thread: threads)
+        thread.join();
+
+    for (int failed: failures)
+        ASSERT_EQ(failed, 0);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <ese/flow/small-function.hxx>
+
+using namespace ese::flow;
+
+class SmallFunctionTest: public testing::Test
+{
+    public:
+        SmallFunctionTest()
+        {
+
+        }
+};
+
+/*
+ * Checks that small lambdas are stored inline and big ones on the heap, and that both are called.
+ */
+TEST_F(SmallFunctionTest, inlineAndHeap)
+{
+    int a = 1;
+    long b[16] = {2};
+
+    SmallFunction<int(int)> small = [a] (int x) { return a + x; };
+    SmallFunction<int(int)> big = [b] (int x) { return static_cast<int>(b[0]) + x; };
+
+    ASSERT_TRUE(small.is_inline());
+    ASSERT_FALSE(big.is_inline());
+    ASSERT_EQ(small(10), 11);
+    ASSERT_EQ(big(10), 12);
+}
+
+/*
+ * Checks that a move-only callable can be wrapped and moved around, and that it is destroyed exactly once.
+ */
+TEST_F(SmallFunctionTest, moveOnly)
+{
+    std::shared_ptr<int> counter = std::make_shared<int>(42);
+    std::unique_ptr<std::shared_ptr<int>> owned(new std::shared_ptr<int>(counter));
+
+    SmallFunction<int()> f = [owned = std::move(owned)] () { return **owned; };
+    ASSERT_EQ(counter.use_count(), 2);
+
+    SmallFunction<int()> g = std::move(f);
+    ASSERT_FALSE(f);
+    ASSERT_TRUE(g);
+    ASSERT_EQ(g(), 42);
+
+    f = std::move(g);
+    ASSERT_EQ(f(), 42);
+
+    f = nullptr;
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+/*
+ * Checks that the inline capacity can be configured.
+ */
+TEST_F(SmallFunctionTest, capacity)
+{
+    std::string s = "ese";
+
+    SmallFunction<std::size_t(), 8> small = [&s] () { return s.size(); };
+    SmallFunction<std::size_t(), 8> big = [s] () { return s.size(); };
+
+    ASSERT_TRUE(small.is_inline());
+    ASSERT_FALSE(big.is_inline());
+    ASSERT_EQ(small(), 3);
+    ASSERT_EQ(big(), 3);
+}
+
+/*
+ * Checks that calling an empty function throws, like std::function does.
+ */
+TEST_F(SmallFunctionTest, emptyCall)
+{
+    SmallFunction<void()> f;
+
+    ASSERT_FALSE(f);
+    ASSERT_THROW(f(), std::bad_function_call);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
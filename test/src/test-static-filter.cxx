@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <ese/flow/static-filter.hxx>
+
+using namespace ese::flow;
+
+class StringToIntFilter: public StaticFilter<StringToIntFilter>
+{
+public:
+    int filter(const std::string& s)
+    {
+        return std::stoi(s);
+    }
+};
+
+class CountingFilter: public StaticFilter<CountingFilter>
+{
+public:
+    int filter(int i)
+    {
+        ++count;
+        return i;
+    }
+
+    int count = 0;
+};
+
+/*
+ * Test if the filter operator (bitwise or) works with a CRTP filter.
+ */
+TEST(StaticFilterTest, filterOperator)
+{
+    static const std::string v = "789";
+    StringToIntFilter filter;
+
+    ASSERT_EQ(std::string("123") | filter, 123);
+    ASSERT_EQ(v | filter, 789);
+}
+
+/*
+ * Test the composition of CRTP filters and callables into a single fused filter.
+ */
+TEST(StaticFilterTest, composition)
+{
+    static const std::string number = "35";
+
+    auto fused = StringToIntFilter() | static_filter([] (int i) { return -i; }) | static_filter([] (int i)
+        {
+            return std::to_string(i);
+        });
+
+    ASSERT_EQ(number | fused, "-35");
+    ASSERT_EQ(fused(std::string("7")), "-7");
+}
+
+/*
+ * Test that a fused filter holds its own copies of the composed filters.
+ */
+TEST(StaticFilterTest, compositionCopies)
+{
+    CountingFilter counting;
+    auto fused = counting | static_filter([] (int i) { return i * 2; });
+
+    ASSERT_EQ(fused(21), 42);
+    ASSERT_EQ(counting.count, 0);
+}
+
+/*
+ * Test that move-only elements are forwarded through the chain.
+ */
+TEST(StaticFilterTest, moveOnlyElements)
+{
+    auto fused = static_filter([] (std::unique_ptr<int> p) { *p += 1; return p; })
+        | static_filter([] (std::unique_ptr<int> p) { return *p; });
+
+    ASSERT_EQ(std::unique_ptr<int>(new int(41)) | fused, 42);
+}
+
+/*
+ * Test the adapter to the (virtual) Filter interface, also chained with it.
+ */
+TEST(StaticFilterTest, adapter)
+{
+    static const std::string number = "35";
+
+    auto adapter = to_filter<std::string, int>(StringToIntFilter() | static_filter([] (int i) { return -i; }));
+    Filter<std::string, int>& filter = adapter;
+
+    ASSERT_EQ(filter.filter(number), -35);
+    ASSERT_EQ(filter.filter(std::string("12")), -12);
+    ASSERT_EQ(number | filter, -35);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <ese/flow/thread-pool-executor.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class ThreadPoolExecutorTest: public testing::Test
+{
+    public:
+        ThreadPoolExecutorTest()
+        {
+
+        }
+};
+
+/*
+ * Checks that every submitted executable is executed before drain() returns.
+ */
+TEST_F(ThreadPoolExecutorTest, executeAndDrain)
+{
+    ThreadPoolExecutor<> pool(4);
+    std::atomic_int count(0);
+
+    for (int i = 0; i < 1000; ++i)
+        pool.execute([&count] ()
+            {
+                ++count;
+            });
+
+    pool.drain();
+
+    ASSERT_EQ(pool.get_workers_count(), 4);
+    ASSERT_EQ(count, 1000);
+}
+
+/*
+ * Checks that executables run in parallel, on the workers' threads.
+ */
+TEST_F(ThreadPoolExecutorTest, parallelExecution)
+{
+    ThreadPoolExecutor<> pool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 4; ++i)
+        pool.execute([&mutex, &ids] ()
+            {
+                std::this_thread::sleep_for(100ms);
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(std::this_thread::get_id());
+            });
+
+    pool.drain();
+    auto end = std::chrono::steady_clock::now();
+
+    ASSERT_LT(end - start, 300ms);
+    ASSERT_EQ(ids.size(), 4);
+    ASSERT_EQ(ids.count(std::this_thread::get_id()), 0);
+}
+
+/*
+ * Checks that executables submitted by running executables (pushed to the workers' deques) are executed, and stolen
+ * by the other workers.
+ */
+TEST_F(ThreadPoolExecutorTest, nestedExecution)
+{
+    ThreadPoolExecutor<> pool(4);
+    std::atomic_int count(0);
+    std::function<void(int)> spawn;
+
+    spawn = [&pool, &count, &spawn] (int depth)
+        {
+            ++count;
+
+            if (depth == 0)
+                return;
+
+            for (int i = 0; i < 2; ++i)
+                pool.execute([&spawn, depth] ()
+                    {
+                        spawn(depth - 1);
+                    });
+        };
+
+    pool.execute([&spawn] ()
+        {
+            spawn(10);
+        });
+
+    pool.drain();
+    ASSERT_EQ(count, 2047);
+}
+
+/*
+ * Checks that shutdown() executes the queued executables and that later ones are executed inline.
+ */
+TEST_F(ThreadPoolExecutorTest, shutdown)
+{
+    std::atomic_int count(0);
+    ThreadPoolExecutor<> pool(2, {0});
+
+    for (int i = 0; i < 100; ++i)
+        pool.execute([&count] ()
+            {
+                std::this_thread::sleep_for(100us);
+                ++count;
+            });
+
+    pool.shutdown();
+    ASSERT_EQ(count, 100);
+
+    std::thread::id id;
+    pool.execute([&id] ()
+        {
+            id = std::this_thread::get_id();
+        });
+
+    ASSERT_EQ(id, std::this_thread::get_id());
+    pool.shutdown();
+}
+
+/*
+ * Checks that a ThreadPoolExecutor can be used through the Executor interface.
+ */
+TEST_F(ThreadPoolExecutorTest, asExecutor)
+{
+    std::atomic_bool success(false);
+
+    {
+        ThreadPoolExecutor<> pool(1);
+        Executor<LambdaExecutable>& executor = pool;
+
+        executor.execute([&success] ()
+            {
+                success = true;
+            });
+    }
+
+    ASSERT_TRUE(success);
+}
+
+/*
+ * Checks that copyable executables are copied to the pool and that move-only captures work with LambdaExecutable.
+ */
+TEST_F(ThreadPoolExecutorTest, executableTypes)
+{
+    std::atomic_int count(0);
+
+    {
+        ThreadPoolExecutor<std::function<void()>> pool(2);
+        const std::function<void()> executable = [&count] () { ++count; };
+
+        pool.execute(executable);
+        pool.execute(executable);
+    }
+
+    {
+        ThreadPoolExecutor<> pool(2);
+        std::unique_ptr<int> one(new int(1));
+
+        pool.execute([&count, one = std::move(one)] () { count += *one; });
+    }
+
+    ASSERT_EQ(count, 3);
+}
+
+/*
+ * Checks that no executable is lost when submitted while the pool is shutting down.
+ */
+TEST_F(ThreadPoolExecutorTest, shutdownWhileSubmitting)
+{
+    for (int round = 0; round < 50; ++round)
+    {
+        std::atomic_int count(0);
+        std::atomic_int submitted(0);
+        ThreadPoolExecutor<> pool(2);
+        std::vector<std::thread> submitters;
+
+        for (int t = 0; t < 2; ++t)
+            submitters.emplace_back([&pool, &count, &submitted] ()
+                {
+                    for (int i = 0; i < 200; ++i)
+                    {
+                        pool.execute([&count] () { ++count; });
+                        ++submitted;
+                    }
+                });
+
+        pool.shutdown();
+
+        for (std::thread& submitter: submitters)
+            submitter.join();
+
+        ASSERT_EQ(count, submitted);
+    }
+}
+
+/*
+ * Checks that an executable can not drain (or shut down) its own pool, instead of waiting for itself forever.
+ */
+TEST_F(ThreadPoolExecutorTest, drainFromWorker)
+{
+    ThreadPoolExecutor<> pool(1);
+    std::atomic_int errors(0);
+
+    pool.execute([&pool, &errors] ()
+        {
+            try
+            {
+                pool.drain();
+            }
+            catch (const std::logic_error&)
+            {
+                ++errors;
+            }
+
+            try
+            {
+                pool.shutdown();
+            }
+            catch (const std::logic_error&)
+            {
+                ++errors;
+            }
+        });
+
+    pool.drain();
+    ASSERT_EQ(errors, 2);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
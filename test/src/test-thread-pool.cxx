@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <ese/flow/thread.hxx>
+#include <ese/flow/thread-pool.hxx>
+
+using namespace ese::flow;
+using namespace std::chrono_literals;
+
+class ThreadPoolTest: public testing::Test
+{
+public:
+    ThreadPoolTest()
+    {
+
+    }
+};
+
+/*
+ * Checks that a pooled thread goes through the same statuses as a system thread.
+ */
+TEST_F(ThreadPoolTest, pooledThreadStatus)
+{
+    ThreadPool pool;
+    std::atomic_bool release(false);
+
+    Thread thread([&release] ()
+        {
+            while (!release)
+                std::this_thread::sleep_for(1ms);
+        }, pool);
+
+    while (!thread.is_running())
+        std::this_thread::sleep_for(1ms);
+
+    ASSERT_EQ(Thread::get_native_running_count(), 1);
+
+    release = true;
+    thread.join();
+
+    ASSERT_TRUE(thread.is_joined());
+    ASSERT_EQ(Thread::get_native_running_count(), 0);
+}
+
+/*
+ * Checks that the workers of a warmed-up pool are reused by the following threads (instead of one system thread
+ * per Thread object).
+ */
+TEST_F(ThreadPoolTest, reuse)
+{
+    ThreadPoolOptions options;
+    options.min_size = 2;
+    ThreadPool pool(options);
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+
+    ASSERT_EQ(pool.get_size(), 2);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Thread thread([&mutex, &ids] ()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(std::this_thread::get_id());
+            }, pool);
+
+        thread.join();
+    }
+
+    // a worker that just finished may not be idle yet when the next thread is submitted: allow a few spawns
+    ASSERT_LT(ids.size(), 10);
+    ASSERT_LT(pool.get_size(), 10);
+}
+
+/*
+ * Checks that the pool grows up to its maximal size, then queues the executables.
+ */
+TEST_F(ThreadPoolTest, maxSize)
+{
+    ThreadPoolOptions options;
+    options.max_size = 2;
+    ThreadPool pool(options);
+    std::atomic_bool release(false);
+    std::atomic_int done(0);
+    std::vector<std::unique_ptr<Thread>> threads;
+
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back(new Thread([&release, &done] ()
+            {
+                while (!release)
+                    std::this_thread::sleep_for(1ms);
+
+                ++done;
+            }, pool));
+
+    std::this_thread::sleep_for(20ms);
+
+    ASSERT_EQ(pool.get_size(), 2);
+    ASSERT_EQ(pool.get_pending_count(), 2);
+    ASSERT_EQ(threads[3]->get_status(), Thread::NOT_STARTED);
+
+    release = true;
+
+    for (std::unique_ptr<Thread>& thread: threads)
+        thread->join();
+
+    ASSERT_EQ(done, 4);
+}
+
+/*
+ * Checks that idle workers are retired after the idle timeout, down to the minimal size.
+ */
+TEST_F(ThreadPoolTest, idleTimeout)
+{
+    ThreadPoolOptions options;
+    options.min_size = 1;
+    options.idle_timeout = 20ms;
+    ThreadPool pool(options);
+
+    pool.warm_up(4);
+    ASSERT_EQ(pool.get_size(), 4);
+
+    std::this_thread::sleep_for(200ms);
+
+    ASSERT_EQ(pool.get_size(), 1);
+    ASSERT_EQ(pool.get_idle_count(), 1);
+}
+
+/*
+ * Checks that the executable of a pooled thread is destroyed before join() returns.
+ */
+TEST_F(ThreadPoolTest, executableDestroyed)
+{
+    std::shared_ptr<int> token = std::make_shared<int>(0);
+    std::weak_ptr<int> observer = token;
+
+    {
+        Thread thread([token = std::move(token)] () {}, ThreadPool::get_default());
+        thread.join();
+    }
+
+    ASSERT_TRUE(observer.expired());
+}
@@ -5,6 +5,11 @@
 #include <gtest/gtest.h>
 #include <ese/flow/thread.hxx>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 using namespace std::chrono_literals;
 using namespace ese::flow;
 
@@ -132,6 +137,64 @@ TEST_F(ThreadTest, customExecutable)
     ASSERT_TRUE(*pointer);
 }
 
+/*
+ * Testing if the options (CPU, name) are applied to the thread before running the executable.
+ */
+TEST_F(ThreadTest, options)
+{
+    ThreadOptions options;
+    options.name = "ese-flow-test-thread";
+
+    // the first CPU the test process may run on (CPU 0 can be outside its cpuset)
+    int target = 0;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+
+    while (target < CPU_SETSIZE && !CPU_ISSET(target, &allowed))
+        ++target;
+
+    ASSERT_LT(target, CPU_SETSIZE);
+#endif
+
+    options.cpus = {target};
+
+    int cpu = -1;
+    char name[16] = {};
+
+    Thread thread([&cpu, &name] ()
+        {
+#ifdef __linux__
+            cpu = sched_getcpu();
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+#endif
+        }, options);
+
+    thread.join();
+
+#ifdef __linux__
+    ASSERT_TRUE(thread.is_placed());
+    ASSERT_EQ(cpu, target);
+    ASSERT_STREQ(name, "ese-flow-test-t");
+#endif
+}
+
+/*
+ * Testing if options the operating system refuses are reported by is_placed().
+ */
+TEST_F(ThreadTest, refusedOptions)
+{
+    ThreadOptions options;
+    options.cpus = {-1};
+
+    Thread thread([] () {}, options);
+    thread.join();
+
+    ASSERT_FALSE(thread.is_placed());
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ese/flow/channel.hxx>
+#include <ese/flow/consumer.hxx>
+#include <ese/flow/deadline-channel.hxx>
+#include <ese/flow/filter-sender.hxx>
+#include <ese/flow/trace.hxx>
+
+using namespace ese::flow;
+
+typedef struct _Task_
+{
+    Deadline deadline;
+
+    Deadline get_deadline() const noexcept
+    {
+        return deadline;
+    }
+} Task;
+
+class DoubleFilter: public Filter<int, int>
+{
+public:
+    int filter(int&& i) override
+    {
+        return i * 2;
+    }
+
+    int filter(const int& i) override
+    {
+        return i * 2;
+    }
+};
+
+class SumConsumerFactory: public ConsumerFactory<int>
+{
+public:
+    SumConsumerFactory(Receiver<int>* receiver):
+        ConsumerFactory(receiver),
+        sum(0)
+    {
+
+    }
+
+    void consume_0(int&& number) override
+    {
+        sum += number;
+    }
+
+    int sum;
+};
+
+class TraceTest: public testing::Test
+{
+public:
+    TraceTest()
+    {
+        Tracer::clear();
+        Tracer::set_sampling(1);
+    }
+
+    ~TraceTest()
+    {
+        Tracer::set_sampling(0);
+        Tracer::clear();
+    }
+
+protected:
+    /**
+     * \brief Get the recorded events of a kind.
+     * */
+    static std::vector<TraceEvent> collect(TraceEventType type, const char* name = nullptr)
+    {
+        std::vector<TraceEvent> events = Tracer::collect();
+
+        events.erase(std::remove_if(events.begin(), events.end(), [type, name] (const TraceEvent& event)
+            {
+                return event.type != type || (name != nullptr && std::strcmp(event.name, name) != 0);
+            }), events.end());
+
+        return events;
+    }
+};
+
+/*
+ * Checks that the sampling period is rounded to a power of two, and that one call every period is sampled.
+ */
+TEST_F(TraceTest, sampling)
+{
+    Tracer::set_sampling(3);
+    ASSERT_EQ(Tracer::get_sampling(), 4);
+
+    int sampled = 0;
+
+    for (int i = 0; i < 400; ++i)
+        if (Tracer::sample())
+            ++sampled;
+
+    ASSERT_EQ(sampled, 100);
+    ASSERT_TRUE(Tracer::is_sampled(8));
+    ASSERT_FALSE(Tracer::is_sampled(9));
+
+    Tracer::set_sampling(0);
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_FALSE(Tracer::sample());
+
+    ASSERT_FALSE(Tracer::is_sampled(0));
+    ASSERT_TRUE(collect(TraceEventType::SPAN).empty());
+}
+
+/*
+ * Checks that the elements are traced through the queue, from the sending thread to the receiving one.
+ */
+TEST_F(TraceTest, channel)
+{
+    Channel<int> channel;
+
+    for (int i = 0; i < 3; ++i)
+        channel.get_sender().send(i);
+
+    std::thread receiver([&channel] ()
+        {
+            int element;
+
+            for (int i = 0; i < 3; ++i)
+                channel.get_receiver().try_receive(&element, true);
+        });
+
+    receiver.join();
+
+    const std::vector<TraceEvent> enqueued = collect(TraceEventType::ENQUEUE);
+    const std::vector<TraceEvent> dequeued = collect(TraceEventType::DEQUEUE);
+
+    ASSERT_EQ(enqueued.size(), 3);
+    ASSERT_EQ(dequeued.size(), 3);
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(enqueued[i].object, &channel);
+        ASSERT_EQ(enqueued[i].sequence, i);
+        ASSERT_EQ(dequeued[i].sequence, i);
+        ASSERT_NE(enqueued[i].thread, dequeued[i].thread);
+        ASSERT_LE(enqueued[i].time, dequeued[i].time);
+    }
+
+    ASSERT_EQ(collect(TraceEventType::SPAN, "send").size(), 3);
+    ASSERT_EQ(collect(TraceEventType::SPAN, "receive").size(), 3);
+}
+
+/*
+ * Checks that the elements dropped by the overflow policy do not shift the pairing of the others.
+ */
+TEST_F(TraceTest, droppedElements)
+{
+    Channel<int> channel(1, OverflowPolicy::DROP_OLDEST);
+    int element;
+
+    channel.get_sender().send(1);
+    channel.get_sender().send(2);
+    ASSERT_TRUE(channel.get_receiver().try_receive(&element));
+
+    const std::vector<TraceEvent> dequeued = collect(TraceEventType::DEQUEUE);
+
+    ASSERT_EQ(element, 2);
+    ASSERT_EQ(dequeued.size(), 1);
+    ASSERT_EQ(dequeued[0].sequence, 1);
+}
+
+/*
+ * Checks that the waits in a priority queue (where elements leave out of order) are not traced.
+ */
+TEST_F(TraceTest, priorityQueue)
+{
+    Channel<int, std::priority_queue<int>> channel;
+    int element;
+
+    channel.get_sender().send(1);
+    ASSERT_TRUE(channel.get_receiver().try_receive(&element));
+
+    ASSERT_TRUE(collect(TraceEventType::ENQUEUE).empty());
+    ASSERT_TRUE(collect(TraceEventType::DEQUEUE).empty());
+    ASSERT_EQ(collect(TraceEventType::SPAN, "send").size(), 1);
+}
+
+/*
+ * Checks that the waits in a deadline queue (that has front(), but reorders the elements) are not traced either.
+ */
+TEST_F(TraceTest, deadlineQueue)
+{
+    DeadlineChannel<Task> channel;
+    Task task;
+
+    channel.get_sender().send({deadline_after(std::chrono::seconds(2))});
+    channel.get_sender().send({deadline_after(std::chrono::seconds(1))});
+    ASSERT_TRUE(channel.get_receiver().try_receive(&task));
+
+    ASSERT_TRUE(collect(TraceEventType::ENQUEUE).empty());
+    ASSERT_TRUE(collect(TraceEventType::DEQUEUE).empty());
+    ASSERT_EQ(collect(TraceEventType::SPAN, "send").size(), 2);
+}
+
+/*
+ * Checks that the buffers of exited threads are reused once their events were collected.
+ */
+TEST_F(TraceTest, threadChurn)
+{
+    for (int i = 0; i < 20; ++i)
+    {
+        std::thread([] ()
+            {
+                TraceSpan span("churn");
+            }).join();
+
+        ASSERT_EQ(collect(TraceEventType::SPAN, "churn").size(), 1);
+    }
+
+    std::ostringstream out;
+    Tracer::dump(out);
+    const std::string trace = out.str();
+    std::size_t threads = 0;
+
+    for (std::size_t i = trace.find("thread_name"); i != std::string::npos; i = trace.find("thread_name", i + 1))
+        ++threads;
+
+    ASSERT_LE(threads, 4);
+}
+
+/*
+ * Checks that the hops called by a traced hop are traced within it, and that consumers are traced.
+ */
+TEST_F(TraceTest, nestedHops)
+{
+    Channel<int> channel;
+    DoubleFilter filter;
+    FilterSender<int, int> sender(&filter, &channel.get_sender());
+    SumConsumerFactory factory(&channel.get_receiver());
+    Consumer<int> consumer = factory.create_one();
+
+    Tracer::set_sampling(2);
+
+    // one call every two is sampled: the filter is, the receive is not and the consume is
+    while (Tracer::sample());
+
+    sender.send(21);
+    ASSERT_EQ(consumer(), 1);
+    ASSERT_EQ(factory.sum, 42);
+
+    const std::vector<TraceEvent> filters = collect(TraceEventType::SPAN, "filter");
+    const std::vector<TraceEvent> sends = collect(TraceEventType::SPAN, "send");
+
+    ASSERT_EQ(filters.size(), 1);
+    ASSERT_EQ(sends.size(), 1);
+    ASSERT_LE(filters[0].time, sends[0].time);
+    ASSERT_GE(filters[0].time + filters[0].duration, sends[0].time + sends[0].duration);
+    ASSERT_TRUE(collect(TraceEventType::SPAN, "receive").empty());
+    ASSERT_EQ(collect(TraceEventType::SPAN, "consume").size(), 1);
+}
+
+/*
+ * Checks that the trace is written in the Chrome trace format.
+ */
+TEST_F(TraceTest, dump)
+{
+    Channel<int> channel;
+    int element;
+
+    channel.get_sender().send(1);
+    ASSERT_TRUE(channel.get_receiver().try_receive(&element));
+
+    std::ostringstream out;
+    Tracer::dump(out);
+    const std::string trace = out.str();
+
+    ASSERT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0);
+    ASSERT_NE(trace.find("\"name\":\"thread_name\""), std::string::npos);
+    ASSERT_NE(trace.find("\"name\":\"send\",\"cat\":\"ese-flow\",\"ph\":\"X\""), std::string::npos);
+    ASSERT_NE(trace.find("\"name\":\"queue\",\"cat\":\"ese-flow\",\"ph\":\"b\""), std::string::npos);
+    ASSERT_NE(trace.find("\"name\":\"queue\",\"cat\":\"ese-flow\",\"ph\":\"e\""), std::string::npos);
+    ASSERT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    ASSERT_EQ(trace.find(",,"), std::string::npos);
+}
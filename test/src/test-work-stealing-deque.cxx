@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <ese/flow/work-stealing-deque.hxx>
+
+using namespace ese::flow;
+
+class WorkStealingDequeTest: public testing::Test
+{
+    public:
+        WorkStealingDequeTest()
+        {
+
+        }
+};
+
+/*
+ * Checks that the owner pops in LIFO order and the thieves steal in FIFO order, even after the deque grows.
+ */
+TEST_F(WorkStealingDequeTest, ownerAndThiefOrder)
+{
+    WorkStealingDeque<int> deque(2);
+    int n;
+
+    for (int i = 0; i < 10; ++i)
+        deque.push(i);
+
+    ASSERT_TRUE(deque.steal(&n));
+    ASSERT_EQ(n, 0);
+    ASSERT_TRUE(deque.pop(&n));
+    ASSERT_EQ(n, 9);
+
+    for (int i = 0; i < 8; ++i)
+        ASSERT_TRUE(deque.pop(&n));
+
+    ASSERT_EQ(n, 1);
+    ASSERT_TRUE(deque.is_empty());
+    ASSERT_FALSE(deque.pop(&n));
+    ASSERT_FALSE(deque.steal(&n));
+}
+
+/*
+ * Pushes and pops many elements while several thieves steal, checking that every element is taken exactly once.
+ */
+TEST_F(WorkStealingDequeTest, concurrentSteal)
+{
+    static const int count = 100000;
+    static const int thieves_count = 3;
+
+    WorkStealingDeque<int> deque(16);
+    std::vector<std::atomic_int> taken(count);
+    std::atomic_bool done(false);
+    std::vector<std::thread> thieves;
+
+    for (std::atomic_int& t: taken)
+        t = 0;
+
+    for (int i = 0; i < thieves_count; ++i)
+        thieves.emplace_back([&deque, &taken, &done] ()
+            {
+                int n;
+
+                while (!done.load())
+                {
+                    if (deque.steal(&n))
+                        ++taken[n];
+                    else
+                        std::this_thread::yield();
+                }
+            });
+
+    int n;
+
+    for (int i = 0; i < count; ++i)
+    {
+        deque.push(i);
+
+        if (i % 3 == 0 && deque.pop(&n))
+            ++taken[n];
+    }
+
+    while (deque.pop(&n))
+        ++taken[n];
+
+    done = true;
+
+    for (std::thread& thief: thieves)
+        thief.join();
+
+    bool once = true;
+
+    for (std::atomic_int& t: taken)
+        once = once && t == 1;
+
+    ASSERT_TRUE(once);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}